@@ -260,6 +260,7 @@
 #include "video/dialogs/GUIDialogTeletext.h"
 #include "dialogs/GUIDialogSlider.h"
 #include "guilib/GUIControlFactory.h"
+#include "guilib/GUISkinCache.h"
 #include "dialogs/GUIDialogCache.h"
 #include "dialogs/GUIDialogPlayEject.h"
 #include "utils/XMLUtils.h"
@@ -372,7 +373,6 @@ CApplication::CApplication(void)
   m_bInitializing = true;
   m_eForcedNextPlayer = EPC_NONE;
   m_strPlayListFile = "";
-  m_nextPlaylistItem = -1;
   m_bPlaybackStarting = false;
   m_skinReloading = false;
 
@@ -1758,6 +1758,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   g_localizeStrings.LoadSkinStrings(langPath, skinEnglishPath);
 
   g_SkinInfo->LoadIncludes();
+  CGUISkinCache::Prune();
 
   int64_t start;
   start = CurrentHostCounter();
@@ -2158,6 +2159,7 @@ void CApplication::Render()
 
   g_renderManager.UpdateResolution();
   g_renderManager.ManageCaptures();
+  g_renderManager.FreeReleasedDirectBuffers();
 
   {
     CSingleLock lock(m_frameMutex);
@@ -3688,7 +3690,7 @@ bool CApplication::PlayFile(const CFileItem& item, bool bRestart)
 
     m_iPlaySpeed = 1;
     *m_itemCurrentFile = item;
-    m_nextPlaylistItem = -1;
+    m_nextPlaylistItems.clear();
     m_currentStackPosition = 0;
     m_currentStack->Clear();
 
@@ -4053,6 +4055,12 @@ void CApplication::OnQueueNextItem()
   g_windowManager.SendThreadMessage(msg);
 }
 
+void CApplication::OnQueueCleared(int items)
+{
+  CGUIMessage msg(GUI_MSG_QUEUE_CLEARED, 0, 0, items);
+  g_windowManager.SendThreadMessage(msg);
+}
+
 void CApplication::OnPlayBackStopped()
 {
   if(m_bPlaybackStarting)
@@ -4636,15 +4644,17 @@ bool CApplication::OnMessage(CGUIMessage& message)
       DarwinSetScheduling(message.GetMessage());
 #endif
       // Update our infoManager with the new details etc.
-      if (m_nextPlaylistItem >= 0)
+      if (!m_nextPlaylistItems.empty())
       { // we've started a previously queued item
-        CFileItemPtr item = g_playlistPlayer.GetPlaylist(g_playlistPlayer.GetCurrentPlaylist())[m_nextPlaylistItem];
+        int nextPlaylistItem = m_nextPlaylistItems.front();
+        m_nextPlaylistItems.pop_front();
+        CFileItemPtr item = g_playlistPlayer.GetPlaylist(g_playlistPlayer.GetCurrentPlaylist())[nextPlaylistItem];
         // update the playlist manager
         int currentSong = g_playlistPlayer.GetCurrentSong();
-        int param = ((currentSong & 0xffff) << 16) | (m_nextPlaylistItem & 0xffff);
+        int param = ((currentSong & 0xffff) << 16) | (nextPlaylistItem & 0xffff);
         CGUIMessage msg(GUI_MSG_PLAYLISTPLAYER_CHANGED, 0, 0, g_playlistPlayer.GetCurrentPlaylist(), param, item);
         g_windowManager.SendThreadMessage(msg);
-        g_playlistPlayer.SetCurrentSong(m_nextPlaylistItem);
+        g_playlistPlayer.SetCurrentSong(nextPlaylistItem);
         *m_itemCurrentFile = *item;
       }
       g_infoManager.SetCurrentItem(*m_itemCurrentFile);
@@ -4695,8 +4705,10 @@ bool CApplication::OnMessage(CGUIMessage& message)
   case GUI_MSG_QUEUE_NEXT_ITEM:
     {
       // Check to see if our playlist player has a new item for us,
-      // and if so, we check whether our current player wants the file
-      int iNext = g_playlistPlayer.GetNextSong();
+      // and if so, we check whether our current player wants the file.
+      // players may queue more than one item ahead
+      int iNext = m_nextPlaylistItems.empty() ? g_playlistPlayer.GetNextSong()
+                                              : g_playlistPlayer.GetNextSong(m_nextPlaylistItems.size() + 1);
       CPlayList& playlist = g_playlistPlayer.GetPlaylist(g_playlistPlayer.GetCurrentPlaylist());
       if (iNext < 0 || iNext >= playlist.size())
       {
@@ -4708,12 +4720,21 @@ bool CApplication::OnMessage(CGUIMessage& message)
       // ok - send the file to the player if it wants it
       if (m_pPlayer && m_pPlayer->QueueNextFile(*item))
       { // player wants the next file
-        m_nextPlaylistItem = iNext;
+        m_nextPlaylistItems.push_back(iNext);
       }
       return true;
     }
     break;
 
+  case GUI_MSG_QUEUE_CLEARED:
+    {
+      // the player won't start these after all
+      int items = std::min((int)message.GetParam1(), (int)m_nextPlaylistItems.size());
+      m_nextPlaylistItems.erase(m_nextPlaylistItems.begin(), m_nextPlaylistItems.begin() + items);
+      return true;
+    }
+    break;
+
   case GUI_MSG_PLAYBACK_STOPPED:
   case GUI_MSG_PLAYBACK_ENDED:
   case GUI_MSG_PLAYLISTPLAYER_STOPPED:
@@ -28,6 +28,7 @@
 #include "threads/Condition.h"
 
 #include <map>
+#include <deque>
 
 class CFileItem;
 class CFileItemList;
@@ -144,6 +145,7 @@ public:
   virtual void OnPlayBackResumed();
   virtual void OnPlayBackStopped();
   virtual void OnQueueNextItem();
+  virtual void OnQueueCleared(int items);
   virtual void OnPlayBackSeek(int iTime, int seekOffset);
   virtual void OnPlayBackSeekChapter(int iChapter);
   virtual void OnPlayBackSpeedChanged(int iSpeed);
@@ -358,7 +360,7 @@ protected:
 
   int m_iPlaySpeed;
   int m_currentStackPosition;
-  int m_nextPlaylistItem;
+  std::deque<int> m_nextPlaylistItems; // items queued in the player, in playing order
 
   bool m_bPresentFrame;
   unsigned int m_lastFrameTime;
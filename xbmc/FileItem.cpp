@@ -42,6 +42,11 @@
 #include "utils/TuxBoxUtil.h"
 #include "video/VideoInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "music/tags/MusicInfoTag.h"
 #include "pictures/PictureInfoTag.h"
 #include "music/Artist.h"
@@ -63,6 +68,85 @@ using namespace XFILE;
 using namespace PLAYLIST;
 using namespace MUSIC_INFO;
 
+#define SORT_PARALLEL_MIN_ITEMS 10000 // smaller lists sort faster than jobs are handed out
+#define SORT_MAX_CHUNKS         8
+
+// items sorting on top, then folders, files and those sorting on bottom
+#define SORT_GROUP_TOP          0
+#define SORT_GROUP_FOLDERS      1
+#define SORT_GROUP_FILES        2
+#define SORT_GROUP_BOTTOM       3
+#define SORT_GROUP_INVALID      4
+
+struct SSortKey
+{
+  int          group;
+  std::string  key;   ///< StringUtils::AlphaNumericSortKey() of the sort label
+  CFileItemPtr item;
+};
+
+class CSortKeyCompare
+{
+public:
+  CSortKeyCompare(bool descending) : m_descending(descending) {}
+  bool operator()(const SSortKey *left, const SSortKey *right) const
+  {
+    if (left->group != right->group)
+      return left->group < right->group;
+    return m_descending ? right->key < left->key : left->key < right->key;
+  }
+private:
+  bool m_descending;
+};
+
+// The chunks of a list to sort in parallel. Whoever is free takes the next chunk, so the calling
+// thread sorts all of them itself if the job workers are busy. Jobs only starting after the sort
+// is done find no chunk left, which is why they share this with the caller.
+class CSortChunks
+{
+public:
+  CSortChunks(vector<SSortKey*> &order, const vector<unsigned int> &bounds, const CSortKeyCompare &compare)
+    : m_order(order), m_bounds(bounds), m_compare(compare), m_chunks(bounds.size() - 1), m_next(0), m_done(0)
+  {
+  }
+  void SortChunks()
+  {
+    long chunk;
+    while ((chunk = AtomicIncrement(&m_next) - 1) < m_chunks)
+    {
+      std::stable_sort(m_order.begin() + m_bounds[chunk], m_order.begin() + m_bounds[chunk + 1], m_compare);
+      if (AtomicIncrement(&m_done) == m_chunks)
+        m_sorted.Set();
+    }
+  }
+  void WaitSorted()
+  {
+    m_sorted.Wait();
+  }
+private:
+  vector<SSortKey*> &m_order;
+  vector<unsigned int> m_bounds;
+  CSortKeyCompare m_compare;
+  long m_chunks;
+  volatile long m_next;
+  volatile long m_done;
+  CEvent m_sorted;
+};
+
+class CSortJob : public CJob
+{
+public:
+  CSortJob(const boost::shared_ptr<CSortChunks> &chunks) : m_chunks(chunks) {}
+  virtual const char *GetType() const { return "filesort"; }
+  virtual bool DoWork()
+  {
+    m_chunks->SortChunks();
+    return true;
+  }
+private:
+  boost::shared_ptr<CSortChunks> m_chunks;
+};
+
 CFileItem::CFileItem(const CSong& song)
 {
   m_musicInfoTag = NULL;
@@ -1198,6 +1282,117 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
   AppendProperties(item);
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+/////
+///// CFileItemDetailsLoader
+/////
+/////////////////////////////////////////////////////////////////////////////////
+
+// loads the details of light items into copies of them, so the items shown are never written
+// to from the job. The loader hands the copies to the items on the GUI thread.
+class CFileItemDetailsJob : public CJob
+{
+public:
+  CFileItemDetailsJob(const CFileItemDetailsLoaderPtr &loader, const vector<CFileItemPtr> &items)
+    : m_loader(loader), m_items(items)
+  {
+    for (vector<CFileItemPtr>::const_iterator it = items.begin(); it != items.end(); ++it)
+      m_details.push_back(CFileItemPtr(new CFileItem(**it)));
+  }
+  virtual const char *GetType() const { return "filedetails"; }
+  virtual bool DoWork()
+  {
+    vector<CFileItem*> details;
+    for (vector<CFileItemPtr>::const_iterator it = m_details.begin(); it != m_details.end(); ++it)
+      details.push_back(it->get());
+
+    unsigned int time = XbmcThreads::SystemClockMillis();
+    m_loader->LoadDetails(details);
+    CLog::Log(LOGDEBUG, "%s - loaded details of %u items in %u ms", __FUNCTION__, (unsigned int)details.size(), XbmcThreads::SystemClockMillis() - time);
+
+    m_loader->OnLoaded(m_items, m_details);
+    return true;
+  }
+private:
+  CFileItemDetailsLoaderPtr m_loader;
+  vector<CFileItemPtr> m_items;
+  vector<CFileItemPtr> m_details;
+};
+
+CFileItemDetailsLoader::CFileItemDetailsLoader(unsigned int windowSize)
+{
+  m_windowSize = windowSize;
+}
+
+CFileItemDetailsLoader::~CFileItemDetailsLoader()
+{
+}
+
+void CFileItemDetailsLoader::Load(const vector<CFileItemPtr> &items)
+{
+  vector<CFileItemPtr> load;
+  for (vector<CFileItemPtr>::const_iterator it = items.begin(); it != items.end(); ++it)
+  {
+    map<const CFileItem*, SLoadedItem>::iterator loaded = m_loadedMap.find(it->get());
+    if (loaded != m_loadedMap.end())
+    { // shown again, so it's the most recent one
+      m_loaded.splice(m_loaded.end(), m_loaded, loaded->second.position);
+      continue;
+    }
+    load.push_back(*it);
+    SLoadedItem &item = m_loadedMap[it->get()];
+    item.position = m_loaded.insert(m_loaded.end(), *it);
+    item.loaded = false;
+  }
+
+  if (!load.empty())
+    CJobManager::GetInstance().AddJob(new CFileItemDetailsJob(shared_from_this(), load), NULL, CJob::PRIORITY_NORMAL);
+
+  // never drop the items just asked for, whatever the window size
+  unsigned int windowSize = max(m_windowSize, (unsigned int)items.size());
+  while (m_loaded.size() > windowSize)
+  {
+    CFileItemPtr item = m_loaded.front();
+    m_loaded.pop_front();
+    map<const CFileItem*, SLoadedItem>::iterator loaded = m_loadedMap.find(item.get());
+    if (loaded->second.loaded)
+      FreeDetails(item.get());
+    m_loadedMap.erase(loaded);
+  }
+}
+
+bool CFileItemDetailsLoader::ApplyLoaded()
+{
+  vector<pair<CFileItemPtr, CFileItemPtr> > results;
+  {
+    CSingleLock lock(m_lock);
+    if (m_results.empty())
+      return false;
+    results.swap(m_results);
+  }
+
+  bool applied = false;
+  for (vector<pair<CFileItemPtr, CFileItemPtr> >::const_iterator it = results.begin(); it != results.end(); ++it)
+  {
+    // items that went out of the window meanwhile, or were loaded by another job, are skipped
+    map<const CFileItem*, SLoadedItem>::iterator loaded = m_loadedMap.find(it->first.get());
+    if (loaded == m_loadedMap.end() || loaded->second.loaded)
+      continue;
+    ApplyDetails(it->first.get(), *it->second);
+    it->first->SetInvalid();
+    loaded->second.loaded = true;
+    applied = true;
+  }
+  return applied;
+}
+
+void CFileItemDetailsLoader::OnLoaded(const vector<CFileItemPtr> &items, const vector<CFileItemPtr> &details)
+{
+  CSingleLock lock(m_lock);
+  for (unsigned int i = 0; i < items.size() && i < details.size(); i++)
+    m_results.push_back(make_pair(items[i], details[i]));
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 /////
 ///// CFileItemList
@@ -1213,6 +1408,7 @@ CFileItemList::CFileItemList()
   m_sortOrder=SORT_ORDER_NONE;
   m_sortIgnoreFolders = false;
   m_replaceListing = false;
+  m_lazyDetails = false;
 }
 
 CFileItemList::CFileItemList(const CStdString& strPath) : CFileItem(strPath, true)
@@ -1223,6 +1419,7 @@ CFileItemList::CFileItemList(const CStdString& strPath) : CFileItem(strPath, tru
   m_sortOrder=SORT_ORDER_NONE;
   m_sortIgnoreFolders = false;
   m_replaceListing = false;
+  m_lazyDetails = false;
 }
 
 CFileItemList::~CFileItemList()
@@ -1299,6 +1496,8 @@ void CFileItemList::Clear()
   m_sortDetails.clear();
   m_replaceListing = false;
   m_content.Empty();
+  m_lazyDetails = false;
+  m_detailsLoader.reset();
 }
 
 void CFileItemList::ClearItems()
@@ -1403,6 +1602,7 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_content = itemlist.m_content;
   m_mapProperties = itemlist.m_mapProperties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
+  m_detailsLoader = itemlist.m_detailsLoader;
 }
 
 bool CFileItemList::Copy(const CFileItemList& items)
@@ -1419,6 +1619,7 @@ bool CFileItemList::Copy(const CFileItemList& items)
   m_sortMethod     = items.m_sortMethod;
   m_sortOrder      = items.m_sortOrder;
   m_sortIgnoreFolders = items.m_sortIgnoreFolders;
+  m_detailsLoader  = items.m_detailsLoader;
 
   // make a copy of each item
   for (int i = 0; i < items.Size(); i++)
@@ -1518,10 +1719,65 @@ void CFileItemList::Reserve(int iCount)
   m_items.reserve(iCount);
 }
 
-void CFileItemList::Sort(FILEITEMLISTCOMPARISONFUNC func)
+void CFileItemList::SortBySortLabel(bool ignoreFolders, SORT_ORDER sortOrder)
 {
   CSingleLock lock(m_lock);
-  std::stable_sort(m_items.begin(), m_items.end(), func);
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
+  // the groups and keys are worked out once per item, rather than on every comparison
+  vector<SSortKey> keys(m_items.size());
+  vector<SSortKey*> order(m_items.size());
+  for (unsigned int i = 0; i < m_items.size(); i++)
+  {
+    SSortKey &key = keys[i];
+    const CFileItemPtr &item = m_items[i];
+    key.item = item;
+    order[i] = &key;
+    if (!item)
+      key.group = SORT_GROUP_INVALID;
+    else if (item->SortsOnTop())
+      key.group = SORT_GROUP_TOP;
+    else if (item->SortsOnBottom())
+      key.group = SORT_GROUP_BOTTOM;
+    else
+    {
+      key.group = (ignoreFolders || item->m_bIsFolder) ? SORT_GROUP_FOLDERS : SORT_GROUP_FILES;
+      StringUtils::AlphaNumericSortKey(item->GetSortLabel().c_str(), key.key);
+    }
+  }
+
+  CSortKeyCompare compare(sortOrder == SORT_ORDER_DESC);
+  unsigned int chunks = std::min(g_cpuInfo.getCPUCount(), SORT_MAX_CHUNKS);
+  if (order.size() < SORT_PARALLEL_MIN_ITEMS || chunks < 2)
+    std::stable_sort(order.begin(), order.end(), compare);
+  else
+  {
+    // sort a chunk per core, then merge the sorted chunks pairwise
+    vector<unsigned int> bounds;
+    for (unsigned int i = 0; i <= chunks; i++)
+      bounds.push_back(order.size() * i / chunks);
+
+    boost::shared_ptr<CSortChunks> sortChunks(new CSortChunks(order, bounds, compare));
+    for (unsigned int i = 1; i < chunks; i++)
+      CJobManager::GetInstance().AddJob(new CSortJob(sortChunks), NULL, CJob::PRIORITY_HIGH);
+    sortChunks->SortChunks();
+    sortChunks->WaitSorted();
+
+    for (unsigned int width = 1; width < chunks; width *= 2)
+    {
+      for (unsigned int i = 0; i + width < chunks; i += 2 * width)
+        std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + width],
+                           order.begin() + bounds[std::min(i + 2 * width, chunks)], compare);
+    }
+  }
+
+  for (unsigned int i = 0; i < order.size(); i++)
+    m_items[i] = order[i]->item;
+
+  if (m_items.size() >= SORT_PARALLEL_MIN_ITEMS)
+    CLog::Log(LOGDEBUG, "%s - sorted %u items in %u ms", __FUNCTION__,
+              (unsigned int)m_items.size(), XbmcThreads::SystemClockMillis() - start);
 }
 
 void CFileItemList::FillSortFields(FILEITEMFILLFUNC func)
@@ -1654,9 +1910,9 @@ void CFileItemList::Sort(SORT_METHOD sortMethod, SORT_ORDER sortOrder)
       sortMethod == SORT_METHOD_VIDEO_SORT_TITLE_IGNORE_THE ||
       sortMethod == SORT_METHOD_LABEL_IGNORE_FOLDERS ||
       m_sortIgnoreFolders)
-    Sort(sortOrder==SORT_ORDER_ASC ? SSortFileItem::IgnoreFoldersAscending : SSortFileItem::IgnoreFoldersDescending);
+    SortBySortLabel(true, sortOrder);
   else if (sortMethod != SORT_METHOD_NONE && sortMethod != SORT_METHOD_UNSORTED)
-    Sort(sortOrder==SORT_ORDER_ASC ? SSortFileItem::Ascending : SSortFileItem::Descending);
+    SortBySortLabel(false, sortOrder);
 
   m_sortMethod=sortMethod;
   m_sortOrder=sortOrder;
@@ -2337,6 +2593,10 @@ bool CFileItemList::Save(int windowID)
   if (iSize <= 0)
     return false;
 
+  // light items are useless without their loader, which can't be archived
+  if (m_detailsLoader)
+    return false;
+
   CLog::Log(LOGDEBUG,"Saving fileitems [%s]",GetPath().c_str());
 
   CFile file;
@@ -35,7 +35,9 @@
 #include "threads/CriticalSection.h"
 
 #include <vector>
+#include <list>
 #include "boost/shared_ptr.hpp"
+#include "boost/enable_shared_from_this.hpp"
 
 namespace MUSIC_INFO
 {
@@ -377,6 +379,77 @@ typedef std::pair<CStdString, CFileItemPtr > MAPFILEITEMSPAIR;
 typedef bool (*FILEITEMLISTCOMPARISONFUNC) (const CFileItemPtr &pItem1, const CFileItemPtr &pItem2);
 typedef void (*FILEITEMFILLFUNC) (CFileItemPtr &item);
 
+/*!
+  \brief Loads the details of items listed with just what's needed to label, sort and filter them
+
+  Huge library nodes are listed with light items, and the container showing the list asks for
+  the details of the items coming on screen.  They are loaded by a job into copies of the items,
+  and handed to the items on the GUI thread.  Only a window of the most recently shown items
+  keeps its details, the details of the rest are freed again.
+  \sa CFileItemList::SetDetailsLoader, CFileItemList::GetLazyDetails
+  */
+class CFileItemDetailsLoader : public boost::enable_shared_from_this<CFileItemDetailsLoader>
+{
+public:
+  CFileItemDetailsLoader(unsigned int windowSize = 500);
+  virtual ~CFileItemDetailsLoader();
+
+  /*! \brief Have the details of the given items loaded
+   Items that haven't got them yet are loaded in one batch by a job, and the least recently
+   shown items beyond the window size lose theirs.  Call from the GUI thread only.
+   \param items the items to load
+   \sa ApplyLoaded
+   */
+  void Load(const std::vector<CFileItemPtr> &items);
+
+  /*! \brief Hand the details loaded by the jobs to their items
+   Call from the GUI thread only, so the items don't change while they're drawn.
+   \return true if any item got its details, false otherwise
+   */
+  bool ApplyLoaded();
+
+  /*! \brief Load the details of copies of light items right away
+   For copies leaving the list, e.g. to be queued.  They keep their details.
+   \param items the copies to load
+   */
+  void LoadNow(const std::vector<CFileItem*> &items) { LoadDetails(items); };
+
+protected:
+  friend class CFileItemDetailsJob;
+
+  /*! \brief Load the details of a batch of items
+   Runs in a job, on copies of the items.
+   \param items the items to load, none of which have their details
+   */
+  virtual void LoadDetails(const std::vector<CFileItem*> &items)=0;
+
+  /*! \brief Give an item the details loaded into a copy of it
+   */
+  virtual void ApplyDetails(CFileItem *item, const CFileItem &details)=0;
+
+  /*! \brief Free the details of an item, leaving it as it was listed
+   */
+  virtual void FreeDetails(CFileItem *item)=0;
+
+private:
+  void OnLoaded(const std::vector<CFileItemPtr> &items, const std::vector<CFileItemPtr> &details);
+
+  typedef std::list<CFileItemPtr> LOADEDITEMS;
+  struct SLoadedItem
+  {
+    LOADEDITEMS::iterator position;
+    bool loaded;                                         ///< false while its job runs
+  };
+
+  unsigned int m_windowSize;
+  LOADEDITEMS m_loaded;                                  ///< items with details or being loaded, least recently shown first
+  std::map<const CFileItem*, SLoadedItem> m_loadedMap;
+  std::vector<std::pair<CFileItemPtr, CFileItemPtr> > m_results; ///< items and the copies their details were loaded into
+  CCriticalSection m_lock;                               ///< guards m_results, the rest is only used on the GUI thread
+};
+
+typedef boost::shared_ptr<CFileItemDetailsLoader> CFileItemDetailsLoaderPtr;
+
 /*!
   \brief Represents a list of files
   \sa CFileItemList, CFileItem
@@ -499,8 +572,30 @@ public:
   const CStdString &GetContent() const { return m_content; };
 
   void ClearSortState();
+
+  /*! \brief Ask for huge library listings to be made of light items
+   Set by the directory before the list is filled.  Database results with more rows than the
+   lazy load threshold then only fill in what's needed to label, sort and filter the items,
+   and set a details loader on the list.
+   \sa SetDetailsLoader
+   */
+  void SetLazyDetails(bool lazyDetails) { m_lazyDetails = lazyDetails; };
+  bool GetLazyDetails() const { return m_lazyDetails; };
+
+  /*! \brief Set the loader for the details of the light items in this list
+   Lists with a details loader are not cached to disc.
+   \sa CFileItemDetailsLoader
+   */
+  void SetDetailsLoader(const CFileItemDetailsLoaderPtr &loader) { m_detailsLoader = loader; };
+  const CFileItemDetailsLoaderPtr &GetDetailsLoader() const { return m_detailsLoader; };
 private:
-  void Sort(FILEITEMLISTCOMPARISONFUNC func);
+  /*!
+   \brief sort the items on their sort labels
+   Items sorting on top or bottom keep their order, and folders go first unless ignoreFolders is set.
+   Comparisons are done on precomputed keys, and large lists are sorted in parallel.
+   \sa StringUtils::AlphaNumericSortKey
+   */
+  void SortBySortLabel(bool ignoreFolders, SORT_ORDER sortOrder);
   void FillSortFields(FILEITEMFILLFUNC func);
   CStdString GetDisCFileCache(int windowID) const;
 
@@ -525,6 +620,8 @@ private:
   CACHE_TYPE m_cacheToDisc;
   bool m_replaceListing;
   CStdString m_content;
+  bool m_lazyDetails;
+  CFileItemDetailsLoaderPtr m_detailsLoader;
 
   std::vector<SORT_METHOD_DETAILS> m_sortDetails;
 
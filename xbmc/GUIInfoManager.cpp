@@ -72,10 +72,12 @@
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 #include "utils/log.h"
 
 #include "addons/AddonManager.h"
 #include "interfaces/info/InfoBool.h"
+#include "guilib/GUIQuadBatchGL.h"
 
 #define SYSHEATUPDATEINTERVAL 60000
 
@@ -102,6 +104,12 @@ CGUIInfoManager::CGUIInfoManager(void)
   m_frameCounter = 0;
   m_lastFPSTime = 0;
   m_updateTime = 1;
+  for (unsigned int i = 0; i < INFO_DEPENDS_COUNT; i++)
+    m_dependencyStamps[i] = 0;
+  m_boolsEvaluated = 0;
+  m_boolsSkipped = 0;
+  m_lastBoolsEvaluated = 0;
+  m_lastBoolsSkipped = 0;
   ResetLibraryBools();
 }
 
@@ -231,6 +239,8 @@ const infomap system_labels[] =  {{ "hasnetwork",       SYSTEM_ETHERNET_LINK_ACT
                                   { "buildversion",     SYSTEM_BUILD_VERSION },
                                   { "builddate",        SYSTEM_BUILD_DATE },
                                   { "fps",              SYSTEM_FPS },
+                                  { "infobools",        SYSTEM_INFOBOOLS },
+                                  { "drawcalls",        SYSTEM_DRAWCALLS },
                                   { "dvdtraystate",     SYSTEM_DVD_TRAY_STATE },
                                   { "freememory",       SYSTEM_FREE_MEMORY },
                                   { "language",         SYSTEM_LANGUAGE },
@@ -1144,6 +1154,18 @@ CStdString CGUIInfoManager::GetLabel(int info, int contextWindow, CStdString *fa
   case SYSTEM_FPS:
     strLabel.Format("%02.2f", m_fps);
     break;
+  case SYSTEM_INFOBOOLS:
+    strLabel.Format("%u evaluated, %u cached", m_lastBoolsEvaluated, m_lastBoolsSkipped);
+    break;
+  case SYSTEM_DRAWCALLS:
+#if defined(HAS_GL)
+    {
+      unsigned int drawCalls, quads;
+      CGUIQuadBatchGL::GetInstance().GetFrameStats(drawCalls, quads);
+      strLabel.Format("%u draw calls, %u quads", drawCalls, quads);
+    }
+#endif
+    break;
   case PLAYER_VOLUME:
     strLabel.Format("%2.1f dB", (float)(g_settings.m_nVolumeLevel + g_settings.m_dynamicRangeCompressionLevel) * 0.01f);
     break;
@@ -1832,10 +1854,98 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
   if (expression && --expression < m_bools.size())
+  {
+    if (item)
+      m_boolsEvaluated++;
     return m_bools[expression]->Get(m_updateTime, item);
+  }
   return false;
 }
 
+void CGUIInfoManager::Invalidate(unsigned int dependency)
+{
+  for (unsigned int i = 0; i < INFO_DEPENDS_COUNT; i++)
+  {
+    if (dependency & (1 << i))
+      AtomicIncrement(&m_dependencyStamps[i]);
+  }
+}
+
+unsigned int CGUIInfoManager::GetDependencyStamp(unsigned int dependencies) const
+{
+  // the stamps only ever go up, so their sum changes whenever one of them does
+  unsigned int stamp = 0;
+  for (unsigned int i = 0; i < INFO_DEPENDS_COUNT; i++)
+  {
+    if (dependencies & (1 << i))
+      stamp += (unsigned int)m_dependencyStamps[i];
+  }
+  return stamp;
+}
+
+unsigned int CGUIInfoManager::GetConditionDependencies(int condition) const
+{
+  condition = abs(condition);
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE ||
+     (condition >= SYSTEM_PLATFORM_XBOX && condition <= SYSTEM_PLATFORM_DARWIN_ATV2))
+    return 0;
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    switch (abs(info.m_info))
+    {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+      case SKIN_HAS_THEME: // changing theme reloads the skin, which registers everything again
+        return INFO_DEPENDS_SKIN;
+      case WINDOW_IS_ACTIVE:
+      case WINDOW_IS_VISIBLE:
+      case WINDOW_IS_TOPMOST:
+      case WINDOW_NEXT:
+      case WINDOW_PREVIOUS:
+        if (info.GetData1())
+          return INFO_DEPENDS_WINDOWS;
+        return INFO_DEPENDS_WINDOWS | INFO_DEPENDS_PROPERTIES; // matched on the xmlfile property
+      case STRING_IS_EMPTY:
+        return GetLabelDependencies(info.GetData1());
+      case STRING_COMPARE:
+        if (info.GetData2() < 0)
+          return GetLabelDependencies(info.GetData1()) | GetLabelDependencies(-info.GetData2());
+        return GetLabelDependencies(info.GetData1());
+    }
+  }
+  return INFO_DEPENDS_ALWAYS;
+}
+
+unsigned int CGUIInfoManager::GetLabelDependencies(int info) const
+{
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    const GUIInfo &label = m_multiInfo[info - MULTI_INFO_START];
+    if (label.m_info == SKIN_STRING)
+      return INFO_DEPENDS_SKIN;
+    if (label.m_info == WINDOW_PROPERTY && label.GetData1())
+      return INFO_DEPENDS_PROPERTIES;
+  }
+  return INFO_DEPENDS_ALWAYS;
+}
+
+unsigned int CGUIInfoManager::GetBoolDependencies(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetDependencies();
+  return INFO_DEPENDS_ALWAYS;
+}
+
+void CGUIInfoManager::CountBoolEvaluation(bool evaluated)
+{
+  if (evaluated)
+    m_boolsEvaluated++;
+  else
+    m_boolsSkipped++;
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -3745,6 +3855,10 @@ void CGUIInfoManager::Clear()
 void CGUIInfoManager::UpdateFPS()
 {
   m_frameCounter++;
+  m_lastBoolsEvaluated = m_boolsEvaluated;
+  m_lastBoolsSkipped = m_boolsSkipped;
+  m_boolsEvaluated = 0;
+  m_boolsSkipped = 0;
   unsigned int curTime = CTimeUtils::GetFrameTime();
 
   float fTimeSpan = (float)(curTime - m_lastFPSTime);
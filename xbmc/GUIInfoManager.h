@@ -372,6 +372,8 @@ namespace INFO
 #define SYSTEM_IDLE_TIME            715
 #define SYSTEM_FRIENDLY_NAME        716
 #define SYSTEM_SCREENSAVER_ACTIVE   717
+#define SYSTEM_INFOBOOLS            718
+#define SYSTEM_DRAWCALLS            719
 
 #define LIBRARY_HAS_MUSIC           720
 #define LIBRARY_HAS_VIDEO           721
@@ -522,6 +524,14 @@ namespace INFO
 #define MULTI_INFO_END                99999
 #define COMBINED_VALUES_START        100000
 
+// state a boolean condition reads, see CGUIInfoManager::Invalidate()
+// conditions without any are constant, those with INFO_DEPENDS_ALWAYS are polled every frame
+#define INFO_DEPENDS_ALWAYS           0x01  // state we aren't told about when it changes
+#define INFO_DEPENDS_SKIN             0x02  // skin settings (Skin.HasSetting, Skin.String, Skin.HasTheme)
+#define INFO_DEPENDS_PROPERTIES       0x04  // properties of a given window (Window(id).Property)
+#define INFO_DEPENDS_WINDOWS          0x08  // open, closing and topmost windows (Window.IsActive etc.)
+#define INFO_DEPENDS_COUNT            4
+
 // forward
 class CInfoLabel;
 class CGUIWindow;
@@ -600,6 +610,34 @@ public:
    */
   bool EvaluateBool(const CStdString &expression, int context = 0);
 
+  /*! \brief Notify conditions reading the given state that it has changed
+   Registered conditions that only read state from INFO_DEPENDS_* sources aren't evaluated
+   again until one of those sources is invalidated. Call this after the state is changed.
+   \param dependency the INFO_DEPENDS_* source that changed
+   */
+  void Invalidate(unsigned int dependency);
+
+  /*! \brief Get a stamp that changes whenever one of the given sources is invalidated
+   \param dependencies INFO_DEPENDS_* sources to check
+   \sa Invalidate
+   */
+  unsigned int GetDependencyStamp(unsigned int dependencies) const;
+
+  /*! \brief Get the INFO_DEPENDS_* sources a condition reads
+   \param condition a condition as returned from TranslateSingleString
+   */
+  unsigned int GetConditionDependencies(int condition) const;
+
+  /*! \brief Get the INFO_DEPENDS_* sources a registered expression reads
+   \param expression an identifier returned from Register
+   */
+  unsigned int GetBoolDependencies(unsigned int expression) const;
+
+  /*! \brief Count an evaluation of a registered expression for the System.InfoBools label
+   \param evaluated true if the expression was evaluated, false if its cached value was used
+   */
+  void CountBoolEvaluation(bool evaluated);
+
   int TranslateString(const CStdString &strCondition);
 
   /*! \brief Get integer value of info.
@@ -668,8 +706,8 @@ public:
   void UpdateFPS();
   inline float GetFPS() const { return m_fps; };
 
-  void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
-  void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
+  void SetNextWindow(int windowID) { m_nextWindowID = windowID; Invalidate(INFO_DEPENDS_WINDOWS); };
+  void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; Invalidate(INFO_DEPENDS_WINDOWS); };
 
   void ResetCache();
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
@@ -726,6 +764,7 @@ protected:
   bool GetMultiInfoBool(const GUIInfo &info, int contextWindow = 0, const CGUIListItem *item = NULL);
   bool GetMultiInfoInt(int &value, const GUIInfo &info, int contextWindow = 0) const;
   CStdString GetMultiInfoLabel(const GUIInfo &info, int contextWindow = 0, CStdString *fallback = NULL);
+  unsigned int GetLabelDependencies(int info) const;
   int TranslateListItem(const Property &info);
   int TranslateMusicPlayerString(const CStdString &info) const;
   TIME_FORMAT TranslateTimeFormat(const CStdString &format);
@@ -793,6 +832,13 @@ protected:
   std::vector<INFO::InfoBool*> m_bools;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
+  volatile long m_dependencyStamps[INFO_DEPENDS_COUNT]; ///< bumped by Invalidate(), one per INFO_DEPENDS_* source
+
+  // per frame counters of expression evaluations
+  unsigned int m_boolsEvaluated;
+  unsigned int m_boolsSkipped;
+  unsigned int m_lastBoolsEvaluated;
+  unsigned int m_lastBoolsSkipped;
 
   int m_libraryHasMusic;
   int m_libraryHasMovies;
@@ -36,9 +36,11 @@
 using namespace std;
 
 
-CImageLoader::CImageLoader(const CStdString &path)
+CImageLoader::CImageLoader(const CStdString &path, unsigned int width, unsigned int height)
 {
   m_path = path;
+  m_width = width;
+  m_height = height;
   m_texture = NULL;
 }
 
@@ -71,10 +73,12 @@ bool CImageLoader::DoWork()
   }
   else
   {
-    // direct route - load the image
+    // direct route - load the image, scaled down at decode time to the size it's displayed at
+    unsigned int width = m_width ? m_width : g_graphicsContext.GetWidth();
+    unsigned int height = m_height ? m_height : g_graphicsContext.GetHeight();
     m_texture = new CTexture();
     unsigned int start = XbmcThreads::SystemClockMillis();
-    if (!m_texture->LoadFromFile(loadPath, g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight(), g_guiSettings.GetBool("pictures.useexifrotation")))
+    if (!m_texture->LoadFromFile(loadPath, width, height, g_guiSettings.GetBool("pictures.useexifrotation")))
     {
       delete m_texture;
       m_texture = NULL;
@@ -89,9 +93,11 @@ bool CImageLoader::DoWork()
   return true;
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path, unsigned int width, unsigned int height)
 {
   m_path = path;
+  m_width = width;
+  m_height = height;
   m_refCount = 1;
   m_timeToDelete = 0;
 }
@@ -132,6 +138,17 @@ bool CGUILargeTextureManager::CLargeTexture::DeleteIfRequired(bool deleteImmedia
   return false;
 }
 
+void CGUILargeTextureManager::CLargeTexture::DelayDelete(unsigned int delay)
+{
+  if (m_refCount == 0)
+    m_timeToDelete = CTimeUtils::GetFrameTime() + delay;
+}
+
+bool CGUILargeTextureManager::CLargeTexture::Matches(const CStdString &path, unsigned int width, unsigned int height) const
+{
+  return m_width == width && m_height == height && m_path == path;
+}
+
 void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
 {
   assert(!m_texture.size());
@@ -162,16 +179,32 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
   }
 }
 
+// round the size an image is displayed at up to the size we load it at.  Rounding lets
+// controls of similar size share a texture, and anything screen sized loads at screen size.
+void CGUILargeTextureManager::GetLoadSize(unsigned int &width, unsigned int &height)
+{
+  static const unsigned int granularity = 128;
+  if (width == 0 || height == 0 ||
+      width >= (unsigned int)g_graphicsContext.GetWidth() || height >= (unsigned int)g_graphicsContext.GetHeight())
+  {
+    width = height = 0;
+    return;
+  }
+  width = (width + granularity - 1) / granularity * granularity;
+  height = (height + granularity - 1) / granularity * granularity;
+}
+
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
-bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest)
+bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, unsigned int width, unsigned int height)
 {
   // note: max size to load images: 2048x1024? (8MB)
+  GetLoadSize(width, height);
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, width, height))
     {
       if (firstRequest)
         image->AddRef();
@@ -181,18 +214,19 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
   }
 
   if (firstRequest)
-    QueueImage(path);
+    QueueImage(path, width, height);
 
   return true;
 }
 
-void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately)
+void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately, unsigned int width, unsigned int height)
 {
+  GetLoadSize(width, height);
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, width, height))
     {
       if (image->DecrRef(immediately) && immediately)
         m_allocated.erase(it);
@@ -203,7 +237,7 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
   {
     unsigned int id = it->first;
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
+    if (image->Matches(path, width, height) && image->DecrRef(true))
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
@@ -213,23 +247,45 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
   }
 }
 
+void CGUILargeTextureManager::PrefetchImage(const CStdString &path, unsigned int width, unsigned int height)
+{
+  if (path.IsEmpty())
+    return;
+
+  GetLoadSize(width, height);
+  CSingleLock lock(m_listSection);
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->Matches(path, width, height))
+    { // already loaded - keep it around a while longer if nothing is using it
+      image->DelayDelete(CLargeTexture::TIME_TO_DELETE_PREFETCH);
+      return;
+    }
+  }
+  QueueImage(path, width, height, true);
+}
+
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const CStdString &path)
+void CGUILargeTextureManager::QueueImage(const CStdString &path, unsigned int width, unsigned int height, bool prefetch)
 {
   CSingleLock lock(m_listSection);
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path)
+    if (image->Matches(path, width, height))
     {
-      image->AddRef();
+      if (!prefetch)
+        image->AddRef();
       return; // already queued
     }
   }
 
-  // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, CJob::PRIORITY_NORMAL);
+  // queue the item.  Prefetched images hold no reference, and load behind the ones on screen
+  CLargeTexture *image = new CLargeTexture(path, width, height);
+  if (prefetch)
+    image->DecrRef(false);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, width, height), this, prefetch ? CJob::PRIORITY_LOW : CJob::PRIORITY_NORMAL);
   m_queued.push_back(make_pair(jobID, image));
 }
 
@@ -244,6 +300,7 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CImageLoader *loader = (CImageLoader *)job;
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
+      image->DelayDelete(CLargeTexture::TIME_TO_DELETE_PREFETCH); // prefetched and not yet requested
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
       m_allocated.push_back(image);
@@ -36,7 +36,7 @@
 class CImageLoader : public CJob
 {
 public:
-  CImageLoader(const CStdString &path);
+  CImageLoader(const CStdString &path, unsigned int width = 0, unsigned int height = 0);
   virtual ~CImageLoader();
 
   /*!
@@ -45,6 +45,8 @@ public:
   virtual bool DoWork();
 
   CStdString    m_path; ///< path of image to load
+  unsigned int  m_width; ///< width the image is decoded to fit, 0 for the screen width
+  unsigned int  m_height; ///< height the image is decoded to fit, 0 for the screen height
   CBaseTexture *m_texture; ///< Texture object to load the image into \sa CBaseTexture.
 };
 
@@ -79,14 +81,20 @@ public:
    object filled if the texture has been previously loaded, else will return with an empty texture
    object if it is being loaded.
 
+   Images are decoded to fit within width x height.  The size is rounded up so that controls of
+   similar size share the same texture, and a size of 0 (or one larger than the screen) loads the
+   image at screen resolution.  The same size must be passed to ReleaseImage().
+
    \param path path of the image to load.
    \param texture texture object to hold the resulting texture
    \param orientation orientation of resulting texture
    \param firstRequest true if this is the first time we are requesting this texture
+   \param width width in pixels the image will be displayed at, 0 for the screen width.
+   \param height height in pixels the image will be displayed at, 0 for the screen height.
    \return true if the image exists, else false.
    \sa CGUITextureArray and CGUITexture
    */
-  bool GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest);
+  bool GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, unsigned int width = 0, unsigned int height = 0);
 
   /*!
    \brief Request a texture to be unloaded.
@@ -98,8 +106,24 @@ public:
    \param path path of the image to release.
    \param immediately if set true the image is immediately unloaded once its reference count reaches zero
                       rather than being unloaded after a delay.
+   \param width width the image was requested at in GetImage().
+   \param height height the image was requested at in GetImage().
    */
-  void ReleaseImage(const CStdString &path, bool immediately = false);
+  void ReleaseImage(const CStdString &path, bool immediately = false, unsigned int width = 0, unsigned int height = 0);
+
+  /*!
+   \brief Load an image ahead of it being requested.
+
+   The image is queued at low priority without taking a reference, so that a following GetImage()
+   with the same path and size finds it loading or loaded.  Prefetched images that are not picked up
+   are unloaded by CleanupUnusedImages() after a delay.  Used by containers to warm the next page.
+
+   \param path path of the image to load.
+   \param width width in pixels the image will be displayed at, 0 for the screen width.
+   \param height height in pixels the image will be displayed at, 0 for the screen height.
+   \sa GetImage
+   */
+  void PrefetchImage(const CStdString &path, unsigned int width = 0, unsigned int height = 0);
 
   /*!
    \brief Cleanup images that are no longer in use.
@@ -116,27 +140,33 @@ private:
   class CLargeTexture
   {
   public:
-    CLargeTexture(const CStdString &path);
+    CLargeTexture(const CStdString &path, unsigned int width, unsigned int height);
     virtual ~CLargeTexture();
 
     void AddRef();
     bool DecrRef(bool deleteImmediately);
     bool DeleteIfRequired(bool deleteImmediately = false);
+    void DelayDelete(unsigned int delay);
     void SetTexture(CBaseTexture* texture);
 
+    bool Matches(const CStdString &path, unsigned int width, unsigned int height) const;
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
 
-  private:
     static const unsigned int TIME_TO_DELETE = 2000;
+    static const unsigned int TIME_TO_DELETE_PREFETCH = 10000;
 
+  private:
     unsigned int m_refCount;
     CStdString m_path;
+    unsigned int m_width;
+    unsigned int m_height;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const CStdString &path);
+  void QueueImage(const CStdString &path, unsigned int width, unsigned int height, bool prefetch = false);
+  static void GetLoadSize(unsigned int &width, unsigned int &height);
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
@@ -76,6 +76,11 @@
 //  Player has requested the next item for caching purposes (PAPlayer)
 #define GUI_MSG_QUEUE_NEXT_ITEM         GUI_MSG_USER + 16
 
+//  Player has dropped items it had queued (PAPlayer)
+//  Parameter:
+//  dwParam1 = number of items dropped, from the first queued one
+#define GUI_MSG_QUEUE_CLEARED           GUI_MSG_USER + 17
+
 // Visualisation messages when loading/unloading
 #define GUI_MSG_VISUALISATION_UNLOADING GUI_MSG_USER + 117 // sent by vis
 #define GUI_MSG_VISUALISATION_LOADED    GUI_MSG_USER + 118 // sent by vis
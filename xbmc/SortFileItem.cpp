@@ -25,11 +25,8 @@
 #include "music/tags/MusicInfoTag.h"
 #include "FileItem.h"
 #include "URL.h"
-#include "utils/log.h"
 #include "video/VideoInfoTag.h"
 
-#define RETURN_IF_NULL(x,y) if ((x) == NULL) { CLog::Log(LOGWARNING, "%s, sort item is null", __FUNCTION__); return y; }
-
 CStdString SSortFileItem::RemoveArticles(const CStdString &label)
 {
   for (unsigned int i=0;i<g_advancedSettings.m_vecTokens.size();++i)
@@ -41,70 +38,6 @@ CStdString SSortFileItem::RemoveArticles(const CStdString &label)
   return label;
 }
 
-bool SSortFileItem::Ascending(const CFileItemPtr &left, const CFileItemPtr &right)
-{
-  // sanity
-  RETURN_IF_NULL(left,false); RETURN_IF_NULL(right,false);
-
-  // ignore items that should sort on top or bottom
-  if (left->SortsOnTop() != right->SortsOnTop())
-    return left->SortsOnTop();
-  if (left->SortsOnBottom() != right->SortsOnBottom())
-    return !left->SortsOnBottom();
-  if (left->SortsOnTop() || left->SortsOnBottom())
-    return false; // both have either sort on top or sort on bottom -> leave as-is
-  if (left->m_bIsFolder == right->m_bIsFolder)
-    return StringUtils::AlphaNumericCompare(left->GetSortLabel().c_str(),right->GetSortLabel().c_str()) < 0;
-  return left->m_bIsFolder;
-}
-
-bool SSortFileItem::Descending(const CFileItemPtr &left, const CFileItemPtr &right)
-{
-  // sanity
-  RETURN_IF_NULL(left,false); RETURN_IF_NULL(right,false);
-
-  // ignore items that should sort on top or bottom
-  if (left->SortsOnTop() != right->SortsOnTop())
-    return left->SortsOnTop();
-  if (left->SortsOnBottom() != right->SortsOnBottom())
-    return !left->SortsOnBottom();
-  if (left->SortsOnTop() || left->SortsOnBottom())
-    return false; // both have either sort on top or sort on bottom -> leave as-is
-  if (left->m_bIsFolder == right->m_bIsFolder)
-    return StringUtils::AlphaNumericCompare(left->GetSortLabel().c_str(),right->GetSortLabel().c_str()) > 0;
-  return left->m_bIsFolder;
-}
-
-bool SSortFileItem::IgnoreFoldersAscending(const CFileItemPtr &left, const CFileItemPtr &right)
-{
-  // sanity
-  RETURN_IF_NULL(left,false); RETURN_IF_NULL(right,false);
-
-  // ignore items that should sort on top or bottom
-  if (left->SortsOnTop() != right->SortsOnTop())
-    return left->SortsOnTop();
-  if (left->SortsOnBottom() != right->SortsOnBottom())
-    return !left->SortsOnBottom();
-  if (left->SortsOnTop() || left->SortsOnBottom())
-    return false; // both have either sort on top or sort on bottom -> leave as-is
-  return StringUtils::AlphaNumericCompare(left->GetSortLabel().c_str(),right->GetSortLabel().c_str()) < 0;
-}
-
-bool SSortFileItem::IgnoreFoldersDescending(const CFileItemPtr &left, const CFileItemPtr &right)
-{
-  // sanity
-  RETURN_IF_NULL(left,false); RETURN_IF_NULL(right,false);
-
-  // ignore items that should sort on top or bottom
-  if (left->SortsOnTop() != right->SortsOnTop())
-    return left->SortsOnTop();
-  if (left->SortsOnBottom() != right->SortsOnBottom())
-    return !left->SortsOnBottom();
-  if (left->SortsOnTop() || left->SortsOnBottom())
-    return false; // both have either sort on top or sort on bottom -> leave as-is
-  return StringUtils::AlphaNumericCompare(left->GetSortLabel().c_str(),right->GetSortLabel().c_str()) > 0;
-}
-
 void SSortFileItem::ByLabel(CFileItemPtr &item)
 {
   if (!item) return;
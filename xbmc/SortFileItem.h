@@ -33,12 +33,6 @@ struct SSortFileItem
    */
   static CStdString RemoveArticles(const CStdString &label);
 
-  // Sort by sort field
-  static bool Ascending(const CFileItemPtr &left, const CFileItemPtr &right);
-  static bool Descending(const CFileItemPtr &left, const CFileItemPtr &right);
-  static bool IgnoreFoldersAscending(const CFileItemPtr &left, const CFileItemPtr &right);
-  static bool IgnoreFoldersDescending(const CFileItemPtr &left, const CFileItemPtr &right);
-
   // Fill in sort field
   static void ByLabel(CFileItemPtr &item);
   static void ByLabelNoThe(CFileItemPtr &item);
@@ -21,6 +21,7 @@
 #include "ScreenSaver.h"
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
+#include "guilib/GUIQuadBatchGL.h"
 
 namespace ADDON
 {
@@ -67,6 +68,9 @@ void CScreenSaver::Start()
 void CScreenSaver::Render()
 {
   // ask screensaver to render itself
+#if defined(HAS_GL)
+  CGUIQuadBatchGL::GetInstance().Flush();
+#endif
   if (Initialized()) m_pStruct->Render();
 }
 
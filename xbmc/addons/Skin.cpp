@@ -180,9 +180,14 @@ void CSkinInfo::LoadIncludes()
   m_includes.LoadIncludes(includesPath);
 }
 
-void CSkinInfo::ResolveIncludes(TiXmlElement *node)
+void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions /* = NULL */)
 {
-  m_includes.ResolveIncludes(node);
+  m_includes.ResolveIncludes(node, conditions);
+}
+
+void CSkinInfo::LoadIncludeFile(const CStdString &includeFile)
+{
+  m_includes.LoadIncludes(includeFile);
 }
 
 int CSkinInfo::GetStartWindow() const
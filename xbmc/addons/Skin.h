@@ -93,7 +93,17 @@ public:
    */
   static bool TranslateResolution(const CStdString &name, RESOLUTION_INFO &res);
 
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions = NULL);
+
+  /*! \brief Get the include files the skin has loaded so far
+   \sa LoadIncludeFile
+   */
+  const std::vector<CStdString> &GetIncludeFiles() const { return m_includes.GetFiles(); };
+
+  /*! \brief Load an additional include file, if it isn't loaded already
+   \param includeFile full path of the include file
+   */
+  void LoadIncludeFile(const CStdString &includeFile);
 
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
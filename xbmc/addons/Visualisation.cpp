@@ -27,6 +27,7 @@
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "windowing/WindowingFactory.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #ifdef _LINUX
@@ -179,6 +180,9 @@ void CVisualisation::Render()
 {
   // ask visz. to render itself
   g_graphicsContext.BeginPaint();
+#if defined(HAS_GL)
+  CGUIQuadBatchGL::GetInstance().Flush();
+#endif
   if (Initialized())
   {
     try
@@ -68,6 +68,34 @@ public:
 
   virtual unsigned int GetProcessorSize() { return 0; }
 
+  /*! \brief Number of buffers frames can be queued in, addressed by index
+   Returns 0 if the renderer picks its buffers itself, only a single frame is queued then.
+   Valid after Configure.
+   */
+  virtual int GetMaxBufferSize() { return 0; }
+  virtual void SetBufferSize(int numBuffers) { }
+
+  /*! \brief Hand out a buffer a decoder can write a YV12 frame into, saving the copy into the render buffers
+   \param image in: width, height, strides and plane sizes the decoder needs, out: the planes
+   \param id [out] identifies the buffer for ReleaseDirectBuffer
+   \return false if there is no such buffer, the frame is decoded into system memory then
+   */
+  virtual bool GetDirectBuffer(YV12Image &image, unsigned int &id) { return false; }
+
+  /*! \brief The decoder is done with a buffer from GetDirectBuffer
+   */
+  virtual void ReleaseDirectBuffer(unsigned int id) { }
+
+  /*! \brief Free the direct buffers released after the render buffers were deleted,
+   called on the render thread every frame
+   */
+  virtual void FreeReleasedDirectBuffers() { }
+
+  /*! \brief Take over the direct buffer holding plane as the frame in render buffer source
+   \return false if plane isn't in a direct buffer, the frame has to be copied then
+   */
+  virtual bool AdoptDirectBuffer(int source, const BYTE *plane) { return false; }
+
 protected:
   void       ChooseBestResolution(float fps);
   bool       FindResolutionFromOverride(float fps, float& weight, bool fallback);
@@ -27,6 +27,7 @@
 
 #ifdef HAS_GL
 #include <locale.h>
+#include <algorithm>
 #include "LinuxRendererGL.h"
 #include "Application.h"
 #include "settings/Settings.h"
@@ -159,6 +160,11 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_context = NULL;
   m_rgbPbo = 0;
 
+  memset(&m_directRequest, 0, sizeof(m_directRequest));
+  m_directId = 0;
+  m_directRendering = false;
+  m_directReleased = false;
+
   m_dllSwScale = new DllSwScale;
 }
 
@@ -224,7 +230,6 @@ bool CLinuxRendererGL::ValidateRenderer()
 
 void CLinuxRendererGL::ManageTextures()
 {
-  m_NumYV12Buffers = 2;
   //m_iYV12RenderBuffer = 0;
   return;
 }
@@ -241,9 +246,21 @@ bool CLinuxRendererGL::ValidateRenderTarget()
     else
       CLog::Log(LOGNOTICE,"Using GL_TEXTURE_2D");
 
+    // Configure() may have lowered the buffer count, the buffers past it are no longer
+    // recreated. Free them while m_textureDelete still matches the format they were made for.
+    for (int i = m_NumYV12Buffers; i < NUM_BUFFERS; i++)
+      (this->*m_textureDelete)(i);
+
      // create the yuv textures
     LoadShaders();
 
+    DeleteDirectBuffers();
+    {
+      CSingleLock lock(m_directSection);
+      m_directRendering = g_advancedSettings.m_videoDirectRendering
+                       && m_textureCreate == &CLinuxRendererGL::CreateYV12Texture;
+    }
+
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
       (this->*m_textureCreate)(i);
 
@@ -279,6 +296,8 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
   for (int i = 0 ; i<m_NumYV12Buffers ; i++)
     m_buffers[i].image.flags = 0;
 
+  m_NumYV12Buffers = 2;
+  m_iYV12RenderBuffer = 0;
   m_iLastRenderBuffer = -1;
 
   m_nonLinStretch    = false;
@@ -290,6 +309,253 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
   return true;
 }
 
+int CLinuxRendererGL::GetMaxBufferSize()
+{
+  // vdpau and vaapi present surfaces owned by the decoder, those can't be held back
+  if (CONF_FLAGS_FORMAT_MASK(m_iFlags) == CONF_FLAGS_FORMAT_VDPAU
+  ||  CONF_FLAGS_FORMAT_MASK(m_iFlags) == CONF_FLAGS_FORMAT_VAAPI)
+    return 0;
+  return NUM_BUFFERS;
+}
+
+void CLinuxRendererGL::SetBufferSize(int numBuffers)
+{
+  // textures are (re)created for the new count on the first frame after Configure
+  if (numBuffers < 2)
+    numBuffers = 2;
+  if (numBuffers > NUM_BUFFERS)
+    numBuffers = NUM_BUFFERS;
+  m_NumYV12Buffers = numBuffers;
+}
+
+static bool IsSameGeometry(const YV12Image &a, const YV12Image &b)
+{
+  if (a.width != b.width || a.height != b.height)
+    return false;
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    if (a.stride[p] != b.stride[p] || a.planesize[p] != b.planesize[p])
+      return false;
+  }
+  return true;
+}
+
+bool CLinuxRendererGL::GetDirectBuffer(YV12Image &image, unsigned int &id)
+{
+  CSingleLock lock(m_directSection);
+  if (!m_directRendering)
+    return false;
+
+  m_directRequest = image;
+  memset(m_directRequest.plane, 0, sizeof(m_directRequest.plane));
+  m_directRequest.flags = 0;
+
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end(); ++it)
+  {
+    if (it->id || it->orphaned || !IsSameGeometry(it->image, image))
+      continue;
+
+    if (++m_directId == 0)
+      m_directId = 1;
+    it->id = m_directId;
+    id     = m_directId;
+    memcpy(image.plane, it->image.plane, sizeof(image.plane));
+    return true;
+  }
+  return false;
+}
+
+void CLinuxRendererGL::ReleaseDirectBuffer(unsigned int id)
+{
+  CSingleLock lock(m_directSection);
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end(); ++it)
+  {
+    if (it->id == id)
+    {
+      it->id = 0;
+      if (it->orphaned)
+      {
+        // the decoder runs without a gl context, pbos are deleted on the render thread
+        if (it->pbo[0])
+          m_directReleased = true;
+        else
+        {
+          FreeDirectBuffer(*it);
+          m_direct.erase(it);
+        }
+      }
+      return;
+    }
+  }
+}
+
+void CLinuxRendererGL::FreeReleasedDirectBuffers()
+{
+  // no buffers to free, return here so we don't do an unnecessary lock
+  if (!m_directReleased)
+    return;
+
+  CSingleLock lock(m_directSection);
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end();)
+  {
+    if (!it->id && it->orphaned)
+    {
+      FreeDirectBuffer(*it);
+      it = m_direct.erase(it);
+    }
+    else
+      ++it;
+  }
+  m_directReleased = false;
+}
+
+bool CLinuxRendererGL::AdoptDirectBuffer(int source, const BYTE *plane)
+{
+  CSingleLock lock(m_directSection);
+  YUVBUFFER &buf = m_buffers[source];
+
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end(); ++it)
+  {
+    if (!it->id || it->orphaned || it->image.plane[0] != plane)
+      continue;
+
+    if (it->image.width != buf.image.width || it->image.height != buf.image.height)
+      return false;
+    for (int p = 0; p < MAX_PLANES; p++)
+    {
+      if ((it->pbo[p] != 0) != (buf.pbo[p] != 0)
+      || (buf.pbo[p] && buf.image.plane[p] == (BYTE*)PBO_OFFSET))
+        return false;
+    }
+
+    /* swap the memory of the render buffer with the direct buffer, which the decoder
+     * still holds and releases later on. it's handed out again from then on */
+    for (int p = 0; p < MAX_PLANES; p++)
+    {
+      std::swap(buf.image.plane[p]    , it->image.plane[p]);
+      std::swap(buf.image.stride[p]   , it->image.stride[p]);
+      std::swap(buf.image.planesize[p], it->image.planesize[p]);
+      std::swap(buf.pbo[p]            , it->pbo[p]);
+    }
+    for (int f = 0; f < MAX_FIELDS; f++)
+    {
+      for (int p = 0; p < MAX_PLANES; p++)
+        buf.fields[f][p].pbo = buf.pbo[p];
+    }
+    return true;
+  }
+  return false;
+}
+
+bool CLinuxRendererGL::CreateDirectBuffer(YUVDIRECT& direct)
+{
+  memset(&direct, 0, sizeof(direct));
+  direct.image = m_directRequest;
+
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    if (!m_pboUsed)
+    {
+      direct.image.plane[p] = new BYTE[direct.image.planesize[p]];
+      continue;
+    }
+
+    glGenBuffersARB(1, &direct.pbo[p]);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, direct.pbo[p]);
+    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, direct.image.planesize[p] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
+    void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_READ_WRITE_ARB);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    if (!pboPtr)
+    {
+      glDeleteBuffersARB(1, &direct.pbo[p]);
+      direct.pbo[p] = 0;
+      FreeDirectBuffer(direct);
+      return false;
+    }
+    direct.image.plane[p] = (BYTE*)pboPtr + PBO_OFFSET;
+  }
+  return true;
+}
+
+void CLinuxRendererGL::FreeDirectBuffer(YUVDIRECT& direct)
+{
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    if (direct.pbo[p])
+    {
+      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, direct.pbo[p]);
+      glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+      glDeleteBuffersARB(1, &direct.pbo[p]);
+      direct.pbo[p] = 0;
+    }
+    else
+      delete[] direct.image.plane[p];
+    direct.image.plane[p] = NULL;
+  }
+}
+
+void CLinuxRendererGL::ManageDirectBuffers()
+{
+  CSingleLock lock(m_directSection);
+
+  // free what the decoder released and is of no use anymore
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end();)
+  {
+    if (!it->id && (it->orphaned || !IsSameGeometry(it->image, m_directRequest)))
+    {
+      FreeDirectBuffer(*it);
+      it = m_direct.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  if (!m_directRendering || !m_directRequest.stride[0])
+    return;
+
+  unsigned int count = 0;
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end(); ++it)
+  {
+    if (!it->orphaned)
+      count++;
+  }
+
+  while (count < NUM_DIRECT_BUFFERS)
+  {
+    YUVDIRECT direct;
+    if (!CreateDirectBuffer(direct))
+    {
+      CLog::Log(LOGWARNING, "GL: failed to set up direct rendering buffers, copying frames");
+      m_directRendering = false;
+      break;
+    }
+    m_direct.push_back(direct);
+    count++;
+  }
+}
+
+void CLinuxRendererGL::DeleteDirectBuffers()
+{
+  CSingleLock lock(m_directSection);
+
+  for (std::vector<YUVDIRECT>::iterator it = m_direct.begin(); it != m_direct.end();)
+  {
+    if (it->id)
+    {
+      it->orphaned = true;
+      ++it;
+    }
+    else
+    {
+      FreeDirectBuffer(*it);
+      it = m_direct.erase(it);
+    }
+  }
+  memset(&m_directRequest, 0, sizeof(m_directRequest));
+  m_directRendering = false;
+}
+
 int CLinuxRendererGL::NextYV12Texture()
 {
   return (m_iYV12RenderBuffer + 1) % m_NumYV12Buffers;
@@ -566,6 +832,7 @@ void CLinuxRendererGL::Flush()
 
   for (int i = 0 ; i < m_NumYV12Buffers ; i++)
     (this->*m_textureDelete)(i);
+  DeleteDirectBuffers();
 
   glFinish();
   m_bValidated = false;
@@ -717,6 +984,7 @@ void CLinuxRendererGL::FlipPage(int source)
     m_iYV12RenderBuffer = NextYV12Texture();
 
   BindPbo(m_buffers[m_iYV12RenderBuffer]);
+  ManageDirectBuffers();
 
   m_buffers[m_iYV12RenderBuffer].flipindex = ++m_flipindex;
 
@@ -1076,6 +1344,7 @@ void CLinuxRendererGL::UnInit()
   // YV12 textures
   for (int i = 0; i < NUM_BUFFERS; ++i)
     (this->*m_textureDelete)(i);
+  DeleteDirectBuffers();
 
   // cleanup framebuffer object if it was in use
   m_fbo.Cleanup();
@@ -1757,7 +2026,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
     {
       glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
       glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_directRendering ? GL_READ_WRITE_ARB : GL_WRITE_ONLY_ARB);
       if (pboPtr)
       {
         im.plane[i] = (BYTE*) pboPtr + PBO_OFFSET;
@@ -3131,7 +3400,7 @@ void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
     glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.image.planesize[plane] + PBO_OFFSET, NULL, GL_STREAM_DRAW_ARB);
-    buff.image.plane[plane] = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
+    buff.image.plane[plane] = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_directRendering ? GL_READ_WRITE_ARB : GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
   if(pbo)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
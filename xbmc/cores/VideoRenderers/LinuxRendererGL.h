@@ -32,6 +32,8 @@
 #include "BaseRenderer.h"
 
 #include "threads/Event.h"
+#include "threads/CriticalSection.h"
+#include <vector>
 
 class CRenderCapture;
 
@@ -41,7 +43,8 @@ namespace Shaders { class BaseYUV2RGBShader; }
 namespace Shaders { class BaseVideoFilterShader; }
 namespace VAAPI   { struct CHolder; }
 
-#define NUM_BUFFERS 3
+#define NUM_BUFFERS 10
+#define NUM_DIRECT_BUFFERS 6 // non reference frames a decoder holds until output, and the one being decoded
 
 
 #undef ALIGN
@@ -141,6 +144,12 @@ public:
   virtual void         UnInit();
   virtual void         Reset(); /* resets renderer after seek for example */
   virtual void         Flush();
+  virtual int          GetMaxBufferSize();
+  virtual void         SetBufferSize(int numBuffers);
+  virtual bool         GetDirectBuffer(YV12Image &image, unsigned int &id);
+  virtual void         ReleaseDirectBuffer(unsigned int id);
+  virtual void         FreeReleasedDirectBuffers();
+  virtual bool         AdoptDirectBuffer(int source, const BYTE *plane);
 
 #ifdef HAVE_LIBVDPAU
   virtual void         AddProcessor(CVDPAU* vdpau);
@@ -305,6 +314,27 @@ protected:
   bool m_pboSupported;
   bool m_pboUsed;
 
+  // buffers handed to the decoder by GetDirectBuffer, swapped into m_buffers by AdoptDirectBuffer
+  struct YUVDIRECT
+  {
+    YV12Image image;
+    GLuint    pbo[MAX_PLANES];
+    unsigned  id;       // non zero while the decoder holds the buffer
+    bool      orphaned; // textures were deleted while the decoder held it, freed once released
+  };
+
+  bool CreateDirectBuffer(YUVDIRECT& direct);
+  void FreeDirectBuffer(YUVDIRECT& direct);
+  void ManageDirectBuffers();
+  void DeleteDirectBuffers();
+
+  std::vector<YUVDIRECT> m_direct;
+  YV12Image        m_directRequest;   // geometry last asked for, buffers are created on the next flip
+  unsigned int     m_directId;
+  bool             m_directRendering;
+  bool             m_directReleased;  // an orphaned pbo buffer was released off the render thread
+  CCriticalSection m_directSection;
+
   bool  m_nonLinStretch;
   bool  m_nonLinStretchGui;
   float m_pixelRatio;
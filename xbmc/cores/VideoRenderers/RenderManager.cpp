@@ -38,6 +38,7 @@
 
 #if defined(HAS_GL)
   #include "LinuxRendererGL.h"
+  #include "guilib/GUIQuadBatchGL.h"
 #elif HAS_GLES == 2
   #include "LinuxRendererGLES.h"
 #elif defined(HAS_DX)
@@ -52,6 +53,7 @@
 #include "../dvdplayer/DVDClock.h"
 #include "../dvdplayer/DVDCodecs/Video/DVDVideoCodec.h"
 #include "../dvdplayer/DVDCodecs/DVDCodecUtils.h"
+#include "../dvdplayer/DVDPerformanceCounter.h"
 
 #define MAXPRESENTDELAY 0.500
 
@@ -101,6 +103,8 @@ CXBMCRenderManager::CXBMCRenderManager()
   m_rendermethod = 0;
   m_presentsource = 0;
   m_presentmethod = PRESENT_METHOD_SINGLE;
+  m_queuesize = 1;
+  m_numbuffers = 0;
   m_bReconfigured = false;
   m_hasCaptures = false;
   m_displayLatency = 0.0f;
@@ -216,7 +220,11 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
 {
   /* make sure any queued frame was fully presented */
   double timeout = m_presenttime + 0.1;
-  while(m_presentstep != PRESENT_IDLE)
+  { CSingleLock queuelock(m_queueSection);
+    if (!m_queued.empty())
+      timeout = m_queued.back().timestamp + 0.1;
+  }
+  while(m_presentstep != PRESENT_IDLE || GetQueuedFrames() > 0)
   {
     if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout)
     {
@@ -245,6 +253,25 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
     m_bIsStarted = true;
     m_bReconfigured = true;
     m_presentstep = PRESENT_IDLE;
+
+    /* size the queue to the buffers the renderer can address by index */
+    { CSingleLock queuelock(m_queueSection);
+      m_queued.clear();
+      m_numbuffers = std::min(m_pRenderer->GetMaxBufferSize(), g_advancedSettings.m_videoRenderBuffers);
+      if (m_numbuffers >= 2)
+      {
+        m_pRenderer->SetBufferSize(m_numbuffers);
+        m_queuesize = m_numbuffers - 1;
+      }
+      else
+      {
+        m_numbuffers = 0;
+        m_queuesize = 1;
+      }
+      m_presentsource = 0;
+      g_dvdPerformanceCounter.SetVideoRenderQueue(0, m_queuesize);
+      CLog::Log(LOGDEBUG, "CRenderManager::Configure - queueing up to %d frames", m_queuesize);
+    }
     m_presentevent.Set();
   }
 
@@ -273,10 +300,19 @@ void CXBMCRenderManager::Update(bool bPauseDrawing)
 
 void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
 {
+#if defined(HAS_GL)
+  // the gui drawn so far goes underneath the video
+  CGUIQuadBatchGL::GetInstance().Flush();
+#endif
+
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if (!m_pRenderer)
       return;
 
+    /* frames are shown once due, a paused player keeps its queue */
+    if (!g_application.IsPaused())
+      PrepareNextRender(true);
+
     if(m_presentstep == PRESENT_FLIP)
     {
       m_overlays.Flip();
@@ -308,6 +344,10 @@ unsigned int CXBMCRenderManager::PreInit()
 
   m_bIsStarted = false;
   m_bPauseDrawing = false;
+  { CSingleLock queuelock(m_queueSection);
+    m_queued.clear();
+    m_presentsource = 0;
+  }
   if (!m_pRenderer)
   {
 #if defined(HAS_GL)
@@ -333,6 +373,7 @@ void CXBMCRenderManager::UnInit()
   m_bIsStarted = false;
 
   m_overlays.Flush();
+  DiscardBuffer();
 
   // free renderer resources.
   // TODO: we may also want to release the renderer here.
@@ -369,6 +410,15 @@ bool CXBMCRenderManager::Flush()
   return true;
 }
 
+void CXBMCRenderManager::DiscardBuffer()
+{
+  { CSingleLock queuelock(m_queueSection);
+    m_queued.clear();
+    g_dvdPerformanceCounter.SetVideoRenderQueue(0, m_queuesize);
+  }
+  m_presentevent.Set();
+}
+
 void CXBMCRenderManager::SetupScreenshot()
 {
   CSharedLock lock(m_sharedSection);
@@ -517,83 +567,129 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
   if(timestamp - GetPresentTime() > MAXPRESENTDELAY)
     timestamp =  GetPresentTime() + MAXPRESENTDELAY;
 
-  /* can't flip, untill timestamp */
-  if(!g_graphicsContext.IsFullScreenVideo())
-    WaitPresentTime(timestamp);
-
-  /* make sure any queued frame was fully presented */
-  double timeout = m_presenttime + 1.0;
-  while(m_presentstep != PRESENT_IDLE && !bStop)
-  {
-    if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
-    {
-      CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for previous frame");
-      return;
-    }
-  };
-
   if(bStop)
     return;
 
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if(!m_pRenderer) return;
 
-    m_presenttime  = timestamp;
-    m_presentfield = sync;
-    m_presentstep  = PRESENT_FLIP;
-    m_presentsource = source;
+    SPresentFrame frame;
+    frame.timestamp = timestamp;
+    frame.field     = sync;
     EDEINTERLACEMODE deinterlacemode = g_settings.m_currentVideoSettings.m_DeinterlaceMode;
     EINTERLACEMETHOD interlacemethod = AutoInterlaceMethodInternal(g_settings.m_currentVideoSettings.m_InterlaceMethod);
 
     bool invert = false;
 
     if (deinterlacemode == VS_DEINTERLACEMODE_OFF)
-      m_presentmethod = PRESENT_METHOD_SINGLE;
+      frame.method = PRESENT_METHOD_SINGLE;
     else
     {
-      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && m_presentfield == FS_NONE)
-        m_presentmethod = PRESENT_METHOD_SINGLE;
+      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && frame.field == FS_NONE)
+        frame.method = PRESENT_METHOD_SINGLE;
       else
       {
-        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            m_presentmethod = PRESENT_METHOD_BLEND;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            m_presentmethod = PRESENT_METHOD_WEAVE;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { m_presentmethod = PRESENT_METHOD_WEAVE ; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { m_presentmethod = PRESENT_METHOD_BOB; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               m_presentmethod = PRESENT_METHOD_BOB;
-        else                                                                    m_presentmethod = PRESENT_METHOD_SINGLE;
+        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            frame.method = PRESENT_METHOD_BLEND;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            frame.method = PRESENT_METHOD_WEAVE;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { frame.method = PRESENT_METHOD_WEAVE ; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              frame.method = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { frame.method = PRESENT_METHOD_BOB; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                frame.method = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               frame.method = PRESENT_METHOD_BOB;
+        else                                                                    frame.method = PRESENT_METHOD_SINGLE;
 
         /* default to odd field if we want to deinterlace and don't know better */
-        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && m_presentfield == FS_NONE)
-          m_presentfield = FS_TOP;
+        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && frame.field == FS_NONE)
+          frame.field = FS_TOP;
 
         /* invert present field */
         if(invert)
         {
-          if( m_presentfield == FS_BOT )
-            m_presentfield = FS_TOP;
+          if( frame.field == FS_BOT )
+            frame.field = FS_TOP;
           else
-            m_presentfield = FS_BOT;
+            frame.field = FS_BOT;
         }
       }
     }
 
+    CSingleLock queuelock(m_queueSection);
+
+    /* the picture was written to the buffer following the queued ones */
+    if (m_numbuffers > 0 && source < 0)
+      frame.source = (m_presentsource + m_queued.size() + 1) % m_numbuffers;
+    else
+      frame.source = source;
+
+    /* can only happen if the render thread stalled past a timeout, drop the oldest */
+    if ((int)m_queued.size() >= m_queuesize)
+    {
+      m_queued.pop_front();
+      g_dvdPerformanceCounter.AddVideoSkippedFrame();
+    }
+
+    m_queued.push_back(frame);
+    g_dvdPerformanceCounter.SetVideoRenderQueue(m_queued.size(), m_queuesize);
   }
 
   g_application.NewFrame();
-  /* wait untill render thread have flipped buffers */
-  timeout = m_presenttime + 1.0;
-  while(m_presentstep == PRESENT_FLIP && !bStop)
+
+  /* wait untill the render thread has room for the next frame */
+  double timeout = timestamp + 1.0;
+  while(GetQueuedFrames() >= m_queuesize && !bStop)
   {
     if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
     {
-      CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for flip to complete");
+      CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for a free render buffer");
       return;
     }
   }
 }
 
+int CXBMCRenderManager::GetQueuedFrames()
+{
+  CSingleLock queuelock(m_queueSection);
+  return m_queued.size();
+}
+
+void CXBMCRenderManager::PrepareNextRender(bool due)
+{
+  CSingleLock queuelock(m_queueSection);
+
+  /* the current frame must have been rendered, both fields if bobbing */
+  if (m_presentstep != PRESENT_IDLE || m_queued.empty())
+    return;
+
+  double now = GetPresentTime();
+  if (due && m_queued.front().timestamp > now)
+    return;
+
+  /* a frame whose successor is already due would barely be seen */
+  while (m_queued.size() > 1 && m_queued[1].timestamp <= now)
+  {
+    m_queued.pop_front();
+    g_dvdPerformanceCounter.AddVideoSkippedFrame();
+  }
+
+  double frametime;
+  if (g_VideoReferenceClock.GetRefreshRate(&frametime) <= 0)
+    frametime = 1.0 / std::max(g_graphicsContext.GetFPS(), 1.0f);
+
+  const SPresentFrame &frame = m_queued.front();
+  if (now - frame.timestamp > frametime)
+    g_dvdPerformanceCounter.AddVideoLateFrame();
+
+  m_presenttime   = frame.timestamp;
+  m_presentfield  = frame.field;
+  m_presentmethod = frame.method;
+  m_presentsource = frame.source;
+  m_presentstep   = PRESENT_FLIP;
+
+  m_queued.pop_front();
+  g_dvdPerformanceCounter.SetVideoRenderQueue(m_queued.size(), m_queuesize);
+  m_presentevent.Set();
+}
+
 float CXBMCRenderManager::GetMaximumFPS()
 {
   float fps;
@@ -627,10 +723,18 @@ void CXBMCRenderManager::Render(bool clear, DWORD flags, DWORD alpha)
 
 void CXBMCRenderManager::Present()
 {
+#if defined(HAS_GL)
+  CGUIQuadBatchGL::GetInstance().Flush();
+#endif
+
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if (!m_pRenderer)
       return;
 
+    /* take the next frame even if early, we wait for its time below. A paused player keeps its queue */
+    if (!g_application.IsPaused())
+      PrepareNextRender(false);
+
     if(m_presentstep == PRESENT_FLIP)
     {
       m_overlays.Flip();
@@ -752,24 +856,42 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   if(m_pRenderer->AddVideoPicture(&pic))
     return 1;
 
+  /* write behind the queued frames, the buffer after the last one is free while the queue isn't full */
+  int source = -1;
+  if (m_numbuffers > 0)
+  {
+    CSingleLock queuelock(m_queueSection);
+    if ((int)m_queued.size() >= m_queuesize)
+      return -1;
+    source = (m_presentsource + m_queued.size() + 1) % m_numbuffers;
+  }
+
   YV12Image image;
-  int index = m_pRenderer->GetImage(&image);
+  int index = m_pRenderer->GetImage(&image, source);
 
   if(index < 0)
     return index;
 
   if(pic.format == DVDVideoPicture::FMT_YUV420P)
   {
-    CDVDCodecUtils::CopyPicture(&image, &pic);
+    if((pic.iFlags & DVP_FLAG_DIRECT) && m_pRenderer->AdoptDirectBuffer(index, pic.data[0]))
+      g_dvdPerformanceCounter.AddVideoDirectFrame();
+    else
+    {
+      CDVDCodecUtils::CopyPicture(&image, &pic);
+      g_dvdPerformanceCounter.AddVideoCopiedFrame(pic.iWidth * pic.iHeight * 3 / 2);
+    }
   }
   else if(pic.format == DVDVideoPicture::FMT_NV12)
   {
     CDVDCodecUtils::CopyNV12Picture(&image, &pic);
+    g_dvdPerformanceCounter.AddVideoCopiedFrame(pic.iWidth * pic.iHeight * 3 / 2);
   }
   else if(pic.format == DVDVideoPicture::FMT_YUY2
        || pic.format == DVDVideoPicture::FMT_UYVY)
   {
     CDVDCodecUtils::CopyYUV422PackedPicture(&image, &pic);
+    g_dvdPerformanceCounter.AddVideoCopiedFrame(pic.iWidth * pic.iHeight * 2);
   }
   else if(pic.format == DVDVideoPicture::FMT_DXVA)
   {
@@ -22,6 +22,7 @@
  */
 
 #include <list>
+#include <deque>
 
 #if defined (HAS_GL)
   #include "LinuxRendererGL.h"
@@ -78,6 +79,10 @@ public:
   void UnInit();
   bool Flush();
 
+  /*! \brief Drop the frames queued for presentation, after a seek for example
+   */
+  void DiscardBuffer();
+
   void AddOverlay(CDVDOverlay* o, double pts)
   {
     CSharedLock lock(m_sharedSection);
@@ -167,6 +172,34 @@ public:
     return 0;
   }
 
+  /*! \brief Buffers of the renderer a software decoder can write frames into directly,
+   see CBaseRenderer::GetDirectBuffer
+   */
+  bool GetDirectBuffer(YV12Image &image, unsigned int &id)
+  {
+    CSharedLock lock(m_sharedSection);
+    if (m_pRenderer)
+      return m_pRenderer->GetDirectBuffer(image, id);
+    return false;
+  }
+
+  void ReleaseDirectBuffer(unsigned int id)
+  {
+    CSharedLock lock(m_sharedSection);
+    if (m_pRenderer)
+      m_pRenderer->ReleaseDirectBuffer(id);
+  }
+
+  /*! \brief Free direct buffers the decoder released after the renderer was uninitialized,
+   called from the render thread every frame
+   */
+  void FreeReleasedDirectBuffers()
+  {
+    CSharedLock lock(m_sharedSection);
+    if (m_pRenderer)
+      m_pRenderer->FreeReleasedDirectBuffers();
+  }
+
 #ifdef HAS_GL
   CLinuxRendererGL *m_pRenderer;
 #elif HAS_GLES == 2
@@ -185,6 +218,9 @@ public:
 protected:
   void Render(bool clear, DWORD flags, DWORD alpha);
 
+  void PrepareNextRender(bool due);
+  int  GetQueuedFrames();
+
   void PresentSingle(bool clear, DWORD flags, DWORD alpha);
   void PresentWeave(bool clear, DWORD flags, DWORD alpha);
   void PresentBob(bool clear, DWORD flags, DWORD alpha);
@@ -232,6 +268,19 @@ protected:
   CEvent     m_presentevent;
   CEvent     m_flushEvent;
 
+  struct SPresentFrame
+  {
+    int            source;    ///< renderer buffer holding the frame
+    double         timestamp; ///< when the frame should be shown
+    EFIELDSYNC     field;
+    EPRESENTMETHOD method;
+  };
+
+  CCriticalSection          m_queueSection; ///< protects m_queued and the buffer indexes
+  std::deque<SPresentFrame> m_queued;       ///< frames flipped by the player, not yet presented
+  int                       m_queuesize;    ///< frames that may be queued ahead of the one shown
+  int                       m_numbuffers;   ///< renderer buffers addressed by index, 0 if the renderer picks them
+
 
   OVERLAY::CRenderer m_overlays;
 
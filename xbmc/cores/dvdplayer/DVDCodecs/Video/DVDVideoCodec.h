@@ -125,6 +125,7 @@ struct DVDVideoUserData
 
 #define DVP_FLAG_NOSKIP             0x00000010 // indicate this picture should never be dropped
 #define DVP_FLAG_DROPPED            0x00000020 // indicate that this picture has been dropped in decoder stage, will have no data
+#define DVP_FLAG_DIRECT             0x00000040 // picture data lives in a buffer of the renderer, it can only be output once
 
 // DVP_FLAG 0x00000100 - 0x00000f00 is in use by libmpeg2!
 
@@ -252,4 +253,24 @@ public:
   {
     return 0;
   }
+
+  /*
+   *
+   * How many pictures the codec may still hold back at the
+   * end of the stream, to be pushed out with Drain()
+   */
+  virtual unsigned GetDelayedPictures()
+  {
+    return 0;
+  }
+
+  /*
+   *
+   * Return a picture held back at the end of the stream,
+   * the result is as for Decode()
+   */
+  virtual int Drain()
+  {
+    return VC_BUFFER;
+  }
 };
@@ -35,6 +35,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "boost/shared_ptr.hpp"
 #include "threads/Atomics.h"
 
@@ -59,6 +60,24 @@
 
 using namespace boost;
 
+// whether any hardware decoder may be picked up in GetFormat()
+static bool IsHardwareDecodingEnabled()
+{
+#ifdef HAVE_LIBVDPAU
+  if(g_guiSettings.GetBool("videoplayer.usevdpau"))
+    return true;
+#endif
+#ifdef HAS_DX
+  if(g_guiSettings.GetBool("videoplayer.usedxva2"))
+    return true;
+#endif
+#ifdef HAVE_LIBVA
+  if(g_guiSettings.GetBool("videoplayer.usevaapi"))
+    return true;
+#endif
+  return false;
+}
+
 enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
                                                 , const PixelFormat * fmt )
 {
@@ -120,6 +139,110 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   return ctx->m_dllAvCodec.avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext * avctx, AVFrame * pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  /* reference frames are read back while decoding the frames that follow them, which is
+   * slow from the write combined memory of the renderer, so they stay in system memory.
+   * the decoder expects all of its frames to have the same strides, the first of those
+   * decides what they are */
+  if (pic->reference
+  || (avctx->pix_fmt != PIX_FMT_YUV420P && avctx->pix_fmt != PIX_FMT_YUVJ420P)
+  || (pic->buffer_hints & (FF_BUFFER_HINTS_READABLE | FF_BUFFER_HINTS_PRESERVE | FF_BUFFER_HINTS_REUSABLE))
+  || ctx->m_pFilterGraph
+  || ctx->m_directLinesize[0] == 0)
+  {
+    int result = ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+    if (result == 0)
+    {
+      for (int i = 0; i < 3; i++)
+        ctx->m_directLinesize[i] = pic->linesize[i];
+    }
+    return result;
+  }
+
+  int width  = avctx->width;
+  int height = avctx->height;
+  int align[AV_NUM_DATA_POINTERS];
+  ctx->m_dllAvCodec.avcodec_align_dimensions2(avctx, &width, &height, align);
+
+  /* the decoder writes whole macroblocks, the buffer has to cover the aligned size */
+  YV12Image image;
+  memset(&image, 0, sizeof(image));
+  image.width    = avctx->width;
+  image.height   = avctx->height;
+  image.cshift_x = 1;
+  image.cshift_y = 1;
+  for (int i = 0; i < 3; i++)
+  {
+    image.stride[i]    = ctx->m_directLinesize[i];
+    image.planesize[i] = ctx->m_directLinesize[i] * (i ? (height + 1) >> 1 : height);
+  }
+
+  unsigned int id = 0;
+  bool direct = ctx->m_directLinesize[0] >= width
+             && ctx->m_directLinesize[1] >= (width + 1) >> 1
+             && ctx->m_directLinesize[2] >= (width + 1) >> 1
+             && g_renderManager.GetDirectBuffer(image, id);
+  for (int i = 0; direct && i < 3; i++)
+  {
+    if ((uintptr_t)image.plane[i] % align[i] || image.stride[i] % align[i])
+    {
+      g_renderManager.ReleaseDirectBuffer(id);
+      direct = false;
+    }
+  }
+  if (!direct)
+    return ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    pic->base[i]     = i < 3 ? image.plane[i] : NULL;
+    pic->data[i]     = pic->base[i];
+    pic->linesize[i] = i < 3 ? image.stride[i] : 0;
+  }
+  pic->extended_data = pic->data;
+  pic->type   = FF_BUFFER_TYPE_USER;
+  pic->opaque = (void*)(uintptr_t)id;
+
+  if (avctx->pkt)
+  {
+    pic->pkt_pts = avctx->pkt->pts;
+    pic->pkt_pos = avctx->pkt->pos;
+  }
+  else
+  {
+    pic->pkt_pts = AV_NOPTS_VALUE;
+    pic->pkt_pos = -1;
+  }
+  pic->reordered_opaque    = avctx->reordered_opaque;
+  pic->sample_aspect_ratio = avctx->sample_aspect_ratio;
+  pic->width               = avctx->width;
+  pic->height              = avctx->height;
+  pic->format              = avctx->pix_fmt;
+  return 0;
+}
+
+void CDVDVideoCodecFFmpeg::ReleaseBuffer(struct AVCodecContext * avctx, AVFrame * pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  if (pic->type != FF_BUFFER_TYPE_USER)
+  {
+    ctx->m_dllAvCodec.avcodec_default_release_buffer(avctx, pic);
+    return;
+  }
+
+  g_renderManager.ReleaseDirectBuffer((unsigned int)(uintptr_t)pic->opaque);
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    pic->base[i] = NULL;
+    pic->data[i] = NULL;
+  }
+  pic->opaque = NULL;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
   m_pCodecContext = NULL;
@@ -141,6 +264,12 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
+  m_frameThreading = false;
+  m_draining = false;
+  m_directRendering = false;
+  memset(m_directLinesize, 0, sizeof(m_directLinesize));
+  m_decodedFrames = 0;
+  m_decodeTime = 0;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -240,7 +369,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
+  /* Only allow slice threading by default, since frame threading is more
    * sensitive to changes in frame sizes, and it causes crashes
    * during HW accell */
   m_pCodecContext->thread_type = FF_THREAD_SLICE;
@@ -281,6 +410,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   {
     if (it->m_name == "surfaces")
       m_uSurfacesCount = std::atoi(it->m_value.c_str());
+    else if (it->m_name == "directrendering")
+      m_directRendering = true;
     else
       m_dllAvUtil.av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
@@ -289,8 +420,20 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
   && ( pCodec->id == CODEC_ID_H264
     || pCodec->id == CODEC_ID_MPEG4 ))
+  {
     m_pCodecContext->thread_count = num_threads;
 
+    /* frame threading scales with the cores on single slice streams, but is
+     * opt in and only used if we won't switch to a hardware decoder later on */
+    if (g_advancedSettings.m_videoFrameThreading
+    && (pCodec->capabilities & CODEC_CAP_FRAME_THREADS)
+    && (m_bSoftware || !IsHardwareDecodingEnabled()))
+    {
+      m_pCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+      m_bSoftware = true;
+    }
+  }
+
   if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
     CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Unable to open codec");
@@ -300,12 +443,37 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pFrame = m_dllAvCodec.avcodec_alloc_frame();
   if (!m_pFrame) return false;
 
+  m_frameThreading = m_pCodecContext->active_thread_type == FF_THREAD_FRAME;
+  if (m_frameThreading)
+    CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::Open() Using frame threading with %d threads", m_pCodecContext->thread_count);
+
+  /* hardware decoders install their own allocators once picked up in GetFormat(). not with
+   * frame threading either, as buffers would be requested from the decoding threads */
+  if (m_directRendering && m_pHardware == NULL && !m_frameThreading
+  && (pCodec->capabilities & CODEC_CAP_DR1))
+  {
+    m_pCodecContext->get_buffer     = GetBuffer;
+    m_pCodecContext->release_buffer = ReleaseBuffer;
+    CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::Open() Using direct rendering");
+  }
+  else
+    m_directRendering = false;
+
   UpdateName();
   return true;
 }
 
 void CDVDVideoCodecFFmpeg::Dispose()
 {
+  if (m_decodedFrames && m_decodeTime)
+  {
+    double seconds = (double)m_decodeTime / CurrentHostFrequency();
+    CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::Dispose() Decoded %u frames in %.2f s (%.1f fps) using %s threading",
+              m_decodedFrames, seconds, m_decodedFrames / seconds, m_frameThreading ? "frame" : "slice");
+  }
+  m_decodedFrames = 0;
+  m_decodeTime = 0;
+
   if (m_pFrame) m_dllAvUtil.av_free(m_pFrame);
   m_pFrame = NULL;
 
@@ -429,10 +597,16 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
     int result = 0;
     if(pData == NULL)
       result = FilterProcess(NULL);
-    if(result)
+    // when draining, the decoder is asked once the filters have nothing left
+    if(result && !(m_draining && result == VC_BUFFER))
       return result;
   }
 
+  // an empty packet makes frame threads return the pictures they hold,
+  // which is only wanted at the end of the stream
+  if(pData == NULL && m_frameThreading && !m_draining)
+    return VC_BUFFER;
+
   m_dts = dts;
   m_pCodecContext->reordered_opaque = pts_dtoi(pts);
 
@@ -440,10 +614,15 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   m_dllAvCodec.av_init_packet(&avpkt);
   avpkt.data = pData;
   avpkt.size = iSize;
+  /* pictures come out some packets later with frame threading,
+   * the dts travels with the packet to the picture */
+  avpkt.dts = pts_dtoi(dts);
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  int64_t start = CurrentHostCounter();
   len = m_dllAvCodec.avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
+  m_decodeTime += CurrentHostCounter() - start;
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
@@ -457,6 +636,15 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   if (!iGotPicture)
     return VC_BUFFER;
 
+  m_decodedFrames++;
+  if(m_frameThreading)
+  {
+    if(m_pFrame->pkt_dts != (int64_t)AV_NOPTS_VALUE)
+      m_dts = pts_itod(m_pFrame->pkt_dts);
+    else
+      m_dts = DVD_NOPTS_VALUE;
+  }
+
   if(m_pFrame->key_frame)
   {
     m_started = true;
@@ -631,6 +819,8 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
   }
 
   pDvdVideoPicture->iFlags |= pDvdVideoPicture->data[0] ? 0 : DVP_FLAG_DROPPED;
+  if (m_directRendering && m_pFrame->type == FF_BUFFER_TYPE_USER && !m_pFilterGraph)
+    pDvdVideoPicture->iFlags |= DVP_FLAG_DIRECT;
   pDvdVideoPicture->extended_format = 0;
   pDvdVideoPicture->color_range = 0;
 
@@ -827,6 +1017,22 @@ int CDVDVideoCodecFFmpeg::FilterProcess(AVFrame* frame)
   return VC_BUFFER;
 }
 
+unsigned CDVDVideoCodecFFmpeg::GetDelayedPictures()
+{
+  if(m_pCodecContext && m_frameThreading)
+    return m_pCodecContext->thread_count + m_pCodecContext->has_b_frames;
+  else
+    return 0;
+}
+
+int CDVDVideoCodecFFmpeg::Drain()
+{
+  m_draining = true;
+  int result = Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+  m_draining = false;
+  return result;
+}
+
 unsigned CDVDVideoCodecFFmpeg::GetConvergeCount()
 {
   if(m_pHardware)
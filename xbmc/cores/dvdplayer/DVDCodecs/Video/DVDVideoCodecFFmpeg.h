@@ -61,6 +61,8 @@ public:
   virtual unsigned int SetFilters(unsigned int filters);
   virtual const char* GetName() { return m_name.c_str(); }; // m_name is never changed after open
   virtual unsigned GetConvergeCount();
+  virtual unsigned GetDelayedPictures();
+  virtual int Drain();
 
   bool               IsHardwareAllowed()                     { return !m_bSoftware; }
   IHardwareDecoder * GetHardware()                           { return m_pHardware; };
@@ -73,6 +75,8 @@ public:
 
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
+  static int  GetBuffer(struct AVCodecContext * avctx, AVFrame * pic);
+  static void ReleaseBuffer(struct AVCodecContext * avctx, AVFrame * pic);
 
   int  FilterOpen(const CStdString& filters, bool scale);
   void FilterClose();
@@ -119,5 +123,13 @@ protected:
   int m_iLastKeyframe;
   double m_dts;
   bool   m_started;
+  bool   m_frameThreading;   ///< frames are decoded in parallel, pictures come out thread_count - 1 packets late
+  bool   m_draining;
+  bool   m_directRendering;   ///< non reference frames are decoded straight into buffers of the renderer
+  int    m_directLinesize[3]; ///< strides of the decoder's own frames, which direct buffers have to match
+
+  // decode throughput, logged when closing
+  unsigned int m_decodedFrames;
+  int64_t      m_decodeTime;
   std::vector<PixelFormat> m_formats;
 };
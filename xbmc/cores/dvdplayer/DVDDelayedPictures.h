@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDClock.h"
+#include <set>
+
+/*!
+ \brief Keeps track of the pictures a decoder holds back, like frame threaded ffmpeg does
+
+ The picture of a packet comes out several packets later, and the last pictures only when the
+ decoder is drained with empty packets at the end of the stream. Drops are therefore matched
+ to the pictures coming out by their pts, rather than applied to whatever picture comes out.
+ */
+class CDVDDelayedPictures
+{
+public:
+  CDVDDelayedPictures() : m_drain(0) {}
+
+  /*! \brief Forget the drain and drop state, on seeks and flushes
+   */
+  void Reset()
+  {
+    m_drain = 0;
+    m_droppedPts.clear();
+  }
+
+  /*! \brief Start draining the decoder at the end of the stream
+   \param delayed the number of pictures the decoder may hold back
+   \return the number of empty packets to queue, 0 if a drain is under way already
+   */
+  unsigned int BeginDrain(unsigned int delayed)
+  {
+    if (m_drain)
+      return 0;
+    m_drain = delayed;
+    return m_drain;
+  }
+
+  /*! \brief Check whether a packet is one of the empty packets queued by BeginDrain()
+   \param size the size of the packet
+   */
+  bool IsDrainPacket(int size)
+  {
+    if (m_drain == 0 || size != 0)
+      return false;
+    m_drain--;
+    return true;
+  }
+
+  /*! \brief Remember that the picture of a packet is to be dropped
+   \param pts the pts of the packet
+   */
+  void DropPacket(double pts)
+  {
+    if (pts != DVD_NOPTS_VALUE)
+      m_droppedPts.insert(pts);
+  }
+
+  /*! \brief Check whether a picture coming out is to be dropped
+   Pictures come out in pts order, so drops of earlier pts won't be matched any more.
+   \param pts the pts of the picture
+   */
+  bool IsPictureDropped(double pts)
+  {
+    bool dropped = m_droppedPts.find(pts) != m_droppedPts.end();
+    m_droppedPts.erase(m_droppedPts.begin(), m_droppedPts.upper_bound(pts));
+    return dropped;
+  }
+
+private:
+  unsigned int     m_drain;      ///< empty packets queued at the end of the stream to drain the decoder
+  std::set<double> m_droppedPts; ///< pts of packets to drop whose pictures haven't come out yet
+};
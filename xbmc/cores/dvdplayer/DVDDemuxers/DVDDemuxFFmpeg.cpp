@@ -37,6 +37,7 @@
 #include "DVDInputStreams/DVDInputStreamBluray.h"
 #endif
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxStreamInfoCache.h"
 #include "DVDClock.h" // for DVD_TIME_BASE
 #include "utils/Win32Exception.h"
 #include "settings/AdvancedSettings.h"
@@ -239,6 +240,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   g_demuxer = this;
   m_program = UINT_MAX;
   const AVIOInterruptCB int_cb = { interrupt_cb, NULL };
+  int64_t startTime = CurrentHostCounter();
+  bool cached = false;
 
   if (!pInput) return false;
 
@@ -422,6 +425,7 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       return false;
     }
   }
+  int64_t openTime = CurrentHostCounter();
 
   // set the interrupt callback, appeared in libavformat 53.15.0
   m_pFormatContext->interrupt_callback = int_cb;
@@ -441,8 +445,50 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       m_pFormatContext->max_analyze_duration = 500000;
 
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+    // files we probed before only need a short look to confirm the streams we
+    // found then, the cache fills in the codec parameters the short probe misses.
+    // Files rewritten at the same size are told apart by their modification time.
+    int64_t length = m_pInput->GetLength();
+    struct __stat64 st;
+    bool cacheable = g_advancedSettings.m_dvdplayerStreamInfoCache
+                  && m_ioContext && m_ioContext->seekable
+                  && !m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD)
+                  && length > 0
+                  && XFILE::CFile::Stat(strFile, &st) == 0 && st.st_mtime != 0;
+    int64_t mtime = cacheable ? (int64_t)st.st_mtime : 0;
+
+    CDVDDemuxStreamInfoCache cache;
+    if (cacheable && cache.Load(strFile, length, mtime) && cache.GetFormat() == m_pFormatContext->iformat->name)
+    {
+      int          analyzeDuration = m_pFormatContext->max_analyze_duration;
+      unsigned int probeSize       = m_pFormatContext->probesize;
+      m_pFormatContext->max_analyze_duration = 500000;
+      m_pFormatContext->probesize            = 500000;
+
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting, short probe", __FUNCTION__);
+      if (m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL) >= 0
+      &&  cache.Apply(m_pFormatContext, m_dllAvUtil))
+        cached = true;
+      else
+        CLog::Log(LOGDEBUG, "%s - streams differ from cached ones, probing in full", __FUNCTION__);
+
+      m_pFormatContext->max_analyze_duration = analyzeDuration;
+      m_pFormatContext->probesize            = probeSize;
+    }
+
+    int iErr = 0;
+    if (!cached)
+    {
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+      if (cacheable)
+      {
+        if (iErr >= 0)
+          CDVDDemuxStreamInfoCache::Save(strFile, length, mtime, m_pFormatContext);
+        else
+          CDVDDemuxStreamInfoCache::Remove(strFile);
+      }
+    }
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
@@ -461,6 +507,14 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   // reset any timeout
   m_timeout.SetInfinite();
 
+  int64_t infoTime = CurrentHostCounter();
+  double  freq     = (double)CurrentHostFrequency() / 1000.0;
+  CLog::Log(LOGDEBUG, "%s - opened in %.1f ms (open %.1f ms, stream info %.1f ms%s)", __FUNCTION__
+          , (infoTime - startTime) / freq
+          , (openTime - startTime) / freq
+          , (infoTime - openTime)  / freq
+          , cached ? ", cached" : "");
+
   // if format can be nonblocking, let's use that
   m_pFormatContext->flags |= AVFMT_FLAG_NONBLOCK;
 
@@ -617,6 +671,19 @@ double CDVDDemuxFFmpeg::ConvertTimestamp(int64_t pts, int den, int num)
   return timestamp*DVD_TIME_BASE;
 }
 
+DemuxPacket* CDVDDemuxFFmpeg::AllocatePacket(AVPacket &pkt)
+{
+  // hand the data over rather than copying it where we can, av_dup_packet makes sure
+  // it isn't a reference into a buffer the demuxer will reuse
+  if (g_advancedSettings.m_videoZeroCopyDemux && pkt.data && m_dllAvCodec.av_dup_packet(&pkt) == 0)
+  {
+    DemuxPacket* pPacket = CDVDDemuxUtils::AllocateDemuxPacket(pkt);
+    if (pPacket)
+      return pPacket;
+  }
+  return CDVDDemuxUtils::AllocateDemuxPacket(pkt.size);
+}
+
 DemuxPacket* CDVDDemuxFFmpeg::Read()
 {
   g_demuxer = this;
@@ -686,7 +753,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         {
           if(pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
           {
-            pPacket = CDVDDemuxUtils::AllocateDemuxPacket(pkt.size);
+            pPacket = AllocatePacket(pkt);
             break;
           }
         }
@@ -695,7 +762,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           bReturnEmpty = true;
       }
       else
-        pPacket = CDVDDemuxUtils::AllocateDemuxPacket(pkt.size);
+        pPacket = AllocatePacket(pkt);
 
       if (pPacket)
       {
@@ -731,11 +798,10 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
+        // copy contents into our own packet, unless it references them
         pPacket->iSize = pkt.size;
 
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (pkt.data)
+        if (pkt.data && pPacket->pData != pkt.data)
           memcpy(pPacket->pData, pkt.data, pPacket->iSize);
 
         pPacket->pts = ConvertTimestamp(pkt.pts, stream->time_base.den, stream->time_base.num);
@@ -122,6 +122,7 @@ protected:
   void AddStream(int iId);
 
   double ConvertTimestamp(int64_t pts, int den, int num);
+  DemuxPacket* AllocatePacket(AVPacket &pkt);
   void UpdateCurrentPTS();
 
   CCriticalSection m_critSection;
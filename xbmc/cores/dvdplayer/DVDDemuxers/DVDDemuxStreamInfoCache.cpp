@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "DVDDemuxStreamInfoCache.h"
+#include "DVDDemuxFFmpeg.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "FileItem.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "threads/Atomics.h"
+
+#include <map>
+#include <time.h>
+
+using namespace XFILE;
+
+#define STREAMINFO_PATH    "special://temp/streaminfo/"
+
+#define STREAMINFO_MAX_AGE   (90 * 24 * 60 * 60) // seconds since an entry was written
+#define STREAMINFO_MAX_SIZE  (16 * 1024 * 1024) // bytes of all entries
+#define STREAMINFO_MAX_ENTRY (4 * 1024 * 1024)  // bytes of a single entry
+
+CStdString CDVDDemuxStreamInfoCache::GetCacheFile(const CStdString &file)
+{
+  Crc32 crc;
+  crc.Compute(file);
+  CStdString cacheFile;
+  cacheFile.Format(STREAMINFO_PATH "%08x.bin", (unsigned int)crc);
+  return cacheFile;
+}
+
+bool CDVDDemuxStreamInfoCache::Load(const CStdString &file, int64_t length, int64_t mtime)
+{
+  CFile cacheFile;
+  if (!cacheFile.Open(GetCacheFile(file)))
+    return false;
+
+  int64_t size = cacheFile.GetLength();
+  if (size <= 0 || size > STREAMINFO_MAX_ENTRY)
+    return false;
+
+  std::string data;
+  data.resize((size_t)size);
+  if (cacheFile.Read(&data[0], size) != size)
+    return false;
+
+  return m_entry.Unserialize(file, length, mtime, data);
+}
+
+void CDVDDemuxStreamInfoCache::Save(const CStdString &file, int64_t length, int64_t mtime, const AVFormatContext *context)
+{
+  CDVDDemuxStreamInfoEntry entry;
+  if (!entry.Set(context))
+    return;
+
+  std::string data;
+  entry.Serialize(file, length, mtime, data);
+  if (data.size() > STREAMINFO_MAX_ENTRY)
+    return;
+
+  // saves run on the player threads, only the first one of a session prunes
+  static long pruned = 0;
+  if (AtomicIncrement(&pruned) == 1)
+    Prune();
+
+  CDirectory::Create(STREAMINFO_PATH);
+  CFile cacheFile;
+  if (!cacheFile.OpenForWrite(GetCacheFile(file), true)
+  ||  cacheFile.Write(data.data(), data.size()) != (int)data.size())
+  {
+    CLog::Log(LOGWARNING, "%s - unable to cache streams of %s", __FUNCTION__, file.c_str());
+    cacheFile.Close();
+    CFile::Delete(GetCacheFile(file));
+  }
+}
+
+void CDVDDemuxStreamInfoCache::Remove(const CStdString &file)
+{
+  CFile::Delete(GetCacheFile(file));
+}
+
+void CDVDDemuxStreamInfoCache::Prune()
+{
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(STREAMINFO_PATH, items, ".bin", DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  // entries are only ever written when a file is probed in full, so that's their age
+  std::multimap<time_t, std::pair<CStdString, int64_t> > entries;
+  int64_t total = 0;
+  time_t now = time(NULL);
+  unsigned int removed = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    struct __stat64 st;
+    if (CFile::Stat(items[i]->GetPath(), &st) != 0)
+      continue;
+    if (now - st.st_mtime > STREAMINFO_MAX_AGE)
+    {
+      if (CFile::Delete(items[i]->GetPath()))
+        removed++;
+      continue;
+    }
+    entries.insert(std::make_pair((time_t)st.st_mtime, std::make_pair(items[i]->GetPath(), (int64_t)st.st_size)));
+    total += st.st_size;
+  }
+
+  // then the oldest ones, until the rest fit
+  for (std::multimap<time_t, std::pair<CStdString, int64_t> >::iterator it = entries.begin(); it != entries.end() && total > STREAMINFO_MAX_SIZE; ++it)
+  {
+    if (CFile::Delete(it->second.first))
+    {
+      total -= it->second.second;
+      removed++;
+    }
+  }
+
+  if (removed)
+    CLog::Log(LOGDEBUG, "%s - removed %u entries", __FUNCTION__, removed);
+}
+
+bool CDVDDemuxStreamInfoCache::Apply(AVFormatContext *context, DllAvUtil &dllAvUtil) const
+{
+  if (!m_entry.Apply(context))
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    AVCodecContext          *codec     = context->streams[i]->codec;
+    const std::vector<char> &extradata = m_entry.GetExtradata(i);
+    if (codec->extradata || extradata.empty())
+      continue;
+
+    codec->extradata = (uint8_t*)dllAvUtil.av_mallocz(extradata.size() + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (codec->extradata)
+    {
+      memcpy(codec->extradata, &extradata[0], extradata.size());
+      codec->extradata_size = extradata.size();
+    }
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDDemuxStreamInfoEntry.h"
+
+struct AVFormatContext;
+class DllAvUtil;
+
+/*!
+ \brief Streams avformat_find_stream_info found in a file, kept in special://temp/streaminfo
+
+ Entries are keyed by the path, size and modification time of the file. Once a file has been
+ probed, later opens only run a short probe, check the streams it finds against the entry and
+ fill in the codec parameters the short probe didn't get to. Entries not written for a while,
+ and the oldest ones past the size budget, are removed on the first save of a session.
+ */
+class CDVDDemuxStreamInfoCache
+{
+public:
+  /*! \brief Load the entry of a file
+   \return false if there is none, or the file changed size or modification time since
+   */
+  bool Load(const CStdString &file, int64_t length, int64_t mtime);
+
+  /*! \brief Store the streams of a fully probed file
+   */
+  static void Save(const CStdString &file, int64_t length, int64_t mtime, const AVFormatContext *context);
+
+  /*! \brief Drop the entry of a file that no longer matches it
+   */
+  static void Remove(const CStdString &file);
+
+  /*! \brief Check the streams of a short probe against the entry and complete their parameters
+   \return false if the streams differ, the file has to be probed in full then
+   */
+  bool Apply(AVFormatContext *context, DllAvUtil &dllAvUtil) const;
+
+  const CStdString &GetFormat() const { return m_entry.GetFormat(); }
+
+private:
+  static CStdString GetCacheFile(const CStdString &file);
+  static void Prune();
+
+  CDVDDemuxStreamInfoEntry m_entry;
+};
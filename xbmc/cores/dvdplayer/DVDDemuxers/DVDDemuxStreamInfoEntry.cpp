@@ -0,0 +1,328 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDDemuxStreamInfoEntry.h"
+#include "DVDDemuxFFmpeg.h" // for MAX_STREAMS
+
+#define STREAMINFO_VERSION 2
+
+#define STREAMINFO_MAX_EXTRADATA (1024 * 1024)
+
+// the layout CArchive used for the entries, kept so existing entries stay valid
+class CStreamInfoWriter
+{
+public:
+  CStreamInfoWriter(std::string &data) : m_data(data) {}
+
+  template <typename T> CStreamInfoWriter& operator<<(const T &value)
+  {
+    m_data.append((const char*)&value, sizeof(T));
+    return *this;
+  }
+
+  CStreamInfoWriter& operator<<(const CStdString &str)
+  {
+    *this << (int)str.size();
+    m_data.append(str);
+    return *this;
+  }
+
+private:
+  std::string &m_data;
+};
+
+// reads what CStreamInfoWriter wrote, every read past the end of the data fails
+class CStreamInfoReader
+{
+public:
+  CStreamInfoReader(const std::string &data) : m_data(data), m_pos(0), m_ok(true) {}
+
+  template <typename T> CStreamInfoReader& operator>>(T &value)
+  {
+    if (m_ok && m_data.size() - m_pos >= sizeof(T))
+    {
+      memcpy(&value, m_data.data() + m_pos, sizeof(T));
+      m_pos += sizeof(T);
+    }
+    else
+    {
+      memset(&value, 0, sizeof(T));
+      m_ok = false;
+    }
+    return *this;
+  }
+
+  CStreamInfoReader& operator>>(CStdString &str)
+  {
+    int size = 0;
+    *this >> size;
+    if (m_ok && size >= 0 && m_data.size() - m_pos >= (size_t)size)
+    {
+      str.assign(m_data, m_pos, size);
+      m_pos += size;
+    }
+    else
+    {
+      str.clear();
+      m_ok = false;
+    }
+    return *this;
+  }
+
+  bool IsOk() const { return m_ok; }
+  void SetFailed()   { m_ok = false; }
+
+private:
+  const std::string &m_data;
+  size_t             m_pos;
+  bool               m_ok;
+};
+
+bool CDVDDemuxStreamInfoEntry::Set(const AVFormatContext *context)
+{
+  m_format.clear();
+  m_streams.clear();
+  if (!context->iformat || !context->nb_streams || context->nb_streams > MAX_STREAMS)
+    return false;
+
+  m_format = context->iformat->name;
+  m_streams.resize(context->nb_streams);
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream       *st    = context->streams[i];
+    const AVCodecContext *codec = st->codec;
+    SStream              &entry = m_streams[i];
+    entry.id                    = st->id;
+    entry.type                  = codec->codec_type;
+    entry.codec_id              = codec->codec_id;
+    entry.codec_tag             = codec->codec_tag;
+    entry.width                 = codec->width;
+    entry.height                = codec->height;
+    entry.pix_fmt               = codec->pix_fmt;
+    entry.aspect_num            = st->sample_aspect_ratio.num;
+    entry.aspect_den            = st->sample_aspect_ratio.den;
+    entry.channels              = codec->channels;
+    entry.sample_rate           = codec->sample_rate;
+    entry.sample_fmt            = codec->sample_fmt;
+    entry.bits_per_coded_sample = codec->bits_per_coded_sample;
+    entry.block_align           = codec->block_align;
+    entry.bit_rate              = codec->bit_rate;
+    entry.profile               = codec->profile;
+    entry.level                 = codec->level;
+    entry.r_frame_rate_num      = st->r_frame_rate.num;
+    entry.r_frame_rate_den      = st->r_frame_rate.den;
+    entry.avg_frame_rate_num    = st->avg_frame_rate.num;
+    entry.avg_frame_rate_den    = st->avg_frame_rate.den;
+    entry.duration              = st->duration;
+
+    if (codec->extradata && codec->extradata_size > 0 && codec->extradata_size <= STREAMINFO_MAX_EXTRADATA)
+      entry.extradata.assign(codec->extradata, codec->extradata + codec->extradata_size);
+  }
+  return true;
+}
+
+void CDVDDemuxStreamInfoEntry::Serialize(const CStdString &file, int64_t length, int64_t mtime, std::string &data) const
+{
+  CStreamInfoWriter ar(data);
+  ar << (int)STREAMINFO_VERSION;
+  ar << file;
+  ar << length;
+  ar << mtime;
+  ar << m_format;
+  ar << (int)m_streams.size();
+  for (unsigned int i = 0; i < m_streams.size(); i++)
+  {
+    const SStream &st = m_streams[i];
+    ar << st.id;
+    ar << st.type;
+    ar << st.codec_id;
+    ar << st.codec_tag;
+    ar << st.width;
+    ar << st.height;
+    ar << st.pix_fmt;
+    ar << st.aspect_num;
+    ar << st.aspect_den;
+    ar << st.channels;
+    ar << st.sample_rate;
+    ar << st.sample_fmt;
+    ar << st.bits_per_coded_sample;
+    ar << st.block_align;
+    ar << st.bit_rate;
+    ar << st.profile;
+    ar << st.level;
+    ar << st.r_frame_rate_num;
+    ar << st.r_frame_rate_den;
+    ar << st.avg_frame_rate_num;
+    ar << st.avg_frame_rate_den;
+    ar << st.duration;
+
+    ar << (int)st.extradata.size();
+    data.append(st.extradata.begin(), st.extradata.end());
+  }
+}
+
+bool CDVDDemuxStreamInfoEntry::Unserialize(const CStdString &file, int64_t length, int64_t mtime, const std::string &data)
+{
+  m_format.clear();
+  m_streams.clear();
+
+  CStreamInfoReader ar(data);
+  int version = 0;
+  CStdString path;
+  int64_t size = 0;
+  int64_t modified = 0;
+  ar >> version;
+  if (version != STREAMINFO_VERSION)
+    return false;
+  ar >> path;
+  ar >> size;
+  ar >> modified;
+  if (path != file || size != length || modified != mtime)
+    return false;
+
+  ar >> m_format;
+  int count = 0;
+  ar >> count;
+  if (!ar.IsOk() || count <= 0 || count > MAX_STREAMS)
+    return false;
+
+  m_streams.resize(count);
+  for (int i = 0; i < count; i++)
+  {
+    SStream &st = m_streams[i];
+    ar >> st.id;
+    ar >> st.type;
+    ar >> st.codec_id;
+    ar >> st.codec_tag;
+    ar >> st.width;
+    ar >> st.height;
+    ar >> st.pix_fmt;
+    ar >> st.aspect_num;
+    ar >> st.aspect_den;
+    ar >> st.channels;
+    ar >> st.sample_rate;
+    ar >> st.sample_fmt;
+    ar >> st.bits_per_coded_sample;
+    ar >> st.block_align;
+    ar >> st.bit_rate;
+    ar >> st.profile;
+    ar >> st.level;
+    ar >> st.r_frame_rate_num;
+    ar >> st.r_frame_rate_den;
+    ar >> st.avg_frame_rate_num;
+    ar >> st.avg_frame_rate_den;
+    ar >> st.duration;
+
+    int extrasize = 0;
+    ar >> extrasize;
+    if (extrasize < 0 || extrasize > STREAMINFO_MAX_EXTRADATA)
+      ar.SetFailed();
+    else
+    {
+      st.extradata.resize(extrasize);
+      for (int j = 0; j < extrasize; j++)
+        ar >> st.extradata[j];
+    }
+    if (!ar.IsOk())
+    {
+      m_format.clear();
+      m_streams.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CDVDDemuxStreamInfoEntry::Apply(AVFormatContext *context) const
+{
+  // the short probe has to find the same streams, in the same order
+  if (strcmp(context->iformat->name, m_format.c_str()) != 0 || context->nb_streams != m_streams.size())
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream       *st    = context->streams[i];
+    const AVCodecContext *codec = st->codec;
+    const SStream        &cached = m_streams[i];
+
+    if (st->id != cached.id || codec->codec_type != cached.type)
+      return false;
+    if (codec->codec_id != CODEC_ID_NONE && codec->codec_id != CODEC_ID_PROBE && codec->codec_id != cached.codec_id)
+      return false;
+    if (codec->width && (codec->width != cached.width || codec->height != cached.height))
+      return false;
+  }
+
+  // fill in what the short probe didn't get to
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    AVStream       *st    = context->streams[i];
+    AVCodecContext *codec = st->codec;
+    const SStream  &cached = m_streams[i];
+
+    if (codec->codec_id == CODEC_ID_NONE || codec->codec_id == CODEC_ID_PROBE)
+    {
+      codec->codec_id  = (CodecID)cached.codec_id;
+      codec->codec_tag = cached.codec_tag;
+    }
+    if (!codec->width)
+    {
+      codec->width  = cached.width;
+      codec->height = cached.height;
+    }
+    if (codec->pix_fmt == PIX_FMT_NONE)
+      codec->pix_fmt = (PixelFormat)cached.pix_fmt;
+    if (!st->sample_aspect_ratio.num && cached.aspect_num)
+    {
+      st->sample_aspect_ratio.num = cached.aspect_num;
+      st->sample_aspect_ratio.den = cached.aspect_den;
+    }
+    if (!codec->channels)
+      codec->channels = cached.channels;
+    if (!codec->sample_rate)
+      codec->sample_rate = cached.sample_rate;
+    if (codec->sample_fmt == AV_SAMPLE_FMT_NONE)
+      codec->sample_fmt = (AVSampleFormat)cached.sample_fmt;
+    if (!codec->bits_per_coded_sample)
+      codec->bits_per_coded_sample = cached.bits_per_coded_sample;
+    if (!codec->block_align)
+      codec->block_align = cached.block_align;
+    if (!codec->bit_rate)
+      codec->bit_rate = cached.bit_rate;
+    if (codec->profile == FF_PROFILE_UNKNOWN)
+      codec->profile = cached.profile;
+    if (codec->level == FF_LEVEL_UNKNOWN)
+      codec->level = cached.level;
+    if (!st->r_frame_rate.num && cached.r_frame_rate_den)
+    {
+      st->r_frame_rate.num = cached.r_frame_rate_num;
+      st->r_frame_rate.den = cached.r_frame_rate_den;
+    }
+    if (!st->avg_frame_rate.num && cached.avg_frame_rate_den)
+    {
+      st->avg_frame_rate.num = cached.avg_frame_rate_num;
+      st->avg_frame_rate.den = cached.avg_frame_rate_den;
+    }
+    if (st->duration == (int64_t)AV_NOPTS_VALUE)
+      st->duration = cached.duration;
+  }
+  return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include <string>
+#include <vector>
+
+struct AVFormatContext;
+
+/*!
+ \brief The streams avformat_find_stream_info found in a file, as kept by CDVDDemuxStreamInfoCache
+
+ Holds no files or libraries, so it can be filled, serialized and applied on its own.
+ */
+class CDVDDemuxStreamInfoEntry
+{
+public:
+  /*! \brief Take the streams of a fully probed file
+   \return false if it has no streams, or more than the demuxer handles
+   */
+  bool Set(const AVFormatContext *context);
+
+  /*! \brief Append the entry of a file to data
+   */
+  void Serialize(const CStdString &file, int64_t length, int64_t mtime, std::string &data) const;
+
+  /*! \brief Read an entry written by Serialize
+   \return false if it's corrupt, of an other version, or of an other file, size or modification time
+   */
+  bool Unserialize(const CStdString &file, int64_t length, int64_t mtime, const std::string &data);
+
+  /*! \brief Check the streams of a short probe against the entry and complete their parameters
+   Extradata isn't allocated here, the caller copies it from GetExtradata() with the avutil it runs.
+   \return false if the streams differ, the context isn't touched then
+   */
+  bool Apply(AVFormatContext *context) const;
+
+  const CStdString &GetFormat() const { return m_format; }
+  const std::vector<char> &GetExtradata(unsigned int stream) const { return m_streams[stream].extradata; }
+
+private:
+  struct SStream
+  {
+    int      id;
+    int      type;
+    int      codec_id;
+    unsigned codec_tag;
+    int      width;
+    int      height;
+    int      pix_fmt;
+    int      aspect_num;
+    int      aspect_den;
+    int      channels;
+    int      sample_rate;
+    int      sample_fmt;
+    int      bits_per_coded_sample;
+    int      block_align;
+    int      bit_rate;
+    int      profile;
+    int      level;
+    int      r_frame_rate_num;
+    int      r_frame_rate_den;
+    int      avg_frame_rate_num;
+    int      avg_frame_rate_den;
+    int64_t  duration;
+    std::vector<char> extradata;
+  };
+
+  CStdString           m_format;
+  std::vector<SStream> m_streams;
+};
@@ -24,6 +24,9 @@
 #endif
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
+#include "DllAvCodec.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
@@ -37,13 +40,229 @@ extern "C" {
 #endif
 }
 
+#include <vector>
+
+// data buffers are pooled in size classes a quarter power of two apart (1KB, 1.25KB, 1.5KB,
+// 1.75KB, 2KB, 2.5KB ... 4MB), so at most a fifth of a buffer is unused. Larger ones come from the heap
+#define PACKET_CLASSES        49
+#define PACKET_CLASS_MIN      1024
+#define PACKET_POOL_MAX_BYTES (32 * 1024 * 1024) // free buffers kept for reuse
+#define PACKET_POOL_MAX_FREE  1024               // free packets kept for reuse
+
+enum PacketData
+{
+  PACKET_DATA_NONE = 0,
+  PACKET_DATA_POOLED,   ///< buffer of size class m_class from the pool
+  PACKET_DATA_HEAP,     ///< buffer too large for the pool
+  PACKET_DATA_AVPACKET  ///< data of the AVPacket m_avpkt
+};
+
+/*
+ A DemuxPacket is always allocated as the start of one of these, so FreeDemuxPacket
+ knows what the data is.
+ */
+struct SPooledPacket
+{
+  DemuxPacket m_packet;
+  PacketData  m_data;
+  int         m_class;
+  AVPacket    m_avpkt;
+};
+
+/*
+ Buffers and packets freed by the players are kept for the next packets the demuxer reads,
+ so playback doesn't hit the heap (and, for large buffers, mmap) for every packet.
+ Packets are read and freed on different threads, so the free lists are locked.
+
+ There is a single pool for the process. Its counters are global as well: they cover the
+ packets of every demuxer between BeginSession() and EndSession(), including those opened
+ for thumbnail extraction or stream details while playing.
+ */
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    m_freeBytes = 0;
+    m_wrapped = 0;
+    ResetStats();
+  }
+
+  ~CDemuxPacketPool()
+  {
+    Trim();
+  }
+
+  static CDemuxPacketPool &GetInstance()
+  {
+    static CDemuxPacketPool pool;
+    return pool;
+  }
+
+  SPooledPacket *AllocPacket()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_packets++;
+      if (!m_freePackets.empty())
+      {
+        SPooledPacket *packet = m_freePackets.back();
+        m_freePackets.pop_back();
+        return packet;
+      }
+    }
+    return new SPooledPacket;
+  }
+
+  void FreePacket(SPooledPacket *packet)
+  {
+    CSingleLock lock(m_section);
+    if (m_freePackets.size() < PACKET_POOL_MAX_FREE)
+      m_freePackets.push_back(packet);
+    else
+      delete packet;
+  }
+
+  /*! \brief Get a buffer for size bytes of data plus padding
+   \param size the size of the data
+   \param sizeClass [out] the size class of the buffer, -1 if it's from the heap
+   */
+  BYTE *AllocData(int size, int &sizeClass)
+  {
+    int needed = size + FF_INPUT_BUFFER_PADDING_SIZE;
+    sizeClass = 0;
+    while (sizeClass < PACKET_CLASSES && ClassSize(sizeClass) < needed)
+      sizeClass++;
+
+    CSingleLock lock(m_section);
+    m_copied++;
+    m_copiedBytes += size;
+    if (sizeClass == PACKET_CLASSES)
+    {
+      sizeClass = -1;
+      m_heapAllocs++;
+      lock.Leave();
+      return (BYTE*)_aligned_malloc(needed, 16);
+    }
+    std::vector<BYTE*> &freeData = m_freeData[sizeClass];
+    if (!freeData.empty())
+    {
+      BYTE *data = freeData.back();
+      freeData.pop_back();
+      m_freeBytes -= ClassSize(sizeClass);
+      m_poolHits++;
+      return data;
+    }
+    m_heapAllocs++;
+    lock.Leave();
+    return (BYTE*)_aligned_malloc(ClassSize(sizeClass), 16);
+  }
+
+  void FreeData(BYTE *data, int sizeClass)
+  {
+    if (sizeClass >= 0)
+    {
+      CSingleLock lock(m_section);
+      if (m_freeBytes + ClassSize(sizeClass) <= PACKET_POOL_MAX_BYTES)
+      {
+        m_freeData[sizeClass].push_back(data);
+        m_freeBytes += ClassSize(sizeClass);
+        return;
+      }
+    }
+    _aligned_free(data);
+  }
+
+  /*! \brief Account for taking over the data of an AVPacket, false if it couldn't be freed later on */
+  bool WrapData(AVPacket &pkt)
+  {
+    CSingleLock lock(m_section);
+    if (!m_dllAvCodec.IsLoaded() && !m_dllAvCodec.Load())
+      return false;
+    m_wrapped++;
+    m_wrappedPackets++;
+    m_wrappedBytes += pkt.size;
+    return true;
+  }
+
+  void FreeWrappedData(AVPacket &pkt)
+  {
+    CSingleLock lock(m_section);
+    m_dllAvCodec.av_free_packet(&pkt);
+    m_wrapped--;
+  }
+
+  void ResetStats()
+  {
+    CSingleLock lock(m_section);
+    m_packets = 0;
+    m_poolHits = 0;
+    m_heapAllocs = 0;
+    m_copied = 0;
+    m_copiedBytes = 0;
+    m_wrappedPackets = 0;
+    m_wrappedBytes = 0;
+  }
+
+  void LogStats()
+  {
+    CSingleLock lock(m_section);
+    CLog::Log(LOGDEBUG, "%s - %u packets: %u buffers from the pool, %u from the heap, %u copied (%"PRIu64" KB), %u by reference (%"PRIu64" KB)",
+              __FUNCTION__, m_packets, m_poolHits, m_heapAllocs, m_copied, m_copiedBytes / 1024, m_wrappedPackets, m_wrappedBytes / 1024);
+  }
+
+  /*! \brief Release the free buffers and packets, and avcodec if no packets reference its data */
+  void Trim()
+  {
+    CSingleLock lock(m_section);
+    for (int i = 0; i < PACKET_CLASSES; i++)
+    {
+      for (std::vector<BYTE*>::iterator it = m_freeData[i].begin(); it != m_freeData[i].end(); ++it)
+        _aligned_free(*it);
+      m_freeData[i].clear();
+    }
+    m_freeBytes = 0;
+    for (std::vector<SPooledPacket*>::iterator it = m_freePackets.begin(); it != m_freePackets.end(); ++it)
+      delete *it;
+    m_freePackets.clear();
+    if (m_wrapped == 0 && m_dllAvCodec.IsLoaded())
+      m_dllAvCodec.Unload();
+  }
+
+private:
+  static int ClassSize(int sizeClass) { return (PACKET_CLASS_MIN + (sizeClass & 3) * (PACKET_CLASS_MIN / 4)) << (sizeClass >> 2); }
+
+  CCriticalSection m_section;
+  std::vector<BYTE*> m_freeData[PACKET_CLASSES];
+  std::vector<SPooledPacket*> m_freePackets;
+  unsigned int m_freeBytes;
+  unsigned int m_wrapped;   ///< packets referencing AVPacket data, which need avcodec to be freed
+  DllAvCodec m_dllAvCodec;
+
+  // counters since BeginSession(), for all demuxers
+  unsigned int m_packets;
+  unsigned int m_poolHits;
+  unsigned int m_heapAllocs;
+  unsigned int m_copied;
+  uint64_t     m_copiedBytes;
+  unsigned int m_wrappedPackets;
+  uint64_t     m_wrappedBytes;
+};
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      CDemuxPacketPool &pool = CDemuxPacketPool::GetInstance();
+      SPooledPacket *packet = (SPooledPacket*)pPacket;
+      if (packet->m_data == PACKET_DATA_POOLED)
+        pool.FreeData(pPacket->pData, packet->m_class);
+      else if (packet->m_data == PACKET_DATA_HEAP)
+        pool.FreeData(pPacket->pData, -1);
+      else if (packet->m_data == PACKET_DATA_AVPACKET)
+        pool.FreeWrappedData(packet->m_avpkt);
+      pool.FreePacket(packet);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -51,14 +270,29 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
   }
 }
 
-DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
+static SPooledPacket *AllocatePooledPacket()
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  SPooledPacket* packet = CDemuxPacketPool::GetInstance().AllocPacket();
+  if (!packet) return NULL;
+
+  memset(&packet->m_packet, 0, sizeof(DemuxPacket));
+  packet->m_data = PACKET_DATA_NONE;
+  packet->m_class = -1;
 
+  // setup defaults
+  packet->m_packet.dts       = DVD_NOPTS_VALUE;
+  packet->m_packet.pts       = DVD_NOPTS_VALUE;
+  packet->m_packet.iStreamId = -1;
+  return packet;
+}
+
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
+{
+  SPooledPacket* packet = NULL;
   try
   {
-    memset(pPacket, 0, sizeof(DemuxPacket));
+    packet = AllocatePooledPacket();
+    if (!packet) return NULL;
 
     if (iDataSize > 0)
     {
@@ -71,27 +305,58 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
+      packet->m_packet.pData = CDemuxPacketPool::GetInstance().AllocData(iDataSize, packet->m_class);
+      if (!packet->m_packet.pData)
       {
-        FreeDemuxPacket(pPacket);
+        FreeDemuxPacket(&packet->m_packet);
         return NULL;
       }
+      packet->m_data = packet->m_class >= 0 ? PACKET_DATA_POOLED : PACKET_DATA_HEAP;
 
       // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+      memset(packet->m_packet.pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
     }
-
-    // setup defaults
-    pPacket->dts       = DVD_NOPTS_VALUE;
-    pPacket->pts       = DVD_NOPTS_VALUE;
-    pPacket->iStreamId = -1;
   }
   catch(...)
   {
     CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
-    FreeDemuxPacket(pPacket);
-    pPacket = NULL;
+    if (packet)
+      FreeDemuxPacket(&packet->m_packet);
+    packet = NULL;
   }
-  return pPacket;
+  return packet ? &packet->m_packet : NULL;
+}
+
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(AVPacket &pkt)
+{
+  if (!pkt.data || !pkt.destruct)
+    return NULL;
+
+  SPooledPacket* packet = AllocatePooledPacket();
+  if (!packet) return NULL;
+
+  if (!CDemuxPacketPool::GetInstance().WrapData(pkt))
+  {
+    FreeDemuxPacket(&packet->m_packet);
+    return NULL;
+  }
+  packet->m_avpkt = pkt;
+  packet->m_data = PACKET_DATA_AVPACKET;
+  packet->m_packet.pData = pkt.data;
+  packet->m_packet.iSize = pkt.size;
+  // the data is ours now, av_free_packet on pkt only resets it
+  pkt.destruct = NULL;
+  return &packet->m_packet;
+}
+
+void CDVDDemuxUtils::BeginSession()
+{
+  CDemuxPacketPool::GetInstance().ResetStats();
+}
+
+void CDVDDemuxUtils::EndSession()
+{
+  CDemuxPacketPool &pool = CDemuxPacketPool::GetInstance();
+  pool.LogStats();
+  pool.Trim();
 }
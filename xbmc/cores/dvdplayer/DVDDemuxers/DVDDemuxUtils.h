@@ -23,10 +23,27 @@
 
 #include "DVDDemux.h"
 
+struct AVPacket;
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /*! \brief Allocate a packet referencing the data of an AVPacket rather than a copy of it
+   The packet takes over the data and pkt is left without a destructor. The data must own its
+   buffer (see av_dup_packet) and be padded by FF_INPUT_BUFFER_PADDING_SIZE.
+   \return the packet, NULL if the data can't be referenced and needs copying instead
+   */
+  static DemuxPacket* AllocateDemuxPacket(AVPacket &pkt);
+
+  /*! \brief Reset the packet counters at the start of playback
+   The counters are shared by all demuxers, so packets of other demuxers open meanwhile are counted too.
+   */
+  static void BeginSession();
+
+  /*! \brief Log the packet counters and release the pooled buffers at the end of playback */
+  static void EndSession();
 };
 
@@ -146,6 +146,12 @@ public:
    */
   virtual unsigned GetReadRate() { return 0; }
 
+  /*! \brief Indicate a region of the stream that will be read again,
+   *  such as an index, so that it can be kept in the cache.
+   *  Should be seen as only a hint
+   */
+  virtual void SetKeepRegion(__int64 offset, __int64 length) {}
+
   bool IsStreamType(DVDStreamType type) const { return m_streamType == type; }
   virtual bool IsEOF() = 0;
   virtual int GetCurrentGroupId() { return 0; }
@@ -26,6 +26,10 @@
 
 using namespace XFILE;
 
+// regions at the start and end of a file that likely hold headers and indexes
+#define KEEP_HEADER_SIZE (1024 * 1024)
+#define KEEP_INDEX_SIZE  (8 * 1024 * 1024)
+
 CDVDInputStreamFile::CDVDInputStreamFile() : CDVDInputStream(DVDSTREAM_TYPE_FILE)
 {
   m_pFile = NULL;
@@ -62,6 +66,9 @@ bool CDVDInputStreamFile::Open(const char* strFile, const std::string& content)
   if (m_pFile->GetImplemenation() && (content.empty() || content == "application/octet-stream"))
     m_content = m_pFile->GetImplemenation()->GetContent();
 
+  // the headers are parsed again on stream changes, keep them around
+  SetKeepRegion(0, KEEP_HEADER_SIZE);
+
   m_eof = true;
   return true;
 }
@@ -101,6 +108,12 @@ __int64 CDVDInputStreamFile::Seek(__int64 offset, int whence)
 
   __int64 ret = m_pFile->Seek(offset, whence);
 
+  /* a jump to the tail of the file is most likely a read of an index (mp4 moov, *
+   * mkv cues), which will be consulted on each seek, so ask to keep it cached   */
+  __int64 length = m_pFile->GetLength();
+  if( ret >= 0 && length > KEEP_INDEX_SIZE * 4 && ret >= length - KEEP_INDEX_SIZE )
+    SetKeepRegion(ret, length - ret);
+
   /* if we succeed, we are not eof anymore */
   if( ret >= 0 ) m_eof = false;
 
@@ -156,6 +169,15 @@ int CDVDInputStreamFile::GetBlockSize()
     return 0;
 }
 
+void CDVDInputStreamFile::SetKeepRegion(__int64 offset, __int64 length)
+{
+  SCacheRange range;
+  range.offset = offset;
+  range.length = length;
+  if(m_pFile)
+    m_pFile->IoControl(IOCTRL_CACHE_KEEP, &range);
+}
+
 void CDVDInputStreamFile::SetReadRate(unsigned rate)
 {
   unsigned maxrate = rate + 1024 * 1024 / 8;
@@ -40,6 +40,7 @@ public:
   virtual __int64 GetCachedBytes();
   virtual void SetReadRate(unsigned rate);
   virtual unsigned GetReadRate();
+  virtual void SetKeepRegion(__int64 offset, __int64 length);
 
 protected:
   XFILE::CFile* m_pFile;
@@ -28,7 +28,45 @@
 
 using namespace std;
 
-CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
+// number of priority zero messages that fit in the ring, messages
+// beyond that go to the overflow list until the consumer catches up
+#define MSGQ_RING_SIZE 1024
+
+CDVDMessageRing::CDVDMessageRing(unsigned int size)
+{
+  m_items = new CDVDMsg*[size];
+  m_mask  = size - 1;
+  m_read  = 0;
+  m_write = 0;
+}
+
+CDVDMessageRing::~CDVDMessageRing()
+{
+  delete[] m_items;
+}
+
+bool CDVDMessageRing::Push(CDVDMsg* msg)
+{
+  unsigned int next = (m_write + 1) & m_mask;
+  if (next == m_read)
+    return false;
+
+  m_items[m_write] = msg;
+  m_write = next;
+  return true;
+}
+
+CDVDMsg* CDVDMessageRing::Pop()
+{
+  if (m_read == m_write)
+    return NULL;
+
+  CDVDMsg* msg = m_items[m_read];
+  m_read = (m_read + 1) & m_mask;
+  return msg;
+}
+
+CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true), m_ring(MSGQ_RING_SIZE)
 {
   m_owner = owner;
   m_iDataSize     = 0;
@@ -45,7 +83,7 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
 CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
-  Flush();
+  Flush(CDVDMsg::NONE);
 }
 
 void CDVDMessageQueue::Init()
@@ -70,6 +108,21 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
       it++;
   }
 
+  // rebuild the data path with the messages we keep, in order
+  deque<CDVDMsg*> keep;
+  while (CDVDMsg* msg = m_ring.Pop())
+    keep.push_back(msg);
+  keep.insert(keep.end(), m_overflow.begin(), m_overflow.end());
+  m_overflow.clear();
+
+  for (deque<CDVDMsg*>::iterator it = keep.begin(); it != keep.end(); it++)
+  {
+    if ((*it)->IsType(type) || type == CDVDMsg::NONE)
+      (*it)->Release();
+    else if (!m_overflow.empty() || !m_ring.Push(*it))
+      m_overflow.push_back(*it);
+  }
+
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
     m_iDataSize = 0;
@@ -99,6 +152,12 @@ void CDVDMessageQueue::End()
   m_bAbortRequest = false;
 }
 
+void CDVDMessageQueue::DrainOverflow()
+{
+  // called with m_section held
+  while (!m_overflow.empty() && m_ring.Push(m_overflow.front()))
+    m_overflow.pop_front();
+}
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 {
@@ -116,67 +175,88 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
+  if (priority != 0)
   {
-    if(priority <= it->priority)
-      break;
-    it++;
-  }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
+    SList::iterator it = m_list.begin();
+    while(it != m_list.end())
+    {
+      if(priority <= it->priority)
+        break;
+      it++;
+    }
+    m_list.insert(it, DVDMessageListItem(pMsg, priority));
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+    pMsg->Release();
+  }
+  else
   {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if(packet)
+    if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
     {
-      m_iDataSize += packet->iSize;
-      if     (packet->dts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->dts;
-      else if(packet->pts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->pts;
-      if(m_TimeBack == DVD_NOPTS_VALUE)
-        m_TimeBack = m_TimeFront;
+      DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+      if(packet)
+      {
+        m_iDataSize += packet->iSize;
+        if     (packet->dts != DVD_NOPTS_VALUE)
+          m_TimeFront = packet->dts;
+        else if(packet->pts != DVD_NOPTS_VALUE)
+          m_TimeFront = packet->pts;
+        if(m_TimeBack == DVD_NOPTS_VALUE)
+          m_TimeBack = m_TimeFront;
+      }
     }
-  }
 
-  pMsg->Release();
+    // the ring takes over our reference
+    DrainOverflow();
+    if (!m_overflow.empty() || !m_ring.Push(pMsg))
+      m_overflow.push_back(pMsg);
+  }
 
   m_hEvent.Set(); // inform waiter for new packet
 
   return MSGQ_OK;
 }
 
-MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+bool CDVDMessageQueue::ReceivePriority(CDVDMsg** pMsg, int &priority, bool above)
 {
-  CSingleLock lock(m_section);
-
-  *pMsg = NULL;
-
-  int ret = 0;
+  // called with m_section held
+  if (m_list.empty())
+    return false;
+
+  DVDMessageListItem& item(m_list.back());
+  if (item.priority < priority || (above && item.priority < 0))
+    return false;
+
+  priority = item.priority;
+  *pMsg = item.message->Acquire();
+  m_list.pop_back();
+  return true;
+}
 
-  if (!m_bInitialized)
-  {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
-    return MSGQ_NOT_INITIALIZED;
-  }
+bool CDVDMessageQueue::Receive(CDVDMsg** pMsg, int &priority)
+{
+  // called with m_section held
+  if (m_bCaching)
+    return false;
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
-  {
-    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
-    m_bEmptied = true;
-  }
+  // priority messages above zero go ahead of the data path
+  if (ReceivePriority(pMsg, priority, true))
+    return true;
 
-  while (!m_bAbortRequest)
+  if (priority <= 0)
   {
-    if(!m_list.empty() && m_list.back().priority >= priority && !m_bCaching)
+    CDVDMsg* msg = m_ring.Pop();
+    if (!msg && !m_overflow.empty())
     {
-      DVDMessageListItem& item(m_list.back());
-      priority = item.priority;
+      DrainOverflow();
+      msg = m_ring.Pop();
+    }
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+    if (msg)
+    {
+      priority = 0;
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
+        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)msg)->GetPacket();
         if(packet)
         {
           m_iDataSize -= packet->iSize;
@@ -190,9 +270,40 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
           m_bEmptied = false;
       }
 
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      // the reference held by the ring goes to the caller
+      *pMsg = msg;
+      return true;
+    }
+  }
+
+  // and anything below it last
+  return ReceivePriority(pMsg, priority, false);
+}
 
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  CSingleLock lock(m_section);
+
+  *pMsg = NULL;
+
+  int ret = 0;
+
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  if(m_ring.IsEmpty() && m_overflow.empty() && m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
+  {
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
+    m_bEmptied = true;
+  }
+
+  while (!m_bAbortRequest)
+  {
+    if (Receive(pMsg, priority))
+    {
       ret = MSGQ_OK;
       break;
     }
@@ -233,6 +344,16 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(it->message->IsType(type))
       count++;
   }
+  for(unsigned int i = 0; i < m_ring.Size(); i++)
+  {
+    if(m_ring.At(i)->IsType(type))
+      count++;
+  }
+  for(deque<CDVDMsg*>::iterator it = m_overflow.begin(); it != m_overflow.end(); it++)
+  {
+    if((*it)->IsType(type))
+      count++;
+  }
 
   return count;
 }
@@ -248,6 +369,8 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
+  CSingleLock lock(m_section);
+
   if(m_iDataSize > m_iMaxDataSize)
     return 100;
   if(m_iDataSize == 0)
@@ -261,6 +384,8 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
+  CSingleLock lock(m_section);
+
   if(IsDataBased())
     return 0;
   else
@@ -269,6 +394,7 @@ int CDVDMessageQueue::GetTimeSize() const
 
 bool CDVDMessageQueue::IsDataBased() const
 {
+  CSingleLock lock(m_section);
   return (m_TimeBack == DVD_NOPTS_VALUE  ||
           m_TimeFront == DVD_NOPTS_VALUE ||
           m_TimeFront <= m_TimeBack);
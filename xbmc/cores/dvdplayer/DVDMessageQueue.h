@@ -24,6 +24,7 @@
 #include "DVDMessage.h"
 #include <string>
 #include <list>
+#include <deque>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -69,6 +70,32 @@ struct DVDMessageListItem
   int      priority;
 };
 
+/**
+ * Bounded ring of messages, allocated once so queueing a message
+ * doesn't allocate a list node. Not thread safe, the owner locks it.
+ */
+class CDVDMessageRing
+{
+public:
+  CDVDMessageRing(unsigned int size);  // size must be a power of two
+  ~CDVDMessageRing();
+
+  // returns false if the ring is full
+  bool     Push(CDVDMsg* msg);
+  // returns NULL if the ring is empty
+  CDVDMsg* Pop();
+
+  bool         IsEmpty() const { return m_read == m_write; }
+  unsigned int Size() const    { return (m_write - m_read) & m_mask; }
+  CDVDMsg*     At(unsigned int index) const { return m_items[(m_read + index) & m_mask]; }
+
+private:
+  CDVDMsg**    m_items;
+  unsigned int m_mask;
+  unsigned int m_read;
+  unsigned int m_write;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK               = 1,
@@ -125,6 +152,10 @@ public:
 
 private:
 
+  bool Receive(CDVDMsg** pMsg, int &priority);
+  bool ReceivePriority(CDVDMsg** pMsg, int &priority, bool above);
+  void DrainOverflow();
+
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
@@ -141,7 +172,13 @@ private:
   bool m_bEmptied;
   std::string m_owner;
 
+  // priority (non zero) messages, sorted by priority
   typedef std::list<DVDMessageListItem> SList;
   SList m_list;
+
+  // priority zero messages (demuxer packets and in-stream control messages)
+  CDVDMessageRing m_ring;
+  // messages that didn't fit into the ring, they go in before any new message
+  std::deque<CDVDMsg*> m_overflow;
 };
 
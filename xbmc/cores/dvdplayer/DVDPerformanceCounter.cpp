@@ -117,6 +117,30 @@ HRESULT __stdcall DVDPerformanceCounterMainPerformance(PLARGE_INTEGER numerator,
   return S_OK;
 }
 
+HRESULT __stdcall DVDPerformanceCounterVideoRenderQueue(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = g_dvdPerformanceCounter.m_renderPerformance.queued;
+  return S_OK;
+}
+
+HRESULT __stdcall DVDPerformanceCounterVideoLateFrames(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = g_dvdPerformanceCounter.m_renderPerformance.late;
+  return S_OK;
+}
+
+HRESULT __stdcall DVDPerformanceCounterVideoSkippedFrames(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = g_dvdPerformanceCounter.m_renderPerformance.skipped;
+  return S_OK;
+}
+
+HRESULT __stdcall DVDPerformanceCounterVideoDroppedFrames(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = g_dvdPerformanceCounter.m_renderPerformance.dropped;
+  return S_OK;
+}
+
 CDVDPerformanceCounter g_dvdPerformanceCounter;
 
 CDVDPerformanceCounter::CDVDPerformanceCounter()
@@ -127,6 +151,7 @@ CDVDPerformanceCounter::CDVDPerformanceCounter()
   memset(&m_videoDecodePerformance, 0, sizeof(m_videoDecodePerformance)); // video decoding
   memset(&m_audioDecodePerformance, 0, sizeof(m_audioDecodePerformance)); // audio decoding + output to audio device
   memset(&m_mainPerformance,        0, sizeof(m_mainPerformance));        // reading files, demuxing, decoding of subtitles + menu overlays
+  memset(&m_renderPerformance,      0, sizeof(m_renderPerformance));      // render queue of the video player
 
   Initialize();
 }
@@ -147,6 +172,10 @@ bool CDVDPerformanceCounter::Initialize()
   DmRegisterPerformanceCounter("DVDVideoDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterVideoDecodePerformance);
   DmRegisterPerformanceCounter("DVDAudioDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterAudioDecodePerformance);
   DmRegisterPerformanceCounter("DVDMainPerformance",          DMCOUNT_SYNC, DVDPerformanceCounterMainPerformance);
+  DmRegisterPerformanceCounter("DVDVideoRenderQueue",         DMCOUNT_SYNC, DVDPerformanceCounterVideoRenderQueue);
+  DmRegisterPerformanceCounter("DVDVideoLateFrames",          DMCOUNT_SYNC, DVDPerformanceCounterVideoLateFrames);
+  DmRegisterPerformanceCounter("DVDVideoSkippedFrames",       DMCOUNT_SYNC, DVDPerformanceCounterVideoSkippedFrames);
+  DmRegisterPerformanceCounter("DVDVideoDroppedFrames",       DMCOUNT_SYNC, DVDPerformanceCounterVideoDroppedFrames);
 
 #endif
 
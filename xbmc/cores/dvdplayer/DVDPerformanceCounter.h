@@ -36,6 +36,18 @@ typedef struct stProcessPerformance
   HANDLE          hThread;
 } ProcessPerformance;
 
+typedef struct stRenderPerformance
+{
+  unsigned int late;      // frames presented more than a refresh after their time
+  unsigned int skipped;   // queued frames never presented as a later frame was already due
+  unsigned int dropped;   // frames dropped by the player before reaching the render queue
+  unsigned int queued;    // frames waiting in the render queue
+  unsigned int queuesize; // frames the render queue can hold
+  unsigned int direct;    // frames decoded straight into a buffer of the renderer
+  unsigned int copied;    // frames copied into a buffer of the renderer
+  uint64_t     copiedbytes;
+} RenderPerformance;
+
 class CDVDPerformanceCounter
 {
 public:
@@ -57,6 +69,15 @@ public:
   void EnableAudioDecodePerformance(HANDLE hThread) { CSingleLock lock(m_critSection); m_audioDecodePerformance.hThread = hThread;  }
   void DisableAudioDecodePerformance()              { CSingleLock lock(m_critSection); m_audioDecodePerformance.hThread = NULL;  }
 
+  void AddVideoLateFrame()                          { CSingleLock lock(m_critSection); m_renderPerformance.late++; }
+  void AddVideoSkippedFrame()                       { CSingleLock lock(m_critSection); m_renderPerformance.skipped++; }
+  void AddVideoDroppedFrame()                       { CSingleLock lock(m_critSection); m_renderPerformance.dropped++; }
+  void AddVideoDirectFrame()                        { CSingleLock lock(m_critSection); m_renderPerformance.direct++; }
+  void AddVideoCopiedFrame(unsigned int bytes)      { CSingleLock lock(m_critSection); m_renderPerformance.copied++; m_renderPerformance.copiedbytes += bytes; }
+  void SetVideoRenderQueue(unsigned int queued, unsigned int size) { CSingleLock lock(m_critSection); m_renderPerformance.queued = queued; m_renderPerformance.queuesize = size; }
+  void ResetVideoRenderPerformance()                { CSingleLock lock(m_critSection); memset(&m_renderPerformance, 0, sizeof(m_renderPerformance)); }
+  RenderPerformance GetVideoRenderPerformance()     { CSingleLock lock(m_critSection); return m_renderPerformance; }
+
   void EnableMainPerformance(HANDLE hThread)        { CSingleLock lock(m_critSection); m_mainPerformance.hThread = hThread;  }
   void DisableMainPerformance()                     { CSingleLock lock(m_critSection); m_mainPerformance.hThread = NULL;  }
 
@@ -67,6 +88,8 @@ public:
   ProcessPerformance        m_audioDecodePerformance;
   ProcessPerformance        m_mainPerformance;
 
+  RenderPerformance         m_renderPerformance;
+
 private:
   CCriticalSection m_critSection;
 };
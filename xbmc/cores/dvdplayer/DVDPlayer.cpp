@@ -316,6 +316,7 @@ CDVDPlayer::CDVDPlayer(IPlayerCallback& callback)
 
   m_bAbortRequest = false;
   m_errorCount = 0;
+  m_startTime = 0;
   m_playSpeed = DVD_PLAYSPEED_NORMAL;
   m_caching = CACHESTATE_DONE;
   
@@ -435,6 +436,8 @@ void CDVDPlayer::OnStartup()
 
   g_dvdPerformanceCounter.EnableMainPerformance(ThreadHandle());
 
+  CDVDDemuxUtils::BeginSession();
+
   CUtil::ClearTempFonts();
 }
 
@@ -907,11 +910,15 @@ bool CDVDPlayer::IsBetterStream(CCurrentStream& current, CDemuxStream* stream)
 
 void CDVDPlayer::Process()
 {
+  m_startTime = CurrentHostCounter();
+  double freq = (double)CurrentHostFrequency() / 1000.0;
+
   if (!OpenInputStream())
   {
     m_bAbortRequest = true;
     return;
   }
+  CLog::Log(LOGDEBUG, "CDVDPlayer::Process - input stream opened after %.1f ms", (CurrentHostCounter() - m_startTime) / freq);
 
   if(m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD))
   {
@@ -932,6 +939,7 @@ void CDVDPlayer::Process()
     m_bAbortRequest = true;
     return;
   }
+  CLog::Log(LOGDEBUG, "CDVDPlayer::Process - demuxer opened after %.1f ms", (CurrentHostCounter() - m_startTime) / freq);
 
   // allow renderer to switch to fullscreen if requested
   m_dvdPlayerVideo.EnableFullscreen(m_PlayerOptions.fullscreen);
@@ -1923,6 +1931,7 @@ void CDVDPlayer::OnExit()
 
     m_messenger.End();
 
+    CDVDDemuxUtils::EndSession();
   }
   catch (...)
   {
@@ -2181,6 +2190,15 @@ void CDVDPlayer::HandleMessages()
         if(player == DVDPLAYER_VIDEO)
           m_CurrentVideo.started = true;
         CLog::Log(LOGDEBUG, "CDVDPlayer::HandleMessages - player started %d", player);
+
+        if (m_startTime)
+        {
+          CLog::Log(LOGDEBUG, "CDVDPlayer::HandleMessages - player %d started after %.1f ms", player
+                  , (CurrentHostCounter() - m_startTime) * 1000.0 / CurrentHostFrequency());
+          if((m_CurrentVideo.id < 0 || m_CurrentVideo.started)
+          && (m_CurrentAudio.id < 0 || m_CurrentAudio.started))
+            m_startTime = 0;
+        }
       }
     }
     catch (...)
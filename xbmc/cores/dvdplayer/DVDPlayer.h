@@ -344,6 +344,7 @@ protected:
 
   int m_errorCount;
   double m_offset_pts;
+  int64_t m_startTime; // host counter at the start of Process, 0 once every stream started
 
   CDVDMessageQueue m_messenger;     // thread messenger
 
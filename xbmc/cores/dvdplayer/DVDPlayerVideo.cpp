@@ -182,7 +182,7 @@ bool CDVDPlayerVideo::OpenStream( CDVDStreamInfo &hint )
 #endif
 
   CLog::Log(LOGNOTICE, "Creating video codec with codec id: %i", hint.codec);
-  CDVDVideoCodec* codec = CDVDFactoryCodec::CreateVideoCodec(hint, surfaces);
+  CDVDVideoCodec* codec = CDVDFactoryCodec::CreateVideoCodec(hint, surfaces, g_advancedSettings.m_videoDirectRendering);
   if(!codec)
   {
     CLog::Log(LOGERROR, "Unsupported video codec");
@@ -284,6 +284,7 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
 void CDVDPlayerVideo::OnStartup()
 {
   m_iDroppedFrames = 0;
+  m_delayedPictures.Reset();
 
   m_crop.x1 = m_crop.x2 = 0.0f;
   m_crop.y1 = m_crop.y2 = 0.0f;
@@ -292,6 +293,7 @@ void CDVDPlayerVideo::OnStartup()
   m_FlipTimeStamp = m_pClock->GetAbsoluteClock();
 
   g_dvdPerformanceCounter.EnableVideoDecodePerformance(ThreadHandle());
+  g_dvdPerformanceCounter.ResetVideoRenderPerformance();
 }
 
 void CDVDPlayerVideo::Process()
@@ -415,6 +417,8 @@ void CDVDPlayerVideo::Process()
         m_pVideoCodec->Reset();
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
       m_packets.clear();
+      m_delayedPictures.Reset();
+      g_renderManager.DiscardBuffer();
       m_started = false;
     }
     else if (pMsg->IsType(CDVDMsg::GENERAL_FLUSH)) // private message sent by (CDVDPlayerVideo::Flush())
@@ -423,6 +427,8 @@ void CDVDPlayerVideo::Process()
         m_pVideoCodec->Reset();
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
       m_packets.clear();
+      m_delayedPictures.Reset();
+      g_renderManager.DiscardBuffer();
 
       m_pullupCorrection.Flush();
       //we need to recalculate the framerate
@@ -458,6 +464,16 @@ void CDVDPlayerVideo::Process()
       msg->m_codec = NULL;
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
     }
+    else if (pMsg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      // push out the pictures the decoder holds back with an empty packet each
+      if (m_pVideoCodec)
+      {
+        unsigned int drain = m_delayedPictures.BeginDrain(m_pVideoCodec->GetDelayedPictures());
+        for (unsigned int i = 0; i < drain; i++)
+          m_messageQueue.Put(new CDVDMsgDemuxerPacket(CDVDDemuxUtils::AllocateDemuxPacket(0)));
+      }
+    }
 
     if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
     {
@@ -520,7 +536,17 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
-      int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      // when the decoder holds pictures back, the picture coming out isn't the one of this
+      // packet, so remember which ones are to be dropped by their pts
+      bool bDelayed = m_pVideoCodec->GetDelayedPictures() > 0;
+      if (bDelayed && bPacketDrop)
+        m_delayedPictures.DropPacket(pPacket->pts);
+
+      int iDecoderState;
+      if (m_delayedPictures.IsDrainPacket(pPacket->iSize))
+        iDecoderState = m_pVideoCodec->Drain();
+      else
+        iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -539,6 +565,7 @@ void CDVDPlayerVideo::Process()
       if(bRequestDrop && !bPacketDrop && (iDecoderState & VC_BUFFER) && !(iDecoderState & VC_PICTURE))
       {
         m_iDroppedFrames++;
+        g_dvdPerformanceCounter.AddVideoDroppedFrame();
         iDropped++;
       }
 
@@ -588,7 +615,11 @@ void CDVDPlayerVideo::Process()
             if(picture.iDuration == 0.0)
               picture.iDuration = frametime;
 
-            if(bPacketDrop)
+            bool bPictureDrop = bPacketDrop;
+            if (bDelayed && picture.pts != DVD_NOPTS_VALUE)
+              bPictureDrop = m_delayedPictures.IsPictureDropped(picture.pts);
+
+            if(bPictureDrop)
               picture.iFlags |= DVP_FLAG_DROPPED;
 
             if (m_iNrOfPicturesNotToSkip > 0)
@@ -672,6 +703,10 @@ void CDVDPlayerVideo::Process()
             CDVDCodecUtils::FreePicture(pTempYUVPackedPicture);
 #endif
 
+            // a directly rendered picture is handed over to the renderer, it can't be output again on a stall
+            if (picture.iFlags & DVP_FLAG_DIRECT)
+              picture.iFlags &= ~DVP_FLAG_ALLOCATED;
+
             if(m_started == false)
             {
               m_codecname = m_pVideoCodec->GetName();
@@ -696,6 +731,7 @@ void CDVDPlayerVideo::Process()
             if( (iResult & EOS_DROPPED) && !bPacketDrop )
             {
               m_iDroppedFrames++;
+              g_dvdPerformanceCounter.AddVideoDroppedFrame();
               iDropped++;
             }
             else
@@ -745,6 +781,13 @@ void CDVDPlayerVideo::OnExit()
 {
   g_dvdPerformanceCounter.DisableVideoDecodePerformance();
 
+  RenderPerformance render = g_dvdPerformanceCounter.GetVideoRenderPerformance();
+  CLog::Log(LOGDEBUG, "CDVDPlayerVideo - render queue of %u frames, %u late, %u skipped, %u dropped",
+            render.queuesize, render.late, render.skipped, render.dropped);
+  if (render.direct + render.copied)
+    CLog::Log(LOGDEBUG, "CDVDPlayerVideo - %u frames rendered directly, %u copied, %.1f KiB copied per frame",
+              render.direct, render.copied, render.copiedbytes / 1024.0 / (render.direct + render.copied));
+
   if (m_pOverlayCodecCC)
   {
     m_pOverlayCodecCC->Dispose();
@@ -1495,6 +1538,10 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   s << ", Mb/s:" << fixed << setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", drop:" << m_iDroppedFrames;
 
+  RenderPerformance render = g_dvdPerformanceCounter.GetVideoRenderPerformance();
+  s << ", rq:" << render.queued << "/" << render.queuesize;
+  s << ", late:" << render.late << ", skip:" << render.skipped;
+
   int pc = m_pullupCorrection.GetPatternLength();
   if (pc > 0)
     s << ", pc:" << pc;
@@ -28,6 +28,7 @@
 #include "DVDClock.h"
 #include "DVDOverlayContainer.h"
 #include "DVDTSCorrection.h"
+#include "DVDDelayedPictures.h"
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
 #endif
@@ -172,6 +173,8 @@ protected:
   int m_iNrOfPicturesNotToSkip;
   int m_speed;
 
+  CDVDDelayedPictures m_delayedPictures; ///< for decoders holding pictures back, like frame threaded ffmpeg
+
   double m_droptime;
   double m_dropbase;
 
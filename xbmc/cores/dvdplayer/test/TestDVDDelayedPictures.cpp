@@ -0,0 +1,271 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "cores/dvdplayer/DVDDelayedPictures.h"
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoCodec.h"
+
+#include <deque>
+#include <boost/test/unit_test.hpp>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+#define PACKET_DURATION (DVD_TIME_BASE / 25)
+
+// a decoder holding back up to delay pictures, reordering them to pts order like
+// frame threaded ffmpeg does with b-frames
+class CFakeDelayingCodec : public CDVDVideoCodec
+{
+public:
+  CFakeDelayingCodec(unsigned int delay) : m_delay(delay), m_drained(0) {}
+
+  virtual bool Open(CDVDStreamInfo &hints, CDVDCodecOptions &options) { return true; }
+  virtual void Dispose() {}
+  virtual void Reset() { m_pending.clear(); }
+  virtual void SetDropState(bool bDrop) {}
+  virtual const char* GetName() { return "fake"; }
+
+  virtual int Decode(BYTE* pData, int iSize, double dts, double pts)
+  {
+    if (!pData)
+      return VC_BUFFER;
+    m_pending.insert(pts);
+    if (m_pending.size() > m_delay)
+      return Output();
+    return VC_BUFFER;
+  }
+
+  virtual bool GetPicture(DVDVideoPicture* pDvdVideoPicture)
+  {
+    memset(pDvdVideoPicture, 0, sizeof(DVDVideoPicture));
+    pDvdVideoPicture->pts = m_picture;
+    pDvdVideoPicture->dts = DVD_NOPTS_VALUE;
+    return true;
+  }
+
+  virtual unsigned GetDelayedPictures() { return m_delay; }
+
+  virtual int Drain()
+  {
+    m_drained++;
+    if (m_pending.empty())
+      return VC_BUFFER;
+    return Output();
+  }
+
+  unsigned int m_drained;
+
+private:
+  int Output()
+  {
+    m_picture = *m_pending.begin();
+    m_pending.erase(m_pending.begin());
+    return VC_PICTURE | VC_BUFFER;
+  }
+
+  unsigned int m_delay;
+  std::multiset<double> m_pending;
+  double m_picture;
+};
+
+struct SPacket
+{
+  double pts;
+  int    size;
+  bool   drop;
+};
+
+struct SShown
+{
+  double pts;
+  bool   dropped;
+};
+
+// the packet and end of stream handling of CDVDPlayerVideo::Process()
+class CFakePlayerVideo
+{
+public:
+  CFakePlayerVideo(CDVDVideoCodec &codec) : m_codec(codec) {}
+
+  void AddPacket(double pts, bool drop = false)
+  {
+    SPacket packet = { pts, 100, drop };
+    m_queue.push_back(packet);
+  }
+
+  void EndOfStream()
+  {
+    unsigned int drain = m_delayed.BeginDrain(m_codec.GetDelayedPictures());
+    for (unsigned int i = 0; i < drain; i++)
+    {
+      SPacket packet = { DVD_NOPTS_VALUE, 0, false };
+      m_queue.push_back(packet);
+    }
+  }
+
+  void Process()
+  {
+    while (!m_queue.empty())
+    {
+      SPacket packet = m_queue.front();
+      m_queue.pop_front();
+
+      bool bDelayed = m_codec.GetDelayedPictures() > 0;
+      if (bDelayed && packet.drop)
+        m_delayed.DropPacket(packet.pts);
+
+      BYTE data[100];
+      int state;
+      if (m_delayed.IsDrainPacket(packet.size))
+        state = m_codec.Drain();
+      else
+        state = m_codec.Decode(packet.size ? data : NULL, packet.size, packet.pts, packet.pts);
+
+      if (state & VC_PICTURE)
+      {
+        DVDVideoPicture picture;
+        m_codec.GetPicture(&picture);
+        bool dropped = packet.drop;
+        if (bDelayed && picture.pts != DVD_NOPTS_VALUE)
+          dropped = m_delayed.IsPictureDropped(picture.pts);
+        SShown shown = { picture.pts, dropped };
+        m_shown.push_back(shown);
+      }
+    }
+  }
+
+  CDVDDelayedPictures  m_delayed;
+  std::vector<SShown>  m_shown;
+  std::deque<SPacket>  m_queue;
+
+private:
+  CDVDVideoCodec &m_codec;
+};
+
+// an IBBP pattern: the b-frames come after the p-frame they're predicted from
+static double DecodeOrderPts(int i)
+{
+  static const int order[] = { 0, 3, 1, 2 };
+  return ((i / 4) * 4 + order[i % 4]) * PACKET_DURATION;
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestDrainPushesOutEveryPicture)
+{
+  const int packets = 100;
+  CFakeDelayingCodec codec(3);
+  CFakePlayerVideo player(codec);
+
+  for (int i = 0; i < packets; i++)
+    player.AddPacket(DecodeOrderPts(i));
+  player.Process();
+  BOOST_CHECK_EQUAL(player.m_shown.size(), (size_t)(packets - 3));
+
+  player.EndOfStream();
+  BOOST_CHECK_EQUAL(player.m_queue.size(), 3U);
+  player.Process();
+  BOOST_CHECK_EQUAL(codec.m_drained, 3U);
+
+  BOOST_REQUIRE_EQUAL(player.m_shown.size(), (size_t)packets);
+  for (int i = 0; i < packets; i++)
+  {
+    BOOST_CHECK_EQUAL(player.m_shown[i].pts, i * PACKET_DURATION);
+    BOOST_CHECK(!player.m_shown[i].dropped);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestDropsLandOnTheirPictures)
+{
+  const int packets = 64;
+  CFakeDelayingCodec codec(3);
+  CFakePlayerVideo player(codec);
+
+  // drop every fifth packet in decode order, which are different pictures in pts order
+  std::set<double> dropped;
+  for (int i = 0; i < packets; i++)
+  {
+    bool drop = i % 5 == 2;
+    if (drop)
+      dropped.insert(DecodeOrderPts(i));
+    player.AddPacket(DecodeOrderPts(i), drop);
+  }
+  player.EndOfStream();
+  player.Process();
+
+  BOOST_REQUIRE_EQUAL(player.m_shown.size(), (size_t)packets);
+  for (int i = 0; i < packets; i++)
+  {
+    bool expected = dropped.find(player.m_shown[i].pts) != dropped.end();
+    BOOST_CHECK_MESSAGE(player.m_shown[i].dropped == expected, "picture " << i << " dropped " << player.m_shown[i].dropped);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestSecondEndOfStreamDuringDrain)
+{
+  CFakeDelayingCodec codec(2);
+  CFakePlayerVideo player(codec);
+
+  for (int i = 0; i < 8; i++)
+    player.AddPacket(i * PACKET_DURATION);
+  player.EndOfStream();
+  player.EndOfStream(); // a drain is under way, so nothing more is queued
+  BOOST_CHECK_EQUAL(player.m_queue.size(), 10U);
+  player.Process();
+  BOOST_CHECK_EQUAL(player.m_shown.size(), 8U);
+
+  // drained, so the next end of stream drains again
+  player.EndOfStream();
+  BOOST_CHECK_EQUAL(player.m_queue.size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(TestResetForgetsDrops)
+{
+  CDVDDelayedPictures delayed;
+  delayed.DropPacket(10);
+  delayed.DropPacket(DVD_NOPTS_VALUE); // can't be matched, so isn't kept
+  BOOST_CHECK_EQUAL(delayed.BeginDrain(4), 4U);
+  delayed.Reset();
+
+  BOOST_CHECK(!delayed.IsPictureDropped(10));
+  BOOST_CHECK(!delayed.IsDrainPacket(0));
+  BOOST_CHECK_EQUAL(delayed.BeginDrain(4), 4U);
+  BOOST_CHECK(!delayed.IsDrainPacket(100)); // only empty packets drain
+  BOOST_CHECK(delayed.IsDrainPacket(0));
+}
+
+BOOST_AUTO_TEST_CASE(TestCodecWithoutDelay)
+{
+  CFakeDelayingCodec codec(0);
+  CFakePlayerVideo player(codec);
+
+  for (int i = 0; i < 10; i++)
+    player.AddPacket(i * PACKET_DURATION, i == 4);
+  player.EndOfStream();
+  BOOST_CHECK(player.m_queue.size() == 10U);
+  player.Process();
+
+  BOOST_REQUIRE_EQUAL(player.m_shown.size(), 10U);
+  for (int i = 0; i < 10; i++)
+    BOOST_CHECK_EQUAL(player.m_shown[i].dropped, i == 4);
+  BOOST_CHECK_EQUAL(codec.m_drained, 0U);
+}
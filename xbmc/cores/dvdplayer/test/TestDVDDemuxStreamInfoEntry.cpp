@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxStreamInfoEntry.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxFFmpeg.h"
+
+#include <boost/test/unit_test.hpp>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+#define TEST_FILE   "smb://server/movies/movie.mkv"
+#define TEST_LENGTH 1234567890LL
+#define TEST_MTIME  1350000000LL
+
+// a matroska file with an h264 video and an ac3 audio stream, as avformat_find_stream_info
+// leaves it when full, and as the short probe of a later open leaves it when not
+class CTestContext
+{
+public:
+  CTestContext(bool full)
+  {
+    memset(&m_format, 0, sizeof(m_format));
+    memset(&m_context, 0, sizeof(m_context));
+    memset(m_streams, 0, sizeof(m_streams));
+    memset(m_codecs, 0, sizeof(m_codecs));
+    m_format.name = "matroska,webm";
+    m_context.iformat = &m_format;
+    m_context.nb_streams = 2;
+    m_context.streams = m_pointers;
+    for (int i = 0; i < 2; i++)
+    {
+      m_pointers[i] = &m_streams[i];
+      m_streams[i].codec = &m_codecs[i];
+      m_streams[i].id = i + 1;
+      m_streams[i].duration = AV_NOPTS_VALUE;
+      m_codecs[i].codec_id = CODEC_ID_NONE;
+      m_codecs[i].pix_fmt = PIX_FMT_NONE;
+      m_codecs[i].sample_fmt = AV_SAMPLE_FMT_NONE;
+      m_codecs[i].profile = FF_PROFILE_UNKNOWN;
+      m_codecs[i].level = FF_LEVEL_UNKNOWN;
+    }
+
+    AVStream       &video  = m_streams[0];
+    AVCodecContext &vcodec = m_codecs[0];
+    vcodec.codec_type = AVMEDIA_TYPE_VIDEO;
+    AVStream       &audio  = m_streams[1];
+    AVCodecContext &acodec = m_codecs[1];
+    acodec.codec_type = AVMEDIA_TYPE_AUDIO;
+    if (!full)
+      return;
+
+    vcodec.codec_id = CODEC_ID_H264;
+    vcodec.codec_tag = 0x31637661;
+    vcodec.width = 1920;
+    vcodec.height = 1080;
+    vcodec.pix_fmt = PIX_FMT_YUV420P;
+    vcodec.profile = 100;
+    vcodec.level = 41;
+    vcodec.extradata = m_extradata;
+    vcodec.extradata_size = sizeof(m_extradata);
+    for (unsigned int i = 0; i < sizeof(m_extradata); i++)
+      m_extradata[i] = (uint8_t)(i * 7);
+    video.sample_aspect_ratio.num = 1;
+    video.sample_aspect_ratio.den = 1;
+    video.r_frame_rate.num = 24000;
+    video.r_frame_rate.den = 1001;
+    video.avg_frame_rate.num = 24000;
+    video.avg_frame_rate.den = 1001;
+    video.duration = 7200000;
+
+    acodec.codec_id = CODEC_ID_AC3;
+    acodec.channels = 6;
+    acodec.sample_rate = 48000;
+    acodec.sample_fmt = AV_SAMPLE_FMT_FLT;
+    acodec.block_align = 1536;
+    acodec.bit_rate = 448000;
+    audio.duration = 7200000;
+  }
+
+  AVFormatContext *Get() { return &m_context; }
+
+  AVInputFormat   m_format;
+  AVFormatContext m_context;
+  AVStream        m_streams[2];
+  AVStream       *m_pointers[2];
+  AVCodecContext  m_codecs[2];
+  uint8_t         m_extradata[40];
+};
+
+static std::string SerializeFull()
+{
+  CTestContext full(true);
+  CDVDDemuxStreamInfoEntry entry;
+  BOOST_REQUIRE(entry.Set(full.Get()));
+  std::string data;
+  entry.Serialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data);
+  return data;
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestRoundTrip)
+{
+  std::string data = SerializeFull();
+
+  CDVDDemuxStreamInfoEntry entry;
+  BOOST_REQUIRE(entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data));
+  BOOST_CHECK_EQUAL(entry.GetFormat(), "matroska,webm");
+
+  CTestContext full(true);
+  CTestContext probe(false);
+  BOOST_REQUIRE(entry.Apply(probe.Get()));
+
+  for (int i = 0; i < 2; i++)
+  {
+    const AVStream       &want  = full.m_streams[i];
+    const AVStream       &got   = probe.m_streams[i];
+    const AVCodecContext &wantc = full.m_codecs[i];
+    const AVCodecContext &gotc  = probe.m_codecs[i];
+    BOOST_CHECK_EQUAL(gotc.codec_id, wantc.codec_id);
+    BOOST_CHECK_EQUAL(gotc.codec_tag, wantc.codec_tag);
+    BOOST_CHECK_EQUAL(gotc.width, wantc.width);
+    BOOST_CHECK_EQUAL(gotc.height, wantc.height);
+    BOOST_CHECK_EQUAL(gotc.pix_fmt, wantc.pix_fmt);
+    BOOST_CHECK_EQUAL(gotc.channels, wantc.channels);
+    BOOST_CHECK_EQUAL(gotc.sample_rate, wantc.sample_rate);
+    BOOST_CHECK_EQUAL(gotc.sample_fmt, wantc.sample_fmt);
+    BOOST_CHECK_EQUAL(gotc.block_align, wantc.block_align);
+    BOOST_CHECK_EQUAL(gotc.bit_rate, wantc.bit_rate);
+    BOOST_CHECK_EQUAL(gotc.profile, wantc.profile);
+    BOOST_CHECK_EQUAL(gotc.level, wantc.level);
+    BOOST_CHECK_EQUAL(got.sample_aspect_ratio.num, want.sample_aspect_ratio.num);
+    BOOST_CHECK_EQUAL(got.sample_aspect_ratio.den, want.sample_aspect_ratio.den);
+    BOOST_CHECK_EQUAL(got.r_frame_rate.num, want.r_frame_rate.num);
+    BOOST_CHECK_EQUAL(got.r_frame_rate.den, want.r_frame_rate.den);
+    BOOST_CHECK_EQUAL(got.avg_frame_rate.num, want.avg_frame_rate.num);
+    BOOST_CHECK_EQUAL(got.avg_frame_rate.den, want.avg_frame_rate.den);
+    BOOST_CHECK_EQUAL(got.duration, want.duration);
+
+    // extradata is left to the caller, it has to be allocated with the avutil the demuxer runs
+    BOOST_CHECK(!gotc.extradata);
+    const std::vector<char> &extradata = entry.GetExtradata(i);
+    BOOST_REQUIRE_EQUAL(extradata.size(), (size_t)wantc.extradata_size);
+    BOOST_CHECK(extradata.empty() || memcmp(&extradata[0], wantc.extradata, extradata.size()) == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestApplyKeepsWhatTheProbeFound)
+{
+  std::string data = SerializeFull();
+  CDVDDemuxStreamInfoEntry entry;
+  BOOST_REQUIRE(entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data));
+
+  CTestContext probe(false);
+  probe.m_codecs[0].codec_id = CODEC_ID_H264;
+  probe.m_codecs[0].width = 1920;
+  probe.m_codecs[0].height = 1080;
+  probe.m_codecs[0].profile = 77;
+  probe.m_codecs[1].sample_rate = 44100;
+  BOOST_REQUIRE(entry.Apply(probe.Get()));
+
+  BOOST_CHECK_EQUAL(probe.m_codecs[0].profile, 77);
+  BOOST_CHECK_EQUAL(probe.m_codecs[0].level, 41);
+  BOOST_CHECK_EQUAL(probe.m_codecs[1].sample_rate, 44100);
+  BOOST_CHECK_EQUAL(probe.m_codecs[1].channels, 6);
+}
+
+BOOST_AUTO_TEST_CASE(TestApplyMismatch)
+{
+  std::string data = SerializeFull();
+  CDVDDemuxStreamInfoEntry entry;
+  BOOST_REQUIRE(entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data));
+
+  for (int mismatch = 0; mismatch < 6; mismatch++)
+  {
+    CTestContext probe(false);
+    switch (mismatch)
+    {
+    case 0: probe.m_format.name = "avi";                           break;
+    case 1: probe.m_context.nb_streams = 1;                        break;
+    case 2: probe.m_streams[1].id = 5;                             break;
+    case 3: probe.m_codecs[1].codec_type = AVMEDIA_TYPE_SUBTITLE;  break;
+    case 4: probe.m_codecs[1].codec_id = CODEC_ID_DTS;             break;
+    case 5: probe.m_codecs[0].width = 1280;
+            probe.m_codecs[0].height = 720;                        break;
+    }
+    BOOST_CHECK_MESSAGE(!entry.Apply(probe.Get()), "mismatch " << mismatch << " applied");
+
+    // nothing is filled in before all streams are checked
+    BOOST_CHECK_EQUAL(probe.m_codecs[0].pix_fmt, PIX_FMT_NONE);
+    BOOST_CHECK_EQUAL(probe.m_codecs[1].channels, 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestUnserializeRejectsOtherFiles)
+{
+  std::string data = SerializeFull();
+  CDVDDemuxStreamInfoEntry entry;
+  BOOST_CHECK(!entry.Unserialize("smb://server/movies/other.mkv", TEST_LENGTH, TEST_MTIME, data));
+  BOOST_CHECK(!entry.Unserialize(TEST_FILE, TEST_LENGTH + 1, TEST_MTIME, data));
+  BOOST_CHECK(!entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME + 1, data));
+
+  std::string version(data);
+  version[0]++;
+  BOOST_CHECK(!entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, version));
+  BOOST_CHECK(entry.GetFormat().empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestUnserializeRejectsTruncatedData)
+{
+  std::string data = SerializeFull();
+  CDVDDemuxStreamInfoEntry entry;
+  for (size_t size = 0; size < data.size(); size++)
+    BOOST_CHECK(!entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data.substr(0, size)));
+  BOOST_CHECK(entry.Unserialize(TEST_FILE, TEST_LENGTH, TEST_MTIME, data));
+}
+
+BOOST_AUTO_TEST_CASE(TestSetRejectsEmptyContexts)
+{
+  CTestContext full(true);
+  CDVDDemuxStreamInfoEntry entry;
+  full.m_context.nb_streams = 0;
+  BOOST_CHECK(!entry.Set(full.Get()));
+  full.m_context.nb_streams = MAX_STREAMS + 1;
+  BOOST_CHECK(!entry.Set(full.Get()));
+}
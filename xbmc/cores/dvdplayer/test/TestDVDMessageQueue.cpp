@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "cores/dvdplayer/DVDMessageQueue.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/dvdplayer/DVDClock.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// more messages than fit into the ring of the queue, so some go through the overflow list
+#define NUM_PACKETS 3000
+// 100 packets per second
+#define PACKET_DURATION (DVD_TIME_BASE / 100)
+
+static CDVDMsg* NewPacket(int index, int size = 100)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts   = index * PACKET_DURATION;
+  packet->pts   = index * PACKET_DURATION;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+static int PacketIndex(CDVDMsg* msg)
+{
+  BOOST_REQUIRE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  return (int)(((CDVDMsgDemuxerPacket*)msg)->GetPacket()->dts / PACKET_DURATION);
+}
+
+class producer
+{
+  CDVDMessageQueue& queue;
+  int count;
+public:
+  producer(CDVDMessageQueue& q, int n) : queue(q), count(n) {}
+
+  void operator()()
+  {
+    for (int i = 0; i < count; i++)
+      queue.Put(NewPacket(i));
+  }
+};
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestRingWraparound)
+{
+  CDVDMessageRing ring(8);
+  CDVDMsg msg[8] = { CDVDMsg::NONE, CDVDMsg::NONE, CDVDMsg::NONE, CDVDMsg::NONE,
+                     CDVDMsg::NONE, CDVDMsg::NONE, CDVDMsg::NONE, CDVDMsg::NONE };
+
+  // one slot always stays free
+  for (int i = 0; i < 7; i++)
+    BOOST_CHECK(ring.Push(&msg[i]));
+  BOOST_CHECK(!ring.Push(&msg[7]));
+  BOOST_CHECK_EQUAL(ring.Size(), 7U);
+
+  // keep the ring partly filled while the positions wrap around many times
+  int read = 0, write = 7;
+  for (int i = 0; i < 100; i++)
+  {
+    for (int j = 0; j < 3; j++)
+      BOOST_CHECK_EQUAL(ring.Pop(), &msg[read++ % 8]);
+    BOOST_CHECK_EQUAL(ring.At(0), &msg[read % 8]);
+    for (int j = 0; j < 3; j++)
+      BOOST_CHECK(ring.Push(&msg[write++ % 8]));
+    BOOST_CHECK_EQUAL(ring.Size(), 7U);
+  }
+
+  while (!ring.IsEmpty())
+    BOOST_CHECK_EQUAL(ring.Pop(), &msg[read++ % 8]);
+  BOOST_CHECK_EQUAL(read, write);
+  BOOST_CHECK(ring.Pop() == NULL);
+}
+
+BOOST_AUTO_TEST_CASE(TestQueueOrderThroughOverflow)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+  queue.SetMaxDataSize(NUM_PACKETS * 100);
+
+  for (int i = 0; i < NUM_PACKETS; i++)
+    BOOST_CHECK_EQUAL(queue.Put(NewPacket(i)), MSGQ_OK);
+
+  BOOST_CHECK_EQUAL(queue.GetDataSize(), NUM_PACKETS * 100);
+  BOOST_CHECK_EQUAL(queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET), (unsigned)NUM_PACKETS);
+  // 30 seconds of packets, more than the default 4 seconds the queue is sized for
+  BOOST_CHECK_EQUAL(queue.GetTimeSize(), NUM_PACKETS / 100 - 1);
+  BOOST_CHECK_EQUAL(queue.GetLevel(), 100);
+
+  // drain half, then add more so new messages queue up behind the overflow
+  int next = 0;
+  for (; next < NUM_PACKETS / 2; next++)
+  {
+    CDVDMsg* msg;
+    BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0), MSGQ_OK);
+    BOOST_CHECK_EQUAL(PacketIndex(msg), next);
+    msg->Release();
+  }
+  for (int i = NUM_PACKETS; i < NUM_PACKETS + 100; i++)
+    queue.Put(NewPacket(i));
+
+  for (; next < NUM_PACKETS + 100; next++)
+  {
+    CDVDMsg* msg;
+    BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0), MSGQ_OK);
+    BOOST_CHECK_EQUAL(PacketIndex(msg), next);
+    msg->Release();
+  }
+
+  CDVDMsg* msg;
+  BOOST_CHECK_EQUAL(queue.Get(&msg, 0), MSGQ_TIMEOUT);
+  BOOST_CHECK_EQUAL(queue.GetDataSize(), 0);
+  queue.End();
+}
+
+BOOST_AUTO_TEST_CASE(TestPriorityMessages)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(NewPacket(0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, -1), -1);
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(NewPacket(1));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 1), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 2), 2);
+
+  CDVDMsg* msg;
+  int priority;
+
+  // asking for priority 2 only gives the priority 2 message
+  priority = 2;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK_EQUAL(priority, 2);
+  BOOST_CHECK_EQUAL(((CDVDMsgInt*)msg)->m_value, 2);
+  msg->Release();
+  BOOST_CHECK_EQUAL(queue.Get(&msg, 0, priority), MSGQ_TIMEOUT);
+
+  // priority messages go ahead of the data path ...
+  priority = 0;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK_EQUAL(priority, 1);
+  BOOST_CHECK_EQUAL(((CDVDMsgInt*)msg)->m_value, 1);
+  msg->Release();
+
+  // ... which keeps packets and in-stream messages in order
+  priority = 0;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK_EQUAL(PacketIndex(msg), 0);
+  msg->Release();
+  priority = 0;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+  priority = 0;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK_EQUAL(PacketIndex(msg), 1);
+  msg->Release();
+
+  // negative priorities come last, and only when asked for
+  priority = 0;
+  BOOST_CHECK_EQUAL(queue.Get(&msg, 0, priority), MSGQ_TIMEOUT);
+  priority = -1;
+  BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0, priority), MSGQ_OK);
+  BOOST_CHECK_EQUAL(priority, -1);
+  BOOST_CHECK_EQUAL(((CDVDMsgInt*)msg)->m_value, -1);
+  msg->Release();
+
+  queue.End();
+}
+
+BOOST_AUTO_TEST_CASE(TestFlushKeepsOrder)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  for (int i = 0; i < NUM_PACKETS; i++)
+  {
+    queue.Put(NewPacket(i));
+    if (i % 100 == 0)
+      queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_SYNCHRONIZE, i));
+  }
+
+  queue.Flush(CDVDMsg::DEMUXER_PACKET);
+  BOOST_CHECK_EQUAL(queue.GetDataSize(), 0);
+  BOOST_CHECK_EQUAL(queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET), 0U);
+  BOOST_CHECK_EQUAL(queue.GetPacketCount(CDVDMsg::GENERAL_SYNCHRONIZE), (unsigned)(NUM_PACKETS / 100));
+
+  for (int i = 0; i < NUM_PACKETS; i += 100)
+  {
+    CDVDMsg* msg;
+    BOOST_REQUIRE_EQUAL(queue.Get(&msg, 0), MSGQ_OK);
+    BOOST_CHECK_EQUAL(((CDVDMsgInt*)msg)->m_value, i);
+    msg->Release();
+  }
+  queue.End();
+}
+
+BOOST_AUTO_TEST_CASE(TestProducerConsumer)
+{
+  const int count = 100000;
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  producer p(queue, count);
+  boost::thread thread(p);
+
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg;
+    BOOST_REQUIRE_EQUAL(queue.Get(&msg, 10000), MSGQ_OK);
+    BOOST_REQUIRE_EQUAL(PacketIndex(msg), i);
+    msg->Release();
+  }
+
+  BOOST_CHECK(thread.timed_join(boost::posix_time::seconds(10)));
+  BOOST_CHECK_EQUAL(queue.GetDataSize(), 0);
+  queue.End();
+}
@@ -25,14 +25,52 @@
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include <math.h>
 
 #define INTERNAL_BUFFER_LENGTH  sizeof(float)*2*44100       // float samples, 2 channels, 44100 samples per sec = 1 second
 
-CAudioDecoder::CAudioDecoder()
+class CAudioDecoderJob : public CJob
+{
+public:
+  CAudioDecoderJob(CAudioDecoder &decoder, const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize)
+    : m_decoder(decoder), m_file(file), m_seekOffset(seekOffset), m_bufferSize(nBufferSize) {}
+
+  // the job manager deletes jobs it drops without running them (CancelJobs() at shutdown),
+  // so the decoder is released here rather than at the end of DoWork()
+  virtual ~CAudioDecoderJob()
+  {
+    m_decoder.m_opening = false;
+    m_decoder.m_opened.Set();
+  }
+
+  virtual const char *GetType() const { return "audiodecoder"; }
+
+  virtual bool DoWork()
+  {
+    if (!m_decoder.m_abort && m_decoder.Open(m_file, m_seekOffset, m_bufferSize))
+    {
+      m_decoder.Prefetch();
+      return true;
+    }
+    return false;
+  }
+
+private:
+  CAudioDecoder &m_decoder;
+  CFileItem      m_file;
+  __int64        m_seekOffset;
+  unsigned int   m_bufferSize;
+};
+
+CAudioDecoder::CAudioDecoder() : m_opened(true, true)
 {
   m_codec = NULL;
+  m_opening = false;
+  m_abort = false;
 
   m_eof = false;
 
@@ -49,11 +87,27 @@ CAudioDecoder::~CAudioDecoder()
 }
 
 void CAudioDecoder::Destroy()
+{
+  // let a pending open finish before we tear down what it is working on
+  m_abort = true;
+  m_opened.Wait();
+  Close();
+}
+
+void CAudioDecoder::FreeBuffers()
+{
+  Destroy();
+  CSingleLock lock(m_critSection);
+  m_pcmBuffer.Destroy();
+}
+
+void CAudioDecoder::Close()
 {
   CSingleLock lock(m_critSection);
   m_status = STATUS_NO_FILE;
 
-  m_pcmBuffer.Destroy();
+  // the pcm buffer is kept for the next track, FreeBuffers() releases it
+  m_pcmBuffer.Clear();
   m_gaplessBufferSize = 0;
 
   if ( m_codec )
@@ -66,11 +120,29 @@ void CAudioDecoder::Destroy()
 bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize)
 {
   Destroy();
+  m_abort = false;
+  return Open(file, seekOffset, nBufferSize);
+}
+
+void CAudioDecoder::CreateAsync(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize)
+{
+  Destroy();
+  m_abort = false;
+  m_opening = true;
+  m_opened.Reset();
+  CJobManager::GetInstance().AddJob(new CAudioDecoderJob(*this, file, seekOffset, nBufferSize), NULL, CJob::PRIORITY_HIGH);
+}
 
+bool CAudioDecoder::Open(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize)
+{
   CSingleLock lock(m_critSection);
-  // create our pcm buffer
-  m_pcmBuffer.Create((int)std::max<unsigned int>(2, nBufferSize) *
-                     INTERNAL_BUFFER_LENGTH);
+  // create our pcm buffer, reusing the one from the previous track if it fits
+  unsigned int size = std::max<unsigned int>(2, nBufferSize) * INTERNAL_BUFFER_LENGTH;
+  if (m_pcmBuffer.getSize() != size)
+  {
+    m_pcmBuffer.Destroy();
+    m_pcmBuffer.Create(size);
+  }
 
   // reset our playback timing variables
   m_eof = false;
@@ -90,7 +162,7 @@ bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned i
   if (!m_codec || !m_codec->Init(file.GetPath(), filecache * 1024))
   {
     CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetPath().c_str());
-    Destroy();
+    Close();
     return false;
   }
   m_blockSize = m_codec->m_Channels * m_codec->m_BitsPerSample / 8;
@@ -107,6 +179,19 @@ bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned i
   return true;
 }
 
+void CAudioDecoder::Prefetch()
+{
+  // fill the buffer while we're still off the player thread. the player takes
+  // over decoding once the track is queued
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  while (!m_abort && m_status == STATUS_QUEUING)
+  {
+    if (ReadSamples(PACKET_SIZE) != RET_SUCCESS)
+      break;
+  }
+  CLog::Log(LOGDEBUG, "CAudioDecoder::Prefetch - decoded %u samples in %u ms", m_pcmBuffer.getMaxReadSize() / (unsigned int)sizeof(float), XbmcThreads::SystemClockMillis() - start);
+}
+
 void CAudioDecoder::GetDataFormat(unsigned int *channels, unsigned int *samplerate, unsigned int *bitspersample)
 {
   if (!m_codec)
@@ -24,6 +24,7 @@
 #include "threads/Thread.h"
 #include "ICodec.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/RingBuffer.h"
 
 class CFileItem;
@@ -57,7 +58,15 @@ public:
   ~CAudioDecoder();
 
   bool Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize);
+  /*! \brief Open the codec, seek and decode the start of the file on a worker thread.
+   Status stays STATUS_NO_FILE until the codec is open, IsOpening() tells whether the
+   worker is still busy with it.
+   */
+  void CreateAsync(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize);
+  bool IsOpening() const { return m_opening; };
   void Destroy();
+  /*! \brief Release the pcm buffer kept between tracks */
+  void FreeBuffers();
 
   int ReadSamples(int numsamples);
 
@@ -77,6 +86,10 @@ public:
   ICodec *GetCodec() const { return m_codec; }
 
 private:
+  friend class CAudioDecoderJob;
+  bool Open(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize);
+  void Prefetch();
+  void Close();
   void ProcessAudio(float *data, int numsamples);
   // ReadPCMSamples() - helper to convert PCM (short/byte) to float
   int ReadPCMSamples(float *buffer, int numsamples, int *actualsamples);
@@ -103,6 +116,11 @@ private:
   int     m_status;
   bool    m_canPlay;
 
+  // asynchronous open
+  volatile bool m_opening;
+  volatile bool m_abort;
+  CEvent        m_opened;
+
   // the codec we're using
   ICodec*          m_codec;
 
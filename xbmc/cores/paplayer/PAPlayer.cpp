@@ -34,6 +34,8 @@
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "utils/ssrc.h"
+#include "utils/PolyphaseResampler.h"
 
 #ifdef _LINUX
 #define XBMC_SAMPLE_RATE 44100
@@ -61,6 +63,7 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) : IPlayer(callback)
   m_bQueueFailed = false;
 
   m_currentDecoder = 0;
+  m_fadingDecoder = -1;
 
   m_iSpeed = 1;
   m_SeekTime=-1;
@@ -78,6 +81,11 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) : IPlayer(callback)
     m_pcmBuffer[i] = NULL;
     m_bufferPos[i] = 0;
     m_Chunklen[i]  = PACKET_SIZE;
+
+    if (g_advancedSettings.m_musicResampler.Equals("polyphase"))
+      m_resampler[i] = new CPolyphaseResampler();
+    else
+      m_resampler[i] = new Cssrc();
   }
 
   m_currentStream = 0;
@@ -95,16 +103,19 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) : IPlayer(callback)
   m_forceFadeToNext = false;
   m_CacheLevel = 0;
   m_LastCacheLevelCheck = 0;
+  m_prefetched = 0;
+  m_underruns = 0;
+  m_starved = false;
 
   m_currentFile = new CFileItem;
-  m_nextFile = new CFileItem;
 }
 
 PAPlayer::~PAPlayer()
 {
   CloseFileInternal(true);
   delete m_currentFile;
-  delete m_nextFile;
+  delete m_resampler[0];
+  delete m_resampler[1];
 }
 
 
@@ -125,16 +136,12 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     //do a short crossfade on trackskip
     //set to max 2 seconds for these prev/next transitions
     if (m_crossFading > 2) m_crossFading = 2;
+    //anything queued from the playlist is no longer next
+    ClearQueue(false);
     //queue for crossfading
     bool result = QueueNextFile(file, false);
-    if (result)
-    {
-      //crossfading value may be update by QueueNextFile when nr of channels changed
-      if (!m_crossFading) // swap to next track
-        m_decoder[m_currentDecoder].SetStatus(STATUS_ENDED);
-      else //force to fade to next track immediately
-        m_forceFadeToNext = true;
-    }
+    if (result) //force to fade to next track as soon as it's open, PrepareNextFile
+      m_forceFadeToNext = true; //swaps instead when we can't crossfade
     return result;
   }
 
@@ -142,8 +149,9 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
   // however no need to return to gui audio device
   CloseFileInternal(false);
 
-  // always open the file using the current decoder
+  // always open the file using the first decoder
   m_currentDecoder = 0;
+  m_fadingDecoder = -1;
 
   if (!m_decoder[m_currentDecoder].Create(file, (__int64)(options.starttime * 1000), m_crossFading))
     return false;
@@ -178,6 +186,8 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
   m_currentlyCrossFading = false;
   m_forceFadeToNext = false;
   m_bQueueFailed = false;
+  m_underruns = 0;
+  m_starved = false;
 
   m_decoder[m_currentDecoder].Start();  // start playback
 
@@ -213,6 +223,7 @@ void PAPlayer::OnNothingToQueueNotify()
 {
   //nothing to queue, stop playing
   m_bQueueFailed = true;
+  m_cachingNextFile = false;
 }
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
@@ -225,42 +236,99 @@ bool PAPlayer::QueueNextFile(const CFileItem &file, bool checkCrossFading)
   if (IsPaused())
     Pause();
 
-  if (file.GetPath() == m_currentFile->GetPath() &&
+  CSingleLock lock(m_queueSection);
+  m_cachingNextFile = false;
+
+  QueuedFile next;
+  next.decoder = -1;
+  next.checkCrossFading = checkCrossFading;
+  next.prepared = false;
+
+  const CFileItem &last = m_queue.empty() ? *m_currentFile : *m_queue.back().file;
+  if (file.GetPath() == last.GetPath() &&
       file.m_lStartOffset > 0 &&
-      file.m_lStartOffset == m_currentFile->m_lEndOffset)
+      file.m_lStartOffset == last.m_lEndOffset)
   { // continuing on a .cue sheet item - return true to say we'll handle the transistion
-    *m_nextFile = file;
+    next.file = new CFileItem(file);
+    next.prepared = true;
+    m_queue.push_back(next);
     return true;
   }
 
-  // check if we can handle this file at all
-  int decoder = 1 - m_currentDecoder;
-  int64_t seekOffset = (file.m_lStartOffset * 1000) / 75;
-  if (!m_decoder[decoder].Create(file, seekOffset, m_crossFading))
+  next.decoder = FindFreeDecoder();
+  if (next.decoder < 0)
   {
-    m_bQueueFailed = true;
+    CLog::Log(LOGWARNING, "PAPlayer: No free decoder to queue %s", file.GetPath().c_str());
     return false;
   }
 
-  // ok, we're good to go on queuing this one up
+  // the codec is opened and the start of the track decoded on a worker thread,
+  // the output stream is set up by PrepareNextFile once the track is next in line
+  int64_t seekOffset = (file.m_lStartOffset * 1000) / 75;
+  m_decoder[next.decoder].CreateAsync(file, seekOffset, m_crossFading);
+
   CLog::Log(LOGINFO, "PAPlayer: Queuing next file %s", file.GetPath().c_str());
 
   m_bQueueFailed = false;
-  if (checkCrossFading)
+  next.file = new CFileItem(file);
+  m_queue.push_back(next);
+
+  return true;
+}
+
+int PAPlayer::FindFreeDecoder() const
+{
+  for (int i = 0; i < PAPLAYER_DECODERS; i++)
   {
-    UpdateCrossFadingTime(file);
+    if (i == m_currentDecoder || i == m_fadingDecoder)
+      continue;
+
+    bool used = false;
+    for (std::deque<QueuedFile>::const_iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+      used |= (it->decoder == i);
+    if (!used)
+      return i;
+  }
+  return -1;
+}
+
+void PAPlayer::PrepareNextFile()
+{
+  CSingleLock lock(m_queueSection);
+  if (m_queue.empty())
+    return;
+
+  QueuedFile &next = m_queue.front();
+  if (next.prepared || m_decoder[next.decoder].IsOpening())
+    return;
+
+  if (m_decoder[next.decoder].GetStatus() == STATUS_NO_FILE)
+  { // failed to open, drop it along with what was queued after it
+    CLog::Log(LOGERROR, "PAPlayer: Unable to open queued file %s", next.file->GetPath().c_str());
+    ClearQueue(true);
+    m_bQueueFailed = true;
+    return;
   }
 
+  // the second output stream is still in use by the previous crossfade
+  if (m_currentlyCrossFading)
+    return;
+
+  if (next.checkCrossFading)
+    UpdateCrossFadingTime(*next.file);
+
   unsigned int channels, samplerate, bitspersample;
-  m_decoder[decoder].GetDataFormat(&channels, &samplerate, &bitspersample);
+  m_decoder[next.decoder].GetDataFormat(&channels, &samplerate, &bitspersample);
 
   // check the number of channels isn't changing (else we can't do crossfading)
   if (m_crossFading && m_decoder[m_currentDecoder].GetChannels() == channels)
   { // crossfading - need to create a new stream
     if (!CreateStream(1 - m_currentStream, channels, samplerate, bitspersample))
     {
-      m_decoder[decoder].Destroy();
       CLog::Log(LOGERROR, "PAPlayer::Unable to create audio stream");
+      ClearQueue(true);
+      m_bQueueFailed = true;
+      return;
     }
   }
   else
@@ -268,12 +336,90 @@ bool PAPlayer::QueueNextFile(const CFileItem &file, bool checkCrossFading)
     m_crossFading = 0;
   }
 
-  *m_nextFile = file;
+  // the user skipped to this track, swap right away if we can't fade
+  if (m_forceFadeToNext && !m_crossFading)
+  {
+    m_forceFadeToNext = false;
+    m_decoder[m_currentDecoder].SetStatus(STATUS_ENDED);
+  }
 
-  return true;
+  next.prepared = true;
+}
+
+void PAPlayer::StartQueuedFile()
+{
+  CSingleLock lock(m_queueSection);
+  QueuedFile next = m_queue.front();
+  m_queue.pop_front();
+
+  m_callback.OnPlayBackStarted();
+  m_timeOffset = next.file->m_lStartOffset * 1000 / 75;
+  m_bytesSentOut = 0;
+  *m_currentFile = *next.file;
+  delete next.file;
+  m_cachingNextFile = false;
+  m_bQueueFailed = false;
+  m_forceFadeToNext = false;
+  m_starved = false;
 }
 
+void PAPlayer::ClearQueue(bool notify)
+{
+  // the player thread may be decoding ahead in the queued decoders. always
+  // take the queue before the decode section, as the player thread does
+  CSingleLock lock(m_queueSection);
+  CSingleLock decodeLock(m_decodeSection);
+  int dropped = 0;
+  while (!m_queue.empty())
+  {
+    QueuedFile &next = m_queue.front();
+    if (next.decoder >= 0)
+      m_decoder[next.decoder].Destroy();
+    if (next.checkCrossFading)
+      dropped++;
+    delete next.file;
+    m_queue.pop_front();
+  }
+  m_forceFadeToNext = false;
+
+  // the application keeps track of the items it queued with us
+  if (notify && dropped)
+    m_callback.OnQueueCleared(dropped);
+}
+
+__int64 PAPlayer::GetQueuedTime()
+{
+  // total play time of the queued tracks, -1 while any of them is unknown
+  CSingleLock lock(m_queueSection);
+  __int64 total = 0;
+  for (std::deque<QueuedFile>::iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+  {
+    const CFileItem &file = *it->file;
+    __int64 time;
+    if (file.m_lEndOffset)
+      time = (file.m_lEndOffset - file.m_lStartOffset) * 1000 / 75;
+    else if (it->decoder >= 0 && !m_decoder[it->decoder].IsOpening())
+      time = m_decoder[it->decoder].TotalTime() - file.m_lStartOffset * 1000 / 75;
+    else
+      return -1;
+
+    if (time <= 0)
+      return -1;
+    total += time;
+  }
+  return total;
+}
 
+void PAPlayer::FinishCrossFade()
+{
+  CLog::Log(LOGDEBUG, "Finished Crossfading");
+  m_currentlyCrossFading = false;
+  SetStreamVolume(m_currentStream, g_settings.m_nVolumeLevel);
+  FreeStream(1 - m_currentStream);
+  if (m_fadingDecoder >= 0)
+    m_decoder[m_fadingDecoder].Destroy();
+  m_fadingDecoder = -1;
+}
 
 bool PAPlayer::CloseFileInternal(bool bAudioDevice /*= true*/)
 {
@@ -286,16 +432,26 @@ bool PAPlayer::CloseFileInternal(bool bAudioDevice /*= true*/)
   m_visBufferLength = 0;
   StopThread();
 
+  ClearQueue(false);
+  m_fadingDecoder = -1;
+
+  // kill our decoders, keeping their buffers unless we're done playing
+  for (int i = 0; i < PAPLAYER_DECODERS; i++)
+  {
+    if (bAudioDevice)
+      m_decoder[i].FreeBuffers();
+    else
+      m_decoder[i].Destroy();
+  }
+
   // kill both our streams if we need to
   for (int i = 0; i < 2; i++)
   {
-    m_decoder[i].Destroy();
     if (bAudioDevice)
       FreeStream(i);
   }
 
   m_currentFile->Reset();
-  m_nextFile->Reset();
 
   if(bAudioDevice)
     g_audioContext.SetActiveDevice(CAudioContext::DEFAULT_DEVICE);
@@ -325,7 +481,7 @@ void PAPlayer::FreeStream(int stream)
     m_packet[stream][i].packet = NULL;
   }
 
-  m_resampler[stream].DeInitialize();
+  m_resampler[stream]->DeInitialize();
 }
 
 void PAPlayer::DrainStream(int stream)
@@ -400,7 +556,7 @@ bool PAPlayer::CreateStream(int num, unsigned int channels, unsigned int sampler
   // set initial volume
   SetStreamVolume(num, g_settings.m_nVolumeLevel);
 
-  m_resampler[num].InitConverter(samplerate, bitspersample, channels, outputSampleRate, m_bitsPerSample[num], PACKET_SIZE);
+  m_resampler[num]->InitConverter(samplerate, bitspersample, channels, outputSampleRate, m_bitsPerSample[num], PACKET_SIZE);
 
   // TODO: How do we best handle the callback, given that our samplerate etc. may be
   // changing at this point?
@@ -504,6 +660,20 @@ void PAPlayer::UpdateCacheLevel()
       m_LastCacheLevelCheck = XbmcThreads::SystemClockMillis();
       //CLog::Log(LOGDEBUG,"Cachelevel: %i%%", m_CacheLevel);
     }
+
+    // count the queued tracks that are ready to go
+    CSingleLock lock(m_queueSection);
+    int prefetched = 0;
+    for (std::deque<QueuedFile>::iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+    {
+      if (it->decoder >= 0 && !m_decoder[it->decoder].IsOpening() &&
+          m_decoder[it->decoder].GetStatus() == STATUS_QUEUED)
+        prefetched++;
+    }
+    if (prefetched != m_prefetched)
+      CLog::Log(LOGDEBUG, "PAPlayer: Cachelevel %i%%, %i of %i queued tracks prefetched, %u underruns",
+                m_CacheLevel, prefetched, (int)m_queue.size(), m_underruns);
+    m_prefetched = prefetched;
   }
 }
 
@@ -542,20 +712,33 @@ bool PAPlayer::ProcessPAP()
     if (status == STATUS_NO_FILE)
       return false;
 
+    CSingleLock lock(m_queueSection);
+
     UpdateCacheLevel();
 
-    // check whether we should queue the next file up
-    if ((GetTotalTime64() > 0) && GetTotalTime64() - GetTime() < TIME_TO_CACHE_NEXT_FILE + m_crossFading * 1000L && !m_cachingNextFile)
-    { // request the next file from our application
-      m_callback.OnQueueNextItem();
-      m_cachingNextFile = true;
+    // set up the output for the next track once it's open
+    PrepareNextFile();
+
+    // check whether we should queue another file up. keep asking while the
+    // tracks we have won't last until we'd normally queue the next one
+    if ((GetTotalTime64() > 0) && !m_cachingNextFile && !m_bQueueFailed && !m_forceFadeToNext &&
+        (int)m_queue.size() < std::min(g_advancedSettings.m_musicPrefetchDepth, PAPLAYER_MAX_PREFETCH))
+    {
+      __int64 queued = GetQueuedTime();
+      if (queued >= 0 && GetTotalTime64() - GetTime() + queued < TIME_TO_CACHE_NEXT_FILE + m_crossFading * 1000L)
+      { // request the next file from our application
+        m_callback.OnQueueNextItem();
+        m_cachingNextFile = true;
+      }
     }
 
-    if (m_crossFading && m_decoder[0].GetChannels() == m_decoder[1].GetChannels())
+    if (m_crossFading && !m_currentlyCrossFading && !m_queue.empty())
     {
-      if (((GetTotalTime64() - GetTime() < m_crossFading * 1000L) || (m_forceFadeToNext)) && !m_currentlyCrossFading)
+      const QueuedFile &next = m_queue.front();
+      if (((GetTotalTime64() - GetTime() < m_crossFading * 1000L) || (m_forceFadeToNext)) &&
+          next.prepared && next.decoder >= 0 && m_decoder[m_currentDecoder].GetChannels() == m_decoder[next.decoder].GetChannels())
       { // request the next file from our application
-        if (m_decoder[1 - m_currentDecoder].GetStatus() == STATUS_QUEUED && m_pAudioDecoder[1 - m_currentStream])
+        if (m_decoder[next.decoder].GetStatus() == STATUS_QUEUED && m_pAudioDecoder[1 - m_currentStream])
         {
           m_currentlyCrossFading = true;
           if (m_forceFadeToNext)
@@ -567,19 +750,15 @@ bool PAPlayer::ProcessPAP()
           {
             m_crossFadeLength = GetTotalTime64() - GetTime();
           }
-          m_currentDecoder = 1 - m_currentDecoder;
+          m_fadingDecoder = m_currentDecoder;
+          m_currentDecoder = next.decoder;
           m_decoder[m_currentDecoder].Start();
           m_currentStream = 1 - m_currentStream;
           CLog::Log(LOGDEBUG, "Starting Crossfade - resuming stream %i", m_currentStream);
 
           m_pAudioDecoder[m_currentStream]->Resume();
 
-          m_callback.OnPlayBackStarted();
-          m_timeOffset = m_nextFile->m_lStartOffset * 1000 / 75;
-          m_bytesSentOut = 0;
-          *m_currentFile = *m_nextFile;
-          m_nextFile->Reset();
-          m_cachingNextFile = false;
+          StartQueuedFile();
         }
       }
     }
@@ -587,24 +766,46 @@ bool PAPlayer::ProcessPAP()
     // Check for EOF and queue the next track if applicable
     if (m_decoder[m_currentDecoder].GetStatus() == STATUS_ENDED)
     { // time to swap tracks
-      if (m_nextFile->GetPath() != m_currentFile->GetPath() ||
-          !m_nextFile->m_lStartOffset ||
-          m_nextFile->m_lStartOffset != m_currentFile->m_lEndOffset)
+      if (!m_queue.empty() && m_queue.front().decoder < 0)
+      {
+        // set the next track playing (.cue sheet)
+        m_decoder[m_currentDecoder].SetStatus(STATUS_PLAYING);
+        StartQueuedFile();
+      }
+      else if (!m_queue.empty())
       { // don't have a .cue sheet item
-        int nextstatus = m_decoder[1 - m_currentDecoder].GetStatus();
+        const QueuedFile &next = m_queue.front();
+        if (m_currentlyCrossFading)
+        { // the faded in track is already over, let the fading one go
+          FinishCrossFade();
+          continue;
+        }
+        if (m_decoder[next.decoder].IsOpening() || !next.prepared)
+        { // the next track isn't ready, we'll run dry until it is
+          if (!m_starved)
+          {
+            m_underruns++;
+            m_starved = true;
+            CLog::Log(LOGWARNING, "PAPlayer: Next track not ready at end of %s", m_currentFile->GetPath().c_str());
+          }
+          lock.Leave();
+          Sleep(10);
+          continue;
+        }
+        int nextstatus = m_decoder[next.decoder].GetStatus();
         if (nextstatus == STATUS_QUEUED || nextstatus == STATUS_QUEUING || nextstatus == STATUS_PLAYING)
         { // swap streams
-          CLog::Log(LOGDEBUG, "PAPlayer: Swapping tracks %i to %i", m_currentDecoder, 1-m_currentDecoder);
-          if (!m_crossFading || m_decoder[0].GetChannels() != m_decoder[1].GetChannels())
+          CLog::Log(LOGDEBUG, "PAPlayer: Swapping tracks %i to %i", m_currentDecoder, next.decoder);
+          if (!m_crossFading || m_decoder[m_currentDecoder].GetChannels() != m_decoder[next.decoder].GetChannels())
           { // playing gapless (we use only the 1 output stream in this case)
             int prefixAmount = m_decoder[m_currentDecoder].GetDataSize();
             CLog::Log(LOGDEBUG, "PAPlayer::Prefixing %i samples of old data to new track for gapless playback", prefixAmount);
-            m_decoder[1 - m_currentDecoder].PrefixData(m_decoder[m_currentDecoder].GetData(prefixAmount), prefixAmount);
+            m_decoder[next.decoder].PrefixData(m_decoder[m_currentDecoder].GetData(prefixAmount), prefixAmount);
             // check if we need to change the resampler (due to format change)
             unsigned int channels, samplerate, bitspersample;
             m_decoder[m_currentDecoder].GetDataFormat(&channels, &samplerate, &bitspersample);
             unsigned int channels2, samplerate2, bitspersample2;
-            m_decoder[1 - m_currentDecoder].GetDataFormat(&channels2, &samplerate2, &bitspersample2);
+            m_decoder[next.decoder].GetDataFormat(&channels2, &samplerate2, &bitspersample2);
             // change of channels - reinitialize our speaker configuration
             if (channels != channels2 || (g_advancedSettings.m_musicResample == 0 && (samplerate != samplerate2 || bitspersample != bitspersample2)))
             {
@@ -620,8 +821,8 @@ bool PAPlayer::ProcessPAP()
             else if (samplerate != samplerate2 || bitspersample != bitspersample2)
             {
               CLog::Log(LOGINFO, "PAPlayer: Restarting resampler due to a change in data format");
-              m_resampler[m_currentStream].DeInitialize();
-              if (!m_resampler[m_currentStream].InitConverter(samplerate2, bitspersample2, channels2, g_advancedSettings.m_musicResample, 16, PACKET_SIZE))
+              m_resampler[m_currentStream]->DeInitialize();
+              if (!m_resampler[m_currentStream]->InitConverter(samplerate2, bitspersample2, channels2, g_advancedSettings.m_musicResample, 16, PACKET_SIZE))
               {
                 CLog::Log(LOGERROR, "PAPlayer: Error initializing resampler!");
                 return false;
@@ -629,59 +830,43 @@ bool PAPlayer::ProcessPAP()
             }
             CLog::Log(LOGINFO, "PAPlayer: Starting new track");
 
+            int decoder = next.decoder;
             m_decoder[m_currentDecoder].Destroy();
-            m_decoder[1 - m_currentDecoder].Start();
-            m_callback.OnPlayBackStarted();
-            m_timeOffset = m_nextFile->m_lStartOffset * 1000 / 75;
-            m_bytesSentOut = 0;
-            *m_currentFile = *m_nextFile;
-            m_nextFile->Reset();
-            m_cachingNextFile = false;
-            m_currentDecoder = 1 - m_currentDecoder;
+            m_decoder[decoder].Start();
+            m_currentDecoder = decoder;
+            StartQueuedFile();
           }
           else
           { // cross fading - shouldn't ever get here - if we do, return false
-            if (!m_currentlyCrossFading)
-            {
-              CLog::Log(LOGERROR, "End of file Reached before crossfading kicked in!");
-              return false;
-            }
-            else
-            {
-              CLog::Log(LOGINFO, "End of file reached before crossfading finished!");
-              return false;
-            }
+            CLog::Log(LOGERROR, "End of file Reached before crossfading kicked in!");
+            return false;
           }
         }
         else
-        {
-          if (GetTotalTime64() <= 0 && !m_bQueueFailed)
-          { //we did not know the duration so didn't queue the next song, try queueing it now
-            if (!m_cachingNextFile)
-            {// request the next file from our application
-              m_callback.OnQueueNextItem();
-              m_cachingNextFile = true;
-            }
-          }
-          else
-          {
-            // no track queued - return and get another one once we are finished
-            // with the current stream
-            WaitForStream();
-            return false;
-          }
+        { // the queued track failed while decoding ahead
+          ClearQueue(true);
+          m_bQueueFailed = true;
+          continue;
         }
       }
       else
       {
-        // set the next track playing (.cue sheet)
-        m_decoder[m_currentDecoder].SetStatus(STATUS_PLAYING);
-        m_callback.OnPlayBackStarted();
-        m_timeOffset = m_nextFile->m_lStartOffset * 1000 / 75;
-        m_bytesSentOut = 0;
-        *m_currentFile = *m_nextFile;
-        m_nextFile->Reset();
-        m_cachingNextFile = false;
+        if (GetTotalTime64() <= 0 && !m_bQueueFailed)
+        { //we did not know the duration so didn't queue the next song, try queueing it now
+          if (!m_cachingNextFile)
+          {// request the next file from our application
+            m_callback.OnQueueNextItem();
+            m_cachingNextFile = true;
+          }
+        }
+        else if (!m_cachingNextFile)
+        {
+          // no track queued - return and get another one once we are finished
+          // with the current stream
+          lock.Leave();
+          WaitForStream();
+          return false;
+        }
       }
     }
 
@@ -696,6 +881,16 @@ bool PAPlayer::ProcessPAP()
 
     if (!m_bPaused)
     {
+      // decode without holding the queue, so queueing the next file doesn't
+      // have to wait for us. ClearQueue waits on the decode section instead.
+      std::vector<int> queued;
+      for (std::deque<QueuedFile>::iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+      {
+        if (it->decoder >= 0 && !m_decoder[it->decoder].IsOpening())
+          queued.push_back(it->decoder);
+      }
+      lock.Leave();
+      CSingleLock decodeLock(m_decodeSection);
 
       // Let our decoding stream(s) do their thing
       int retVal = m_decoder[m_currentDecoder].ReadSamples(PACKET_SIZE);
@@ -705,23 +900,32 @@ bool PAPlayer::ProcessPAP()
         return false;
       }
 
-      int retVal2 = m_decoder[1 - m_currentDecoder].ReadSamples(PACKET_SIZE);
-      if (retVal2 == RET_ERROR)
+      int retVal2 = RET_SLEEP;
+      if (m_fadingDecoder >= 0)
       {
-        m_decoder[1 - m_currentDecoder].Destroy();
+        retVal2 = m_decoder[m_fadingDecoder].ReadSamples(PACKET_SIZE);
+        if (retVal2 == RET_ERROR)
+          m_decoder[m_fadingDecoder].Destroy();
       }
 
+      // keep the buffers of the queued tracks topped up once they are open
+      for (std::vector<int>::iterator it = queued.begin(); it != queued.end(); ++it)
+      {
+        int ret = m_decoder[*it].ReadSamples(PACKET_SIZE);
+        if (ret == RET_ERROR)
+          m_decoder[*it].Destroy();
+        else if (ret == RET_SUCCESS)
+          retVal2 = RET_SUCCESS;
+      }
+      decodeLock.Leave();
+
       // if we're cross-fading, then we do this for both streams, otherwise
       // we do it just for the one stream.
       if (m_currentlyCrossFading)
       {
         if (GetTime() >= m_crossFadeLength)  // finished
         {
-          CLog::Log(LOGDEBUG, "Finished Crossfading");
-          m_currentlyCrossFading = false;
-          SetStreamVolume(m_currentStream, g_settings.m_nVolumeLevel);
-          FreeStream(1 - m_currentStream);
-          m_decoder[1 - m_currentDecoder].Destroy();
+          FinishCrossFade();
         }
         else
         {
@@ -733,7 +937,7 @@ bool PAPlayer::ProcessPAP()
           float volumeNext = 2000.0f * log10(0.5f + fraction);
           SetStreamVolume(m_currentStream, g_settings.m_nVolumeLevel + (int)volumeCurrent);
           SetStreamVolume(1 - m_currentStream, g_settings.m_nVolumeLevel + (int)volumeNext);
-          if (AddPacketsToStream(1 - m_currentStream, m_decoder[1 - m_currentDecoder]))
+          if (AddPacketsToStream(1 - m_currentStream, m_decoder[m_fadingDecoder]))
             retVal2 = RET_SUCCESS;
         }
       }
@@ -742,6 +946,17 @@ bool PAPlayer::ProcessPAP()
       if (AddPacketsToStream(m_currentStream, m_decoder[m_currentDecoder]))
         retVal = RET_SUCCESS;
 
+      // count the times the output runs dry in the middle of a track
+      bool starved = m_decoder[m_currentDecoder].GetStatus() == STATUS_PLAYING &&
+                     m_bytesSentOut > m_BytesPerSecond &&
+                     m_pAudioDecoder[m_currentStream]->GetCacheTime() < 0.01f;
+      if (starved && !m_starved)
+      {
+        m_underruns++;
+        CLog::Log(LOGDEBUG, "PAPlayer: Output underrun (%u so far)", m_underruns);
+      }
+      m_starved = starved;
+
       if (retVal == RET_SLEEP && retVal2 == RET_SLEEP)
       {
         float maximumSleepTime = m_pAudioDecoder[m_currentStream]->GetCacheTime();
@@ -755,7 +970,10 @@ bool PAPlayer::ProcessPAP()
       }
     }
     else
+    {
+      lock.Leave();
       Sleep(100);
+    }
   }
   return true;
 }
@@ -781,6 +999,11 @@ int PAPlayer::GetTotalTime()
   return (int)(GetTotalTime64()/1000);
 }
 
+void PAPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
+{
+  strGeneralInfo.Format("cache:%i%% prefetched:%i underruns:%u", m_CacheLevel, m_prefetched, m_underruns);
+}
+
 int PAPlayer::GetCacheLevel() const
 {
   const ICodec* codec = m_decoder[m_currentDecoder].GetCodec();
@@ -970,13 +1193,13 @@ bool PAPlayer::AddPacketsToStream(int stream, CAudioDecoder &dec)
     return false;
 
   bool ret = false;
-  int amount = m_resampler[stream].GetInputSamples();
+  int amount = m_resampler[stream]->GetInputSamples();
   if (amount > 0 && amount <= (int)dec.GetDataSize())
   { // resampler wants more data - let's feed it
-    m_resampler[stream].PutFloatData((float *)dec.GetData(amount), amount);
+    m_resampler[stream]->PutFloatData((float *)dec.GetData(amount), amount);
     ret = true;
   }
-  else if (m_resampler[stream].GetData(m_packet[stream][0].packet))
+  else if (m_resampler[stream]->GetData(m_packet[stream][0].packet))
   {
     // got some data from our resampler - construct audio packet
     m_packet[stream][0].length = PACKET_SIZE;
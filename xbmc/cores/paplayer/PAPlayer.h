@@ -24,8 +24,10 @@
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
-#include "utils/ssrc.h"
+#include "utils/IResampler.h"
 #include "cores/AudioRenderers/IAudioRenderer.h"
+#include "threads/CriticalSection.h"
+#include <deque>
 
 class CFileItem;
 #ifndef _LINUX
@@ -34,6 +36,12 @@ class CFileItem;
 #define PACKET_COUNT  1
 #endif
 
+// tracks queued ahead at most, <audio><prefetchdepth> is capped to this. each queued track
+// holds an open codec and a few seconds of decoded audio, and the queue is only refilled
+// when the queued tracks run short, so a deeper queue only helps runs of very short tracks
+#define PAPLAYER_MAX_PREFETCH 8
+#define PAPLAYER_DECODERS (PAPLAYER_MAX_PREFETCH + 2) // the playing track, one fading out and the prefetched ones
+
 #define STATUS_NO_FILE  0
 #define STATUS_QUEUING  1
 #define STATUS_QUEUED   2
@@ -73,7 +81,7 @@ public:
   virtual void SetDynamicRangeCompression(long drc);
   virtual void GetAudioInfo( CStdString& strAudioInfo) {}
   virtual void GetVideoInfo( CStdString& strVideoInfo) {}
-  virtual void GetGeneralInfo( CStdString& strVideoInfo) {}
+  virtual void GetGeneralInfo( CStdString& strGeneralInfo);
   virtual void Update(bool bPauseDrawing = false) {}
   virtual void ToFFRW(int iSpeed = 0);
   virtual int GetCacheLevel() const;
@@ -129,7 +137,20 @@ private:
   bool    m_forceFadeToNext;
 
   int m_currentDecoder;
-  CAudioDecoder m_decoder[2]; // our 2 audiodecoders (for crossfading + precaching)
+  int m_fadingDecoder;        // decoder fading out while crossfading, -1 if none
+  CAudioDecoder m_decoder[PAPLAYER_DECODERS]; // our audiodecoders (for crossfading + precaching)
+
+  // tracks queued up after the current one, in playing order
+  struct QueuedFile
+  {
+    int        decoder;       // -1 when continuing a .cue sheet in the current decoder
+    CFileItem *file;
+    bool       checkCrossFading; // queued by the application, rather than by OpenFile
+    bool       prepared;      // output stream has been set up for it
+  };
+  std::deque<QueuedFile> m_queue;
+  CCriticalSection m_queueSection;
+  CCriticalSection m_decodeSection; // held while decoding ahead in the queued decoders
 
 #ifndef _LINUX
   void SetupDirectSound(int channels);
@@ -150,6 +171,12 @@ private:
 
   void UpdateCrossFadingTime(const CFileItem& file);
   bool QueueNextFile(const CFileItem &file, bool checkCrossFading);
+  int  FindFreeDecoder() const;
+  void PrepareNextFile();
+  void StartQueuedFile();
+  void ClearQueue(bool notify);
+  __int64 GetQueuedTime();
+  void FinishCrossFade();
   void UpdateCacheLevel();
 
   int m_currentStream;
@@ -182,14 +209,16 @@ private:
 
   unsigned int     m_CacheLevel;
   unsigned int     m_LastCacheLevelCheck;
+  int              m_prefetched;       // queued tracks that have their buffers filled
+  unsigned int     m_underruns;        // times the output ran dry while playing
+  bool             m_starved;
 
     // resampler
-  Cssrc            m_resampler[2];
+  IResampler      *m_resampler[2];
   bool             m_resampleAudio;
 
   // our file
   CFileItem*        m_currentFile;
-  CFileItem*        m_nextFile;
 
   // stuff for visualisation
   unsigned int     m_visBufferLength;
@@ -43,6 +43,8 @@ CDatabase::CDatabase(void)
   m_openCount = 0;
   m_sqlite = true;
   m_bMultiWrite = false;
+  m_bBatch = false;
+  m_bBatchRolledBack = false;
 }
 
 CDatabase::~CDatabase(void)
@@ -247,6 +249,50 @@ bool CDatabase::CommitInsertQueries()
   return bReturn;
 }
 
+bool CDatabase::ExecutePrepared(const CStdString &strTemplate, const DatabaseRow &row, int64_t *insertId /* = NULL */)
+{
+  if (NULL == m_pDB.get()) return false;
+
+  try
+  {
+    int64_t id = m_pDB->exec_prepared(strTemplate, row);
+    if (insertId)
+      *insertId = id;
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strTemplate.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool CDatabase::BulkInsert(const CStdString &strTemplate, const std::vector<DatabaseRow> &rows)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (rows.empty()) return true;
+
+  bool ownTransaction = !InTransaction();
+  if (ownTransaction)
+    BeginTransaction();
+
+  for (unsigned int i = 0; i < rows.size(); i++)
+  {
+    if (!ExecutePrepared(strTemplate, rows[i]))
+    {
+      if (ownTransaction)
+        RollbackTransaction();
+      return false;
+    }
+  }
+
+  if (ownTransaction)
+    return CommitTransaction();
+  return true;
+}
+
 bool CDatabase::Open()
 {
   DatabaseSettings db_fallback;
@@ -484,6 +530,7 @@ void CDatabase::Close()
   }
 
   m_openCount = 0;
+  m_bBatch = false;
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
@@ -536,6 +583,9 @@ void CDatabase::Interupt()
 
 void CDatabase::BeginTransaction()
 {
+  if (m_bBatch)
+    return;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -549,6 +599,9 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_bBatch)
+    return true;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -564,6 +617,9 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_bBatch)
+    CLog::Log(LOGWARNING, "%s - rolling back the current batch", __FUNCTION__);
+
   try
   {
     if (NULL != m_pDB.get())
@@ -573,11 +629,37 @@ void CDatabase::RollbackTransaction()
   {
     CLog::Log(LOGERROR, "database:rollbacktransaction failed");
   }
+
+  // what follows is still grouped, in a fresh transaction
+  if (m_bBatch)
+  {
+    m_bBatchRolledBack = true;
+    m_bBatch = false;
+    BeginTransaction();
+    m_bBatch = true;
+  }
+}
+
+void CDatabase::BeginBatch()
+{
+  BeginTransaction();
+  m_bBatch = true;
+  m_bBatchRolledBack = false;
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (!m_bBatch)
+    return false;
+
+  m_bBatch = false;
+  bool committed = CommitTransaction();
+  return committed && !m_bBatchRolledBack;
 }
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
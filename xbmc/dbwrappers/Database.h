@@ -26,9 +26,16 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
 }
 
 #include <memory>
+#include <vector>
+
+/*!
+ * @brief The values bound to the placeholders of one prepared statement execution.
+ */
+typedef std::vector<dbiplus::field_value> DatabaseRow;
 
 class DatabaseSettings; // forward
 
@@ -49,6 +56,19 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*!
+   * @brief Group all transactions up to CommitBatch() into a single one.
+   * @remarks Begin/CommitTransaction() do nothing while the batch is open. A RollbackTransaction()
+   * rolls back everything written in the batch so far, and starts it over. CommitBatch() reports it.
+   */
+  void BeginBatch();
+
+  /*!
+   * @brief Commit the transaction opened by BeginBatch().
+   * @return True if the batch was committed, false if any of it was rolled back or the commit failed.
+   */
+  bool CommitBatch();
+
   static CStdString FormatSQL(CStdString strStmt, ...);
   CStdString PrepareSQL(CStdString strStmt, ...) const;
 
@@ -106,6 +126,27 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Execute a statement with '?' placeholders, binding the given values to them.
+   * @remarks The compiled statement is cached by the connection, so repeated calls with
+   * the same template only rebind the values. Strings need no escaping.
+   * @param strTemplate The statement to execute.
+   * @param row The values to bind, in placeholder order.
+   * @param insertId If not NULL, receives the row id generated by the statement.
+   * @return True if the statement was executed successfully, false otherwise.
+   */
+  bool ExecutePrepared(const CStdString &strTemplate, const DatabaseRow &row, int64_t *insertId = NULL);
+
+  /*!
+   * @brief Execute an INSERT template once per row, all inside one transaction.
+   * @remarks Runs in the current transaction if there is one, otherwise in its own which is
+   * rolled back when a row fails.
+   * @param strTemplate The INSERT statement with '?' placeholders.
+   * @param rows The values to insert.
+   * @return True if all rows were inserted, false otherwise.
+   */
+  bool BulkInsert(const CStdString &strTemplate, const std::vector<DatabaseRow> &rows);
+
 protected:
   void Split(const CStdString& strFileNameAndPath, CStdString& strPath, CStdString& strFileName);
   uint32_t ComputeCRC(const CStdString &text);
@@ -131,5 +172,7 @@ private:
   bool UpdateVersionNumber();
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
+  bool m_bBatch; /*!< True while the transactions are grouped by BeginBatch() */
+  bool m_bBatchRolledBack; /*!< True if the open batch was rolled back and started over */
   unsigned int m_openCount;
 };
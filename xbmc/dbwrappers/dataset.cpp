@@ -91,6 +91,11 @@ string Database::vprepare(const char *format, va_list args)
   return result;
 }
 
+int64_t Database::exec_prepared(const std::string &tmpl, const std::vector<field_value> &params)
+{
+  throw DbErrors("Prepared statements are not supported by this database");
+}
+
 
 
 //************* Dataset implementation ***************
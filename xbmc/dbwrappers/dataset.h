@@ -34,6 +34,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include "qry_dat.h"
 #include <stdarg.h>
 
@@ -47,6 +48,7 @@ class Dataset;		// forward declaration of class Dataset
 #define S_NO_CONNECTION "No active connection";
 
 #define DB_BUFF_MAX           8*1024    // Maximum buffer's capacity
+#define DB_MAX_PREPARED       64        // Maximum statements cached per connection
 
 #define DB_CONNECTION_NONE	0
 #define DB_CONNECTION_OK	1
@@ -153,6 +155,21 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* virtual methods for prepared statements */
+
+  /*! \brief Execute a statement with '?' placeholders, binding the given values to them.
+   The compiled statement is kept per connection and keyed by its template, so executing
+   the same template again only rebinds the values.
+   \param tmpl - SQL statement with one '?' placeholder per value.
+   \param params - values to bind, in placeholder order. NULL values are bound as SQL NULL.
+   \return the row id generated by the statement, if any. Throws DbErrors on failure.
+   */
+  virtual int64_t exec_prepared(const std::string &tmpl, const std::vector<field_value> &params);
+
+  /*! \brief Release all statements cached by exec_prepared().
+   */
+  virtual void clear_prepared() {};
+
 };
 
 
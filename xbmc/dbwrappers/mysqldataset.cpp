@@ -184,6 +184,7 @@ int MysqlDatabase::connect(bool create_new) {
 void MysqlDatabase::disconnect(void) {
   if (conn != NULL)
   {
+    clear_prepared();
     mysql_close(conn);
     conn = NULL;
   }
@@ -282,6 +283,117 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
   return result;
 }
 
+int64_t MysqlDatabase::exec_prepared(const string &tmpl, const vector<field_value> &params) {
+  if (!active || conn == NULL) throw DbErrors("No Database Connection");
+
+  // the bound buffers have to stay alive until mysql_stmt_execute() returns
+  unsigned int count = params.size();
+  vector<MYSQL_BIND> binds(count);
+  vector<long long> ints(count);
+  vector<double> doubles(count);
+  vector<string> strings(count);
+  vector<unsigned long> lengths(count);
+  if (count)
+    memset(&binds[0], 0, count * sizeof(MYSQL_BIND));
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const field_value &value = params[i];
+    MYSQL_BIND &bind = binds[i];
+    if (value.get_isNull())
+    {
+      bind.buffer_type = MYSQL_TYPE_NULL;
+      continue;
+    }
+
+    switch (value.get_fType())
+    {
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+    case ft_UInt:
+    case ft_Int64:
+      ints[i] = value.get_asInt64();
+      bind.buffer_type = MYSQL_TYPE_LONGLONG;
+      bind.buffer = &ints[i];
+      break;
+    case ft_Float:
+    case ft_Double:
+      doubles[i] = value.get_asDouble();
+      bind.buffer_type = MYSQL_TYPE_DOUBLE;
+      bind.buffer = &doubles[i];
+      break;
+    default:
+      strings[i] = value.get_asString();
+      lengths[i] = strings[i].size();
+      bind.buffer_type = MYSQL_TYPE_STRING;
+      bind.buffer = (void *)strings[i].c_str();
+      bind.buffer_length = lengths[i];
+      bind.length = &lengths[i];
+      break;
+    }
+  }
+
+  int attempts = 5;
+  while (true)
+  {
+    MYSQL_STMT *stmt = NULL;
+    int result = MYSQL_OK;
+
+    StatementMap::iterator it = statements.find(tmpl);
+    if (it != statements.end())
+      stmt = it->second;
+    else
+    {
+      if (statements.size() >= DB_MAX_PREPARED)
+        clear_prepared();
+
+      stmt = mysql_stmt_init(conn);
+      if (stmt == NULL)
+        result = mysql_errno(conn);
+      else if (mysql_stmt_prepare(stmt, tmpl.c_str(), tmpl.size()) != MYSQL_OK)
+      {
+        result = mysql_stmt_errno(stmt);
+        mysql_stmt_close(stmt);
+        stmt = NULL;
+      }
+      else
+        statements.insert(make_pair(tmpl, stmt));
+    }
+
+    if (stmt)
+    {
+      if (mysql_stmt_param_count(stmt) != count)
+        result = CR_UNKNOWN_ERROR;
+      else if (mysql_stmt_bind_param(stmt, count ? &binds[0] : NULL) ||
+               mysql_stmt_execute(stmt))
+        result = mysql_stmt_errno(stmt);
+      else
+        return mysql_stmt_insert_id(stmt);
+    }
+
+    // reconnecting drops the cached statements, so they are prepared again on retry
+    if ((result == CR_SERVER_GONE_ERROR || result == CR_SERVER_LOST) && attempts-- > 0)
+    {
+      CLog::Log(LOGINFO,"MYSQL server has gone. Will try %d more attempt(s) to reconnect.", attempts);
+      active = false;
+      connect(true);
+      if (active)
+        continue;
+    }
+
+    setErr(result, tmpl.c_str());
+    throw DbErrors(getErrorMsg());
+  }
+}
+
+void MysqlDatabase::clear_prepared() {
+  for (StatementMap::iterator it = statements.begin(); it != statements.end(); ++it)
+    mysql_stmt_close(it->second);
+  statements.clear();
+}
+
 long MysqlDatabase::nextid(const char* sname) {
   CLog::Log(LOGDEBUG,"MysqlDatabase::nextid for %s",sname);
   if (!active) return DB_UNEXPECTED_RESULT;
@@ -23,6 +23,7 @@
 #define _MYSQLDATASET_H
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include "mysql/mysql.h"
 
@@ -38,6 +39,9 @@ protected:
   MYSQL* conn;
   bool _in_transaction;
   int last_err;
+/* statements compiled by exec_prepared(), keyed by their template */
+  typedef std::map<std::string, MYSQL_STMT*> StatementMap;
+  StatementMap statements;
 
 
 public:
@@ -84,6 +88,10 @@ public:
   bool in_transaction() {return _in_transaction;};
   int query_with_reconnect(const char* query);
 
+/* virtual methods for prepared statements */
+  virtual int64_t exec_prepared(const std::string &tmpl, const std::vector<field_value> &params);
+  virtual void clear_prepared();
+
 private:
 
   typedef struct StrAccum StrAccum;
@@ -260,6 +260,8 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  // sqlite3_close() refuses to close while statements are still alive
+  clear_prepared();
   sqlite3_close(conn);
   active = false;
 }
@@ -405,6 +407,87 @@ string SqliteDatabase::vprepare(const char *format, va_list args)
 }
 
 
+// methods for prepared statements
+// ---------------------------------------------
+int64_t SqliteDatabase::exec_prepared(const string &tmpl, const vector<field_value> &params)
+{
+  if (!active) throw DbErrors("No Database Connection");
+
+  sqlite3_stmt *stmt = NULL;
+  StatementMap::iterator it = statements.find(tmpl);
+  if (it != statements.end())
+    stmt = it->second;
+  else
+  {
+    if (statements.size() >= DB_MAX_PREPARED)
+      clear_prepared();
+
+    if (setErr(sqlite3_prepare_v2(conn, tmpl.c_str(), -1, &stmt, NULL), tmpl.c_str()) != SQLITE_OK)
+      throw DbErrors(getErrorMsg());
+    statements.insert(make_pair(tmpl, stmt));
+  }
+
+  int rc = SQLITE_OK;
+  if ((int)params.size() != sqlite3_bind_parameter_count(stmt))
+    rc = SQLITE_RANGE;
+
+  for (unsigned int i = 0; i < params.size() && rc == SQLITE_OK; i++)
+  {
+    const field_value &value = params[i];
+    if (value.get_isNull())
+    {
+      rc = sqlite3_bind_null(stmt, i + 1);
+      continue;
+    }
+
+    switch (value.get_fType())
+    {
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+    case ft_UInt:
+    case ft_Int64:
+      rc = sqlite3_bind_int64(stmt, i + 1, value.get_asInt64());
+      break;
+    case ft_Float:
+    case ft_Double:
+      rc = sqlite3_bind_double(stmt, i + 1, value.get_asDouble());
+      break;
+    default:
+      {
+        string text = value.get_asString();
+        rc = sqlite3_bind_text(stmt, i + 1, text.c_str(), text.size(), SQLITE_TRANSIENT);
+      }
+      break;
+    }
+  }
+
+  if (rc == SQLITE_OK)
+  {
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_DONE || rc == SQLITE_ROW)
+      rc = SQLITE_OK;
+  }
+
+  // leave the statement ready for the next call
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (setErr(rc, tmpl.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  return sqlite3_last_insert_rowid(conn);
+}
+
+void SqliteDatabase::clear_prepared()
+{
+  for (StatementMap::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
+}
+
+
 //************* SqliteDataset implementation ***************
 
 SqliteDataset::SqliteDataset():Dataset() {
@@ -30,6 +30,7 @@
 #define _SQLITEDATASET_H
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -45,6 +46,9 @@ protected:
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
+/* statements compiled by exec_prepared(), keyed by their template */
+  typedef std::map<std::string, sqlite3_stmt*> StatementMap;
+  StatementMap statements;
 
 public:
 /* default constructor */
@@ -94,6 +98,10 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* virtual methods for prepared statements */
+  virtual int64_t exec_prepared(const std::string &tmpl, const std::vector<field_value> &params);
+  virtual void clear_prepared();
+
 };
 
 
@@ -29,8 +29,20 @@
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
 #include "SpecialProtocol.h"
+#include "File.h"
+#include "Directory.h"
+#include "FileItem.h"
+#include "utils/Crc32.h"
+#include "utils/URIUtils.h"
+#include <set>
 #ifdef _WIN32
 #include "PlatformDefs.h" //for PRIdS, PRId64
+#else
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 namespace XFILE {
@@ -253,4 +265,477 @@ void CSimpleFileCache::EndOfInput()
   m_hDataAvailEvent->Set();
 }
 
+// size of the windows of the cache file that are mapped at a time. must be
+// a multiple of the page size and of the allocation granularity on windows.
+#define SPARSE_CACHE_VIEW_SIZE (16 * 1024 * 1024)
+#define SPARSE_CACHE_INDEX_MAGIC "XBMCSFC2"
+
+// kept cache files that are open, they must not be pruned or opened a second time
+static CCriticalSection     g_sparseCacheSection;
+static std::set<CStdString> g_sparseCacheOpen;
+
+CSparseFileCache::CSparseFileCache(bool persistent, int64_t persistentSize)
+  : m_readPos(0)
+  , m_writePos(0)
+  , m_persistent(persistent)
+  , m_keep(false)
+  , m_persistentSize(persistentSize)
+  , m_sourceLength(0)
+#ifdef _WIN32
+  , m_file(INVALID_HANDLE_VALUE)
+#else
+  , m_file(-1)
+#endif
+{
+  m_readView.data  = NULL;
+  m_readView.start = 0;
+  m_writeView.data  = NULL;
+  m_writeView.start = 0;
+}
+
+CSparseFileCache::~CSparseFileCache()
+{
+  Close();
+}
+
+void CSparseFileCache::SetSource(const CStdString &path, int64_t length, const CStdString &version)
+{
+  m_source        = path;
+  m_sourceLength  = length;
+  m_sourceVersion = version;
+}
+
+int CSparseFileCache::Open()
+{
+  Close();
+
+  CSingleLock lock(m_sync);
+
+  // we can only find our data again if we know what we cached, and can tell
+  // whether the source changed since
+  bool persist = m_persistent && !m_source.IsEmpty() && m_sourceLength > 0 && !m_sourceVersion.IsEmpty();
+  if (persist)
+  {
+    Crc32 crc;
+    crc.ComputeFromLowerCase(m_source);
+    CStdString fileName;
+    fileName.Format("special://temp/filecache-%08x.cache", (uint32_t)crc);
+    m_cacheFile = CSpecialProtocol::TranslatePath(fileName);
+
+    // the same source may be cached by another reader, which then owns the kept file
+    CSingleLock openLock(g_sparseCacheSection);
+    persist = g_sparseCacheOpen.insert(m_cacheFile).second;
+    openLock.Leave();
+
+    if (persist)
+      PruneKept();
+  }
+  if (!persist)
+    m_cacheFile = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+
+  if (m_cacheFile.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    return CACHE_RC_ERROR;
+  }
+
+#ifdef _WIN32
+  m_file = CreateFile(m_cacheFile.c_str()
+            , GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ
+            , NULL
+            , persist ? OPEN_ALWAYS : CREATE_ALWAYS
+            , persist ? FILE_ATTRIBUTE_NORMAL : FILE_ATTRIBUTE_NORMAL | FILE_FLAG_DELETE_ON_CLOSE
+            , NULL);
+  if (m_file == INVALID_HANDLE_VALUE)
+#else
+  m_file = open(m_cacheFile.c_str(), O_RDWR | O_CREAT | (persist ? 0 : O_TRUNC), 0644);
+  if (m_file < 0)
+#endif
+  {
+    CLog::Log(LOGERROR, "%s - failed to create file %s with error code %d", __FUNCTION__, m_cacheFile.c_str(), GetLastError());
+    if (persist)
+    {
+      CSingleLock openLock(g_sparseCacheSection);
+      g_sparseCacheOpen.erase(m_cacheFile);
+    }
+    return CACHE_RC_ERROR;
+  }
+
+#ifndef _WIN32
+  // we keep the descriptor, the file goes away with it
+  if (!persist)
+    unlink(m_cacheFile.c_str());
+#endif
+
+  m_ranges.clear();
+  m_keep = persist;
+  if (m_keep && LoadIndex())
+    CLog::Log(LOGDEBUG, "%s - reusing %u cached ranges of %s", __FUNCTION__, (unsigned int)m_ranges.size(), m_source.c_str());
+
+  m_readPos  = 0;
+  m_writePos = 0;
+  m_written.Reset();
+  return CACHE_RC_OK;
+}
+
+void CSparseFileCache::Close()
+{
+  CSingleLock lock(m_sync);
+
+  UnmapView(m_readView);
+  UnmapView(m_writeView);
+
+#ifdef _WIN32
+  if (m_file != INVALID_HANDLE_VALUE)
+  {
+    SaveIndex();
+    CloseHandle(m_file);
+  }
+  m_file = INVALID_HANDLE_VALUE;
+#else
+  if (m_file >= 0)
+  {
+    SaveIndex();
+    close(m_file);
+  }
+  m_file = -1;
+#endif
+  m_ranges.clear();
+
+  if (m_keep)
+  {
+    CSingleLock openLock(g_sparseCacheSection);
+    g_sparseCacheOpen.erase(m_cacheFile);
+    m_keep = false;
+  }
+}
+
+bool CSparseFileCache::LoadIndex()
+{
+  // the index is only valid for the same source we cached before
+  CFile file;
+  if (!file.Open(m_cacheFile + ".idx"))
+    return false;
+
+  char    magic[8];
+  int64_t length = 0;
+  int32_t versionSize = 0;
+  int64_t count  = 0;
+  if (file.Read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, SPARSE_CACHE_INDEX_MAGIC, sizeof(magic))
+   || file.Read(&length, sizeof(length)) != sizeof(length) || length != m_sourceLength
+   || file.Read(&versionSize, sizeof(versionSize)) != sizeof(versionSize) || versionSize != (int32_t)m_sourceVersion.size())
+    return false;
+
+  std::string version(versionSize, '\0');
+  if ((versionSize && file.Read(&version[0], versionSize) != versionSize) || version != m_sourceVersion.c_str()
+   || file.Read(&count, sizeof(count)) != sizeof(count))
+    return false;
+
+  // the data file may have been removed or truncated since the index was written
+  int64_t size = 0;
+#ifdef _WIN32
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(m_file, &fileSize))
+    size = fileSize.QuadPart;
+#else
+  struct stat st;
+  if (fstat(m_file, &st) == 0)
+    size = st.st_size;
+#endif
+
+  for (int64_t i = 0; i < count; i++)
+  {
+    int64_t range[2];
+    if (file.Read(range, sizeof(range)) != sizeof(range)
+     || range[0] < 0 || range[0] >= range[1] || range[1] > size || range[1] > m_sourceLength)
+    {
+      CLog::Log(LOGDEBUG, "%s - cache index of %s doesn't match its data, discarding it", __FUNCTION__, m_source.c_str());
+      m_ranges.clear();
+      return false;
+    }
+    AddRange(range[0], range[1]);
+  }
+  return true;
+}
+
+void CSparseFileCache::SaveIndex()
+{
+  if (!m_keep)
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(m_cacheFile + ".idx", true))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write cache index for %s", __FUNCTION__, m_source.c_str());
+    return;
+  }
+
+  int64_t count = m_ranges.size();
+  int32_t versionSize = m_sourceVersion.size();
+  file.Write(SPARSE_CACHE_INDEX_MAGIC, 8);
+  file.Write(&m_sourceLength, sizeof(m_sourceLength));
+  file.Write(&versionSize, sizeof(versionSize));
+  file.Write(m_sourceVersion.c_str(), versionSize);
+  file.Write(&count, sizeof(count));
+  for (Ranges::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    int64_t range[2] = { it->first, it->second };
+    file.Write(range, sizeof(range));
+  }
+}
+
+void CSparseFileCache::PruneKept()
+{
+  CFileItemList items;
+  if (!CDirectory::GetDirectory("special://temp/", items, ".cache", DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  // last use is when the index was last written, which is when the file was closed
+  std::multimap<time_t, std::pair<CStdString, int64_t> > kept;
+  int64_t total = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CStdString path = items[i]->GetPath();
+    if (!URIUtils::GetFileName(path).Left(10).Equals("filecache-"))
+      continue;
+
+    // skip our own file, and those other caches are still using
+    CStdString translated = CSpecialProtocol::TranslatePath(path);
+    CSingleLock openLock(g_sparseCacheSection);
+    if (g_sparseCacheOpen.find(translated) != g_sparseCacheOpen.end())
+      continue;
+    openLock.Leave();
+
+    struct __stat64 st;
+    if (CFile::Stat(path, &st) != 0)
+      continue;
+#ifdef _WIN32
+    int64_t size = st.st_size;
+#else
+    int64_t size = (int64_t)st.st_blocks * 512; // only what the sparse file really holds
+#endif
+    time_t used = st.st_mtime;
+    if (CFile::Stat(path + ".idx", &st) == 0)
+      used = st.st_mtime;
+
+    kept.insert(std::make_pair(used, std::make_pair(path, size)));
+    total += size;
+  }
+
+  for (std::multimap<time_t, std::pair<CStdString, int64_t> >::iterator it = kept.begin(); it != kept.end() && total > m_persistentSize; ++it)
+  {
+    CLog::Log(LOGDEBUG, "%s - removing %s, kept cache files exceed %"PRId64" bytes", __FUNCTION__, it->second.first.c_str(), m_persistentSize);
+    CFile::Delete(it->second.first);
+    CFile::Delete(it->second.first + ".idx");
+    total -= it->second.second;
+  }
+}
+
+uint8_t *CSparseFileCache::MapView(View &view, int64_t pos, size_t &len)
+{
+  int64_t start = pos - pos % SPARSE_CACHE_VIEW_SIZE;
+  if (!view.data || view.start != start)
+  {
+    UnmapView(view);
+
+#ifdef _WIN32
+    // the mapping grows the file as needed, the view keeps the mapping alive
+    int64_t size = start + SPARSE_CACHE_VIEW_SIZE;
+    HANDLE mapping = CreateFileMapping(m_file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+    if (!mapping)
+      return NULL;
+    view.data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, (DWORD)(start >> 32), (DWORD)start, SPARSE_CACHE_VIEW_SIZE);
+    CloseHandle(mapping);
+#else
+    // extend the file so the whole view is backed, the file stays sparse
+    struct stat st;
+    if (fstat(m_file, &st) == 0 && st.st_size < start + SPARSE_CACHE_VIEW_SIZE)
+    {
+      if (ftruncate(m_file, start + SPARSE_CACHE_VIEW_SIZE) != 0)
+      {
+        CLog::Log(LOGERROR, "%s - unable to grow cache file to %"PRId64, __FUNCTION__, start + SPARSE_CACHE_VIEW_SIZE);
+        return NULL;
+      }
+    }
+    view.data = (uint8_t*)mmap(NULL, SPARSE_CACHE_VIEW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, start);
+    if (view.data == MAP_FAILED)
+      view.data = NULL;
+#endif
+    if (!view.data)
+    {
+      CLog::Log(LOGERROR, "%s - unable to map cache file at %"PRId64, __FUNCTION__, start);
+      return NULL;
+    }
+    view.start = start;
+  }
+
+  size_t offset = (size_t)(pos - start);
+  len = std::min(len, (size_t)SPARSE_CACHE_VIEW_SIZE - offset);
+  return view.data + offset;
+}
+
+void CSparseFileCache::UnmapView(View &view)
+{
+  if (!view.data)
+    return;
+#ifdef _WIN32
+  UnmapViewOfFile(view.data);
+#else
+  munmap(view.data, SPARSE_CACHE_VIEW_SIZE);
+#endif
+  view.data = NULL;
+}
+
+int64_t CSparseFileCache::GetRangeEnd(int64_t pos) const
+{
+  // find the last range starting at or before pos
+  Ranges::const_iterator it = m_ranges.upper_bound(pos);
+  if (it == m_ranges.begin())
+    return pos;
+  --it;
+  return std::max(it->second, pos);
+}
+
+void CSparseFileCache::AddRange(int64_t start, int64_t end)
+{
+  if (end <= start)
+    return;
+
+  // merge with any range overlapping or touching the new one
+  Ranges::iterator it = m_ranges.upper_bound(start);
+  if (it != m_ranges.begin())
+  {
+    Ranges::iterator prev = it;
+    --prev;
+    if (prev->second >= start)
+    {
+      start = prev->first;
+      end   = std::max(end, prev->second);
+      m_ranges.erase(prev);
+    }
+  }
+  while (it != m_ranges.end() && it->first <= end)
+  {
+    end = std::max(end, it->second);
+    m_ranges.erase(it++);
+  }
+  m_ranges[start] = end;
+}
+
+int CSparseFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  uint8_t *dest = MapView(m_writeView, m_writePos, iSize);
+  if (!dest)
+    return CACHE_RC_ERROR;
+
+  memcpy(dest, pBuffer, iSize);
+  AddRange(m_writePos, m_writePos + iSize);
+  m_writePos += iSize;
+
+  // when reader waits for data it will wait on the event.
+  m_written.Set();
+  return iSize;
+}
+
+int CSparseFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t avail = (size_t)std::min<int64_t>(GetRangeEnd(m_readPos) - m_readPos, iMaxSize);
+  if (avail == 0)
+  {
+    if (m_bEndOfInput && m_readPos >= m_writePos)
+      return 0;
+    if (m_sourceLength > 0 && m_readPos >= m_sourceLength)
+      return 0;
+    return CACHE_RC_WOULD_BLOCK;
+  }
+
+  const uint8_t *src = MapView(m_readView, m_readPos, avail);
+  if (!src)
+    return CACHE_RC_ERROR;
+
+  memcpy(pBuffer, src, avail);
+  m_readPos += avail;
+
+  m_space.Set();
+  return avail;
+}
+
+int64_t CSparseFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = GetRangeEnd(m_readPos) - m_readPos;
+
+  if (iMillis == 0 || IsEndOfInput())
+    return avail;
+
+  XbmcThreads::EndTime endtime(iMillis);
+  // only data the source is writing right behind us will ever show up
+  while (!IsEndOfInput() && avail < iMinAvail && m_readPos + avail == m_writePos && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = GetRangeEnd(m_readPos) - m_readPos;
+  }
+
+  return avail;
+}
+
+int64_t CSparseFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what is being written, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (GetRangeEnd(iFilePosition) == iFilePosition && iFilePosition > m_writePos && iFilePosition < m_writePos + 100000)
+  {
+    XbmcThreads::EndTime endtime(5000);
+    while (!IsEndOfInput() && m_writePos < iFilePosition && !endtime.IsTimePast())
+    {
+      lock.Leave();
+      m_written.WaitMSec(50);
+      lock.Enter();
+    }
+  }
+
+  // anything within (or right at the end of) a cached range can be read from the cache
+  Ranges::const_iterator it = m_ranges.upper_bound(iFilePosition);
+  if (it != m_ranges.begin() && (--it)->second >= iFilePosition)
+  {
+    m_readPos = iFilePosition;
+    m_space.Set();
+    return iFilePosition;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+void CSparseFileCache::Reset(int64_t iSourcePosition)
+{
+  // the source now continues at the given position, cached ranges stay
+  CSingleLock lock(m_sync);
+  m_writePos = iSourcePosition;
+  m_readPos  = iSourcePosition;
+}
+
+void CSparseFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_written.Set();
+}
+
+int64_t CSparseFileCache::GetSourceSeekPosition()
+{
+  CSingleLock lock(m_sync);
+  if (GetRangeEnd(m_readPos) > m_readPos || m_readPos == m_writePos)
+    return -1;
+  if (m_sourceLength > 0 && m_readPos >= m_sourceLength)
+    return -1;
+  return m_readPos;
+}
+
 }
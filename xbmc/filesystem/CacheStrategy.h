@@ -24,6 +24,7 @@
 #define XFILECACHESTRATEGY_H
 
 #include <stdint.h>
+#include <map>
 #ifdef _LINUX
 #include "PlatformDefs.h"
 #include "XHandlePublic.h"
@@ -31,6 +32,7 @@
 #endif
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "utils/StdString.h"
 
 namespace XFILE {
 
@@ -58,6 +60,31 @@ public:
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
 
+  /*!
+   \brief Tell the cache which source it is about to cache, prior to Open()
+   Strategies that keep data between plays use this to find it again.
+   \param path the path of the source
+   \param length the length of the source, 0 if unknown
+   \param version what identifies this version of the source (etag, modification time), empty if unknown
+   */
+  virtual void SetSource(const CStdString &path, int64_t length, const CStdString &version) {};
+
+  /*!
+   \brief Position the source should continue from for reads to make progress.
+   Strategies that serve reads from data cached earlier may have a read position
+   that isn't being filled by the source.
+   \return the position to move the source to, or -1 if data for the read position is on its way
+   */
+  virtual int64_t GetSourceSeekPosition() { return -1; };
+
+  /*!
+   \brief Hint that a region of the source will be read again and should stay cached.
+   Used for areas such as a seek index that the reader keeps returning to.
+   \param iFilePosition start of the region
+   \param iLength length of the region
+   */
+  virtual void SetKeepRegion(int64_t iFilePosition, int64_t iLength) {};
+
   CEvent m_space;
 protected:
   bool  m_bEndOfInput;
@@ -92,6 +119,72 @@ protected:
   volatile int64_t m_nReadPosition;
 };
 
+/**
+ * File cache backed by a sparse, memory mapped file, that keeps track of
+ * the byte ranges of the source it holds. Seeking into any of the ranges
+ * is served from the mapping, instead of restarting the download. The file
+ * and its range index can be kept to be reused by the next play of the source.
+ */
+class CSparseFileCache : public CCacheStrategy {
+public:
+  /*!
+   \param persistent keep the cache file of sources that can be recognised again
+   \param persistentSize bytes the kept cache files may use on disk, the least recently used go first
+   */
+  CSparseFileCache(bool persistent = false, int64_t persistentSize = 0);
+  virtual ~CSparseFileCache();
+
+  virtual void SetSource(const CStdString &path, int64_t length, const CStdString &version);
+  virtual int Open();
+  virtual void Close();
+
+  virtual int WriteToCache(const char *pBuffer, size_t iSize);
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize);
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis);
+
+  virtual int64_t Seek(int64_t iFilePosition);
+  virtual void Reset(int64_t iSourcePosition);
+  virtual void EndOfInput();
+  virtual int64_t GetSourceSeekPosition();
+
+protected:
+  struct View
+  {
+    uint8_t *data;
+    int64_t  start;
+  };
+
+  typedef std::map<int64_t, int64_t> Ranges; ///< start -> end of each cached range
+
+  int64_t  GetRangeEnd(int64_t pos) const;
+  void     AddRange(int64_t start, int64_t end);
+  uint8_t *MapView(View &view, int64_t pos, size_t &len);
+  void     UnmapView(View &view);
+  bool     LoadIndex();
+  void     SaveIndex();
+  void     PruneKept();
+
+  Ranges     m_ranges;
+  int64_t    m_readPos;
+  int64_t    m_writePos;
+  View       m_readView;
+  View       m_writeView;
+  bool       m_persistent; ///< keep cache files between plays when possible
+  bool       m_keep;       ///< whether the current cache file is kept
+  int64_t    m_persistentSize;
+  CStdString m_source;
+  int64_t    m_sourceLength;
+  CStdString m_sourceVersion;
+  CStdString m_cacheFile;
+#ifdef _WIN32
+  HANDLE     m_file;
+#else
+  int        m_file;
+#endif
+  CCriticalSection m_sync;
+  CEvent           m_written;
+};
+
 }
 
 #endif
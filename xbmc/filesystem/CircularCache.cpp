@@ -25,6 +25,9 @@
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
 #include "CircularCache.h"
+#ifdef _WIN32
+#include "PlatformDefs.h" //for PRId64
+#endif
 
 using namespace XFILE;
 
@@ -220,3 +223,319 @@ void CCircularCache::Reset(int64_t pos)
   m_cur = pos;
 }
 
+// size of the blocks the segment cache manages its memory in
+#define SEGMENT_BLOCK_SIZE (256 * 1024)
+
+CSegmentCache::CSegmentCache(size_t front, size_t back)
+ : CCacheStrategy()
+ , m_buf(NULL)
+ , m_size(front + back)
+ , m_front(front)
+ , m_keepSize(0)
+ , m_cur(0)
+ , m_end(0)
+ , m_stamp(0)
+{
+}
+
+CSegmentCache::~CSegmentCache()
+{
+  Close();
+}
+
+int CSegmentCache::Open()
+{
+  CSingleLock lock(m_sync);
+
+  size_t count = std::max<size_t>(m_size / SEGMENT_BLOCK_SIZE, 4);
+  m_buf = new uint8_t[count * SEGMENT_BLOCK_SIZE];
+  if(m_buf == 0)
+    return CACHE_RC_ERROR;
+
+  Block unused = { -1, 0, 0, 0 };
+  m_blocks.assign(count, unused);
+  m_index.clear();
+  m_keep.clear();
+  m_keepSize = 0;
+  m_cur = 0;
+  m_end = 0;
+  m_stamp = 0;
+  return CACHE_RC_OK;
+}
+
+void CSegmentCache::Close()
+{
+  CSingleLock lock(m_sync);
+  delete[] m_buf;
+  m_buf = NULL;
+  m_blocks.clear();
+  m_index.clear();
+}
+
+CSegmentCache::Block *CSegmentCache::FindBlock(int64_t index)
+{
+  BlockMap::iterator it = m_index.find(index);
+  if(it == m_index.end())
+    return NULL;
+  return &m_blocks[it->second];
+}
+
+bool CSegmentCache::IsProtected(const Block &block) const
+{
+  int64_t beg = block.index * SEGMENT_BLOCK_SIZE;
+  int64_t end = beg + SEGMENT_BLOCK_SIZE;
+
+  // the data the reader is about to consume
+  if(end > m_cur && beg < m_cur + (int64_t)m_front)
+    return true;
+
+  // and the block being written
+  if(block.index == m_end / SEGMENT_BLOCK_SIZE)
+    return true;
+
+  for(Regions::const_iterator it = m_keep.begin(); it != m_keep.end(); ++it)
+  {
+    if(end > it->first && beg < it->second)
+      return true;
+  }
+  return false;
+}
+
+CSegmentCache::Block *CSegmentCache::AllocBlock(int64_t index)
+{
+  // take an unused block, or the least recently used one we may drop
+  Block *victim = NULL;
+  for(std::vector<Block>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if(it->index < 0)
+    {
+      victim = &*it;
+      break;
+    }
+    if((!victim || (int)(it->used - victim->used) < 0) && !IsProtected(*it))
+      victim = &*it;
+  }
+
+  // the read window and the kept regions can cover every block, the writer
+  // would stall then. drop the block furthest from the reader, the reader
+  // blocks and the source is moved back should it ever get there.
+  if(!victim)
+  {
+    int64_t cur      = m_cur / SEGMENT_BLOCK_SIZE;
+    int64_t distance = 0;
+    for(std::vector<Block>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+      if(it->index == m_end / SEGMENT_BLOCK_SIZE)
+        continue;
+      int64_t d = it->index > cur ? it->index - cur : cur - it->index;
+      if(d > distance)
+      {
+        distance = d;
+        victim   = &*it;
+      }
+    }
+    if(!victim)
+      return NULL;
+    CLog::Log(LOGDEBUG, "CSegmentCache::AllocBlock - all blocks protected, dropping block %"PRId64, victim->index);
+  }
+
+  if(victim->index >= 0)
+    m_index.erase(victim->index);
+
+  victim->index = index;
+  victim->beg   = 0;
+  victim->end   = 0;
+  victim->used  = ++m_stamp;
+  m_index[index] = victim - &m_blocks[0];
+  return victim;
+}
+
+/**
+ * Data is written at m_end into the block holding that
+ * position. Will only write up to the end of the block,
+ * so multiple calls may be needed to write all data.
+ *
+ * The amount of data ahead of the reader is limited to
+ * the front size, and blocks the reader may still need
+ * are never dropped to make room.
+ */
+int CSegmentCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  // limit by max forward size
+  if(m_end >= m_cur && m_end - m_cur >= (int64_t)m_front)
+    return 0;
+
+  int64_t index  = m_end / SEGMENT_BLOCK_SIZE;
+  size_t  offset = (size_t)(m_end % SEGMENT_BLOCK_SIZE);
+
+  Block *block = FindBlock(index);
+  if(!block)
+    block = AllocBlock(index);
+  if(!block)
+    return 0;
+
+  // data in a block is kept contiguous, drop what we can't join to
+  if(offset < block->beg || offset > block->end)
+  {
+    block->beg = offset;
+    block->end = offset;
+  }
+
+  len = std::min(len, SEGMENT_BLOCK_SIZE - offset);
+  memcpy(m_buf + (block - &m_blocks[0]) * SEGMENT_BLOCK_SIZE + offset, buf, len);
+  block->end  = std::max(block->end, offset + len);
+  block->used = ++m_stamp;
+  m_end += len;
+
+  m_written.Set();
+
+  return len;
+}
+
+/**
+ * Reads data from cache. Will only read up till
+ * the end of a block. So multiple calls
+ * may be needed to read all available data
+ */
+int CSegmentCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  size_t offset = (size_t)(m_cur % SEGMENT_BLOCK_SIZE);
+  Block *block  = FindBlock(m_cur / SEGMENT_BLOCK_SIZE);
+  if(!block || offset < block->beg || offset >= block->end)
+  {
+    if(IsEndOfInput() && m_cur >= m_end)
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  len = std::min(len, block->end - offset);
+  if(len == 0)
+    return 0;
+
+  memcpy(buf, m_buf + (block - &m_blocks[0]) * SEGMENT_BLOCK_SIZE + offset, len);
+  block->used = ++m_stamp;
+  m_cur += len;
+
+  m_space.Set();
+
+  return len;
+}
+
+uint64_t CSegmentCache::GetAvailable(int64_t pos)
+{
+  // follow the blocks as long as the data is contiguous
+  uint64_t avail = 0;
+  while(true)
+  {
+    size_t offset = (size_t)(pos % SEGMENT_BLOCK_SIZE);
+    Block *block  = FindBlock(pos / SEGMENT_BLOCK_SIZE);
+    if(!block || offset < block->beg || offset >= block->end)
+      break;
+    avail += block->end - offset;
+    pos   += block->end - offset;
+    if(block->end < SEGMENT_BLOCK_SIZE)
+      break;
+  }
+  return avail;
+}
+
+int64_t CSegmentCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  uint64_t avail = GetAvailable(m_cur);
+
+  if(millis == 0 || IsEndOfInput())
+    return avail;
+
+  if(minimum > m_front)
+    minimum = m_front;
+
+  // only data written right behind what we have will ever show up
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && m_cur + (int64_t)avail == m_end && !endtime.IsTimePast() )
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = GetAvailable(m_cur);
+  }
+
+  return avail;
+}
+
+int64_t CSegmentCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos > m_end && pos < m_end + 100000 && GetAvailable(pos) == 0)
+  {
+    XbmcThreads::EndTime endtime(5000);
+    while (!IsEndOfInput() && m_end < pos && !endtime.IsTimePast())
+    {
+      lock.Leave();
+      m_written.WaitMSec(50);
+      lock.Enter();
+    }
+  }
+
+  // anything within a segment, or right where we are writing, can be read from cache
+  size_t offset = (size_t)(pos % SEGMENT_BLOCK_SIZE);
+  Block *block  = FindBlock(pos / SEGMENT_BLOCK_SIZE);
+  if((block && offset >= block->beg && offset <= block->end) || pos == m_end)
+  {
+    m_cur = pos;
+    m_space.Set();
+    return pos;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+void CSegmentCache::Reset(int64_t pos)
+{
+  // the source continues at pos, other segments stay cached
+  CSingleLock lock(m_sync);
+  m_end = pos;
+  m_cur = pos;
+}
+
+void CSegmentCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_written.Set();
+}
+
+int64_t CSegmentCache::GetSourceSeekPosition()
+{
+  CSingleLock lock(m_sync);
+  if(m_cur == m_end || GetAvailable(m_cur) > 0)
+    return -1;
+  return m_cur;
+}
+
+void CSegmentCache::SetKeepRegion(int64_t pos, int64_t len)
+{
+  CSingleLock lock(m_sync);
+
+  // readers tend to hint the same index on every seek
+  for(Regions::const_iterator it = m_keep.begin(); it != m_keep.end(); ++it)
+  {
+    if(pos >= it->first && pos + len <= it->second)
+      return;
+  }
+
+  // never let kept regions take more than a quarter of the cache
+  len = std::min<int64_t>(len, m_size / 4 - m_keepSize);
+  if(len <= 0)
+    return;
+
+  m_keep.push_back(std::make_pair(pos, pos + len));
+  m_keepSize += len;
+}
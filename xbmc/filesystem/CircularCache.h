@@ -25,6 +25,8 @@
 #include "CacheStrategy.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include <map>
+#include <vector>
 
 namespace XFILE {
 
@@ -58,5 +60,61 @@ protected:
 #endif
 };
 
+/**
+ * Memory cache holding several independent segments of the source within
+ * the same budget as CCircularCache. The memory is split in fixed size blocks,
+ * and blocks outside the current read window are evicted least recently used
+ * first, unless they are part of a region the reader asked to keep (such as the
+ * header, or an index at the end of the file).
+ */
+class CSegmentCache : public CCacheStrategy
+{
+public:
+    CSegmentCache(size_t front, size_t back);
+    virtual ~CSegmentCache();
+
+    virtual int Open() ;
+    virtual void Close();
+
+    virtual int WriteToCache(const char *buf, size_t len) ;
+    virtual int ReadFromCache(char *buf, size_t len) ;
+    virtual int64_t WaitForData(unsigned int minimum, unsigned int iMillis) ;
+
+    virtual int64_t Seek(int64_t pos) ;
+    virtual void Reset(int64_t pos) ;
+    virtual void EndOfInput();
+    virtual int64_t GetSourceSeekPosition();
+    virtual void SetKeepRegion(int64_t pos, int64_t len);
+
+protected:
+    struct Block
+    {
+      int64_t  index;   /**< block number in the file, -1 if unused */
+      size_t   beg;     /**< start of valid data within the block */
+      size_t   end;     /**< end of valid data within the block */
+      unsigned used;    /**< last use, for lru eviction */
+    };
+    typedef std::map<int64_t, unsigned int> BlockMap;
+    typedef std::vector<std::pair<int64_t, int64_t> > Regions;
+
+    Block   *FindBlock(int64_t index);
+    Block   *AllocBlock(int64_t index);
+    bool     IsProtected(const Block &block) const;
+    uint64_t GetAvailable(int64_t pos);
+
+    uint8_t          *m_buf;       /**< buffer holding all blocks */
+    size_t            m_size;      /**< size of buffer */
+    size_t            m_front;     /**< maximum amount of data to cache ahead of the reader */
+    std::vector<Block> m_blocks;
+    BlockMap          m_index;     /**< block number in file -> position in m_blocks */
+    Regions           m_keep;      /**< regions hinted to stay cached */
+    int64_t           m_keepSize;
+    int64_t           m_cur;       /**< current reading index in file */
+    int64_t           m_end;       /**< current writing index in file */
+    unsigned          m_stamp;
+    CCriticalSection  m_sync;
+    CEvent            m_written;
+};
+
 } // namespace XFILE
 #endif
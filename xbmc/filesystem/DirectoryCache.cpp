@@ -20,22 +20,30 @@
  */
 
 #include "DirectoryCache.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "URL.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "video/VideoInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "climits"
 
+#include <algorithm>
+
 using namespace std;
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
+  m_size = 0;
+  m_expires = 0;
   m_Items = new CFileItemList;
-  m_Items->SetFastLookup(true);
 }
 
 CDirectoryCache::CDir::~CDir()
@@ -43,20 +51,61 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::SetItems(const CFileItemList &items)
 {
-  m_lastAccess = accessCounter++;
+  m_Items->Copy(items);
+  m_paths.clear();
+  m_paths.reserve(m_Items->Size());
+  m_size = sizeof(CDir) + sizeof(CFileItemList);
+  for (int i = 0; i < m_Items->Size(); i++)
+  {
+    const CFileItemPtr item = m_Items->Get(i);
+    CStdString path(item->GetPath()); path.ToLower();
+    m_size += GetItemSize(*item) + sizeof(CStdString) + path.size();
+    m_paths.push_back(path);
+  }
+  sort(m_paths.begin(), m_paths.end());
+}
+
+void CDirectoryCache::CDir::AddFile(const CStdString &strFile)
+{
+  CFileItemPtr item(new CFileItem(strFile, false));
+  m_Items->Add(item);
+  CStdString path(strFile); path.ToLower();
+  m_size += GetItemSize(*item) + sizeof(CStdString) + path.size();
+  m_paths.insert(lower_bound(m_paths.begin(), m_paths.end(), path), path);
+}
+
+bool CDirectoryCache::CDir::Contains(const CStdString &strFile) const
+{
+  // checks case insensitive
+  CStdString path(strFile); path.ToLower();
+  return binary_search(m_paths.begin(), m_paths.end(), path);
+}
+
+unsigned int CDirectoryCache::CDir::GetItemSize(const CFileItem &item)
+{
+  // a rough estimate - strings are only counted by their length
+  unsigned int size = sizeof(CFileItem) + sizeof(CFileItemPtr);
+  size += item.GetPath().size() + item.GetLabel().size() + item.GetLabel2().size();
+  if (item.HasMusicInfoTag())
+    size += sizeof(MUSIC_INFO::CMusicInfoTag);
+  if (item.HasVideoInfoTag())
+    size += sizeof(CVideoInfoTag);
+  if (item.HasPictureInfoTag())
+    size += sizeof(CPictureInfoTag);
+  return size;
 }
 
 CDirectoryCache::CDirectoryCache(void)
 {
   m_iThumbCacheRefCount = 0;
   m_iMusicThumbCacheRefCount = 0;
-  m_accessCounter = 0;
-#ifdef _DEBUG
+  m_size = 0;
   m_cacheHits = 0;
   m_cacheMisses = 0;
-#endif
+  m_evictions = 0;
+  m_expirations = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void)
@@ -70,21 +119,20 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end() && !Expire(i))
   {
     CDir* dir = i->second;
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      Touch(dir);
+      m_cacheHits++;
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -111,11 +159,29 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
+  // don't let one huge listing push everything else out of the cache
+  unsigned int size = 0;
+  for (int i = 0; i < items.Size(); i++)
+    size += CDir::GetItemSize(*items[i]);
+  if (size > (unsigned int)g_advancedSettings.m_dirCacheSize * 1024 / 2)
+  {
+    CLog::Log(LOGDEBUG, "%s - not caching %s, %d items is too large", __FUNCTION__, storedPath.c_str(), items.Size());
+    return;
+  }
+  Trim(size);
 
   CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
+  dir->SetItems(items);
+
+  CStdString protocol = CURL(storedPath).GetProtocol();
+  if (protocol.IsEmpty())
+    protocol = "file";
+  map<CStdString, int>::const_iterator ttl = g_advancedSettings.m_dirCacheTTL.find(protocol.ToLower());
+  if (ttl != g_advancedSettings.m_dirCacheTTL.end() && ttl->second > 0)
+    dir->m_expires = (XbmcThreads::SystemClockMillis() + ttl->second * 1000) | 1;
+
+  dir->m_lruPos = m_lru.insert(m_lru.begin(), storedPath);
+  m_size += dir->m_size;
   m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
 }
 
@@ -164,13 +230,14 @@ void CDirectoryCache::AddFile(const CStdString& strFile)
   URIUtils::GetDirectory(strFile, strPath);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  iCache i = m_cache.find(strPath);
+  if (i != m_cache.end() && !Expire(i))
   {
     CDir *dir = i->second;
-    CFileItemPtr item(new CFileItem(strFile, false));
-    dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    m_size -= dir->m_size;
+    dir->AddFile(strFile);
+    m_size += dir->m_size;
+    Touch(dir);
   }
 }
 
@@ -183,20 +250,16 @@ bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
   URIUtils::GetDirectory(strFile, strPath);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  iCache i = m_cache.find(strPath);
+  if (i != m_cache.end() && !Expire(i))
   {
     bInCache = true;
     CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
+    Touch(dir);
     m_cacheHits++;
-#endif
-    return dir->m_Items->Contains(strFile);
+    return dir->Contains(strFile);
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
@@ -331,54 +394,83 @@ void CDirectoryCache::ClearMusicThumbCache()
   ClearCache(m_musicThumbDirs);
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::Trim(unsigned int size)
 {
   CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
+  unsigned int maxSize = (unsigned int)g_advancedSettings.m_dirCacheSize * 1024;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // walk from the least recently used folder, skipping the thumb folders we keep cached
+  // and the listings that are to be cached always
+  list<CStdString>::iterator it = m_lru.end();
+  while (m_size + size > maxSize && it != m_lru.begin())
   {
-    // ensure dirs that are always cached aren't cleared
-    if (!IsCacheDir(i->first) && i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    --it;
+    if (IsCacheDir(*it))
+      continue;
+
+    list<CStdString>::iterator next = it;
+    ++next;
+    iCache i = m_cache.find(*it);
+    if (i != m_cache.end() && i->second->m_cacheType == XFILE::DIR_CACHE_ALWAYS)
+      continue;
+    if (i != m_cache.end())
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      Delete(i);
+      m_evictions++;
     }
+    else
+      m_lru.erase(it);
+    it = next;
   }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
-    Delete(lastAccessed);
+}
+
+bool CDirectoryCache::Expire(iCache i)
+{
+  CDir* dir = i->second;
+  if (!dir->m_expires || (int)(XbmcThreads::SystemClockMillis() - dir->m_expires) < 0)
+    return false;
+
+  Delete(i);
+  m_expirations++;
+  return true;
+}
+
+void CDirectoryCache::Touch(CDir *dir)
+{
+  m_lru.splice(m_lru.begin(), m_lru, dir->m_lruPos);
 }
 
 void CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  m_size -= dir->m_size;
+  m_lru.erase(dir->m_lruPos);
   delete dir;
   m_cache.erase(it);
 }
 
-#ifdef _DEBUG
-void CDirectoryCache::PrintStats() const
+void CDirectoryCache::GetStats(DirectoryCacheStats &stats) const
 {
   CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.evictions = m_evictions;
+  stats.expirations = m_expirations;
+  stats.directories = m_cache.size();
+  stats.items = 0;
   for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
-  {
-    if (!IsCacheDir(i->first))
-    {
-      CDir *dir = i->second;
-      oldest = min(oldest, dir->GetLastAccess());
-      numItems += dir->m_Items->Size();
-      numDirs++;
-    }
-  }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+    stats.items += i->second->m_Items->Size();
+  stats.size = m_size;
+  stats.maxSize = (unsigned int)g_advancedSettings.m_dirCacheSize * 1024;
+}
+
+#ifdef _DEBUG
+void CDirectoryCache::PrintStats() const
+{
+  DirectoryCacheStats stats;
+  GetStats(stats);
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, stats.hits, stats.misses);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using %u of %u bytes. %u evicted, %u expired", __FUNCTION__,
+            stats.directories, stats.items, stats.size, stats.maxSize, stats.evictions, stats.expirations);
 }
 #endif
@@ -24,13 +24,31 @@
 #include "Directory.h"
 #include "threads/CriticalSection.h"
 
+#include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Counters of the directory cache
+   \sa CDirectoryCache::GetStats
+   */
+  struct DirectoryCacheStats
+  {
+    unsigned int hits;        ///< listings and file lookups answered from the cache
+    unsigned int misses;      ///< listings and file lookups that weren't cached
+    unsigned int evictions;   ///< listings dropped to stay within the memory budget
+    unsigned int expirations; ///< listings dropped because their protocol's ttl passed
+    unsigned int directories; ///< listings currently cached
+    unsigned int items;       ///< items in the cached listings
+    unsigned int size;        ///< estimated memory used by the cached listings, in bytes
+    unsigned int maxSize;     ///< memory budget, in bytes
+  };
+
   class CDirectoryCache
   {
     class CDir
@@ -39,13 +57,22 @@ namespace XFILE
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
+      /*! \brief Take a copy of a listing
+       Only the items are kept, and the per item lookup map of the list is replaced by a
+       sorted vector of paths, which is all FileExists() needs.
+       */
+      void SetItems(const CFileItemList &items);
+      void AddFile(const CStdString &strFile);
+      bool Contains(const CStdString &strFile) const;
+      static unsigned int GetItemSize(const CFileItem &item);
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      unsigned int m_size;                        ///< estimated memory used by the listing in bytes
+      unsigned int m_expires;                     ///< system clock time the listing expires at, 0 for never
+      std::list<CStdString>::iterator m_lruPos;   ///< position in the LRU list
     private:
-      unsigned int m_lastAccess;
+      std::vector<CStdString> m_paths;            ///< lower case paths of the items, sorted
     };
   public:
     CDirectoryCache(void);
@@ -62,6 +89,7 @@ namespace XFILE
     void ClearThumbCache();
     void InitMusicThumbCache();
     void ClearMusicThumbCache();
+    void GetStats(DirectoryCacheStats &stats) const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -69,25 +97,35 @@ namespace XFILE
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
     bool IsCacheDir(const CStdString &strPath) const;
-    void CheckIfFull();
+
+    /*! \brief Evict the least recently used listings until size more bytes fit in the budget
+     */
+    void Trim(unsigned int size);
 
     std::map<CStdString, CDir*> m_cache;
     typedef std::map<CStdString, CDir*>::iterator iCache;
     typedef std::map<CStdString, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
 
+    /*! \brief Check whether a listing outlived the ttl of its protocol, and drop it if so
+     \return true if the listing was dropped
+     */
+    bool Expire(iCache i);
+    void Touch(CDir *dir);
+
     CCriticalSection m_cs;
     std::set<CStdString> m_thumbDirs;
     std::set<CStdString> m_musicThumbDirs;
     int m_iThumbCacheRefCount;
     int m_iMusicThumbCacheRefCount;
 
-    unsigned int m_accessCounter;
+    std::list<CStdString> m_lru;  ///< cached paths, most recently used first
+    unsigned int m_size;          ///< estimated memory used by all listings in bytes
 
-#ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
-#endif
+    unsigned int m_evictions;
+    unsigned int m_expirations;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
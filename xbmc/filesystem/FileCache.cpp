@@ -27,6 +27,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "CurlFile.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -87,7 +88,10 @@ CFileCache::CFileCache()
    m_readPos = 0;
    m_writePos = 0;
    if (g_advancedSettings.m_cacheMemBufferSize == 0)
-     m_pCache = new CSimpleFileCache();
+     m_pCache = new CSparseFileCache(g_advancedSettings.m_cachePersistent, (int64_t)g_advancedSettings.m_cachePersistentSize * 1024 * 1024);
+   else if (g_advancedSettings.m_cacheSegmented)
+     m_pCache = new CSegmentCache(g_advancedSettings.m_cacheMemBufferSize
+                                , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
    else
      m_pCache = new CCircularCache(g_advancedSettings.m_cacheMemBufferSize
                                  , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
@@ -146,18 +150,35 @@ bool CFileCache::Open(const CURL& url)
 
   m_sourcePath = url.Get();
 
-  // open cache strategy
-  if (m_pCache->Open() != CACHE_RC_OK)
+  // opening the source file.
+  if (!m_source.Open(m_sourcePath, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
   {
-    CLog::Log(LOGERROR,"CFileCache::Open - failed to open cache");
+    CLog::Log(LOGERROR,"%s - failed to open source <%s>", __FUNCTION__, m_sourcePath.c_str());
     Close();
     return false;
   }
 
-  // opening the source file.
-  if (!m_source.Open(m_sourcePath, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
+  // what tells this version of the source apart from an earlier one
+  CStdString version;
+  CCurlFile *curl = dynamic_cast<CCurlFile*>(m_source.GetImplemenation());
+  if (curl)
   {
-    CLog::Log(LOGERROR,"%s - failed to open source <%s>", __FUNCTION__, m_sourcePath.c_str());
+    version = curl->GetHttpHeader().GetValue("etag");
+    if (version.IsEmpty())
+      version = curl->GetHttpHeader().GetValue("last-modified");
+  }
+  else
+  {
+    struct __stat64 st;
+    if (m_source.Stat(&st) == 0 && st.st_mtime)
+      version.Format("%"PRId64, (int64_t)st.st_mtime);
+  }
+
+  // open cache strategy
+  m_pCache->SetSource(m_sourcePath, m_source.GetLength(), version);
+  if (m_pCache->Open() != CACHE_RC_OK)
+  {
+    CLog::Log(LOGERROR,"CFileCache::Open - failed to open cache");
     Close();
     return false;
   }
@@ -345,6 +366,22 @@ retry:
 
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
+    // the cache may be serving data it got earlier, in which case the
+    // source has to continue from where we are reading now
+    int64_t sourcePos = m_pCache->GetSourceSeekPosition();
+    if (sourcePos >= 0 && m_seekPossible)
+    {
+      CLog::Log(LOGDEBUG, "%s - end of cached data, continue source at %"PRId64, __FUNCTION__, sourcePos);
+      m_seekPos = sourcePos;
+      m_seekEvent.Set();
+      if (!m_seekEnded.Wait())
+      {
+        CLog::Log(LOGWARNING, "%s - seek to %"PRId64" failed.", __FUNCTION__, m_seekPos);
+        return 0;
+      }
+      m_seekEvent.Reset();
+    }
+
     // just wait for some data to show up
     iRc = m_pCache->WaitForData(1, 10000);
     if (iRc > 0)
@@ -480,5 +517,12 @@ int CFileCache::IoControl(EIoControl request, void* param)
   if (request == IOCTRL_SEEK_POSSIBLE)
     return m_seekPossible;
 
+  if (request == IOCTRL_CACHE_KEEP)
+  {
+    SCacheRange* range = (SCacheRange*)param;
+    m_pCache->SetKeepRegion(range->offset, range->length);
+    return 0;
+  }
+
   return -1;
 }
@@ -46,7 +46,8 @@ namespace XFILE
     DIR_FLAG_NO_FILE_INFO  = (2 << 2), ///< Don't read additional file info (stat for example)
     DIR_FLAG_GET_HIDDEN    = (2 << 3), ///< Get hidden files
     DIR_FLAG_READ_CACHE    = (2 << 4), ///< Force reading from the directory cache (if available)
-    DIR_FLAG_BYPASS_CACHE  = (2 << 5)  ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_BYPASS_CACHE  = (2 << 5), ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_LAZY_DETAILS  = (2 << 6)  ///< Huge library listings may be made of light items (see CFileItemList::SetLazyDetails)
   };
 /*!
  \ingroup filesystem
@@ -55,11 +55,18 @@ struct SCacheStatus
   bool     full;     /**< is the cache full */
 };
 
+struct SCacheRange
+{
+  int64_t offset;    /**< start of the region in the file */
+  int64_t length;    /**< length of the region */
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1, /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2, /**< return 0 if known not to work, 1 if it should work */
   IOCTRL_CACHE_STATUS  = 3, /**< SCacheStatus structure */
   IOCTRL_CACHE_SETRATE = 4, /**< unsigned int with speed limit for caching in bytes per second */
+  IOCTRL_CACHE_KEEP    = 5, /**< SCacheRange structure with a region that will be read again and should stay cached */
 } EIoControl;
 
 class IFile
@@ -49,7 +49,9 @@ bool CMusicDatabaseDirectory::GetDirectory(const CStdString& strPath, CFileItemL
   if (!pNode.get())
     return false;
 
+  items.SetLazyDetails((m_flags & DIR_FLAG_LAZY_DETAILS) != 0);
   bool bResult = pNode->GetChilds(items);
+  items.SetLazyDetails(false);
   for (int i=0;i<items.Size();++i)
   {
     CFileItemPtr item = items[i];
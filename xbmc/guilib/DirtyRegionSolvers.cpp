@@ -22,6 +22,8 @@
 #include "DirtyRegionSolvers.h"
 #include "GraphicContext.h"
 #include <stdio.h>
+#include <math.h>
+#include <algorithm>
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
@@ -82,3 +84,132 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+#define DIRTYREGION_TILE_SIZE  32 // pixels
+#define DIRTYREGION_MAX_RECTS  32 // beyond this the regions are simply unified
+
+CTileDirtyRegionSolver::CTileDirtyRegionSolver()
+{
+  // a pass walks the whole window and control tree, which costs about as much as filling 256x256 pixels
+  m_costNewRegion = 256.0f * 256.0f;
+}
+
+float CTileDirtyRegionSolver::Cost(const CRect &region) const
+{
+  return m_costNewRegion + region.Area();
+}
+
+void CTileDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  if (input.empty())
+    return;
+
+  const CRect view(0, 0, (float)g_graphicsContext.GetWidth(), (float)g_graphicsContext.GetHeight());
+  const int columns = (g_graphicsContext.GetWidth() + DIRTYREGION_TILE_SIZE - 1) / DIRTYREGION_TILE_SIZE;
+  const int rows = (g_graphicsContext.GetHeight() + DIRTYREGION_TILE_SIZE - 1) / DIRTYREGION_TILE_SIZE;
+  if (columns <= 0 || rows <= 0)
+    return;
+
+  // mark the tiles touched by any of the regions
+  m_tiles.assign(columns * rows, false);
+  for (unsigned int i = 0; i < input.size(); i++)
+  {
+    CRect region(input[i]);
+    region.Intersect(view);
+    if (region.IsEmpty())
+      continue;
+
+    int x1 = (int)(region.x1 / DIRTYREGION_TILE_SIZE);
+    int y1 = (int)(region.y1 / DIRTYREGION_TILE_SIZE);
+    int x2 = std::min(columns, (int)ceilf(region.x2 / DIRTYREGION_TILE_SIZE));
+    int y2 = std::min(rows, (int)ceilf(region.y2 / DIRTYREGION_TILE_SIZE));
+    for (int y = y1; y < y2; y++)
+      for (int x = x1; x < x2; x++)
+        m_tiles[y * columns + x] = true;
+  }
+
+  // collect runs of marked tiles, extending a run from the row above when it spans the same columns
+  std::vector<CRect> rects;
+  std::vector<unsigned int> open, nextOpen;
+  for (int y = 0; y < rows; y++)
+  {
+    nextOpen.clear();
+    int x = 0;
+    while (x < columns)
+    {
+      if (!m_tiles[y * columns + x])
+      {
+        x++;
+        continue;
+      }
+      int start = x;
+      while (x < columns && m_tiles[y * columns + x])
+        x++;
+
+      float x1 = (float)(start * DIRTYREGION_TILE_SIZE);
+      float x2 = (float)(x * DIRTYREGION_TILE_SIZE);
+      float y2 = (float)((y + 1) * DIRTYREGION_TILE_SIZE);
+      bool extended = false;
+      for (unsigned int j = 0; j < open.size(); j++)
+      {
+        CRect &rect = rects[open[j]];
+        if (rect.x1 == x1 && rect.x2 == x2)
+        {
+          rect.y2 = y2;
+          nextOpen.push_back(open[j]);
+          extended = true;
+          break;
+        }
+      }
+      if (!extended)
+      {
+        rects.push_back(CRect(x1, (float)(y * DIRTYREGION_TILE_SIZE), x2, y2));
+        nextOpen.push_back(rects.size() - 1);
+      }
+    }
+    open.swap(nextOpen);
+  }
+
+  if (rects.size() > DIRTYREGION_MAX_RECTS)
+  {
+    // too fragmented to be worth evaluating, a single pass will do
+    CRect unifiedRegion;
+    for (unsigned int i = 0; i < rects.size(); i++)
+      unifiedRegion.Union(rects[i]);
+    rects.assign(1, unifiedRegion);
+  }
+
+  // merge the pair saving the most until no merge lowers the cost
+  while (rects.size() > 1)
+  {
+    unsigned int bestA = 0, bestB = 0;
+    float bestSaving = 0.0f;
+    for (unsigned int a = 0; a < rects.size(); a++)
+    {
+      for (unsigned int b = a + 1; b < rects.size(); b++)
+      {
+        CRect merged(rects[a]);
+        merged.Union(rects[b]);
+        float saving = Cost(rects[a]) + Cost(rects[b]) - Cost(merged);
+        if (saving > bestSaving)
+        {
+          bestSaving = saving;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+    if (bestSaving <= 0.0f)
+      break;
+    rects[bestA].Union(rects[bestB]);
+    rects.erase(rects.begin() + bestB);
+  }
+
+  for (unsigned int i = 0; i < rects.size(); i++)
+  {
+    CRect region(rects[i]);
+    region.Intersect(view);
+    if (!region.IsEmpty())
+      output.push_back(region);
+  }
+}
@@ -49,3 +49,23 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Solver snapping the marked regions to a grid of tiles.
+
+ The marked tiles are collected in rectangles, which are then merged as long as
+ a merge lowers the estimated cost of the frame: a fixed cost per rendering pass
+ plus the number of pixels redrawn. Unlike a plain union, two small regions in
+ opposite corners of the screen stay two small passes.
+ */
+class CTileDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CTileDirtyRegionSolver();
+  virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+private:
+  float Cost(const CRect &region) const;
+
+  float m_costNewRegion;        ///< cost of a rendering pass, in pixels
+  std::vector<bool> m_tiles;    ///< marked tiles, reused between frames
+};
@@ -28,6 +28,7 @@ CDirtyRegionTracker::CDirtyRegionTracker(int buffering)
 {
   m_buffering = buffering;
   m_solver = NULL;
+  m_solved = false;
 }
 
 CDirtyRegionTracker::~CDirtyRegionTracker()
@@ -38,6 +39,7 @@ CDirtyRegionTracker::~CDirtyRegionTracker()
 void CDirtyRegionTracker::SelectAlgorithm()
 {
   delete m_solver;
+  m_solved = false;
 
   switch (g_advancedSettings.m_guiAlgorithmDirtyRegions)
   {
@@ -49,6 +51,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       CLog::Log(LOGDEBUG, "guilib: Cost reduction as algorithm for solving rendering passes");
       m_solver = new CGreedyDirtyRegionSolver();
       break;
+    case DIRTYREGION_SOLVER_TILES:
+      CLog::Log(LOGDEBUG, "guilib: Tiles with cost reduction as algorithm for solving rendering passes");
+      m_solver = new CTileDirtyRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_UNION:
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
@@ -64,7 +70,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
 void CDirtyRegionTracker::MarkDirtyRegion(const CDirtyRegion &region)
 {
   if (!region.IsEmpty())
+  {
     m_markedRegions.push_back(region);
+    m_solved = false;
+  }
 }
 
 const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
@@ -74,17 +83,22 @@ const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
 
 CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions()
 {
-  CDirtyRegionList output;
-
-  if (m_solver)
-    m_solver->Solve(m_markedRegions, output);
+  // the regions are asked for more than once a frame, so solve once until they change
+  if (!m_solved)
+  {
+    m_dirtyRegions.clear();
+    if (m_solver)
+      m_solver->Solve(m_markedRegions, m_dirtyRegions);
+    m_solved = true;
+  }
 
-  return output;
+  return m_dirtyRegions;
 }
 
 void CDirtyRegionTracker::CleanMarkedRegions()
 {
   int buffering = g_advancedSettings.m_guiVisualizeDirtyRegions ? 20 : m_buffering;
+  m_solved = false;
   int i = m_markedRegions.size() - 1;
   while (i >= 0)
 	{
@@ -43,6 +43,8 @@ public:
 
 private:
   CDirtyRegionList m_markedRegions;
+  CDirtyRegionList m_dirtyRegions; ///< solution for m_markedRegions, valid while m_solved
+  bool m_solved;
   int m_buffering;
   IDirtyRegionSolver *m_solver;
 };
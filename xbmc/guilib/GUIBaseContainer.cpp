@@ -59,6 +59,9 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_layout = NULL;
   m_focusedLayout = NULL;
   m_cacheItems = preloadItems;
+  m_prefetchOffset = 0;
+  m_prefetched = false;
+  m_detailsStart = m_detailsEnd = -1;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
@@ -93,6 +96,7 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   // Free memory not used on screen
   if ((int)m_items.size() > m_itemsPerPage + cacheBefore + cacheAfter)
     FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
+  LoadDetails(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
 
   CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
   float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
@@ -128,6 +132,7 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   }
 
   UpdatePageControl(offset);
+  PrefetchPage(offset);
 
   CGUIControl::Process(currentTime, dirtyregions);
 }
@@ -373,6 +378,7 @@ bool CGUIBaseContainer::OnMessage(CGUIMessage& message)
         CFileItemList *items = (CFileItemList *)message.GetPointer();
         for (int i = 0; i < items->Size(); i++)
           m_items.push_back(items->Get(i));
+        m_detailsLoader = items->GetDetailsLoader();
         UpdateLayout(true); // true to refresh all items
         UpdateScrollByLetter();
         SelectItem(message.GetParam1());
@@ -789,6 +795,7 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   CalculateLayout();
   SetPageControlRange();
   MarkDirtyRegion();
+  m_prefetched = false;
 }
 
 void CGUIBaseContainer::SetPageControlRange()
@@ -975,6 +982,9 @@ void CGUIBaseContainer::Reset()
   m_wasReset = true;
   m_items.clear();
   m_lastItem = NULL;
+  m_prefetched = false;
+  m_detailsLoader.reset();
+  m_detailsStart = m_detailsEnd = -1;
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
@@ -1037,6 +1047,46 @@ void CGUIBaseContainer::SetType(VIEW_TYPE type, const CStdString &label)
   m_label = label;
 }
 
+// start loading the images of the page after the cached items in the direction we're scrolling,
+// so they're decoded by the time they come on screen.  offset is in rows.
+void CGUIBaseContainer::PrefetchPage(int offset, int itemsPerRow)
+{
+  if (!m_layout || (m_prefetched && offset == m_prefetchOffset))
+    return;
+
+  int cacheBefore, cacheAfter;
+  GetCacheOffsets(cacheBefore, cacheAfter);
+  int start = offset + m_itemsPerPage + cacheAfter;
+  if (m_prefetched && offset < m_prefetchOffset)
+    start = offset - cacheBefore - m_itemsPerPage;
+  m_prefetchOffset = offset;
+  m_prefetched = true;
+
+  vector<CFileItemPtr> lightItems;
+  for (int row = start; row < start + m_itemsPerPage; row++)
+  {
+    for (int col = 0; col < itemsPerRow; col++)
+    {
+      int itemNo = CorrectOffset(row, col);
+      if (itemNo >= 0 && itemNo < (int)m_items.size() && m_detailsLoader && m_items[itemNo]->IsFileItem())
+        lightItems.push_back(boost::static_pointer_cast<CFileItem>(m_items[itemNo]));
+    }
+  }
+  // have the details of the coming page loading as well
+  if (!lightItems.empty())
+    m_detailsLoader->Load(lightItems);
+
+  for (int row = start; row < start + m_itemsPerPage; row++)
+  {
+    for (int col = 0; col < itemsPerRow; col++)
+    {
+      int itemNo = CorrectOffset(row, col);
+      if (itemNo >= 0 && itemNo < (int)m_items.size())
+        m_layout->Prefetch(m_items[itemNo].get());
+    }
+  }
+}
+
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
   if (keepStart < keepEnd)
@@ -1053,6 +1103,43 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   }
 }
 
+// lists of light items get the details of the items on screen (and those cached) loaded,
+// in one go as the window moves.  keepStart and keepEnd are as for FreeMemory.
+void CGUIBaseContainer::LoadDetails(int keepStart, int keepEnd)
+{
+  if (!m_detailsLoader)
+    return;
+
+  // the details are loaded by a job, and handed to the items here as we're on the GUI thread
+  if (m_detailsLoader->ApplyLoaded())
+    MarkDirtyRegion();
+
+  if (keepStart == m_detailsStart && keepEnd == m_detailsEnd)
+    return;
+  m_detailsStart = keepStart;
+  m_detailsEnd = keepEnd;
+
+  // the window is [keepStart, keepEnd], or [keepStart, size) and [0, keepEnd] when wrapping
+  int size = (int)m_items.size();
+  int ranges[2][2] = { { keepStart, keepEnd }, { 0, -1 } };
+  if (keepStart >= keepEnd)
+  {
+    ranges[0][1] = size - 1;
+    ranges[1][1] = keepEnd;
+  }
+
+  vector<CFileItemPtr> items;
+  for (int r = 0; r < 2; r++)
+  {
+    for (int i = std::max(ranges[r][0], 0); i <= ranges[r][1] && i < size; i++)
+    {
+      if (m_items[i]->IsFileItem())
+        items.push_back(boost::static_pointer_cast<CFileItem>(m_items[i]));
+    }
+  }
+  m_detailsLoader->Load(items);
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
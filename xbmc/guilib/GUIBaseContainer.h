@@ -33,6 +33,8 @@
 
 typedef boost::shared_ptr<CGUIListItem> CGUIListItemPtr;
 
+class CFileItemDetailsLoader;
+
 /*!
  \ingroup controls
  \brief
@@ -129,6 +131,8 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  void LoadDetails(int keepStart, int keepEnd);
+  void PrefetchPage(int offset, int itemsPerRow = 1);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -200,6 +204,11 @@ private:
   int m_cursor;
   int m_offset;
   int m_cacheItems;
+  int m_prefetchOffset;  ///< offset the last page was prefetched from
+  bool m_prefetched;     ///< false until a page has been prefetched for the current items
+  boost::shared_ptr<CFileItemDetailsLoader> m_detailsLoader; ///< loads the details of light items, if the bound list has them
+  int m_detailsStart;    ///< first item of the window the details were last loaded for
+  int m_detailsEnd;      ///< last item of the window the details were last loaded for
   CStopWatch m_scrollTimer;
   CStopWatch m_lastScrollStartTimer;
   CStopWatch m_pageChangeTimer;
@@ -239,7 +239,8 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200),
+  m_renderedFrames(0), m_renderedRegions(0), m_renderedPixels(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -262,6 +263,9 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  m_renderedFrames = 0;
+  m_renderedRegions = 0;
+  m_renderedPixels = 0;
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -288,6 +292,13 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::AddRenderedRegions(unsigned int regions, float pixels)
+{
+  m_renderedFrames++;
+  m_renderedRegions += regions;
+  m_renderedPixels += pixels;
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -351,6 +362,19 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  if (m_renderedFrames)
+  {
+    // averaged per frame
+    TiXmlElement *regions = new TiXmlElement("dirtyregions");
+    str.Format("%u", m_renderedFrames);
+    regions->SetAttribute("framecount", str.c_str());
+    str.Format("%.2f", (double)m_renderedRegions / m_renderedFrames);
+    regions->SetAttribute("regions", str.c_str());
+    str.Format("%.0f", m_renderedPixels / m_renderedFrames);
+    regions->SetAttribute("pixels", str.c_str());
+    root->LinkEndChild(regions);
+  }
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -70,6 +70,11 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  /*! \brief Record the dirty regions rendered in a frame
+   \param regions the number of rendering passes
+   \param pixels the area redrawn by those passes
+   */
+  void AddRenderedRegions(unsigned int regions, float pixels);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const CStdString &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -92,6 +97,9 @@ private:
   CStdString m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+  unsigned int m_renderedFrames;  ///< frames recorded by AddRenderedRegions
+  unsigned int m_renderedRegions; ///< rendering passes in those frames
+  double m_renderedPixels;        ///< pixels redrawn in those frames
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
@@ -31,7 +31,9 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "utils/CharsetConverter.h"
 #include "windowing/WindowingFactory.h"
+#include "LangInfo.h"
 
 using namespace std;
 
@@ -149,6 +151,7 @@ CGUIFont* GUIFontManager::LoadTTF(const CStdString& strFontName, const CStdStrin
 
     m_vecFontFiles.push_back(pFontFile);
   }
+  pFontFile->CacheCharacters(GetPrewarmCharacters(), iStyle);
 
   // font file is loaded, create our CGUIFont
   CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile);
@@ -233,6 +236,7 @@ void GUIFontManager::ReloadTTFFonts(void)
 
       m_vecFontFiles.push_back(pFontFile);
     }
+    pFontFile->CacheCharacters(GetPrewarmCharacters(), font->GetStyle());
 
     font->SetFont(pFontFile);
   }
@@ -452,6 +456,47 @@ void GUIFontManager::LoadFonts(const TiXmlNode* fontNode)
 
     fontNode = fontNode->NextSibling();
   }
+
+  FontAtlasStats stats;
+  GetAtlasStats(stats);
+  CLog::Log(LOGDEBUG, "%s - %u glyphs of %u font files cached in %u KB of glyph atlases, %u%% used", __FUNCTION__,
+            stats.glyphs, stats.fonts, stats.size / 1024, stats.size ? (unsigned int)((uint64_t)stats.used * 100 / stats.size) : 0);
+}
+
+// the printable characters of the gui charset, so that the first time text is drawn
+// doesn't stall on rasterizing and uploading glyphs. Multibyte charsets only get ascii.
+const CStdStringW &GUIFontManager::GetPrewarmCharacters()
+{
+  CStdString charset = g_langInfo.GetGuiCharSet();
+  if (charset == m_prewarmCharset && !m_prewarmCharacters.IsEmpty())
+    return m_prewarmCharacters;
+
+  m_prewarmCharset = charset;
+  m_prewarmCharacters.clear();
+  for (wchar_t letter = 0x20; letter < 0x7f; letter++)
+    m_prewarmCharacters += letter;
+
+  CStdStringA upper;
+  for (int letter = 0xa0; letter <= 0xff; letter++)
+    upper += (char)letter;
+  CStdStringW converted;
+  g_charsetConverter.toW(upper, converted, charset);
+  if (converted.size() == upper.size())
+  {
+    for (unsigned int i = 0; i < converted.size(); i++)
+    {
+      if (converted[i] >= 0xa0 && converted[i] <= 0xffff)
+        m_prewarmCharacters += converted[i];
+    }
+  }
+  return m_prewarmCharacters;
+}
+
+void GUIFontManager::GetAtlasStats(FontAtlasStats &stats) const
+{
+  memset(&stats, 0, sizeof(stats));
+  for (vector<CGUIFontTTFBase*>::const_iterator it = m_vecFontFiles.begin(); it != m_vecFontFiles.end(); ++it)
+    (*it)->GetAtlasStats(stats);
 }
 
 bool GUIFontManager::OpenFontFile(TiXmlDocument& xmlDoc)
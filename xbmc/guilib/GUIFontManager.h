@@ -35,6 +35,7 @@
 // Forward
 class CGUIFont;
 class CGUIFontTTFBase;
+struct FontAtlasStats;
 class TiXmlDocument;
 class TiXmlNode;
 
@@ -75,6 +76,10 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief Sum up the occupancy of the glyph atlases of all loaded font files
+   */
+  void GetAtlasStats(FontAtlasStats &stats) const;
+
   bool IsFontSetUnicode() { return m_fontsetUnicode; }
   bool IsFontSetUnicode(const CStdString& strFontSet);
   bool GetFirstFontSetUnicode(CStdString& strFontSet);
@@ -85,6 +90,7 @@ protected:
   void LoadFonts(const TiXmlNode* fontNode);
   CGUIFontTTFBase* GetFontFile(const CStdString& strFontFile);
   bool OpenFontFile(TiXmlDocument& xmlDoc);
+  const CStdStringW &GetPrewarmCharacters();
 
   std::vector<CGUIFont*> m_vecFonts;
   std::vector<CGUIFontTTFBase*> m_vecFontFiles;
@@ -92,6 +98,8 @@ protected:
   bool m_fontsetUnicode;
   RESOLUTION_INFO m_skinResolution;
   bool m_canReload;
+  CStdString m_prewarmCharset;     ///< gui charset m_prewarmCharacters was built for
+  CStdStringW m_prewarmCharacters; ///< characters rasterized when a font is loaded
 };
 
 /*!
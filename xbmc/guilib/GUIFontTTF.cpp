@@ -48,7 +48,7 @@ using namespace std;
 
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define CHAR_TABLE_SIZE 256   // initial size of the character hash, doubled as it fills
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -139,8 +139,6 @@ CFreeTypeLibrary g_freeTypeLibrary; // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
@@ -155,7 +153,8 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
+  m_shelfBottom = 0;
+  m_usedPixels = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -190,14 +189,14 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
+  m_char.clear();
+  m_charTable.assign(CHAR_TABLE_SIZE, (Character *)NULL);
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)m_cellHeight;
+  // our texture will be created on first character write.
+  m_shelves.clear();
+  m_shelfBottom = 0;
+  m_usedPixels = 0;
   m_textureHeight = 0;
 }
 
@@ -205,13 +204,13 @@ void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
+  m_char.clear();
+  m_charTable.clear();
   memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_shelves.clear();
+  m_shelfBottom = 0;
+  m_usedPixels = 0;
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -278,11 +277,14 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
+  m_char.clear();
+  m_charTable.assign(CHAR_TABLE_SIZE, (Character *)NULL);
+  memset(m_charquick, 0, sizeof(m_charquick));
 
-  m_maxChars = 0;
   m_numChars = 0;
+  m_shelves.clear();
+  m_shelfBottom = 0;
+  m_usedPixels = 0;
 
   m_strFilename = strFilename;
 
@@ -294,10 +296,6 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   if (m_textureWidth > g_Windowing.GetMaxTextureSize())
     m_textureWidth = g_Windowing.GetMaxTextureSize();
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)m_cellHeight;
-
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
   if (ellipse) m_ellipsesWidth = ellipse->advance;
@@ -462,52 +460,21 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   }
 
   // letters are stored based on style and letter
-  character_t ch = (style << 16) | letter;
-
-  int low = 0;
-  int high = m_numChars - 1;
-  int mid;
-  while (low <= high)
-  {
-    mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
+  Character *cached = FindCharacter((style << 16) | letter);
+  if (cached)
+    return cached;
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
-
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  Character ch;
+  if (!CacheCharacter(letter, style, &ch))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, &ch))
     {
       CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
       if (nestedBeginCount) Begin();
@@ -518,18 +485,135 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
+  return AddCharacter(ch);
+}
+
+static inline unsigned int HashCharacter(character_t letterAndStyle)
+{
+  return letterAndStyle * 2654435761U;
+}
+
+CGUIFontTTFBase::Character *CGUIFontTTFBase::FindCharacter(character_t letterAndStyle) const
+{
+  if (m_charTable.empty())
+    return NULL;
+
+  unsigned int mask = m_charTable.size() - 1;
+  for (unsigned int i = HashCharacter(letterAndStyle) & mask; m_charTable[i]; i = (i + 1) & mask)
   {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
+    if (m_charTable[i]->letterAndStyle == letterAndStyle)
+      return m_charTable[i];
+  }
+  return NULL;
+}
+
+CGUIFontTTFBase::Character *CGUIFontTTFBase::AddCharacter(const Character &ch)
+{
+  m_char.push_back(ch);
+  Character *added = &m_char.back();
+  m_numChars++;
+
+  // keep the table at most half full, rehashing everything when we grow it
+  if (m_charTable.size() < CHAR_TABLE_SIZE || (unsigned int)m_numChars * 2 > m_charTable.size())
+  {
+    m_charTable.assign(std::max<size_t>(CHAR_TABLE_SIZE, m_charTable.size() * 2), (Character *)NULL);
+    for (std::deque<Character>::iterator it = m_char.begin(); it != m_char.end(); ++it)
     {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
+      unsigned int mask = m_charTable.size() - 1;
+      unsigned int i = HashCharacter(it->letterAndStyle) & mask;
+      while (m_charTable[i])
+        i = (i + 1) & mask;
+      m_charTable[i] = &*it;
     }
   }
+  else
+  {
+    unsigned int mask = m_charTable.size() - 1;
+    unsigned int i = HashCharacter(added->letterAndStyle) & mask;
+    while (m_charTable[i])
+      i = (i + 1) & mask;
+    m_charTable[i] = added;
+  }
+
+  // quick access
+  if ((added->letterAndStyle & 0xffff) < 255)
+    m_charquick[((added->letterAndStyle & 0xffff0000) >> 8) | (added->letterAndStyle & 0xff)] = added;
 
-  return m_char + low;
+  return added;
+}
+
+void CGUIFontTTFBase::CacheCharacters(const CStdStringW &characters, uint32_t style)
+{
+  for (unsigned int i = 0; i < characters.size(); i++)
+    GetCharacter(((style & 3) << 24) | (characters[i] & 0xffff));
+}
+
+void CGUIFontTTFBase::GetAtlasStats(FontAtlasStats &stats) const
+{
+  stats.fonts++;
+  stats.glyphs += m_numChars;
+  stats.size += m_textureWidth * m_textureHeight;
+  stats.used += m_usedPixels;
+}
+
+// find room for a width x height glyph in our texture, growing the texture if needed
+bool CGUIFontTTFBase::AllocateGlyph(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  // glyphs are kept a pixel apart so filtering doesn't bleed their neighbours in
+  width++;
+  height++;
+  if (width > m_textureWidth)
+    return false;
+
+  // the lowest shelf with room that fits the glyph
+  Shelf *best = NULL;
+  for (vector<Shelf>::iterator it = m_shelves.begin(); it != m_shelves.end(); ++it)
+  {
+    if (it->height >= height && it->x + width <= m_textureWidth && (!best || it->height < best->height))
+      best = &*it;
+  }
+
+  // open a new shelf if nothing fits, or it would waste more than half the shelf.
+  // Rather than growing the texture for the latter, we put up with the waste.
+  bool newShelf = !best || best->height > 2 * height;
+  if (newShelf && best && m_shelfBottom + height > m_textureHeight)
+    newShelf = false;
+
+  if (newShelf)
+  {
+    if (m_shelfBottom + height > m_textureHeight)
+    {
+      // create the new larger texture
+      unsigned int newHeight = m_shelfBottom + height;
+      // check for max height
+      if (newHeight > g_Windowing.GetMaxTextureSize())
+      {
+        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
+        return false;
+      }
+
+      CBaseTexture* newTexture = ReallocTexture(newHeight);
+      if (newTexture == NULL)
+      {
+        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
+        return false;
+      }
+      m_texture = newTexture;
+    }
+    Shelf shelf;
+    shelf.x = 0;
+    shelf.y = m_shelfBottom;
+    shelf.height = height;
+    m_shelves.push_back(shelf);
+    m_shelfBottom += height;
+    best = &m_shelves.back();
+  }
+
+  x = best->x;
+  y = best->y;
+  best->x += width;
+  m_usedPixels += width * height;
+  return true;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
@@ -564,44 +648,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  if (bitGlyph->left < 0)
-    m_posX += -bitGlyph->left;
-
-  // check we have enough room for the character
-  if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-    m_posX = 0;
-    m_posY += m_cellHeight;
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    if(m_posY + m_cellHeight >= m_textureHeight)
-    {
-      // create the new larger texture
-      unsigned int newHeight = m_posY + m_cellHeight;
-      // check for max height
-      if (newHeight > g_Windowing.GetMaxTextureSize())
-      {
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
-        FT_Done_Glyph(glyph);
-        return false;
-      }
 
-      CBaseTexture* newTexture = NULL;
-      newTexture = ReallocTexture(newHeight);
-      if(newTexture == NULL)
-      {
-        FT_Done_Glyph(glyph);
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
-        return false;
-      }
-      m_texture = newTexture;
-    }
+  // find room for the bitmap in our texture
+  unsigned int x, y;
+  if (!AllocateGlyph(bitmap.width, bitmap.rows, x, y))
+  {
+    FT_Done_Glyph(glyph);
+    return false;
   }
 
   if(m_texture == NULL)
   {
     CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: no texture to cache character to");
+    FT_Done_Glyph(glyph);
     return false;
   }
 
@@ -609,8 +668,8 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)max((short)m_cellBaseLine - bitGlyph->top, 0);
-  ch->left = (float)m_posX + ch->offsetX;
-  ch->top = (float)m_posY + ch->offsetY;
+  ch->left = (float)x;
+  ch->top = (float)y;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
@@ -620,8 +679,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   {
     CopyCharToTexture(bitGlyph, ch);
   }
-  m_posX += 1 + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
-  m_numChars++;
 
   m_textureScaleX = 1.0f / m_textureWidth;
   m_textureScaleY = 1.0f / m_textureHeight;
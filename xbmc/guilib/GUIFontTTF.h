@@ -28,6 +28,9 @@
  *
  */
 
+#include <deque>
+#include <vector>
+
 // forward definition
 class CBaseTexture;
 
@@ -53,6 +56,17 @@ typedef std::vector<color_t> vecColors;
  \brief
  */
 
+/*!
+ \brief Occupancy of the glyph atlases, summed over the font files passed to GetAtlasStats()
+ */
+struct FontAtlasStats
+{
+  unsigned int fonts;       ///< font files (face, size, aspect and border) counted
+  unsigned int glyphs;      ///< glyphs cached over all styles
+  unsigned int size;        ///< size of the atlas textures in bytes
+  unsigned int used;        ///< bytes of the atlas textures taken by glyphs
+};
+
 struct SVertex
 {
   float x, y, z;
@@ -83,6 +97,18 @@ public:
 
   const CStdString& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Rasterize characters ahead of them being drawn
+   Used after loading to fill the atlas with the character set of the active language, so
+   the first time text is drawn doesn't stall on rasterizing and uploading glyphs.
+   \param characters the characters to cache
+   \param style the FONT_STYLE the characters are drawn in
+   */
+  void CacheCharacters(const CStdStringW &characters, uint32_t style);
+
+  /*! \brief Add the occupancy of this font's glyph atlas to stats
+   */
+  void GetAtlasStats(FontAtlasStats &stats) const;
+
 protected:
   struct Character
   {
@@ -108,7 +134,10 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
+  Character *FindCharacter(character_t letterAndStyle) const;
+  Character *AddCharacter(const Character &ch);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool AllocateGlyph(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
 
@@ -124,14 +153,26 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+
+  /*! \brief A row of the atlas holding glyphs up to its height, filled left to right.
+   Glyphs go in the lowest shelf they fit, and a new shelf is opened at m_shelfBottom when
+   none fits without wasting more than half its height.
+   */
+  struct Shelf
+  {
+    unsigned int x;
+    unsigned int y;
+    unsigned int height;
+  };
+  std::vector<Shelf> m_shelves;
+  unsigned int m_shelfBottom;        // top of the next shelf
+  unsigned int m_usedPixels;         // texture area taken by glyphs (and their padding)
 
   color_t m_color;
 
-  Character *m_char;                 // our characters
+  std::deque<Character> m_char;      // our characters, a deque so pointers to them stay valid
+  std::vector<Character *> m_charTable; // open addressed hash of m_char on letterAndStyle
   Character *m_charquick[256*4];     // ascii chars (4 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
   int m_numChars;                    // the current number of cached characters
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
@@ -277,8 +277,8 @@ bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
 
   RECT sourcerect = { 0, 0, bitmap.width, bitmap.rows };
   RECT targetrect;
-  targetrect.top = m_posY + ch->offsetY;
-  targetrect.left = m_posX + bitGlyph->left;
+  targetrect.top = (LONG)ch->top;
+  targetrect.left = (LONG)ch->left;
   targetrect.bottom = targetrect.top + bitmap.rows;
   targetrect.right = targetrect.left + bitmap.width;
   
@@ -28,6 +28,10 @@
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include <algorithm>
+#ifdef HAS_GL
+#include "GUIQuadBatchGL.h"
+#endif
 #if HAS_GLES == 2
 #include "windowing/WindowingFactory.h"
 #endif
@@ -46,6 +50,8 @@ using namespace std;
 CGUIFontTTFGL::CGUIFontTTFGL(const CStdString& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
+  m_textureStale = false;
+  m_dirtyTop = m_dirtyBottom = 0;
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
@@ -56,49 +62,14 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
-    if (!m_bTextureLoaded)
-    {
-      // Have OpenGL generate a texture object handle for us
-      glGenTextures(1, (GLuint*) &m_nTexture);
-
-      // Bind the texture object
-      glBindTexture(GL_TEXTURE_2D, m_nTexture);
-#ifdef HAS_GL
-      glEnable(GL_TEXTURE_2D);
-#endif
-      // Set the texture's stretching properties
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-      // Set the texture image -- THIS WORKS, so the pixels must be wrong.
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_texture->GetWidth(), m_texture->GetHeight(), 0,
-                   GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels());
-
-      VerifyGLState();
-      m_bTextureLoaded = true;
-    }
+    LoadHardwareTexture();
 
+#ifndef HAS_GL
     // Turn Blending On
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
-#ifdef HAS_GL
-    glEnable(GL_TEXTURE_2D);
-#endif
     glBindTexture(GL_TEXTURE_2D, m_nTexture);
 
-#ifdef HAS_GL
-    glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_COMBINE);
-    glTexEnvi(GL_TEXTURE_ENV,GL_COMBINE_RGB,GL_REPLACE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE0);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    VerifyGLState();
-#else
     g_Windowing.EnableGUIShader(SM_FONTS);
 #endif
 
@@ -117,17 +88,33 @@ void CGUIFontTTFGL::End()
     return;
 
 #ifdef HAS_GL
-  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
-
-  glColorPointer   (4, GL_UNSIGNED_BYTE, sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, r));
-  glVertexPointer  (3, GL_FLOAT        , sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, x));
-  glTexCoordPointer(2, GL_FLOAT        , sizeof(SVertex), (char*)m_vertex + offsetof(SVertex, u));
-  glEnableClientState(GL_COLOR_ARRAY);
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDrawArrays(GL_QUADS, 0, m_vertex_count);
-  glPopClientAttrib();
+  if (!m_vertex_count)
+    return;
+
+  // the texture may have been grown while caching characters
+  LoadHardwareTexture();
+
+  // hand the quads to the batch, so text sharing this font is drawn in one go
+  CGUIQuadBatchGL &batch = CGUIQuadBatchGL::GetInstance();
+  batch.SetState(m_nTexture, 0, CGUIQuadBatchGL::MODE_FONT);
+  CGUIQuadBatchGL::Vertex *v = batch.AddQuads(m_vertex_count / 4);
+  for (int i = 0; i < m_vertex_count; i++, v++)
+  {
+    v->x = m_vertex[i].x;
+    v->y = m_vertex[i].y;
+    v->z = m_vertex[i].z;
+    v->r = m_vertex[i].r;
+    v->g = m_vertex[i].g;
+    v->b = m_vertex[i].b;
+    v->a = m_vertex[i].a;
+    v->u1 = m_vertex[i].u;
+    v->v1 = m_vertex[i].v;
+  }
 #else
+  // the texture may have been grown while caching characters
+  LoadHardwareTexture();
+  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+
   // GLES 2.0 version. Cannot draw quads. Convert to triangles.
   GLint posLoc  = g_Windowing.GUIShaderGetPos();
   GLint colLoc  = g_Windowing.GUIShaderGetCol();
@@ -180,6 +167,11 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
     CLog::Log(LOGERROR, "GUIFontTTFGL::CacheCharacter: Error creating new cache texture for size %f", m_height);
     return NULL;
   }
+
+  // the hardware texture no longer matches in size. We may not hold the GL context here,
+  // so it's recreated from the new one by the next Begin() or End()
+  if (m_bTextureLoaded)
+    m_textureStale = true;
   m_textureHeight = newTexture->GetHeight();
   m_textureWidth = newTexture->GetWidth();
 
@@ -205,7 +197,8 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   FT_Bitmap bitmap = bitGlyph->bitmap;
 
   unsigned char* source = (unsigned char*) bitmap.buffer;
-  unsigned char* target = (unsigned char*) m_texture->GetPixels() + (m_posY + ch->offsetY) * m_texture->GetPitch() + m_posX + bitGlyph->left;
+  unsigned int top = (unsigned int)ch->top;
+  unsigned char* target = (unsigned char*) m_texture->GetPixels() + top * m_texture->GetPitch() + (unsigned int)ch->left;
 
   for (int y = 0; y < bitmap.rows; y++)
   {
@@ -215,28 +208,74 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   }
   // THE SOURCE VALUES ARE THE SAME IN BOTH SITUATIONS.
 
-  // Since we have a new texture, we need to delete the old one
-  // the Begin(); End(); stuff is handled by whoever called us
-  if (m_bTextureLoaded)
+  // Only the rows holding the new character need uploading, which is left to the next
+  // Begin() or End() as they run with the GL context held.
+  if (m_dirtyBottom > m_dirtyTop)
   {
-    g_graphicsContext.BeginPaint();  //FIXME
-    DeleteHardwareTexture();
-    g_graphicsContext.EndPaint();
-    m_bTextureLoaded = false;
+    m_dirtyTop = std::min(m_dirtyTop, top);
+    m_dirtyBottom = std::max(m_dirtyBottom, top + bitmap.rows);
+  }
+  else
+  {
+    m_dirtyTop = top;
+    m_dirtyBottom = top + bitmap.rows;
   }
 
   return TRUE;
 }
 
 
+void CGUIFontTTFGL::LoadHardwareTexture()
+{
+  if (m_textureStale)
+    DeleteHardwareTexture();
+
+  if (m_bTextureLoaded)
+  {
+    if (m_dirtyBottom > m_dirtyTop)
+    {
+      // Whole rows are sent as GLES has no GL_UNPACK_ROW_LENGTH.
+      glBindTexture(GL_TEXTURE_2D, m_nTexture);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_dirtyTop, m_texture->GetWidth(), m_dirtyBottom - m_dirtyTop,
+                      GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels() + m_dirtyTop * m_texture->GetPitch());
+      VerifyGLState();
+      m_dirtyTop = m_dirtyBottom = 0;
+    }
+    return;
+  }
+
+  // Have OpenGL generate a texture object handle for us
+  glGenTextures(1, (GLuint*) &m_nTexture);
+
+  // Bind the texture object
+  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+
+  // Set the texture's stretching properties
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  // Set the texture image -- THIS WORKS, so the pixels must be wrong.
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_texture->GetWidth(), m_texture->GetHeight(), 0,
+               GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels());
+
+  VerifyGLState();
+  m_bTextureLoaded = true;
+  m_dirtyTop = m_dirtyBottom = 0;
+}
+
 void CGUIFontTTFGL::DeleteHardwareTexture()
 {
   if (m_bTextureLoaded)
   {
+#ifdef HAS_GL
+    CGUIQuadBatchGL::GetInstance().FlushTexture(m_nTexture);
+#endif
     if (glIsTexture(m_nTexture))
       glDeleteTextures(1, (GLuint*) &m_nTexture);
     m_bTextureLoaded = false;
   }
+  m_textureStale = false;
+  m_dirtyTop = m_dirtyBottom = 0;
 }
 
 #endif
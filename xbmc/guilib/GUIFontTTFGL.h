@@ -50,6 +50,12 @@ protected:
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
   virtual void DeleteHardwareTexture();
 
+private:
+  void LoadHardwareTexture();
+
+  bool m_textureStale;         ///< the hardware texture has to be recreated as the cache texture grew
+  unsigned int m_dirtyTop;     ///< first row of the cache texture not yet uploaded
+  unsigned int m_dirtyBottom;  ///< row after the last one not yet uploaded
 };
 
 #endif
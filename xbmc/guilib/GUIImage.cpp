@@ -78,6 +78,14 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
     SetFileName(m_info.GetLabel(m_parentID, true, &m_currentFallback));
 }
 
+void CGUIImage::PrefetchInfo(const CGUIListItem *item) const
+{
+  if (m_info.IsConstant() || !item)
+    return;
+
+  m_texture.PrefetchFile(m_info.GetItemLabel(item, true));
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
@@ -79,6 +79,7 @@ public:
   virtual void SetInvalid();
   virtual bool CanFocus() const;
   virtual void UpdateInfo(const CGUIListItem *item = NULL);
+  void PrefetchInfo(const CGUIListItem *item) const;
 
   virtual void SetInfo(const CGUIInfoLabel &info);
   virtual void SetFileName(const CStdString& strFileName, bool setConstant = false);
@@ -47,12 +47,17 @@ public:
    Replaces any instances of <include file="foo">bar</include> with the value of the include
    "bar" from the include file "foo".
    \param node an XML Element - all child elements are traversed.
+   \param conditions [out] if non-NULL, the conditions of conditional includes are returned along with their value.
    */
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 
+  /*! \brief Get the include files loaded so far
+   */
+  const std::vector<CStdString> &GetFiles() const { return m_files; };
+
 private:
-  void ResolveIncludesForNode(TiXmlElement *node);
+  void ResolveIncludesForNode(TiXmlElement *node, std::map<CStdString, bool> *conditions);
   CStdString ResolveConstant(const CStdString &constant) const;
   bool HasIncludeFile(const CStdString &includeFile) const;
   std::map<CStdString, TiXmlElement> m_includes;
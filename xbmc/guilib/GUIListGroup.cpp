@@ -97,6 +97,17 @@ void CGUIListGroup::UpdateVisibility(const CGUIListItem *item)
   m_item = item;
 }
 
+void CGUIListGroup::PrefetchInfo(const CGUIListItem *item) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_IMAGE || (*it)->GetControlType() == CGUIControl::GUICONTROL_BORDEREDIMAGE)
+      ((const CGUIImage *)*it)->PrefetchInfo(item);
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      ((const CGUIListGroup *)*it)->PrefetchInfo(item);
+  }
+}
+
 void CGUIListGroup::UpdateInfo(const CGUIListItem *item)
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
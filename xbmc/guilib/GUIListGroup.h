@@ -46,6 +46,7 @@ public:
   virtual void ResetAnimation(ANIMATION_TYPE type);
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
   virtual void UpdateInfo(const CGUIListItem *item);
+  void PrefetchInfo(const CGUIListItem *item) const;
   virtual void SetInvalid();
 
   void SetFocusedItem(unsigned int subfocus);
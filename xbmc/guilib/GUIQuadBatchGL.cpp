@@ -0,0 +1,175 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "GUIQuadBatchGL.h"
+#include "utils/GLUtils.h"
+
+#if defined(HAS_GL)
+
+#define QUADBATCH_RESERVE 4096 // vertices
+
+CGUIQuadBatchGL::CGUIQuadBatchGL()
+{
+  m_vertices.reserve(QUADBATCH_RESERVE);
+  m_count = 0;
+  m_texture = 0;
+  m_diffuse = 0;
+  m_mode = MODE_TEXTURE;
+  m_drawCalls = 0;
+  m_quads = 0;
+  m_lastDrawCalls = 0;
+  m_lastQuads = 0;
+}
+
+CGUIQuadBatchGL &CGUIQuadBatchGL::GetInstance()
+{
+  static CGUIQuadBatchGL batch;
+  return batch;
+}
+
+void CGUIQuadBatchGL::SetState(GLuint texture, GLuint diffuse, Mode mode)
+{
+  if (texture == m_texture && diffuse == m_diffuse && mode == m_mode)
+    return;
+  Flush();
+  m_texture = texture;
+  m_diffuse = diffuse;
+  m_mode = mode;
+}
+
+CGUIQuadBatchGL::Vertex *CGUIQuadBatchGL::AddQuads(unsigned int count)
+{
+  unsigned int first = m_count;
+  m_count += 4 * count;
+  if (m_vertices.size() < m_count)
+    m_vertices.resize(m_count);
+  return &m_vertices[first];
+}
+
+void CGUIQuadBatchGL::FlushTexture(GLuint texture)
+{
+  if (m_count && (texture == m_texture || texture == m_diffuse))
+    Flush();
+}
+
+void CGUIQuadBatchGL::Flush()
+{
+  if (!m_count)
+    return;
+
+  glActiveTextureARB(GL_TEXTURE0_ARB);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glEnable(GL_TEXTURE_2D);
+
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glEnable(GL_BLEND);          // Turn Blending On
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+  if (m_mode == MODE_FONT)
+  {
+    // vertex color, alpha from the glyph texture
+    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE0);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+  }
+  else
+  {
+    // diffuse coloring
+    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE0);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+  }
+  VerifyGLState();
+
+  if (m_diffuse)
+  {
+    glActiveTextureARB(GL_TEXTURE1_ARB);
+    glBindTexture(GL_TEXTURE_2D, m_diffuse);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE1);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+    VerifyGLState();
+  }
+
+  // client active texture is part of the vertex array state, so is restored as well
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  const Vertex *vertices = &m_vertices[0];
+  glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices->r);
+  glVertexPointer(3, GL_FLOAT,         sizeof(Vertex), &vertices->x);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+
+  glClientActiveTextureARB(GL_TEXTURE0_ARB);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices->u1);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  if (m_diffuse)
+  {
+    glClientActiveTextureARB(GL_TEXTURE1_ARB);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices->u2);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+
+  glDrawArrays(GL_QUADS, 0, m_count);
+  glPopClientAttrib();
+
+  if (m_diffuse)
+  {
+    glDisable(GL_TEXTURE_2D);
+    glActiveTextureARB(GL_TEXTURE0_ARB);
+  }
+  glDisable(GL_TEXTURE_2D);
+  VerifyGLState();
+
+  m_drawCalls++;
+  m_quads += m_count / 4;
+  m_count = 0;
+}
+
+void CGUIQuadBatchGL::EndFrame()
+{
+  Flush();
+  m_lastDrawCalls = m_drawCalls;
+  m_lastQuads = m_quads;
+  m_drawCalls = 0;
+  m_quads = 0;
+}
+
+void CGUIQuadBatchGL::GetFrameStats(unsigned int &drawCalls, unsigned int &quads) const
+{
+  drawCalls = m_lastDrawCalls;
+  quads = m_lastQuads;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*!
+\file GUIQuadBatchGL.h
+\brief
+*/
+
+#ifndef GUILIB_GUIQUADBATCHGL_H
+#define GUILIB_GUIQUADBATCHGL_H
+
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include <vector>
+
+#if defined(HAS_GL)
+
+/*!
+ \ingroup textures
+ \brief Collects the quads of GUI textures and fonts into a single vertex array.
+
+ Consecutive quads drawn with the same texture, diffuse texture and texture environment
+ are sent with one glDrawArrays call. The batch is flushed when that state changes, and
+ by anything that changes GL state the quads depend on (viewport, scissor, transforms,
+ textures being reloaded or deleted) or draws outside of the batch (video, visualisations).
+ */
+class CGUIQuadBatchGL
+{
+public:
+  enum Mode { MODE_TEXTURE, MODE_FONT };
+
+  struct Vertex
+  {
+    float x, y, z;
+    GLubyte r, g, b, a;
+    float u1, v1; ///< texture coordinates
+    float u2, v2; ///< diffuse texture coordinates
+  };
+
+  static CGUIQuadBatchGL &GetInstance();
+
+  /*! \brief Set the state of the quads that follow, flushing the batch if it differs
+   \param texture the texture object to draw with
+   \param diffuse the diffuse texture object, 0 for none
+   \param mode MODE_TEXTURE to modulate the texture by the vertex color, MODE_FONT to use the
+               vertex color with the alpha of the texture
+   */
+  void SetState(GLuint texture, GLuint diffuse, Mode mode);
+
+  /*! \brief Append quads to the batch
+   \param count the number of quads
+   \return the 4 * count vertices to fill in, valid until the next call to the batch
+   */
+  Vertex *AddQuads(unsigned int count);
+
+  /*! \brief Draw the pending quads
+   */
+  void Flush();
+
+  /*! \brief Draw the pending quads if they use the given texture object
+   Called before a texture object is reloaded or deleted.
+   */
+  void FlushTexture(GLuint texture);
+
+  /*! \brief Flush and start counting a new frame
+   */
+  void EndFrame();
+
+  /*! \brief Draw calls and quads sent during the last frame
+   */
+  void GetFrameStats(unsigned int &drawCalls, unsigned int &quads) const;
+
+private:
+  CGUIQuadBatchGL();
+
+  std::vector<Vertex> m_vertices;
+  unsigned int m_count;         ///< vertices pending in m_vertices
+  GLuint       m_texture;
+  GLuint       m_diffuse;
+  Mode         m_mode;
+
+  unsigned int m_drawCalls;     ///< draw calls in the current frame
+  unsigned int m_quads;         ///< quads in the current frame
+  unsigned int m_lastDrawCalls; ///< draw calls in the last frame
+  unsigned int m_lastQuads;     ///< quads in the last frame
+};
+
+#endif
+
+#endif
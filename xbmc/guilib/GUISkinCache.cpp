@@ -0,0 +1,361 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUISkinCache.h"
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "FileItem.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "tinyXML/tinyxml.h"
+
+#include <time.h>
+
+using namespace std;
+using namespace XFILE;
+
+#define SKINCACHE_PATH    "special://temp/skincache/"
+#define SKINCACHE_MAGIC   0x58534b43 // XSKC
+#define SKINCACHE_VERSION 1
+
+#define SKINCACHE_MAX_AGE  (90 * 24 * 60 * 60) // seconds since an entry was written
+#define SKINCACHE_MAX_SIZE (32 * 1024 * 1024)  // bytes of all entries
+
+#define NODE_ELEMENT      1
+#define NODE_TEXT         2
+#define NODE_CDATA        3
+
+/*
+ Layout of an entry, all integers in native byte order:
+   magic, version, skin id, skin version, window file
+   number of files, then per file: path, mtime, size
+   number of conditions, then per condition: condition, value
+   the root element
+ Elements are stored as type, name, number of attributes, attribute name/value pairs,
+ number of children followed by the children. Text nodes are stored as type and value.
+ Strings are a length followed by the characters. Comments and declarations are dropped.
+ */
+
+class CSkinCacheWriter
+{
+public:
+  void WriteInt(uint32_t value)
+  {
+    m_data.append((const char *)&value, sizeof(value));
+  }
+  void WriteInt64(int64_t value)
+  {
+    m_data.append((const char *)&value, sizeof(value));
+  }
+  void WriteString(const std::string &value)
+  {
+    WriteInt(value.size());
+    m_data.append(value);
+  }
+  void WriteNode(const TiXmlNode *node)
+  {
+    if (node->Type() == TiXmlNode::TEXT)
+    {
+      WriteInt(((const TiXmlText *)node)->CDATA() ? NODE_CDATA : NODE_TEXT);
+      WriteString(node->ValueStr());
+      return;
+    }
+    const TiXmlElement *element = node->ToElement();
+    WriteInt(NODE_ELEMENT);
+    WriteString(element->ValueStr());
+
+    uint32_t count = 0;
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+      count++;
+    WriteInt(count);
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      WriteString(attribute->NameStr());
+      WriteString(attribute->ValueStr());
+    }
+
+    count = 0;
+    for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() == TiXmlNode::ELEMENT || child->Type() == TiXmlNode::TEXT)
+        count++;
+    }
+    WriteInt(count);
+    for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() == TiXmlNode::ELEMENT || child->Type() == TiXmlNode::TEXT)
+        WriteNode(child);
+    }
+  }
+  const std::string &GetData() const { return m_data; };
+private:
+  std::string m_data;
+};
+
+class CSkinCacheReader
+{
+public:
+  CSkinCacheReader(const char *data, unsigned int size)
+    : m_pos(data), m_end(data + size), m_valid(true)
+  {
+  }
+  uint32_t ReadInt()
+  {
+    uint32_t value = 0;
+    Read(&value, sizeof(value));
+    return value;
+  }
+  int64_t ReadInt64()
+  {
+    int64_t value = 0;
+    Read(&value, sizeof(value));
+    return value;
+  }
+  std::string ReadString()
+  {
+    uint32_t size = ReadInt();
+    if (!m_valid || size > (uint32_t)(m_end - m_pos))
+    {
+      m_valid = false;
+      return "";
+    }
+    std::string value(m_pos, size);
+    m_pos += size;
+    return value;
+  }
+  TiXmlNode *ReadNode()
+  {
+    uint32_t type = ReadInt();
+    if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      TiXmlText *text = new TiXmlText(ReadString());
+      text->SetCDATA(type == NODE_CDATA);
+      return text;
+    }
+    if (type != NODE_ELEMENT || !m_valid)
+    {
+      m_valid = false;
+      return NULL;
+    }
+    TiXmlElement *element = new TiXmlElement(ReadString());
+    uint32_t count = ReadInt();
+    for (uint32_t i = 0; i < count && m_valid; i++)
+    {
+      std::string name = ReadString();
+      std::string value = ReadString();
+      element->SetAttribute(name, value);
+    }
+    count = ReadInt();
+    for (uint32_t i = 0; i < count && m_valid; i++)
+    {
+      TiXmlNode *child = ReadNode();
+      if (child)
+        element->LinkEndChild(child);
+    }
+    return element;
+  }
+  bool IsValid() const { return m_valid; };
+private:
+  void Read(void *value, unsigned int size)
+  {
+    if (!m_valid || size > (unsigned int)(m_end - m_pos))
+    {
+      m_valid = false;
+      return;
+    }
+    memcpy(value, m_pos, size);
+    m_pos += size;
+  }
+  const char *m_pos;
+  const char *m_end;
+  bool m_valid;
+};
+
+CStdString CGUISkinCache::GetCacheFile(const CStdString &xmlFile)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(g_SkinInfo->ID() + "|" + g_SkinInfo->Version().c_str() + "|" + xmlFile);
+  CStdString cacheFile;
+  cacheFile.Format(SKINCACHE_PATH "%08x.bin", (unsigned int)crc);
+  return cacheFile;
+}
+
+bool CGUISkinCache::Load(const CStdString &xmlFile, TiXmlDocument &xmlDoc)
+{
+  if (!g_advancedSettings.m_guiSkinCache || !g_SkinInfo)
+    return false;
+
+  CFile file;
+  if (!file.Open(GetCacheFile(xmlFile)))
+    return false;
+
+  // read the entry in one go, it's parsed straight from memory
+  int64_t length = file.GetLength();
+  if (length <= 0 || length > 64 * 1024 * 1024)
+    return false;
+  std::string data;
+  data.resize((size_t)length);
+  if (file.Read(&data[0], length) != (unsigned int)length)
+    return false;
+  file.Close();
+
+  CSkinCacheReader reader(data.c_str(), data.size());
+  if (reader.ReadInt() != SKINCACHE_MAGIC || reader.ReadInt() != SKINCACHE_VERSION)
+    return false;
+  if (reader.ReadString() != g_SkinInfo->ID() ||
+      reader.ReadString() != g_SkinInfo->Version().c_str() ||
+      reader.ReadString() != xmlFile)
+    return false;
+
+  // the window and include files must be unchanged
+  vector<CStdString> includeFiles;
+  uint32_t count = reader.ReadInt();
+  for (uint32_t i = 0; i < count && reader.IsValid(); i++)
+  {
+    CStdString path = reader.ReadString();
+    int64_t mtime = reader.ReadInt64();
+    int64_t size = reader.ReadInt64();
+    struct __stat64 st;
+    if (CFile::Stat(path, &st) != 0 || (int64_t)st.st_mtime != mtime || (int64_t)st.st_size != size)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s changed, reloading %s", __FUNCTION__, path.c_str(), xmlFile.c_str());
+      return false;
+    }
+    if (i > 0)
+      includeFiles.push_back(path);
+  }
+
+  // and the conditional includes must still go the same way
+  count = reader.ReadInt();
+  for (uint32_t i = 0; i < count && reader.IsValid(); i++)
+  {
+    CStdString condition = reader.ReadString();
+    bool value = reader.ReadInt() != 0;
+    if (g_infoManager.EvaluateBool(condition) != value)
+      return false;
+  }
+
+  TiXmlNode *root = reader.ReadNode();
+  if (!reader.IsValid() || !root)
+  {
+    delete root;
+    CLog::Log(LOGERROR, "%s - corrupt cache entry for %s", __FUNCTION__, xmlFile.c_str());
+    return false;
+  }
+  xmlDoc.Clear();
+  xmlDoc.LinkEndChild(root);
+
+  // include files pulled in by <include file="..."> also carry the skin variables used
+  for (vector<CStdString>::const_iterator it = includeFiles.begin(); it != includeFiles.end(); ++it)
+    g_SkinInfo->LoadIncludeFile(*it);
+
+  return true;
+}
+
+void CGUISkinCache::Save(const CStdString &xmlFile, const CStdString &loadedFile, const TiXmlDocument &xmlDoc, const map<CStdString, bool> &conditions)
+{
+  if (!g_advancedSettings.m_guiSkinCache || !g_SkinInfo || !xmlDoc.RootElement())
+    return;
+
+  CSkinCacheWriter writer;
+  writer.WriteInt(SKINCACHE_MAGIC);
+  writer.WriteInt(SKINCACHE_VERSION);
+  writer.WriteString(g_SkinInfo->ID());
+  writer.WriteString(g_SkinInfo->Version().c_str());
+  writer.WriteString(xmlFile);
+
+  vector<CStdString> files;
+  files.push_back(loadedFile);
+  files.insert(files.end(), g_SkinInfo->GetIncludeFiles().begin(), g_SkinInfo->GetIncludeFiles().end());
+  writer.WriteInt(files.size());
+  for (vector<CStdString>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    struct __stat64 st;
+    if (CFile::Stat(*it, &st) != 0)
+      return;
+    writer.WriteString(*it);
+    writer.WriteInt64(st.st_mtime);
+    writer.WriteInt64(st.st_size);
+  }
+
+  writer.WriteInt(conditions.size());
+  for (map<CStdString, bool>::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+  {
+    writer.WriteString(it->first);
+    writer.WriteInt(it->second ? 1 : 0);
+  }
+
+  writer.WriteNode(xmlDoc.RootElement());
+
+  CDirectory::Create(SKINCACHE_PATH);
+  CFile file;
+  if (!file.OpenForWrite(GetCacheFile(xmlFile), true) ||
+      file.Write(writer.GetData().c_str(), writer.GetData().size()) != (int)writer.GetData().size())
+  {
+    file.Close();
+    CFile::Delete(GetCacheFile(xmlFile));
+    CLog::Log(LOGWARNING, "%s - unable to cache %s", __FUNCTION__, xmlFile.c_str());
+  }
+}
+
+void CGUISkinCache::Prune()
+{
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(SKINCACHE_PATH, items, ".bin", DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  // entries are rewritten whenever the skin changes, so those of other skins and
+  // older skin versions are the ones that get old
+  multimap<time_t, pair<CStdString, int64_t> > entries;
+  int64_t total = 0;
+  time_t now = time(NULL);
+  unsigned int removed = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    struct __stat64 st;
+    if (CFile::Stat(items[i]->GetPath(), &st) != 0)
+      continue;
+    if (now - st.st_mtime > SKINCACHE_MAX_AGE)
+    {
+      if (CFile::Delete(items[i]->GetPath()))
+        removed++;
+      continue;
+    }
+    entries.insert(make_pair((time_t)st.st_mtime, make_pair(items[i]->GetPath(), (int64_t)st.st_size)));
+    total += st.st_size;
+  }
+
+  // then the oldest ones, until the rest fit
+  for (multimap<time_t, pair<CStdString, int64_t> >::iterator it = entries.begin(); it != entries.end() && total > SKINCACHE_MAX_SIZE; ++it)
+  {
+    if (CFile::Delete(it->second.first))
+    {
+      total -= it->second.second;
+      removed++;
+    }
+  }
+
+  if (removed)
+    CLog::Log(LOGDEBUG, "%s - removed %u entries", __FUNCTION__, removed);
+}
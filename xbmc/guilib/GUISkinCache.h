@@ -0,0 +1,64 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include <map>
+
+class TiXmlDocument;
+
+/*!
+ \ingroup windows
+ \brief Binary cache of include resolved window XML.
+
+ Resolving includes, defaults and constants is done once per window file and the result
+ stored in special://temp/skincache, keyed by skin id, skin version and the path of the
+ window file (which includes the resolution folder). An entry is only used while the window
+ file and the include files it was resolved against are unchanged, and while the conditional
+ includes it met still evaluate the same. Entries not written for a while, and the oldest
+ ones past the size budget, are removed by Prune().
+ */
+class CGUISkinCache
+{
+public:
+  /*! \brief Load the include resolved document for a window file
+   \param xmlFile path of the window file, as passed to CGUIWindow::LoadXML
+   \param xmlDoc [out] the resolved document
+   \return true if an up to date entry was found, false if the file needs parsing and resolving
+   */
+  static bool Load(const CStdString &xmlFile, TiXmlDocument &xmlDoc);
+
+  /*! \brief Store the include resolved document for a window file
+   \param xmlFile path of the window file, as passed to CGUIWindow::LoadXML
+   \param loadedFile path the window file was actually loaded from
+   \param xmlDoc the resolved document
+   \param conditions conditional includes met while resolving, and their values
+   */
+  static void Save(const CStdString &xmlFile, const CStdString &loadedFile, const TiXmlDocument &xmlDoc, const std::map<CStdString, bool> &conditions);
+
+  /*! \brief Remove old entries and keep the cache within its size budget
+   Called while a skin is loaded, before any of its windows are.
+   */
+  static void Prune();
+
+private:
+  static CStdString GetCacheFile(const CStdString &xmlFile);
+};
@@ -83,6 +83,8 @@ CGUITextureBase::CGUITextureBase(float posX, float posY, float width, float heig
 
   m_allocateDynamically = false;
   m_isAllocated = NO;
+  m_largeWidth = 0;
+  m_largeHeight = 0;
   m_invalid = true;
 }
 
@@ -119,6 +121,8 @@ CGUITextureBase::CGUITextureBase(const CGUITextureBase &right)
   m_currentLoop = 0;
 
   m_isAllocated = NO;
+  m_largeWidth = 0;
+  m_largeHeight = 0;
   m_invalid = true;
 }
 
@@ -313,7 +317,9 @@ bool CGUITextureBase::AllocResources()
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
       CTextureArray texture;
-      if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated()))
+      if (!IsAllocated())
+        GetLargeSize(m_largeWidth, m_largeHeight);
+      if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated(), m_largeWidth, m_largeHeight))
       {
         m_isAllocated = LARGE;
 
@@ -456,7 +462,7 @@ bool CGUITextureBase::CalculateSize()
 void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED), m_largeWidth, m_largeHeight);
   else if (m_isAllocated == NORMAL && m_texture.size())
     g_TextureManager.ReleaseTexture(m_info.filename);
 
@@ -652,6 +658,29 @@ bool CGUITextureBase::SetFileName(const CStdString& filename)
   return true;
 }
 
+void CGUITextureBase::GetLargeSize(unsigned int &width, unsigned int &height) const
+{
+  width = height = 0; // screen size
+  // only images that are fitted to the frame can be decoded to the frame size - scaled and
+  // stretched images need both dimensions covered, which we can't know before decoding.
+  // The frame may hold the image rotated, so ask for a square that fits it either way.
+  if (m_aspect.ratio == CAspectRatio::AR_KEEP && m_width > 0 && m_height > 0)
+  {
+    float size = std::max(m_width * g_graphicsContext.GetGUIScaleX(), m_height * g_graphicsContext.GetGUIScaleY());
+    width = height = (unsigned int)(size + 0.5f);
+  }
+}
+
+void CGUITextureBase::PrefetchFile(const CStdString &filename) const
+{
+  if (filename.IsEmpty() || !(m_info.useLarge || !g_TextureManager.CanLoad(filename)))
+    return;
+
+  unsigned int width, height;
+  GetLargeSize(width, height);
+  g_largeTextureManager.PrefetchImage(filename, width, height);
+}
+
 int CGUITextureBase::GetOrientation() const
 {
   // multiply our orientations
@@ -104,6 +104,7 @@ public:
   bool SetHeight(float height);
   bool SetFileName(const CStdString &filename);
   bool SetAspectRatio(const CAspectRatio &aspect);
+  void PrefetchFile(const CStdString &filename) const;
 
   const CStdString& GetFileName() const { return m_info.filename; };
   float GetTextureWidth() const { return m_frameWidth; };
@@ -125,6 +126,7 @@ protected:
   void LoadDiffuseImage();
   bool AllocateOnDemand();
   bool UpdateAnimFrame();
+  void GetLargeSize(unsigned int &width, unsigned int &height) const;
   void Render(float left, float top, float bottom, float right, float u1, float v1, float u2, float v2, float u3, float v3);
   void OrientateTexture(CRect &rect, float width, float height, int orientation);
 
@@ -163,6 +165,8 @@ protected:
   bool m_allocateDynamically;
   enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED };
   ALLOCATE_TYPE m_isAllocated;
+  unsigned int m_largeWidth;  // size the large texture was requested at
+  unsigned int m_largeHeight;
 
   CTextureInfo m_info;
   CAspectRatio m_aspect;
@@ -22,6 +22,7 @@
 #include "system.h"
 #if defined(HAS_GL)
 #include "GUITextureGL.h"
+#include "GUIQuadBatchGL.h"
 #endif
 #include "Texture.h"
 #include "utils/log.h"
@@ -42,105 +43,85 @@ void CGUITextureGL::Begin(color_t color)
   m_col[3] = (GLubyte)GET_A(color);
 
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  glActiveTextureARB(GL_TEXTURE0_ARB);
   texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
-  glBindTexture(GL_TEXTURE_2D, texture->GetTextureObject());
-  glEnable(GL_TEXTURE_2D);
-
-  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);          // Turn Blending On
-  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-  // diffuse coloring
-  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE0);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-  VerifyGLState();
-
+  GLuint diffuse = 0;
   if (m_diffuse.size())
   {
-    glActiveTextureARB(GL_TEXTURE1_ARB);
-    glBindTexture(GL_TEXTURE_2D, m_diffuse.m_textures[0]->GetTextureObject());
-    glEnable(GL_TEXTURE_2D);
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE1);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-    VerifyGLState();
+    m_diffuse.m_textures[0]->LoadToGPU();
+    diffuse = m_diffuse.m_textures[0]->GetTextureObject();
   }
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
+
+  // quads are drawn by the batch, along with any others sharing the same textures
+  CGUIQuadBatchGL::GetInstance().SetState(texture->GetTextureObject(), diffuse, CGUIQuadBatchGL::MODE_TEXTURE);
 }
 
 void CGUITextureGL::End()
 {
-  glEnd();
-  if (m_diffuse.size())
-  {
-    glDisable(GL_TEXTURE_2D);
-    glActiveTextureARB(GL_TEXTURE0_ARB);
-  }
-  glDisable(GL_TEXTURE_2D);
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  CGUIQuadBatchGL::Vertex *v = CGUIQuadBatchGL::GetInstance().AddQuads(1);
+  for (int i = 0; i < 4; i++)
+  {
+    v[i].x = x[i];
+    v[i].y = y[i];
+    v[i].z = z[i];
+    v[i].r = m_col[0];
+    v[i].g = m_col[1];
+    v[i].b = m_col[2];
+    v[i].a = m_col[3];
+  }
+
   // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  v[0].u1 = texture.x1; v[0].v1 = texture.y1;
+  v[0].u2 = diffuse.x1; v[0].v2 = diffuse.y1;
 
   // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
+  {
+    v[1].u1 = texture.x1; v[1].v1 = texture.y2;
+  }
+  else
+  {
+    v[1].u1 = texture.x2; v[1].v1 = texture.y1;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[1].u2 = diffuse.x1; v[1].v2 = diffuse.y2;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    v[1].u2 = diffuse.x2; v[1].v2 = diffuse.y1;
   }
-  glVertex3f(x[1], y[1], z[1]);
 
   // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  v[2].u1 = texture.x2; v[2].v1 = texture.y2;
+  v[2].u2 = diffuse.x2; v[2].v2 = diffuse.y2;
 
   // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
+  {
+    v[3].u1 = texture.x2; v[3].v1 = texture.y1;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    v[3].u1 = texture.x1; v[3].v1 = texture.y2;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[3].u2 = diffuse.x2; v[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    v[3].u2 = diffuse.x1; v[3].v2 = diffuse.y2;
   }
-  glVertex3f(x[3], y[3], z[3]);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   if (texture)
   {
     glActiveTextureARB(GL_TEXTURE0_ARB);
@@ -27,6 +27,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUISkinCache.h"
 #include "settings/Settings.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
@@ -40,6 +41,7 @@
 #include "input/ButtonTranslator.h"
 #include "utils/XMLUtils.h"
 #include "GUIAudioManager.h"
+#include "TextureManager.h"
 #include "Application.h"
 #include "utils/Variant.h"
 
@@ -115,17 +117,26 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   TiXmlDocument xmlDoc;
-  if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+  if (CGUISkinCache::Load(strPath, xmlDoc))
+    return Load(xmlDoc, false);
+
+  CStdString loadedPath(strPath);
+  if ( !xmlDoc.LoadFile(loadedPath) && !xmlDoc.LoadFile(loadedPath = CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(loadedPath = strLowerPath))
   {
     CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
     SetID(WINDOW_INVALID);
     return false;
   }
 
-  return Load(xmlDoc);
+  // Resolve any includes that may be present, and keep the result for next time
+  map<CStdString, bool> conditions;
+  g_SkinInfo->ResolveIncludes(xmlDoc.RootElement(), &conditions);
+  CGUISkinCache::Save(strPath, loadedPath, xmlDoc, conditions);
+
+  return Load(xmlDoc, false);
 }
 
-bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
+bool CGUIWindow::Load(TiXmlDocument &xmlDoc, bool resolveIncludes /* = true */)
 {
   TiXmlElement* pRootElement = xmlDoc.RootElement();
   if (strcmpi(pRootElement->Value(), "window"))
@@ -139,9 +150,12 @@ bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
   // Resolve any includes that may be present
-  g_SkinInfo->ResolveIncludes(pRootElement);
+  if (resolveIncludes)
+    g_SkinInfo->ResolveIncludes(pRootElement);
   // now load in the skin file
   SetDefaults();
+  m_preloadTextures.clear();
+  m_preloadImages.clear();
 
   CGUIControlFactory::GetInfoColor(pRootElement, "backgroundcolor", m_clearBackground, GetID());
   CGUIControlFactory::GetActions(pRootElement, "onload", m_loadActions);
@@ -212,6 +226,7 @@ bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
     }
     else if (strValue == "controls")
     {
+      GetPreloadTextures(pChild, m_preloadTextures);
       TiXmlElement *pControl = pChild->FirstChildElement();
       while (pControl)
       {
@@ -238,6 +253,28 @@ bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
   return true;
 }
 
+// collect the static textures of the controls, so they can be unpacked in one go when allocating
+void CGUIWindow::GetPreloadTextures(const TiXmlElement *element, vector<CStdString> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    CStdString name = child->ValueStr();
+    name.ToLower();
+    if (name.Find("texture") >= 0)
+    {
+      const TiXmlNode *value = child->FirstChild();
+      if (value && value->Type() == TiXmlNode::TEXT && !strchr(value->Value(), '$'))
+        textures.push_back(value->ValueStr());
+    }
+    else if (name == "itemlayout" || name == "focusedlayout")
+      continue; // allocated per item as the list is shown
+    else if (name == "control" && child->Attribute("type") && strcmpi(child->Attribute("type"), "image") == 0)
+      GetPreloadTextures(child, m_preloadImages);
+    else
+      GetPreloadTextures(child, textures);
+  }
+}
+
 void CGUIWindow::LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup)
 {
   // get control type
@@ -350,11 +387,13 @@ void CGUIWindow::Close_Internal(bool forceClose /*= false*/, int nextWindowID /*
       // Perform the window out effect
       QueueAnimation(ANIM_TYPE_WINDOW_CLOSE);
       m_closing = true;
+      g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
     }
     return;
   }
 
   m_closing = false;
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
   CGUIMessage msg(GUI_MSG_WINDOW_DEINIT, 0, 0);
   OnMessage(msg);
 }
@@ -461,6 +500,7 @@ void CGUIWindow::OnInitWindow()
   m_hasRendered = false;
   m_closing = false;
   m_active = true;
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
   ResetAnimations();  // we need to reset our animations as those windows that don't dynamically allocate
                       // need their anims reset. An alternative solution is turning off all non-dynamic
                       // allocation (which in some respects may be nicer, but it kills hdd spindown and the like)
@@ -652,10 +692,11 @@ void CGUIWindow::AllocResources(bool forceLoad /*= FALSE */)
 {
   CSingleLock lock(g_graphicsContext);
 
-#ifdef _DEBUG
   int64_t start;
   start = CurrentHostCounter();
-#endif
+  TextureManagerStats before;
+  g_TextureManager.GetStats(before);
+
   // load skin xml fil
   CStdString xmlFile = GetProperty("xmlfile").asString();
   bool bHasPath=false;
@@ -667,15 +708,29 @@ void CGUIWindow::AllocResources(bool forceLoad /*= FALSE */)
   int64_t slend;
   slend = CurrentHostCounter();
 
-  // and now allocate resources
+  // and now allocate resources, with the bundled textures unpacked up front. Dynamically allocated
+  // images only load once they're shown, when the unpacked textures are gone again, so they're skipped
+  if (m_dynamicResourceAlloc)
+    g_TextureManager.PreloadTextures(m_preloadTextures);
+  else
+  {
+    vector<CStdString> textures(m_preloadTextures);
+    textures.insert(textures.end(), m_preloadImages.begin(), m_preloadImages.end());
+    g_TextureManager.PreloadTextures(textures);
+  }
   CGUIControlGroup::AllocResources();
+  g_TextureManager.FreePreloadedTextures();
 
-#ifdef _DEBUG
+  // time cold (textures decoded) against warm (textures still cached) window loads
   int64_t end, freq;
   end = CurrentHostCounter();
   freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Alloc resources: %.2fms (%.2f ms skin load)", 1000.f * (end - start) / freq, 1000.f * (slend - start) / freq);
-#endif
+  TextureManagerStats after;
+  g_TextureManager.GetStats(after);
+  CLog::Log(LOGDEBUG,"Alloc resources: %.2fms (%.2f ms skin load), textures: %u loaded, %u reused, %u shared, %u KB resident",
+            1000.f * (end - start) / freq, 1000.f * (slend - start) / freq,
+            after.misses - before.misses, after.reuses - before.reuses,
+            (after.hits - before.hits) - (after.reuses - before.reuses), after.size / 1024);
   m_bAllocated = true;
 }
 
@@ -698,6 +753,8 @@ void CGUIWindow::ClearAll()
 {
   OnWindowUnload();
   CGUIControlGroup::ClearAll();
+  m_preloadTextures.clear();
+  m_preloadImages.clear();
   m_windowLoaded = false;
   m_dynamicResourceAlloc = true;
 }
@@ -758,6 +815,7 @@ bool CGUIWindow::Animate(unsigned int currentTime)
 void CGUIWindow::DisableAnimations()
 {
   m_animationsEnabled = false;
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS); // we no longer count as closing
 }
 
 // returns true if the control group with id groupID has controlID as
@@ -926,6 +984,7 @@ void CGUIWindow::SetProperty(const CStdString &strKey, const CVariant &value)
 {
   CSingleLock lock(*this);
   m_mapProperties[strKey] = value;
+  g_infoManager.Invalidate(INFO_DEPENDS_PROPERTIES);
 }
 
 CVariant CGUIWindow::GetProperty(const CStdString &strKey) const
@@ -942,6 +1001,7 @@ void CGUIWindow::ClearProperties()
 {
   CSingleLock lock(*this);
   m_mapProperties.clear();
+  g_infoManager.Invalidate(INFO_DEPENDS_PROPERTIES);
 }
 
 void CGUIWindow::SetRunActionsManually()
@@ -194,7 +194,7 @@ public:
 protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const CStdString& strPath, const CStdString &strLowerPath);  ///< Loads from the given file
-  bool Load(TiXmlDocument &xmlDoc);                 ///< Loads from the given XML document
+  bool Load(TiXmlDocument &xmlDoc, bool resolveIncludes = true); ///< Loads from the given XML document
   virtual void LoadAdditionalTags(TiXmlElement *root) {}; ///< Load additional information from the XML document
 
   virtual void SetDefaults();
@@ -226,6 +226,7 @@ protected:
   MAPCONTROLSELECTEDEVENTS m_mapSelectedEvents;
 
   void LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup);
+  void GetPreloadTextures(const TiXmlElement *element, std::vector<CStdString> &textures);
 
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
   void ChangeButtonToEdit(int id, bool singleLabel = false);
@@ -256,6 +257,8 @@ protected:
   // control states
   int m_lastControlID;
   std::vector<CControlState> m_controlStates;
+  std::vector<CStdString> m_preloadTextures; ///< bundled textures the controls are likely to load
+  std::vector<CStdString> m_preloadImages;   ///< bundled textures of image controls, only loaded up front without dynamic allocation
   int m_previousWindow;
 
   bool m_animationsEnabled;
@@ -32,6 +32,7 @@
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIControlProfiler.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 
@@ -195,6 +196,8 @@ void CGUIWindowManager::Add(CGUIWindow* pWindow)
     }
     m_mapWindows.insert(pair<int, CGUIWindow *>(pWindow->GetID() + i, pWindow));
   }
+  // Window(id).Property() may now find a window it didn't before
+  g_infoManager.Invalidate(INFO_DEPENDS_PROPERTIES);
 }
 
 void CGUIWindowManager::AddCustomWindow(CGUIWindow* pWindow)
@@ -207,6 +210,8 @@ void CGUIWindowManager::AddCustomWindow(CGUIWindow* pWindow)
 void CGUIWindowManager::AddModeless(CGUIWindow* dialog)
 {
   CSingleLock lock(g_graphicsContext);
+  // a dialog that was closing is shown again even when it's still in the list
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
   // only add the window if it's not already added
   for (iDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
     if (*it == dialog) return;
@@ -228,6 +233,7 @@ void CGUIWindowManager::Remove(int id)
     }
 
     m_mapWindows.erase(it);
+    g_infoManager.Invalidate(INFO_DEPENDS_PROPERTIES | INFO_DEPENDS_WINDOWS);
   }
   else
   {
@@ -310,6 +316,7 @@ void CGUIWindowManager::PreviousWindow()
 
   // remove the current window off our window stack
   m_windowHistory.pop();
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
 
   // ok, initialize the new window
   CLog::Log(LOGDEBUG,"CGUIWindowManager::PreviousWindow: Activate new");
@@ -548,11 +555,15 @@ bool CGUIWindowManager::Render()
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
   bool hasRendered = false;
+  unsigned int renderedRegions = 0;
+  float renderedPixels = 0;
   // If we visualize the regions we will always render the entire viewport
   if (g_advancedSettings.m_guiVisualizeDirtyRegions || g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
     RenderPass();
     hasRendered = true;
+    renderedRegions = 1;
+    renderedPixels = g_graphicsContext.GetViewWindow().Area();
   }
   else if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
   {
@@ -560,6 +571,8 @@ bool CGUIWindowManager::Render()
     {
       RenderPass();
       hasRendered = true;
+      renderedRegions = 1;
+      renderedPixels = g_graphicsContext.GetViewWindow().Area();
     }
   }
   else
@@ -572,10 +585,15 @@ bool CGUIWindowManager::Render()
       g_graphicsContext.SetScissors(*i);
       RenderPass();
       hasRendered = true;
+      renderedRegions++;
+      renderedPixels += i->Area();
     }
     g_graphicsContext.ResetScissors();
   }
 
+  if (CGUIControlProfiler::IsRunning())
+    CGUIControlProfiler::Instance().AddRenderedRegions(renderedRegions, renderedPixels);
+
   if (g_advancedSettings.m_guiVisualizeDirtyRegions)
   {
     g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
@@ -679,6 +697,7 @@ void CGUIWindowManager::DeInitialize()
   // clear our vectors of windows
   m_vecCustomWindows.clear();
   m_activeDialogs.clear();
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
 
   m_initialized = false;
 }
@@ -693,6 +712,7 @@ void CGUIWindowManager::RouteToWindow(CGUIWindow* dialog)
   RemoveDialog(dialog->GetID());
 
   m_activeDialogs.push_back(dialog);
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
 }
 
 /// \brief Unroute window
@@ -705,6 +725,7 @@ void CGUIWindowManager::RemoveDialog(int id)
     if ((*it)->GetID() == id)
     {
       m_activeDialogs.erase(it);
+      g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
       return;
     }
   }
@@ -916,6 +937,7 @@ void CGUIWindowManager::AddToWindowHistory(int newWindowID)
   { // didn't find window in history - add it to the stack
     m_windowHistory.push(newWindowID);
   }
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
 }
 
 void CGUIWindowManager::GetActiveModelessWindows(vector<int> &ids)
@@ -964,6 +986,7 @@ void CGUIWindowManager::ClearWindowHistory()
 {
   while (m_windowHistory.size())
     m_windowHistory.pop();
+  g_infoManager.Invalidate(INFO_DEPENDS_WINDOWS);
 }
 
 void CGUIWindowManager::CloseWindowSync(CGUIWindow *window, int nextWindowID /*= 0*/)
@@ -134,6 +134,8 @@ CJpegIO::CJpegIO()
   m_imgsize = 0;
   m_width  = 0;
   m_height = 0;
+  m_originalWidth  = 0;
+  m_originalHeight = 0;
   m_orientation = 0;
   m_inputBuffSize = 0;
   m_inputBuff = NULL;
@@ -215,9 +217,14 @@ bool CJpegIO::Open(const CStdString &texturePath, unsigned int minx, unsigned in
       if (m_cinfo.output_width >= m_minx || m_cinfo.output_height >= m_miny)
         break;
     }
+    // never go past 8/8, decoders that can upscale would otherwise return more than the original
+    if (m_cinfo.scale_num > 8)
+      m_cinfo.scale_num = 8;
     jpeg_calc_output_dimensions(&m_cinfo);
     m_width  = m_cinfo.output_width;
     m_height = m_cinfo.output_height;
+    m_originalWidth  = m_cinfo.image_width;
+    m_originalHeight = m_cinfo.image_height;
 
     GetExif();
     return true;
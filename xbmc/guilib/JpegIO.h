@@ -43,6 +43,8 @@ public:
   unsigned int   FileSize()    { return m_imgsize; }
   unsigned int   Width()       { return m_width; }
   unsigned int   Height()      { return m_height; }
+  unsigned int   OriginalWidth()  { return m_originalWidth; }
+  unsigned int   OriginalHeight() { return m_originalHeight; }
   unsigned int   Orientation() { return m_orientation; }
 
 protected:
@@ -62,6 +64,8 @@ protected:
   unsigned int   m_imgsize;
   unsigned int   m_width;
   unsigned int   m_height;
+  unsigned int   m_originalWidth;
+  unsigned int   m_originalHeight;
   unsigned int   m_orientation;
 };
 
@@ -204,6 +204,10 @@ bool CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned int maxW
         {
           if (autoRotate && jpegfile.Orientation())
             m_orientation = jpegfile.Orientation() - 1;
+          if (originalWidth)
+            *originalWidth = jpegfile.OriginalWidth();
+          if (originalHeight)
+            *originalHeight = jpegfile.OriginalHeight();
           m_hasAlpha=false;
           return true;
         }
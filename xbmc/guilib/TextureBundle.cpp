@@ -104,6 +104,17 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+void CTextureBundle::PreloadTextures(const std::vector<CStdString> &names)
+{
+  if (m_useXBT)
+    m_tbXBT.PreloadTextures(names);
+}
+
+void CTextureBundle::FreePreloaded()
+{
+  m_tbXBT.FreePreloaded();
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
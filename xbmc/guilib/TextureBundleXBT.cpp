@@ -30,16 +30,118 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/JobManager.h"
+#include "utils/CPUInfo.h"
+#include "threads/SingleLock.h"
+#include "threads/Event.h"
 #include "XBTF.h"
 #include <lzo/lzo1x.h>
+#include <boost/shared_ptr.hpp>
 
 #ifdef _WIN32
 #pragma comment(lib,"liblzo2.lib")
 #endif
 
+#define PRELOAD_MAX_JOBS 8
+
+/*
+ Unpacks a set of frames. The thread preloading and the jobs it starts all take the
+ next frame to unpack until there are none left, so the preload never waits on a job
+ that hasn't started yet.
+ */
+class CXBTUnpacker
+{
+public:
+  struct Frame
+  {
+    const unsigned char *packed;
+    uint64_t packedSize;
+    unsigned char *unpacked;
+    uint64_t unpackedSize;
+    bool ok;
+  };
+
+  CXBTUnpacker() : m_next(0), m_busy(0), m_done(true) {}
+
+  void Add(const unsigned char *packed, uint64_t packedSize, unsigned char *unpacked, uint64_t unpackedSize)
+  {
+    Frame frame = { packed, packedSize, unpacked, unpackedSize, false };
+    m_frames.push_back(frame);
+  }
+
+  void Run()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_busy++;
+    }
+    while (true)
+    {
+      Frame *frame = NULL;
+      {
+        CSingleLock lock(m_section);
+        if (m_next < m_frames.size())
+          frame = &m_frames[m_next++];
+      }
+      if (!frame)
+        break;
+      lzo_uint size = (lzo_uint)frame->unpackedSize;
+      frame->ok = lzo1x_decompress_safe(frame->packed, (lzo_uint)frame->packedSize, frame->unpacked, &size, NULL) == LZO_E_OK &&
+                  size == frame->unpackedSize;
+    }
+    CSingleLock lock(m_section);
+    if (--m_busy == 0)
+      m_done.Set();
+  }
+
+  /*! \brief Wait for the jobs that took a frame to finish it */
+  void Wait()
+  {
+    while (true)
+    {
+      {
+        CSingleLock lock(m_section);
+        if (m_busy == 0)
+          return;
+        m_done.Reset();
+      }
+      m_done.Wait();
+    }
+  }
+
+  std::vector<Frame> &GetFrames() { return m_frames; };
+
+private:
+  std::vector<Frame> m_frames;
+  unsigned int m_next;
+  unsigned int m_busy;     ///< threads currently unpacking
+  CCriticalSection m_section;
+  CEvent m_done;
+};
+
+typedef boost::shared_ptr<CXBTUnpacker> CXBTUnpackerPtr;
+
+class CXBTUnpackJob : public CJob
+{
+public:
+  CXBTUnpackJob(const CXBTUnpackerPtr &unpacker) : m_unpacker(unpacker) {}
+  virtual bool DoWork()
+  {
+    m_unpacker->Run();
+    return true;
+  }
+  virtual const char *GetType() const { return "xbtunpack"; };
+private:
+  CXBTUnpackerPtr m_unpacker;
+};
+
 CTextureBundleXBT::CTextureBundleXBT(void)
 {
   m_themeBundle = false;
+  m_openTime = m_loadTime = m_preloadTime = 0;
+  m_framesLoaded = m_framesPreloaded = 0;
+  m_bytesLoaded = 0;
 }
 
 CTextureBundleXBT::~CTextureBundleXBT(void)
@@ -78,12 +180,15 @@ bool CTextureBundleXBT::OpenBundle()
   strPath = CSpecialProtocol::TranslatePathConvertCase(strPath);
 
   // Load the texture file
+  int64_t start = CurrentHostCounter();
   if (!m_XBTFReader.Open(strPath))
   {
     return false;
   }
+  m_openTime = CurrentHostCounter() - start;
 
-  CLog::Log(LOGDEBUG, "%s - Opened bundle %s", __FUNCTION__, strPath.c_str());
+  CLog::Log(LOGDEBUG, "%s - Opened bundle %s (%"PRId64" ms, %s)", __FUNCTION__, strPath.c_str(),
+            m_openTime * 1000 / CurrentHostFrequency(), m_XBTFReader.IsMapped() ? "mapped" : "read");
 
   m_TimeStamp = m_XBTFReader.GetLastModificationTimestamp();
 
@@ -193,43 +298,72 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
-  {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
+  int64_t start = CurrentHostCounter();
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
+  // frames unpacked by PreloadTextures() are ready to go
+  unsigned char *buffer = NULL;
+  std::map<uint64_t, unsigned char*>::iterator preloaded = m_unpacked.find(frame.GetOffset());
+  if (preloaded != m_unpacked.end())
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    buffer = preloaded->second;
+    m_unpacked.erase(preloaded);
   }
-
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+  else
+  {
+    // use the frame straight from the mapped bundle where we can
+    const unsigned char *data = m_XBTFReader.GetData(frame);
+    unsigned char *loaded = NULL;
+    if (!data)
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
+      loaded = new squish::u8[(size_t)frame.GetPackedSize()];
+      if (loaded == NULL)
+      {
+        CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+        return false;
+      }
+
+      // load the compressed texture
+      if (!m_XBTFReader.Load(frame, loaded))
+      {
+        CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+        delete[] loaded;
+        return false;
+      }
+      data = loaded;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
-    {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
-      return false;
+
+    // check if it's packed with lzo
+    if (frame.IsPacked())
+    { // unpack
+      buffer = new squish::u8[(size_t)frame.GetUnpackedSize()];
+      if (buffer == NULL)
+      {
+        CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
+        delete[] loaded;
+        return false;
+      }
+      lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
+      if (lzo1x_decompress_safe(data, (lzo_uint)frame.GetPackedSize(), buffer, &s, NULL) != LZO_E_OK ||
+          s != frame.GetUnpackedSize())
+      {
+        CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+        delete[] loaded;
+        delete[] buffer;
+        return false;
+      }
+      delete[] loaded;
+    }
+    else if (loaded)
+      buffer = loaded;
+    else
+    { // the texture copies the pixels, so the mapping can be handed over as is
+      *ppTexture = new CTexture();
+      (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), (unsigned char *)data);
+      m_framesLoaded++;
+      m_bytesLoaded += frame.GetUnpackedSize();
+      m_loadTime += CurrentHostCounter() - start;
+      return true;
     }
-    delete[] buffer;
-    buffer = unpacked;
   }
 
   // create an xbmc texture
@@ -238,16 +372,94 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
 
   delete[] buffer;
 
+  m_framesLoaded++;
+  m_bytesLoaded += frame.GetUnpackedSize();
+  m_loadTime += CurrentHostCounter() - start;
   return true;
 }
 
+void CTextureBundleXBT::PreloadTextures(const std::vector<CStdString> &names)
+{
+  if (!m_XBTFReader.IsMapped())
+    return;
+
+  int64_t start = CurrentHostCounter();
+
+  CXBTUnpackerPtr unpacker(new CXBTUnpacker);
+  std::vector<uint64_t> offsets;
+  uint64_t bytes = 0;
+  for (std::vector<CStdString>::const_iterator it = names.begin(); it != names.end(); ++it)
+  {
+    CXBTFFile* file = m_XBTFReader.Find(Normalize(*it));
+    if (!file)
+      continue;
+    std::vector<CXBTFFrame> &frames = file->GetFrames();
+    for (std::vector<CXBTFFrame>::const_iterator frame = frames.begin(); frame != frames.end(); ++frame)
+    {
+      // unpacked frames are used straight from the mapping, so there's nothing to gain
+      if (!frame->IsPacked() || m_unpacked.find(frame->GetOffset()) != m_unpacked.end())
+        continue;
+      const unsigned char *data = m_XBTFReader.GetData(*frame);
+      if (!data)
+        continue;
+      unsigned char *unpacked = new unsigned char[(size_t)frame->GetUnpackedSize()];
+      m_unpacked.insert(std::make_pair(frame->GetOffset(), unpacked));
+      unpacker->Add(data, frame->GetPackedSize(), unpacked, frame->GetUnpackedSize());
+      offsets.push_back(frame->GetOffset());
+      bytes += frame->GetUnpackedSize();
+    }
+  }
+  if (offsets.empty())
+    return;
+
+  // the calling thread unpacks as well, so one job less than there are cores
+  unsigned int cores = (unsigned int)std::max(g_cpuInfo.getCPUCount(), 1);
+  unsigned int jobs = std::min((unsigned int)offsets.size(), std::min(cores, (unsigned int)PRELOAD_MAX_JOBS)) - 1;
+  for (unsigned int i = 0; i < jobs; i++)
+    CJobManager::GetInstance().AddJob(new CXBTUnpackJob(unpacker), NULL, CJob::PRIORITY_HIGH);
+  unpacker->Run();
+  unpacker->Wait();
+
+  // frames that failed to unpack are left for ConvertFrameToTexture() to report
+  std::vector<CXBTUnpacker::Frame> &frames = unpacker->GetFrames();
+  for (unsigned int i = 0; i < frames.size(); i++)
+  {
+    if (!frames[i].ok)
+    {
+      delete[] frames[i].unpacked;
+      m_unpacked.erase(offsets[i]);
+    }
+    else
+      m_framesPreloaded++;
+  }
+
+  int64_t elapsed = CurrentHostCounter() - start;
+  m_preloadTime += elapsed;
+  CLog::Log(LOGDEBUG, "%s - unpacked %u frames (%"PRIu64" KB) in %"PRId64" ms using %u jobs", __FUNCTION__,
+            (unsigned int)frames.size(), bytes / 1024, elapsed * 1000 / CurrentHostFrequency(), jobs);
+}
+
+void CTextureBundleXBT::FreePreloaded()
+{
+  for (std::map<uint64_t, unsigned char*>::iterator it = m_unpacked.begin(); it != m_unpacked.end(); ++it)
+    delete[] it->second;
+  m_unpacked.clear();
+}
+
 void CTextureBundleXBT::Cleanup()
 {
+  FreePreloaded();
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
-    CLog::Log(LOGDEBUG, "%s - Closed %sbundle", __FUNCTION__, m_themeBundle ? "theme " : "");
+    int64_t freq = CurrentHostFrequency();
+    CLog::Log(LOGDEBUG, "%s - Closed %sbundle: opened in %"PRId64" ms, %u frames (%"PRIu64" KB) loaded in %"PRId64" ms, %u unpacked ahead in %"PRId64" ms",
+              __FUNCTION__, m_themeBundle ? "theme " : "", m_openTime * 1000 / freq, m_framesLoaded, m_bytesLoaded / 1024,
+              m_loadTime * 1000 / freq, m_framesPreloaded, m_preloadTime * 1000 / freq);
   }
+  m_openTime = m_loadTime = m_preloadTime = 0;
+  m_framesLoaded = m_framesPreloaded = 0;
+  m_bytesLoaded = 0;
 }
 
 void CTextureBundleXBT::SetThemeBundle(bool themeBundle)
@@ -45,6 +45,14 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Unpack the compressed frames of the given textures ahead of loading them
+   The frames are unpacked in parallel on the job pool and kept until the textures are
+   loaded or FreePreloaded() is called.
+   \param names the textures, as passed to LoadTexture
+   */
+  void PreloadTextures(const std::vector<CStdString> &names);
+  void FreePreloaded();
+
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
@@ -53,6 +61,15 @@ private:
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+  std::map<uint64_t, unsigned char*> m_unpacked; ///< preloaded frames by offset
+
+  // timing of the bundle since it was opened
+  int64_t m_openTime;
+  int64_t m_loadTime;          ///< reading, unpacking and creating textures from frames
+  int64_t m_preloadTime;       ///< unpacking frames in parallel
+  unsigned int m_framesLoaded;
+  unsigned int m_framesPreloaded;
+  uint64_t m_bytesLoaded;      ///< unpacked size of the frames loaded
 };
 
 
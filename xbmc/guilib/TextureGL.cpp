@@ -21,6 +21,7 @@
 
 #include "system.h"
 #include "TextureGL.h"
+#include "GUIQuadBatchGL.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -50,7 +51,12 @@ void CGLTexture::CreateTextureObject()
 void CGLTexture::DestroyTextureObject()
 {
   if (m_texture)
+  {
+#if defined(HAS_GL)
+    CGUIQuadBatchGL::GetInstance().FlushTexture(m_texture);
+#endif
     glDeleteTextures(1, (GLuint*) &m_texture);
+  }
 }
 
 void CGLTexture::LoadToGPU()
@@ -66,6 +72,13 @@ void CGLTexture::LoadToGPU()
     // this happens only one time - the first time the texture is loaded
     CreateTextureObject();
   }
+#if defined(HAS_GL)
+  else
+  {
+    // quads still waiting in the batch were drawn with the old contents
+    CGUIQuadBatchGL::GetInstance().FlushTexture(m_texture);
+  }
+#endif
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
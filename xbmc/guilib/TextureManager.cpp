@@ -28,6 +28,7 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "addons/Skin.h"
+#include "settings/AdvancedSettings.h"
 #ifdef _DEBUG
 #include "utils/TimeUtils.h"
 #endif
@@ -127,6 +128,8 @@ CTextureMap::CTextureMap()
   m_textureName = "";
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_unused = false;
+  m_generation = 0;
 }
 
 CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, int loops)
@@ -135,6 +138,8 @@ CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, i
   m_textureName = textureName;
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_unused = false;
+  m_generation = 0;
 }
 
 CTextureMap::~CTextureMap()
@@ -215,6 +220,12 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+  m_unusedSize = 0;
+  m_generation = 0;
+  m_hits = 0;
+  m_misses = 0;
+  m_reuses = 0;
+  m_evictions = 0;
 }
 
 CGUITextureManager::~CGUITextureManager(void)
@@ -226,16 +237,57 @@ const CTextureArray& CGUITextureManager::GetTexture(const CStdString& strTexture
 {
   static CTextureArray emptyTexture;
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  CSingleLock lock(m_mapSection);
+  CTextureMap *pMap = FindTexture(strTextureName);
+  if (!pMap)
+    return emptyTexture;
+
+  if (pMap->m_unused)
+  { // back in use, so take it off the eviction list
+    m_unusedTextures.erase(pMap->m_lruPos);
+    m_unusedSize -= pMap->GetMemoryUsage();
+    pMap->m_unused = false;
+    m_reuses++;
+  }
+  return pMap->GetTexture();
+}
+
+CTextureMap *CGUITextureManager::FindTexture(const CStdString &textureName) const
+{
+  ciTextures it = m_textures.find(textureName);
+  if (it == m_textures.end())
+    return NULL;
+
+  // an unused map that was resolved against other texture paths may not be what
+  // this name points at now, so it has to be loaded again
+  CTextureMap *pMap = it->second;
+  if (pMap->m_unused && pMap->m_generation != m_generation && !CURL::IsFullPath(textureName))
+    return NULL;
+  return pMap;
+}
+
+void CGUITextureManager::AddTexture(CTextureMap *pMap)
+{
+  CSingleLock lock(m_mapSection);
+  iTextures it = m_textures.find(pMap->GetName());
+  if (it != m_textures.end())
+    RemoveTexture(it->second); // stale unused map with the same name
+
+  pMap->m_generation = m_generation;
+  m_textures.insert(make_pair(pMap->GetName(), pMap));
+  m_misses++;
+}
+
+void CGUITextureManager::RemoveTexture(CTextureMap *pMap)
+{
+  m_textures.erase(pMap->GetName());
+  if (pMap->m_unused)
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-      return pMap->GetTexture();
-    }
+    m_unusedTextures.erase(pMap->m_lruPos);
+    m_unusedSize -= pMap->GetMemoryUsage();
+    pMap->m_unused = false;
   }
-  return emptyTexture;
+  m_freeTextures.push_back(pMap);
 }
 
 /************************************************************************/
@@ -265,10 +317,9 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   CStdString bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
+    CSingleLock lock(m_mapSection);
+    if (FindTexture(textureName))
     {
       if (size) *size = 1;
       return true;
@@ -293,6 +344,9 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
 int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleOnly /*= false */)
 {
+  //Lock here, we will do stuff that could break rendering
+  CSingleLock lock(g_graphicsContext);
+
   CStdString strPath;
   int bundle = -1;
   int size = 0;
@@ -300,14 +354,15 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     return 0;
 
   if (size) // we found the texture
+  {
+    CSingleLock mapLock(m_mapSection);
+    m_hits++;
     return size;
+  }
 
   if (checkBundleOnly && bundle == -1)
     return 0;
 
-  //Lock here, we will do stuff that could break rendering
-  CSingleLock lock(g_graphicsContext);
-
 #ifdef _DEBUG
   int64_t start;
   start = CurrentHostCounter();
@@ -384,7 +439,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return 1;
   } // of if (strPath.Right(4).ToLower()==".gif")
 
@@ -411,7 +466,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddTexture(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -429,24 +484,25 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock mapLock(m_mapSection);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures it = m_textures.find(strTextureName);
+  if (it != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    CTextureMap* pMap = it->second;
+    if (!pMap->m_unused && pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(pMap);
-        i = m_vecTextures.erase(i);
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      if (pMap->IsEmpty())
+        RemoveTexture(pMap);
+      else
+      { // keep it loaded until we run over budget
+        pMap->m_unused = true;
+        pMap->m_lruPos = m_unusedTextures.insert(m_unusedTextures.end(), pMap);
+        m_unusedSize += pMap->GetMemoryUsage();
       }
-      return;
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
@@ -454,24 +510,81 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 void CGUITextureManager::FreeUnusedTextures()
 {
   CSingleLock lock(g_graphicsContext);
-  for (ivecTextures i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  CSingleLock mapLock(m_mapSection);
+
+  unsigned int maxSize = (unsigned int)g_advancedSettings.m_guiTextureCacheSize * 1024;
+  unsigned int evicted = 0;
+  while (m_unusedSize > maxSize && !m_unusedTextures.empty())
+  {
+    RemoveTexture(m_unusedTextures.front());
+    evicted++;
+  }
+  if (evicted)
+  {
+    m_evictions += evicted;
+    CLog::Log(LOGDEBUG, "%s - freed %u unused textures, %u of %u bytes still cached", __FUNCTION__, evicted, m_unusedSize, maxSize);
+  }
+
+  for (ivecTextures i = m_freeTextures.begin(); i != m_freeTextures.end(); ++i)
     delete *i;
-  m_unusedTextures.clear();
+  m_freeTextures.clear();
+}
+
+void CGUITextureManager::PreloadTextures(const std::vector<CStdString> &textureNames)
+{
+  CSingleLock lock(g_graphicsContext);
+
+  // the theme bundle takes precedence, as in HasTexture()
+  std::vector<CStdString> bundled[2];
+  for (std::vector<CStdString>::const_iterator it = textureNames.begin(); it != textureNames.end(); ++it)
+  {
+    if (!CanLoad(*it))
+      continue;
+    {
+      CSingleLock mapLock(m_mapSection);
+      if (FindTexture(*it))
+        continue;
+    }
+    CStdString bundledName = CTextureBundle::Normalize(*it);
+    for (int i = 0; i < 2; i++)
+    {
+      if (m_TexBundle[i].HasFile(bundledName))
+      {
+        bundled[i].push_back(bundledName);
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (!bundled[i].empty())
+      m_TexBundle[i].PreloadTextures(bundled[i]);
+  }
+}
+
+void CGUITextureManager::FreePreloadedTextures()
+{
+  CSingleLock lock(g_graphicsContext);
+  for (int i = 0; i < 2; i++)
+    m_TexBundle[i].FreePreloaded();
 }
 
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock mapLock(m_mapSection);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (iTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
-    CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
+    CTextureMap* pMap = i->second;
+    if (!pMap->m_unused)
+      CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
+  m_unusedTextures.clear();
+  m_unusedSize = 0;
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
   FreeUnusedTextures();
@@ -480,12 +593,12 @@ void CGUITextureManager::Cleanup()
 void CGUITextureManager::Dump() const
 {
   CStdString strLog;
-  strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
+  strLog.Format("total texturemaps size:%i\n", m_textures.size());
   OutputDebugString(strLog.c_str());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (ciTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -494,35 +607,47 @@ void CGUITextureManager::Dump() const
 void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock mapLock(m_mapSection);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    pMap->Flush();
-    if (pMap->IsEmpty() )
-    {
-      delete pMap;
-      i = m_vecTextures.erase(i);
-    }
+    CTextureMap* pMap = i->second;
+    ++i;
+    if (pMap->m_unused)
+      RemoveTexture(pMap);
     else
     {
-      ++i;
+      pMap->Flush();
+      if (pMap->IsEmpty())
+        RemoveTexture(pMap);
     }
   }
 }
 
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
+  CSingleLock lock(m_mapSection);
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
-  }
+  for (ciTextures i = m_textures.begin(); i != m_textures.end(); ++i)
+    memUsage += i->second->GetMemoryUsage();
   return memUsage;
 }
 
+void CGUITextureManager::GetStats(TextureManagerStats &stats) const
+{
+  CSingleLock lock(m_mapSection);
+  stats.textures = m_textures.size();
+  stats.unused = m_unusedTextures.size();
+  stats.size = GetMemoryUsage();
+  stats.unusedSize = m_unusedSize;
+  stats.maxSize = (unsigned int)g_advancedSettings.m_guiTextureCacheSize * 1024;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.reuses = m_reuses;
+  stats.evictions = m_evictions;
+}
+
 void CGUITextureManager::SetTexturePath(const CStdString &texturePath)
 {
   CSingleLock lock(m_section);
@@ -535,6 +660,9 @@ void CGUITextureManager::AddTexturePath(const CStdString &texturePath)
   CSingleLock lock(m_section);
   if (!texturePath.IsEmpty())
     m_texturePaths.push_back(texturePath);
+
+  CSingleLock mapLock(m_mapSection);
+  m_generation++;
 }
 
 void CGUITextureManager::RemoveTexturePath(const CStdString &texturePath)
@@ -545,6 +673,8 @@ void CGUITextureManager::RemoveTexturePath(const CStdString &texturePath)
     if (*it == texturePath)
     {
       m_texturePaths.erase(it);
+      CSingleLock mapLock(m_mapSection);
+      m_generation++;
       return;
     }
   }
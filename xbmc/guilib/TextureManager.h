@@ -28,6 +28,8 @@
 #define GUILIB_TEXTUREMANAGER_H
 
 #include <vector>
+#include <list>
+#include <map>
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -86,12 +88,35 @@ public:
   void Flush();
   bool IsEmpty() const;
 protected:
+  friend class CGUITextureManager;
   void FreeTexture();
 
   CStdString m_textureName;
   CTextureArray m_texture;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+
+  bool m_unused;                              ///< true while on the texture manager's unused list
+  unsigned int m_generation;                  ///< texture path generation the map was loaded under
+  std::list<CTextureMap*>::iterator m_lruPos; ///< position on the texture manager's unused list
+};
+
+/*!
+ \ingroup textures
+ \brief Counters of the texture manager
+ \sa CGUITextureManager::GetStats
+ */
+struct TextureManagerStats
+{
+  unsigned int textures;   ///< texture maps loaded, referenced or not
+  unsigned int unused;     ///< loaded texture maps no control references
+  unsigned int size;       ///< memory used by all loaded texture maps, in bytes
+  unsigned int unusedSize; ///< memory used by the unreferenced texture maps, in bytes
+  unsigned int maxSize;    ///< budget for the unreferenced texture maps, in bytes
+  unsigned int hits;       ///< loads answered by an already loaded texture map
+  unsigned int misses;     ///< loads that had to decode the texture
+  unsigned int reuses;     ///< unreferenced texture maps picked up again before being freed
+  unsigned int evictions;  ///< unreferenced texture maps freed to stay within the budget
 };
 
 /*!
@@ -124,10 +149,38 @@ public:
   void RemoveTexturePath(const CStdString &texturePath); ///< Remove a path from the paths to check when loading media
 
   void FreeUnusedTextures(); ///< Free textures (called from app thread only)
+
+  /*! \brief Unpack bundled textures that aren't loaded yet ahead of loading them
+   Used by windows before allocating their controls, so the frames are unpacked in parallel
+   rather than one by one as each control loads its textures.
+   \param textureNames the textures the window is likely to load
+   \sa FreePreloadedTextures
+   */
+  void PreloadTextures(const std::vector<CStdString> &textureNames);
+  void FreePreloadedTextures(); ///< Free whatever PreloadTextures() unpacked that wasn't loaded
+  void GetStats(TextureManagerStats &stats) const;
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::vector<CTextureMap*> m_unusedTextures;
+  CTextureMap *FindTexture(const CStdString &textureName) const;
+  void AddTexture(CTextureMap *pMap);
+  void RemoveTexture(CTextureMap *pMap);
+
+  /*! \brief Loaded texture maps by name.
+   Maps no control references any longer stay in here (and on m_unusedTextures) until
+   FreeUnusedTextures() evicts them, so reopening a window doesn't decode its textures again.
+   */
+  std::map<CStdString, CTextureMap*> m_textures;
+  typedef std::map<CStdString, CTextureMap*>::iterator iTextures;
+  typedef std::map<CStdString, CTextureMap*>::const_iterator ciTextures;
+  std::list<CTextureMap*> m_unusedTextures;   ///< unreferenced maps, least recently released first
+  std::vector<CTextureMap*> m_freeTextures;   ///< maps to delete in FreeUnusedTextures()
   typedef std::vector<CTextureMap*>::iterator ivecTextures;
+  unsigned int m_unusedSize;
+  unsigned int m_generation;                  ///< bumped whenever the texture paths change
+  unsigned int m_hits;
+  unsigned int m_misses;
+  unsigned int m_reuses;
+  unsigned int m_evictions;
+  CCriticalSection m_mapSection;              ///< guards the maps, lists and counters above
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
@@ -20,6 +20,11 @@
  */
 
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#else
+#include <io.h>
+#endif
 #include "XBTFReader.h"
 #include "utils/EndianSwap.h"
 #include "utils/CharsetConverter.h"
@@ -47,6 +52,11 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_mapping = NULL;
+  m_mappingSize = 0;
+#ifdef _WIN32
+  m_mappingHandle = NULL;
+#endif
 }
 
 bool CXBTFReader::IsOpen() const
@@ -136,11 +146,51 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+  Map();
+
   return true;
 }
 
+// map the whole file so frames can be used in place, falling back to reading them if we can't
+void CXBTFReader::Map()
+{
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return;
+  m_mappingSize = fileStat.st_size;
+
+#ifdef _WIN32
+  m_mappingHandle = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(m_file)), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mappingHandle)
+    m_mapping = (unsigned char *)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+  void *mapping = mmap(NULL, (size_t)m_mappingSize, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (mapping != MAP_FAILED)
+    m_mapping = (unsigned char *)mapping;
+#endif
+  if (!m_mapping)
+    Unmap();
+}
+
+void CXBTFReader::Unmap()
+{
+#ifdef _WIN32
+  if (m_mapping)
+    UnmapViewOfFile(m_mapping);
+  if (m_mappingHandle)
+    CloseHandle(m_mappingHandle);
+  m_mappingHandle = NULL;
+#else
+  if (m_mapping)
+    munmap(m_mapping, (size_t)m_mappingSize);
+#endif
+  m_mapping = NULL;
+  m_mappingSize = 0;
+}
+
 void CXBTFReader::Close()
 {
+  Unmap();
   if (m_file)
   {
     fclose(m_file);
@@ -189,6 +239,12 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   {
     return false;
   }
+  const unsigned char *data = GetData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
 #if defined(__APPLE__) || defined(__FreeBSD__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -206,6 +262,18 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   return true;
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_mapping || frame.GetOffset() > m_mappingSize || frame.GetPackedSize() > m_mappingSize - frame.GetOffset())
+    return NULL;
+  return m_mapping + frame.GetOffset();
+}
+
+bool CXBTFReader::IsMapped() const
+{
+  return m_mapping != NULL;
+}
+
 std::vector<CXBTFFile>& CXBTFReader::GetFiles()
 {
   return m_xbtf.GetFiles();
@@ -38,13 +38,27 @@ public:
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get the (packed) data of a frame straight from the mapped file
+   \return a pointer into the mapping, or NULL if the file couldn't be mapped
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
+  bool IsMapped() const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
+  void Map();
+  void Unmap();
+
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
   std::map<CStdString, CXBTFFile> m_filesMap;
+  unsigned char* m_mapping;  ///< the whole file, read only
+  uint64_t   m_mappingSize;
+#ifdef _WIN32
+  void*      m_mappingHandle;
+#endif
 };
 
 #endif
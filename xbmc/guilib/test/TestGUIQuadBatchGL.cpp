@@ -0,0 +1,204 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+
+#if defined(HAS_GL)
+
+#include "guilib/GUIQuadBatchGL.h"
+
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+//=============================================================================
+// GL stubs
+//=============================================================================
+
+// the batch only ever draws with glDrawArrays, so counting those counts its draw calls
+struct DrawCall
+{
+  GLuint       texture;
+  GLuint       diffuse;
+  unsigned int vertices;
+  float        firstX;  ///< x of the first vertex drawn, to check the order quads are sent in
+};
+
+static std::vector<DrawCall> drawCalls;
+static GLuint boundTexture[2] = { 0, 0 };
+static unsigned int activeTexture = 0;
+static const GLvoid *vertexPointer = NULL;
+
+extern "C"
+{
+  static void APIENTRY StubActiveTexture(GLenum texture) { activeTexture = texture - GL_TEXTURE0_ARB; }
+  static void APIENTRY StubClientActiveTexture(GLenum texture) {}
+
+  PFNGLACTIVETEXTUREARBPROC __glewActiveTextureARB = StubActiveTexture;
+  PFNGLCLIENTACTIVETEXTUREARBPROC __glewClientActiveTextureARB = StubClientActiveTexture;
+
+  void APIENTRY glBindTexture(GLenum target, GLuint texture) { boundTexture[activeTexture] = texture; }
+  void APIENTRY glEnable(GLenum cap) {}
+  void APIENTRY glDisable(GLenum cap) {}
+  void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {}
+  void APIENTRY glPolygonMode(GLenum face, GLenum mode) {}
+  void APIENTRY glTexEnvi(GLenum target, GLenum pname, GLint param) {}
+  void APIENTRY glPushClientAttrib(GLbitfield mask) {}
+  void APIENTRY glPopClientAttrib(void) {}
+  void APIENTRY glEnableClientState(GLenum cap) {}
+  void APIENTRY glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {}
+  void APIENTRY glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {}
+  void APIENTRY glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) { vertexPointer = pointer; }
+  void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+  {
+    DrawCall call;
+    call.texture = boundTexture[0];
+    call.diffuse = boundTexture[1];
+    call.vertices = count;
+    call.firstX = ((const GLfloat *)vertexPointer)[first * sizeof(CGUIQuadBatchGL::Vertex) / sizeof(GLfloat)];
+    drawCalls.push_back(call);
+  }
+}
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// queues quads the way CGUITextureGL does, one control at a time
+static void addQuads(GLuint texture, GLuint diffuse, CGUIQuadBatchGL::Mode mode, unsigned int count, float x)
+{
+  CGUIQuadBatchGL &batch = CGUIQuadBatchGL::GetInstance();
+  batch.SetState(texture, diffuse, mode);
+  CGUIQuadBatchGL::Vertex *v = batch.AddQuads(count);
+  for (unsigned int i = 0; i < 4 * count; i++)
+  {
+    v[i].x = x;
+    v[i].y = v[i].z = 0;
+  }
+}
+
+struct BatchFixture
+{
+  BatchFixture()
+  {
+    // drop whatever a previous test left pending
+    CGUIQuadBatchGL::GetInstance().EndFrame();
+    boundTexture[0] = boundTexture[1] = 0;
+    drawCalls.clear();
+  }
+};
+
+//=============================================================================
+
+BOOST_FIXTURE_TEST_CASE(TestSameStateIsOneDrawCall, BatchFixture)
+{
+  for (unsigned int i = 0; i < 100; i++)
+    addQuads(1, 0, CGUIQuadBatchGL::MODE_TEXTURE, 1, (float)i);
+  BOOST_CHECK(drawCalls.empty());
+
+  CGUIQuadBatchGL::GetInstance().EndFrame();
+  BOOST_REQUIRE_EQUAL(drawCalls.size(), 1U);
+  BOOST_CHECK_EQUAL(drawCalls[0].texture, 1U);
+  BOOST_CHECK_EQUAL(drawCalls[0].vertices, 400U);
+  BOOST_CHECK_EQUAL(drawCalls[0].firstX, 0.0f);
+
+  unsigned int calls, quads;
+  CGUIQuadBatchGL::GetInstance().GetFrameStats(calls, quads);
+  BOOST_CHECK_EQUAL(calls, 1U);
+  BOOST_CHECK_EQUAL(quads, 100U);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestStateChangesFlush, BatchFixture)
+{
+  addQuads(1, 0, CGUIQuadBatchGL::MODE_TEXTURE, 1, 0);
+  addQuads(2, 0, CGUIQuadBatchGL::MODE_TEXTURE, 1, 1); // texture
+  addQuads(2, 3, CGUIQuadBatchGL::MODE_TEXTURE, 1, 2); // diffuse texture
+  addQuads(2, 3, CGUIQuadBatchGL::MODE_FONT, 1, 3);    // texture environment
+  addQuads(2, 3, CGUIQuadBatchGL::MODE_FONT, 2, 4);    // same again, joins the last one
+  CGUIQuadBatchGL::GetInstance().EndFrame();
+
+  BOOST_REQUIRE_EQUAL(drawCalls.size(), 4U);
+  BOOST_CHECK_EQUAL(drawCalls[0].texture, 1U);
+  BOOST_CHECK_EQUAL(drawCalls[1].texture, 2U);
+  BOOST_CHECK_EQUAL(drawCalls[1].diffuse, 0U);
+  BOOST_CHECK_EQUAL(drawCalls[2].diffuse, 3U);
+  BOOST_CHECK_EQUAL(drawCalls[3].vertices, 12U);
+  for (unsigned int i = 0; i < drawCalls.size(); i++)
+    BOOST_CHECK_EQUAL(drawCalls[i].firstX, (float)i);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestFlushTexture, BatchFixture)
+{
+  CGUIQuadBatchGL &batch = CGUIQuadBatchGL::GetInstance();
+  addQuads(1, 2, CGUIQuadBatchGL::MODE_TEXTURE, 1, 0);
+
+  batch.FlushTexture(3); // not used by the pending quads
+  BOOST_CHECK(drawCalls.empty());
+  batch.FlushTexture(2);
+  BOOST_CHECK_EQUAL(drawCalls.size(), 1U);
+
+  addQuads(1, 2, CGUIQuadBatchGL::MODE_TEXTURE, 1, 1);
+  batch.FlushTexture(1);
+  BOOST_CHECK_EQUAL(drawCalls.size(), 2U);
+
+  batch.FlushTexture(1); // nothing pending
+  batch.EndFrame();
+  BOOST_CHECK_EQUAL(drawCalls.size(), 2U);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestGrowsPastReserve, BatchFixture)
+{
+  // more than the initial reservation, added in pieces so earlier vertices have to survive the growth
+  for (unsigned int i = 0; i < 50; i++)
+    addQuads(1, 0, CGUIQuadBatchGL::MODE_FONT, 100, i ? 1.0f : 0.0f);
+  CGUIQuadBatchGL::GetInstance().EndFrame();
+
+  BOOST_REQUIRE_EQUAL(drawCalls.size(), 1U);
+  BOOST_CHECK_EQUAL(drawCalls[0].vertices, 20000U);
+  BOOST_CHECK_EQUAL(drawCalls[0].firstX, 0.0f);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestListFrameDrawCalls, BatchFixture)
+{
+  // a list of 20 items, each a focus/nofocus background, an icon from a shared texture and
+  // two labels from the same font, similar to a Confluence file list. Before batching each
+  // texture was its own draw and each label one at the font's End().
+  const unsigned int items = 20;
+  unsigned int unbatched = 0;
+  for (unsigned int i = 0; i < items; i++)
+  {
+    addQuads(i == 5 ? 2 : 1, 0, CGUIQuadBatchGL::MODE_TEXTURE, 1, 0); unbatched++;
+    addQuads(3, 0, CGUIQuadBatchGL::MODE_TEXTURE, 1, 0); unbatched++;
+    addQuads(4, 0, CGUIQuadBatchGL::MODE_FONT, 12, 0); unbatched++;
+    addQuads(4, 0, CGUIQuadBatchGL::MODE_FONT, 8, 0); unbatched++;
+  }
+  CGUIQuadBatchGL::GetInstance().EndFrame();
+
+  unsigned int calls, quads;
+  CGUIQuadBatchGL::GetInstance().GetFrameStats(calls, quads);
+  BOOST_CHECK_EQUAL(calls, drawCalls.size());
+  BOOST_CHECK_EQUAL(quads, items * 22);
+  // background, icon and both labels: three state changes per item
+  BOOST_CHECK_EQUAL(calls, items * 3);
+  BOOST_CHECK_LT(calls, unbatched);
+  BOOST_TEST_MESSAGE("CGUIQuadBatchGL: " << quads << " quads in " << calls << " draw calls, " << unbatched << " unbatched");
+}
+
+#endif
@@ -27,10 +27,25 @@
 using namespace std;
 using namespace INFO;
 
+bool InfoBool::IsDirty()
+{
+  unsigned int stamp = g_infoManager.GetDependencyStamp(m_dependencies);
+  if (m_valid && stamp == m_stamp && !(m_dependencies & INFO_DEPENDS_ALWAYS))
+  {
+    g_infoManager.CountBoolEvaluation(false);
+    return false;
+  }
+  m_stamp = stamp;
+  m_valid = true;
+  g_infoManager.CountBoolEvaluation(true);
+  return true;
+}
+
 InfoSingle::InfoSingle(const CStdString &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression);
+  m_dependencies = g_infoManager.GetConditionDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -143,6 +158,11 @@ void InfoExpression::Parse(const CStdString &expression)
     operators.pop();
   }
 
+  // we only need evaluating when one of our operands might have changed
+  m_dependencies = 0;
+  for (vector<unsigned int>::const_iterator it = m_operands.begin(); it != m_operands.end(); ++it)
+    m_dependencies |= g_infoManager.GetBoolDependencies(*it);
+
   // test evaluate
   bool test;
   if (!Evaluate(NULL, test))
@@ -24,6 +24,7 @@
 #include <vector>
 #include <map>
 #include "utils/StdString.h"
+#include "GUIInfoManager.h"
 
 class CGUIListItem;
 
@@ -39,8 +40,11 @@ public:
   InfoBool(const CStdString &expression, int context)
     : m_value(false),
       m_context(context),
+      m_dependencies(INFO_DEPENDS_ALWAYS),
       m_expression(expression),
-      m_lastUpdate(0)
+      m_lastUpdate(0),
+      m_stamp(0),
+      m_valid(false)
   {
   };
 
@@ -54,15 +58,24 @@ public:
   inline bool Get(unsigned int time, const CGUIListItem *item = NULL)
   {
     if (item)
+    {
       Update(item);
+      m_valid = false; // m_value is the item's now
+    }
     else if (time - m_lastUpdate > 0)
     {
-      Update(NULL);
+      if (IsDirty())
+        Update(NULL);
       m_lastUpdate = time;
     }
     return m_value;
   }
 
+  /*! \brief Get the state this info bool reads
+   \return INFO_DEPENDS_* flags, 0 if the value never changes
+   */
+  unsigned int GetDependencies() const { return m_dependencies; };
+
   bool operator==(const InfoBool &right) const
   {
     return (m_context == right.m_context && 
@@ -78,10 +91,17 @@ protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
+  unsigned int m_dependencies; ///< INFO_DEPENDS_* state the value is computed from
 
 private:
+  /*! \brief Check whether the state this info bool reads has changed since the last update
+   */
+  bool IsDirty();
+
   CStdString m_expression;     ///< original expression
   unsigned int m_lastUpdate;   ///< last update time (to determine dirty status)
+  unsigned int m_stamp;        ///< dependency stamp at the last update
+  bool m_valid;                ///< false until m_value has been computed without an item
 };
 
 /*! \brief Class to wrap active boolean conditions
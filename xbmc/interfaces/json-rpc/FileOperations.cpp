@@ -25,6 +25,7 @@
 #include "settings/Settings.h"
 #include "MediaSource.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
@@ -226,6 +227,23 @@ JSONRPC_STATUS CFileOperations::Download(const CStdString &method, ITransportLay
   return transport->Download(parameterObject["path"].asString().c_str(), result) ? OK : InvalidParams;
 }
 
+JSONRPC_STATUS CFileOperations::GetDirectoryCacheStats(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  DirectoryCacheStats stats;
+  g_directoryCache.GetStats(stats);
+
+  result["hits"] = stats.hits;
+  result["misses"] = stats.misses;
+  result["evictions"] = stats.evictions;
+  result["expirations"] = stats.expirations;
+  result["directories"] = stats.directories;
+  result["items"] = stats.items;
+  result["size"] = stats.size;
+  result["maxsize"] = stats.maxSize;
+
+  return OK;
+}
+
 bool CFileOperations::FillFileItem(const CFileItemPtr &originalItem, CFileItem &item, CStdString media /* = "" */)
 {
   if (originalItem.get() == NULL)
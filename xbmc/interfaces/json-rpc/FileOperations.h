@@ -35,6 +35,8 @@ namespace JSONRPC
     static JSONRPC_STATUS PrepareDownload(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result);
     static JSONRPC_STATUS Download(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result);
 
+    static JSONRPC_STATUS GetDirectoryCacheStats(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result);
+
     static bool FillFileItem(const CFileItemPtr &originalItem, CFileItem &item, CStdString media = "");
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
   };
@@ -131,6 +131,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Files.GetDirectory",                           CFileOperations::GetDirectory },
   { "Files.PrepareDownload",                        CFileOperations::PrepareDownload },
   { "Files.Download",                               CFileOperations::Download },
+  { "Files.GetDirectoryCacheStats",                 CFileOperations::GetDirectoryCacheStats },
 
 // Music Library
   { "AudioLibrary.GetArtists",                      CAudioLibrary::GetArtists },
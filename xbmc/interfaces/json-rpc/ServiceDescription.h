@@ -1430,6 +1430,26 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Files.GetDirectoryCacheStats\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the counters of the directory cache\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"hits\": { \"type\": \"integer\", \"required\": true },"
+          "\"misses\": { \"type\": \"integer\", \"required\": true },"
+          "\"evictions\": { \"type\": \"integer\", \"required\": true, \"description\": \"Directories dropped to stay within the memory budget\" },"
+          "\"expirations\": { \"type\": \"integer\", \"required\": true, \"description\": \"Directories dropped because their protocol's ttl passed\" },"
+          "\"directories\": { \"type\": \"integer\", \"required\": true },"
+          "\"items\": { \"type\": \"integer\", \"required\": true },"
+          "\"size\": { \"type\": \"integer\", \"required\": true, \"description\": \"Estimated memory used by the cache in bytes\" },"
+          "\"maxsize\": { \"type\": \"integer\", \"required\": true, \"description\": \"Memory budget of the cache in bytes\" }"
+        "}"
+      "}"
+    "}",
     "\"AudioLibrary.GetArtists\": {"
       "\"type\": \"method\","
       "\"description\": \"Retrieve all artists\","
@@ -308,29 +308,49 @@ void CMusicDatabase::AddSong(CSong& song, bool bCheck)
     }
     if (bInsert)
     {
-      CStdString strSQL1;
-
-      strSQL=PrepareSQL("insert into song (idSong,idAlbum,idPath,idArtist,strExtraArtists,idGenre,strExtraGenres,strTitle,iTrack,iDuration,iYear,dwFileNameCRC,strFileName,strMusicBrainzTrackID,strMusicBrainzArtistID,strMusicBrainzAlbumID,strMusicBrainzAlbumArtistID,strMusicBrainzTRMID,iTimesPlayed,iStartOffset,iEndOffset,idThumb,lastplayed,rating,comment) values (NULL,%i,%i,%i,'%s',%i,'%s','%s',%i,%i,%i,'%ul','%s','%s','%s','%s','%s','%s'",
-                    idAlbum, idPath, idArtist, strExtraArtists.c_str(), idGenre, strExtraGenres.c_str(),
-                    song.strTitle.c_str(),
-                    song.iTrack, song.iDuration, song.iYear,
-                    crc, strFileName.c_str(),
-                    song.strMusicBrainzTrackID.c_str(),
-                    song.strMusicBrainzArtistID.c_str(),
-                    song.strMusicBrainzAlbumID.c_str(),
-                    song.strMusicBrainzAlbumArtistID.c_str(),
-                    song.strMusicBrainzTRMID.c_str());
-
+      // the crc has always been stored with a trailing 'l', keep it that way for lookups
+      CStdString strCRC;
+      strCRC.Format("%ul", crc);
+
+      DatabaseRow row;
+      row.push_back(idAlbum);
+      row.push_back(idPath);
+      row.push_back(idArtist);
+      row.push_back(strExtraArtists.c_str());
+      row.push_back(idGenre);
+      row.push_back(strExtraGenres.c_str());
+      row.push_back(song.strTitle.c_str());
+      row.push_back(song.iTrack);
+      row.push_back(song.iDuration);
+      row.push_back(song.iYear);
+      row.push_back(strCRC.c_str());
+      row.push_back(strFileName.c_str());
+      row.push_back(song.strMusicBrainzTrackID.c_str());
+      row.push_back(song.strMusicBrainzArtistID.c_str());
+      row.push_back(song.strMusicBrainzAlbumID.c_str());
+      row.push_back(song.strMusicBrainzAlbumArtistID.c_str());
+      row.push_back(song.strMusicBrainzTRMID.c_str());
+      row.push_back(song.iTimesPlayed);
+      row.push_back(song.iStartOffset);
+      row.push_back(song.iEndOffset);
+      row.push_back(idThumb);
+      dbiplus::field_value lastPlayed;
       if (song.lastPlayed.IsValid())
-        strSQL1=PrepareSQL(",%i,%i,%i,%i,'%s','%c','%s')",
-                      song.iTimesPlayed, song.iStartOffset, song.iEndOffset, idThumb, song.lastPlayed.GetAsDBDateTime().c_str(), song.rating, song.strComment.c_str());
+        lastPlayed = song.lastPlayed.GetAsDBDateTime().c_str();
       else
-        strSQL1=PrepareSQL(",%i,%i,%i,%i,NULL,'%c','%s')",
-                      song.iTimesPlayed, song.iStartOffset, song.iEndOffset, idThumb, song.rating, song.strComment.c_str());
-      strSQL+=strSQL1;
-
-      m_pDS->exec(strSQL.c_str());
-      idSong = (int)m_pDS->lastinsertid();
+        lastPlayed.set_isNull();
+      row.push_back(lastPlayed);
+      row.push_back(CStdString(1, song.rating).c_str());
+      row.push_back(song.strComment.c_str());
+
+      // the scanner adds a whole folder in one transaction, so this statement is
+      // compiled once and only rebound for each song
+      strSQL = "insert into song (idSong,idAlbum,idPath,idArtist,strExtraArtists,idGenre,strExtraGenres,strTitle,iTrack,iDuration,iYear,dwFileNameCRC,strFileName,strMusicBrainzTrackID,strMusicBrainzArtistID,strMusicBrainzAlbumID,strMusicBrainzAlbumArtistID,strMusicBrainzTRMID,iTimesPlayed,iStartOffset,iEndOffset,idThumb,lastplayed,rating,comment) "
+               "values (NULL,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+      int64_t insertId;
+      if (!ExecutePrepared(strSQL, row, &insertId))
+        return;
+      idSong = (int)insertId;
     }
 
     // add extra artists and genres
@@ -757,7 +777,7 @@ CSong CMusicDatabase::GetSongFromDataset(bool bWithMusicDbPath/*=false*/)
   return song;
 }
 
-void CMusicDatabase::GetFileItemFromDataset(CFileItem* item, const CStdString& strMusicDBbasePath)
+void CMusicDatabase::GetFileItemFromDataset(CFileItem* item, const CStdString& strMusicDBbasePath, bool details /* = true */)
 {
   // get the full artist string
   CStdString strArtist=m_pDS->fv(song_strArtist).get_asString();
@@ -781,22 +801,19 @@ void CMusicDatabase::GetFileItemFromDataset(CFileItem* item, const CStdString& s
   item->SetLabel(m_pDS->fv(song_strTitle).get_asString());
   item->m_lStartOffset = m_pDS->fv(song_iStartOffset).get_asInt();
   item->m_lEndOffset = m_pDS->fv(song_iEndOffset).get_asInt();
-  item->GetMusicInfoTag()->SetMusicBrainzTrackID(m_pDS->fv(song_strMusicBrainzTrackID).get_asString());
-  item->GetMusicInfoTag()->SetMusicBrainzArtistID(m_pDS->fv(song_strMusicBrainzArtistID).get_asString());
-  item->GetMusicInfoTag()->SetMusicBrainzAlbumID(m_pDS->fv(song_strMusicBrainzAlbumID).get_asString());
-  item->GetMusicInfoTag()->SetMusicBrainzAlbumArtistID(m_pDS->fv(song_strMusicBrainzAlbumArtistID).get_asString());
-  item->GetMusicInfoTag()->SetMusicBrainzTRMID(m_pDS->fv(song_strMusicBrainzTRMID).get_asString());
   item->GetMusicInfoTag()->SetRating(m_pDS->fv(song_rating).get_asChar());
-  item->GetMusicInfoTag()->SetComment(m_pDS->fv(song_comment).get_asString());
   item->GetMusicInfoTag()->SetPlayCount(m_pDS->fv(song_iTimesPlayed).get_asInt());
   item->GetMusicInfoTag()->SetLastPlayed(m_pDS->fv(song_lastplayed).get_asString());
   CStdString strRealPath;
   URIUtils::AddFileToFolder(m_pDS->fv(song_strPath).get_asString(), m_pDS->fv(song_strFileName).get_asString(), strRealPath);
   item->GetMusicInfoTag()->SetURL(strRealPath);
   item->GetMusicInfoTag()->SetLoaded(true);
+  // the thumb is kept by light items too, as the thumb loader may fill it in
   CStdString strThumb=m_pDS->fv(song_strThumb).get_asString();
   if (strThumb != "NONE")
     item->SetThumbnailImage(strThumb);
+  if (details)
+    GetFileItemDetailsFromDataset(item);
   // Get filename with full path
   if (strMusicDBbasePath.IsEmpty())
   {
@@ -811,6 +828,17 @@ void CMusicDatabase::GetFileItemFromDataset(CFileItem* item, const CStdString& s
   }
 }
 
+// the parts of a song item that aren't needed to label, sort or filter it
+void CMusicDatabase::GetFileItemDetailsFromDataset(CFileItem* item)
+{
+  item->GetMusicInfoTag()->SetMusicBrainzTrackID(m_pDS->fv(song_strMusicBrainzTrackID).get_asString());
+  item->GetMusicInfoTag()->SetMusicBrainzArtistID(m_pDS->fv(song_strMusicBrainzArtistID).get_asString());
+  item->GetMusicInfoTag()->SetMusicBrainzAlbumID(m_pDS->fv(song_strMusicBrainzAlbumID).get_asString());
+  item->GetMusicInfoTag()->SetMusicBrainzAlbumArtistID(m_pDS->fv(song_strMusicBrainzAlbumArtistID).get_asString());
+  item->GetMusicInfoTag()->SetMusicBrainzTRMID(m_pDS->fv(song_strMusicBrainzTRMID).get_asString());
+  item->GetMusicInfoTag()->SetComment(m_pDS->fv(song_comment).get_asString());
+}
+
 CAlbum CMusicDatabase::GetAlbumFromDataset(dbiplus::Dataset* pDS, bool imageURL /* = false*/)
 {
   CAlbum album;
@@ -3025,6 +3053,46 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const CStdStrin
   return false;
 }
 
+// fills in the details of light song items as they're shown
+class CSongDetailsLoader : public CFileItemDetailsLoader
+{
+protected:
+  virtual void LoadDetails(const vector<CFileItem*> &items)
+  {
+    CMusicDatabase database;
+    if (database.Open())
+    {
+      database.GetSongsDetails(items);
+      database.Close();
+    }
+  }
+  virtual void FreeDetails(CFileItem *item)
+  {
+    if (!item->HasMusicInfoTag())
+      return;
+    MUSIC_INFO::CMusicInfoTag *tag = item->GetMusicInfoTag();
+    tag->SetMusicBrainzTrackID("");
+    tag->SetMusicBrainzArtistID("");
+    tag->SetMusicBrainzAlbumID("");
+    tag->SetMusicBrainzAlbumArtistID("");
+    tag->SetMusicBrainzTRMID("");
+    tag->SetComment("");
+  }
+  virtual void ApplyDetails(CFileItem *item, const CFileItem &details)
+  {
+    if (!item->HasMusicInfoTag() || !details.HasMusicInfoTag())
+      return;
+    MUSIC_INFO::CMusicInfoTag *tag = item->GetMusicInfoTag();
+    const MUSIC_INFO::CMusicInfoTag &from = *details.GetMusicInfoTag();
+    tag->SetMusicBrainzTrackID(from.GetMusicBrainzTrackID());
+    tag->SetMusicBrainzArtistID(from.GetMusicBrainzArtistID());
+    tag->SetMusicBrainzAlbumID(from.GetMusicBrainzAlbumID());
+    tag->SetMusicBrainzAlbumArtistID(from.GetMusicBrainzAlbumArtistID());
+    tag->SetMusicBrainzTRMID(from.GetMusicBrainzTRMID());
+    tag->SetComment(from.GetComment());
+  }
+};
+
 bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const CStdString &whereClause, CFileItemList &items)
 {
   if (NULL == m_pDB.get()) return false;
@@ -3046,6 +3114,11 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const CStdString
       return false;
     }
 
+    // huge listings only get what's needed to label, sort and filter the songs here,
+    // the rest is loaded as they're shown
+    bool lazy = items.GetLazyDetails() && g_advancedSettings.m_iMusicLibraryLazyLoadItems > 0 &&
+                iRowsFound > g_advancedSettings.m_iMusicLibraryLazyLoadItems;
+
     // get data from returned rows
     items.Reserve(items.Size() + iRowsFound);
     // get songs from returned subtable
@@ -3055,7 +3128,7 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const CStdString
       try
       {
         CFileItemPtr item(new CFileItem);
-        GetFileItemFromDataset(item.get(), baseDir);
+        GetFileItemFromDataset(item.get(), baseDir, !lazy);
         // HACK for sorting by database returned order
         item->m_iprogramCount = ++count;
         items.Add(item);
@@ -3070,7 +3143,9 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const CStdString
     }
     // cleanup
     m_pDS->close();
-    CLog::Log(LOGDEBUG, "%s(%s) - took %d ms", __FUNCTION__, whereClause.c_str(), XbmcThreads::SystemClockMillis() - time);
+    if (lazy)
+      items.SetDetailsLoader(CFileItemDetailsLoaderPtr(new CSongDetailsLoader));
+    CLog::Log(LOGDEBUG, "%s(%s) - took %d ms%s", __FUNCTION__, whereClause.c_str(), XbmcThreads::SystemClockMillis() - time, lazy ? " (lazy details)" : "");
     return true;
   }
   catch (...)
@@ -3082,6 +3157,47 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const CStdString
   return false;
 }
 
+bool CMusicDatabase::GetSongsDetails(const vector<CFileItem*> &items)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS.get()) return false;
+
+  try
+  {
+    map<int, CFileItem*> songs;
+    CStdString ids;
+    for (vector<CFileItem*>::const_iterator it = items.begin(); it != items.end(); ++it)
+    {
+      if (!(*it)->HasMusicInfoTag())
+        continue;
+      int idSong = (*it)->GetMusicInfoTag()->GetDatabaseId();
+      songs[idSong] = *it;
+      ids.AppendFormat(ids.IsEmpty() ? "%i" : ",%i", idSong);
+    }
+    if (songs.empty())
+      return true;
+
+    CStdString strSQL = "select * from songview where idSong in (" + ids + ")";
+    if (!m_pDS->query(strSQL.c_str()))
+      return false;
+    while (!m_pDS->eof())
+    {
+      map<int, CFileItem*>::iterator song = songs.find(m_pDS->fv(song_idSong).get_asInt());
+      if (song != songs.end())
+        GetFileItemDetailsFromDataset(song->second);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    m_pDS->close();
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CMusicDatabase::GetSongsByYear(const CStdString& baseDir, CFileItemList& items, int year)
 {
   CStdString where=PrepareSQL("where (iYear=%ld)", year);
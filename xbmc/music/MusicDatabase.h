@@ -163,6 +163,14 @@ public:
   bool GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist,int idAlbum);
   bool GetSongsByYear(const CStdString& baseDir, CFileItemList& items, int year);
   bool GetSongsByWhere(const CStdString &baseDir, const CStdString &whereClause, CFileItemList& items);
+
+  /*! \brief Load the details of light song items
+   Fills in what GetSongsByWhere leaves out of the items of lazily loaded listings.
+   \param items the song items to fill in
+   \return true if the query succeeded, false otherwise
+   \sa CFileItemList::SetLazyDetails
+   */
+  bool GetSongsDetails(const std::vector<CFileItem*> &items);
   bool GetAlbumsByWhere(const CStdString &baseDir, const CStdString &where, const CStdString &order, CFileItemList &items);
   bool GetRandomSong(CFileItem* item, int& idSong, const CStdString& strWhere);
   int GetKaraokeSongsCount();
@@ -238,7 +246,8 @@ private:
   CSong GetSongFromDataset(bool bWithMusicDbPath=false);
   CArtist GetArtistFromDataset(dbiplus::Dataset* pDS, bool needThumb=true);
   CAlbum GetAlbumFromDataset(dbiplus::Dataset* pDS, bool imageURL=false);
-  void GetFileItemFromDataset(CFileItem* item, const CStdString& strMusicDBbasePath);
+  void GetFileItemFromDataset(CFileItem* item, const CStdString& strMusicDBbasePath, bool details=true);
+  void GetFileItemDetailsFromDataset(CFileItem* item);
   bool CleanupSongs();
   bool CleanupSongsByIds(const CStdString &strSongIds);
   bool CleanupPaths();
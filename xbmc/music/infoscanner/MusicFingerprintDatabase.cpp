@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "MusicFingerprintDatabase.h"
+#include "dbwrappers/dataset.h"
+#include "utils/log.h"
+
+using namespace std;
+
+CMusicFingerprintDatabase::CMusicFingerprintDatabase()
+{
+}
+
+CMusicFingerprintDatabase::~CMusicFingerprintDatabase()
+{
+}
+
+bool CMusicFingerprintDatabase::Open()
+{
+  return CDatabase::Open();
+}
+
+bool CMusicFingerprintDatabase::CreateTables()
+{
+  try
+  {
+    CDatabase::CreateTables();
+
+    CLog::Log(LOGINFO, "create fingerprint table");
+    m_pDS->exec("CREATE TABLE fingerprint (idFingerprint integer primary key, strPath text, strParent text, iMTime integer, iFiles integer, strHash text)\n");
+
+    CLog::Log(LOGINFO, "create fingerprint indices");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_fingerprint_path ON fingerprint(strPath)");
+    m_pDS->exec("CREATE INDEX ix_fingerprint_parent ON fingerprint(strParent)");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s unable to create tables", __FUNCTION__);
+    return false;
+  }
+
+  return true;
+}
+
+bool CMusicFingerprintDatabase::UpdateOldVersion(int version)
+{
+  return true;
+}
+
+bool CMusicFingerprintDatabase::GetFingerprint(const CStdString &path, int64_t &mtime, int &files, CStdString &hash)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("select iMTime, iFiles, strHash from fingerprint where strPath='%s'", path.c_str());
+    m_pDS->query(sql.c_str());
+    if (!m_pDS->eof())
+    {
+      mtime = m_pDS->fv(0).get_asInt64();
+      files = m_pDS->fv(1).get_asInt();
+      hash = m_pDS->fv(2).get_asString();
+      m_pDS->close();
+      return true;
+    }
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CMusicFingerprintDatabase::SetFingerprint(const CStdString &path, const CStdString &parent, int64_t mtime, int files, const CStdString &hash)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("replace into fingerprint (idFingerprint, strPath, strParent, iMTime, iFiles, strHash) values(NULL, '%s', '%s', %I64d, %i, '%s')",
+                                path.c_str(), parent.c_str(), mtime, files, hash.c_str());
+    m_pDS->exec(sql.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CMusicFingerprintDatabase::GetSubFolders(const CStdString &path, vector<CStdString> &folders)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("select strPath from fingerprint where strParent='%s'", path.c_str());
+    m_pDS->query(sql.c_str());
+    while (!m_pDS->eof())
+    {
+      folders.push_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+void CMusicFingerprintDatabase::RemoveFolder(const CStdString &path)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return;
+    if (NULL == m_pDS.get()) return;
+
+    // paths end in a slash, so a prefix match only catches the folder and its subfolders
+    CStdString sql = PrepareSQL("delete from fingerprint where substr(strPath,1,%i)='%s'", (int)path.size(), path.c_str());
+    m_pDS->exec(sql.c_str());
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+}
+
+int CMusicFingerprintDatabase::GetFileCount(const CStdString &path)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return -1;
+    if (NULL == m_pDS.get()) return -1;
+
+    CStdString sql = PrepareSQL("select count(*), sum(iFiles) from fingerprint where substr(strPath,1,%i)='%s'", (int)path.size(), path.c_str());
+    m_pDS->query(sql.c_str());
+    int count = -1;
+    if (!m_pDS->eof() && m_pDS->fv(0).get_asInt() > 0)
+      count = m_pDS->fv(1).get_asInt();
+    m_pDS->close();
+    return count;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return -1;
+}
@@ -0,0 +1,84 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "dbwrappers/Database.h"
+
+#include <vector>
+
+/*!
+ \brief Fingerprints of the folders seen by the music scanner.
+
+ Each folder is stored with the modification time it had when it was last
+ scanned, the number of audio files in it and the hash of its listing. When
+ the modification time of a folder hasn't changed, the scanner can walk into
+ its subfolders from here instead of listing it again.
+ */
+class CMusicFingerprintDatabase : public CDatabase
+{
+public:
+  CMusicFingerprintDatabase();
+  virtual ~CMusicFingerprintDatabase();
+  virtual bool Open();
+
+  /*! \brief Get the fingerprint of a folder
+   \param path folder to look up
+   \param mtime [out] modification time of the folder when it was scanned
+   \param files [out] number of audio files in the folder
+   \param hash [out] hash of the folder listing
+   \return true if the folder has a fingerprint
+   */
+  bool GetFingerprint(const CStdString &path, int64_t &mtime, int &files, CStdString &hash);
+
+  /*! \brief Store the fingerprint of a folder, replacing any previous one
+   \param path folder that was scanned
+   \param parent parent folder the scan recursed from, empty for a scan root
+   \param mtime modification time of the folder, 0 if it isn't known
+   \param files number of audio files in the folder
+   \param hash hash of the folder listing
+   \return true if the fingerprint was stored
+   */
+  bool SetFingerprint(const CStdString &path, const CStdString &parent, int64_t mtime, int files, const CStdString &hash);
+
+  /*! \brief Get the subfolders stored for a folder
+   \param path folder to look up
+   \param folders [out] subfolders that have a fingerprint
+   \return true on success
+   */
+  bool GetSubFolders(const CStdString &path, std::vector<CStdString> &folders);
+
+  /*! \brief Remove the fingerprints of a folder and everything below it
+   \param path folder to remove
+   */
+  void RemoveFolder(const CStdString &path);
+
+  /*! \brief Get the number of audio files below a folder, including itself
+   \param path folder to count
+   \return number of audio files, or -1 if the folder has no fingerprint
+   */
+  int GetFileCount(const CStdString &path);
+
+protected:
+  virtual bool CreateTables();
+  virtual bool UpdateOldVersion(int version);
+  virtual int GetMinVersion() const { return 1; };
+  const char *GetBaseDBName() const { return "MusicFingerprints"; };
+};
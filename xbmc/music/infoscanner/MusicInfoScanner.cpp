@@ -65,6 +65,9 @@ CMusicInfoScanner::CMusicInfoScanner()
   m_bCanInterrupt = false;
   m_currentItem=0;
   m_itemCount=0;
+  m_useFingerprints = false;
+  m_foldersListed = 0;
+  m_foldersSkipped = 0;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner()
@@ -97,12 +100,23 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_foldersListed = 0;
+      m_foldersSkipped = 0;
+      m_useFingerprints = g_advancedSettings.m_bMusicLibraryScanByMTime && m_fingerprintDatabase.Open();
+      if (m_useFingerprints)
+        m_fingerprintDatabase.BeginTransaction();
 
       // Create the thread to count all files to be scanned
       SetPriority( GetMinPriority() );
       CThread fileCountReader(this);
       if (m_pObserver)
-        fileCountReader.Create();
+      { // counting lists the whole collection, so take the counts from the fingerprints if we can
+        int count = m_useFingerprints ? CountFilesFromFingerprints() : -1;
+        if (count >= 0)
+          m_itemCount = count;
+        else
+          fileCountReader.Create();
+      }
 
       // Database operations should not be canceled
       // using Interupt() while scanning as it could
@@ -152,10 +166,16 @@ void CMusicInfoScanner::Process()
       g_directoryCache.ClearMusicThumbCache();
 
       m_musicDatabase.Close();
+      if (m_useFingerprints)
+      {
+        m_fingerprintDatabase.CommitTransaction();
+        m_fingerprintDatabase.Close();
+      }
       CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Listed %d folders, skipped %d unchanged folders without listing them", m_foldersListed, m_foldersSkipped);
     }
     bool bCanceled;
     if (m_scanType == 1) // load album info
@@ -332,7 +352,7 @@ void CMusicInfoScanner::SetObserver(IMusicInfoScannerObserver* pObserver)
   m_pObserver = pObserver;
 }
 
-bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
+bool CMusicInfoScanner::DoScan(const CStdString& strDirectory, const CStdString& strParent /* = "" */)
 {
   if (m_pObserver)
     m_pObserver->OnDirectoryChanged(strDirectory);
@@ -353,16 +373,26 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  // the modification time is taken before listing so that changes made while we scan are seen next time
+  int64_t mtime = 0;
+  if (m_useFingerprints)
+  {
+    mtime = GetFolderTime(strDirectory);
+    if (mtime && ScanUnchangedFolder(strDirectory, mtime))
+      return !m_bStop;
+  }
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, g_settings.m_musicExtensions + "|.jpg|.tbn|.lrc|.cdg");
+  m_foldersListed++;
 
   // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
   // if we have a changed hash.
   items.Sort(SORT_METHOD_LABEL, SORT_ORDER_ASC);
   CStdString hash;
-  GetPathHash(items, hash);
+  int files = GetPathHash(items, hash);
 
   // get the folder's thumb (this will cache the album thumb).
   items.SetMusicThumb(true); // true forces it to get a remote thumb
@@ -405,6 +435,7 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
   }
 
   // now scan the subfolders
+  set<CStdString> subFolders;
   for (int i = 0; i < items.Size(); ++i)
   {
     CFileItemPtr pItem = items[i];
@@ -415,16 +446,87 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
     {
       CStdString strPath=pItem->GetPath();
-      if (!DoScan(strPath))
+      subFolders.insert(strPath);
+      if (!DoScan(strPath, strDirectory))
       {
         m_bStop = true;
       }
     }
   }
 
+  // the fingerprint is only stored once all the subfolders are done, so an interrupted
+  // scan lists this folder again next time
+  if (m_useFingerprints && !m_bStop)
+  {
+    vector<CStdString> storedFolders;
+    m_fingerprintDatabase.GetSubFolders(strDirectory, storedFolders);
+    for (vector<CStdString>::iterator i = storedFolders.begin(); i != storedFolders.end(); ++i)
+    {
+      if (subFolders.find(*i) == subFolders.end())
+        m_fingerprintDatabase.RemoveFolder(*i);
+    }
+    m_fingerprintDatabase.SetFingerprint(strDirectory, strParent, mtime, files, hash);
+  }
+
   return !m_bStop;
 }
 
+bool CMusicInfoScanner::ScanUnchangedFolder(const CStdString& strDirectory, int64_t mtime)
+{
+  int64_t storedTime;
+  int files;
+  CStdString hash, dbHash;
+  if (!m_fingerprintDatabase.GetFingerprint(strDirectory, storedTime, files, hash) || storedTime != mtime ||
+      !m_musicDatabase.GetPathHash(strDirectory, dbHash) || dbHash != hash)
+    return false;
+
+  vector<CStdString> subFolders;
+  if (!m_fingerprintDatabase.GetSubFolders(strDirectory, subFolders))
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change (mtime)", __FUNCTION__, strDirectory.c_str());
+  m_foldersSkipped++;
+  m_currentItem += files;
+
+  // notify our observer of our progress
+  if (m_pObserver)
+  {
+    if (m_itemCount>0)
+      m_pObserver->OnSetProgress(m_currentItem, m_itemCount);
+    m_pObserver->OnDirectoryScanned(strDirectory);
+  }
+
+  for (vector<CStdString>::iterator i = subFolders.begin(); i != subFolders.end(); ++i)
+  {
+    if (m_bStop)
+      break;
+    if (!DoScan(*i, strDirectory))
+      m_bStop = true;
+  }
+  return true;
+}
+
+int64_t CMusicInfoScanner::GetFolderTime(const CStdString& strDirectory)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(strDirectory, &buffer) == 0 && buffer.st_mtime > 0)
+    return buffer.st_mtime;
+  return 0;
+}
+
+int CMusicInfoScanner::CountFilesFromFingerprints()
+{
+  int count = 0;
+  for (set<CStdString>::const_iterator i = m_pathsToCount.begin(); i != m_pathsToCount.end(); ++i)
+  {
+    int files = m_fingerprintDatabase.GetFileCount(*i);
+    if (files < 0)
+      return -1;
+    count += files;
+  }
+  return count;
+}
+
 int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory)
 {
   CSongMap songsMap;
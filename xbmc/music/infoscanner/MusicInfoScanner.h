@@ -22,6 +22,7 @@
 #include "threads/Thread.h"
 #include "music/MusicDatabase.h"
 #include "MusicAlbumInfo.h"
+#include "MusicFingerprintDatabase.h"
 
 class CAlbum;
 class CArtist;
@@ -67,7 +68,27 @@ protected:
   void GetAlbumArtwork(long id, const CAlbum &artist);
   void GetArtistArtwork(long id, const CStdString &artistName, const CArtist *artist = NULL);
 
-  bool DoScan(const CStdString& strDirectory);
+  bool DoScan(const CStdString& strDirectory, const CStdString& strParent = "");
+
+  /*! \brief Walk an unchanged folder using its fingerprint instead of listing it
+   Only used when the musiclibrary scanbymtime advanced setting is enabled. A folder is unchanged
+   when its modification time and the hash in the music database match its fingerprint. Files
+   changed in place don't touch the folder's modification time and are missed in this mode.
+   \param strDirectory folder to scan
+   \param mtime current modification time of the folder
+   \return true if the folder was unchanged and its subfolders have been scanned
+   */
+  bool ScanUnchangedFolder(const CStdString& strDirectory, int64_t mtime);
+
+  /*! \brief Get the modification time of a folder
+   \return the modification time, or 0 if the filesystem can't tell
+   */
+  static int64_t GetFolderTime(const CStdString& strDirectory);
+
+  /*! \brief Sum the file counts stored in the fingerprints of the paths we are scanning
+   \return the number of files, or -1 if a path has no fingerprint
+   */
+  int CountFilesFromFingerprints();
 
   virtual void Run();
   int CountFiles(const CFileItemList& items, bool recursive);
@@ -82,6 +103,10 @@ protected:
   bool m_needsCleanup;
   int m_scanType; // 0 - load from files, 1 - albums, 2 - artists
   CMusicDatabase m_musicDatabase;
+  CMusicFingerprintDatabase m_fingerprintDatabase;
+  bool m_useFingerprints;
+  int m_foldersListed;
+  int m_foldersSkipped;
 
   std::set<CStdString> m_pathsToScan;
   std::set<CAlbum> m_albumsToScan;
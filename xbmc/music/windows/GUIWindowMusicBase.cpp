@@ -631,6 +631,9 @@ void CGUIWindowMusicBase::OnQueueItem(int iItem)
   if (!item->CanQueue())
     item->SetCanQueue(true);
 
+  if (!item->m_bIsFolder)
+    LoadDetails(vector<CFileItem*>(1, item.get()));
+
   CLog::Log(LOGDEBUG, "Adding file %s%s to music playlist", item->GetPath().c_str(), item->m_bIsFolder ? " (folder) " : "");
   CFileItemList queuedItems;
   AddItemToPlayList(item, queuedItems);
@@ -22,6 +22,7 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/Texture.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "utils/ssrc.h"         // for M_PI
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -717,6 +718,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
 
 #elif defined(HAS_GL)
   g_graphicsContext.BeginPaint();
+  CGUIQuadBatchGL::GetInstance().Flush();
   if (pTexture)
   {
     pTexture->LoadToGPU();
@@ -24,6 +24,7 @@
 #ifdef HAS_GL
 
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -254,6 +255,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   return true;
 }
 
@@ -262,6 +265,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -290,6 +295,9 @@ bool CRenderSystemGL::PresentRender(const CDirtyRegionList& dirty)
   if (!m_bRenderCreated)
     return false;
 
+  // draw anything left of the gui, and start counting the next frame
+  CGUIQuadBatchGL::GetInstance().EndFrame();
+
   if (m_iVSyncMode != 0 && m_iSwapRate != 0)
   {
     int64_t curr, diff, freq;
@@ -385,6 +393,8 @@ void CRenderSystemGL::CaptureStateBlock()
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUIQuadBatchGL::GetInstance().Flush();
   
   glGetIntegerv(GL_VIEWPORT, m_viewPort);
 
@@ -407,6 +417,8 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   glViewport(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
   glMatrixMode(GL_PROJECTION);
   glPopMatrix();
@@ -427,6 +439,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   g_graphicsContext.BeginPaint();
 
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
@@ -490,6 +504,8 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   glMatrixMode(GL_MODELVIEW);
   glPushMatrix();
   GLfloat matrix[4][4];
@@ -511,6 +527,8 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
 }
@@ -580,6 +598,8 @@ void CRenderSystemGL::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
 }
@@ -588,6 +608,9 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUIQuadBatchGL::GetInstance().Flush();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
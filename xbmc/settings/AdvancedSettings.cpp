@@ -95,6 +95,11 @@ void CAdvancedSettings::Initialize()
   m_videoAllowMpeg4VDPAU = false;
   m_videoAllowMpeg4VAAPI = false;  
   m_videoDisableBackgroundDeinterlace = false;
+  m_videoZeroCopyDemux = true;
+  m_videoFrameThreading = false;
+  m_videoRenderBuffers = 4;
+  m_videoDirectRendering = false;
+  m_dvdplayerStreamInfoCache = true;
   m_videoCaptureUseOcclusionQuery = -1; //-1 is auto detect
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
@@ -113,6 +118,8 @@ void CAdvancedSettings::Initialize()
   m_musicPercentSeekForwardBig = 10;
   m_musicPercentSeekBackwardBig = -10;
   m_musicResample = 0;
+  m_musicResampler = "ssrc";
+  m_musicPrefetchDepth = 2;
 
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
@@ -171,6 +178,8 @@ void CAdvancedSettings::Initialize()
   m_tvshowMultiPartEnumRegExp = "^[-_EeXx]+([0-9]+)";
 
   m_remoteDelay = 3;
+  m_dirCacheSize = 16384;
+  m_dirCacheTTL.clear();
   m_controllerDeadzone = 0.2f;
 
   m_playlistAsFolders = true;
@@ -195,7 +204,9 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryHideAllItems = false;
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryAlbumsSortByArtistThenYear = false;
+  m_bMusicLibraryScanByMTime = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
+  m_iMusicLibraryLazyLoadItems = 2000;
   m_strMusicLibraryAlbumFormat = "";
   m_strMusicLibraryAlbumFormatRight = "";
   m_prioritiseAPEv2tags = false;
@@ -205,12 +216,14 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryHideAllItems = false;
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
+  m_iVideoLibraryLazyLoadItems = 2000;
   m_bVideoLibraryHideRecentlyAddedItems = false;
   m_bVideoLibraryHideEmptySeries = false;
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryExportAutoThumbs = false;
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerThreads = 4;
 
   m_iTuxBoxStreamtsPort = 31339;
   m_bTuxBoxAudioChannelSelection = false;
@@ -277,6 +290,9 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cachePersistent = false;
+  m_cachePersistentSize = 1024;
+  m_cacheSegmented = false;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
@@ -287,6 +303,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 0;
   m_guiDirtyRegionNoFlipTimeout = -1;
+  m_guiTextureCacheSize = 32768;
+  m_guiSkinCache = true;
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
@@ -358,6 +376,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
     XMLUtils::GetInt(pElement, "resample", m_musicResample, 0, 192000);
+    XMLUtils::GetString(pElement, "resampler", m_musicResampler);
+    XMLUtils::GetInt(pElement, "prefetchdepth", m_musicPrefetchDepth, 1, 8); // PAPLAYER_MAX_PREFETCH
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -454,6 +474,11 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vaapi",m_videoAllowMpeg4VAAPI);    
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
+    XMLUtils::GetBoolean(pElement, "zerocopydemux", m_videoZeroCopyDemux);
+    XMLUtils::GetBoolean(pElement, "framethreading", m_videoFrameThreading);
+    XMLUtils::GetInt(pElement, "renderbuffers", m_videoRenderBuffers, 2, 10);
+    XMLUtils::GetBoolean(pElement, "directrendering", m_videoDirectRendering);
+    XMLUtils::GetBoolean(pElement, "dvdplayerstreaminfocache", m_dvdplayerStreamInfoCache);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
 
     TiXmlElement* pAdjustRefreshrate = pElement->FirstChildElement("adjustrefreshrate");
@@ -587,9 +612,11 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   {
     XMLUtils::GetBoolean(pElement, "hideallitems", m_bMusicLibraryHideAllItems);
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iMusicLibraryRecentlyAddedItems, 1, INT_MAX);
+    XMLUtils::GetInt(pElement, "lazyloaditems", m_iMusicLibraryLazyLoadItems, 0, INT_MAX);
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "albumssortbyartistthenyear", m_bMusicLibraryAlbumsSortByArtistThenYear);
+    XMLUtils::GetBoolean(pElement, "scanbymtime", m_bMusicLibraryScanByMTime);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
@@ -601,6 +628,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "hideallitems", m_bVideoLibraryHideAllItems);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bVideoLibraryAllItemsOnBottom);
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iVideoLibraryRecentlyAddedItems, 1, INT_MAX);
+    XMLUtils::GetInt(pElement, "lazyloaditems", m_iVideoLibraryLazyLoadItems, 0, INT_MAX);
     XMLUtils::GetBoolean(pElement, "hiderecentlyaddeditems", m_bVideoLibraryHideRecentlyAddedItems);
     XMLUtils::GetBoolean(pElement, "hideemptyseries", m_bVideoLibraryHideEmptySeries);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bVideoLibraryCleanOnUpdate);
@@ -613,6 +641,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "threads", m_iVideoScannerThreads, 1, 16);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -646,6 +675,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetBoolean(pElement, "cachepersistent", m_cachePersistent);
+    XMLUtils::GetInt(pElement, "cachepersistentsize", m_cachePersistentSize, 0, 1048576);
+    XMLUtils::GetBoolean(pElement, "cachesegmented", m_cacheSegmented);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -860,6 +892,20 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     }
   }
 
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "memorysize", m_dirCacheSize, 1024, 1048576);
+    const TiXmlElement *pTTL = pElement->FirstChildElement("ttl");
+    while (pTTL)
+    { // <ttl protocol="upnp">60</ttl>, local paths use the "file" protocol
+      const char *protocol = pTTL->Attribute("protocol");
+      if (protocol && pTTL->FirstChild())
+        m_dirCacheTTL[CStdString(protocol).ToLower()] = atoi(pTTL->FirstChild()->Value());
+      pTTL = pTTL->NextSiblingElement("ttl");
+    }
+  }
+
   XMLUtils::GetInt(pRootElement, "remotedelay", m_remoteDelay, 1, 20);
   XMLUtils::GetFloat(pRootElement, "controllerdeadzone", m_controllerDeadzone, 0.0f, 1.0f);
   XMLUtils::GetInt(pRootElement, "thumbsize", m_thumbSize, 0, 1024);
@@ -959,6 +1005,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetInt(pElement, "texturecachesize",          m_guiTextureCacheSize, 0, 1048576);
+    XMLUtils::GetBoolean(pElement, "skincache",             m_guiSkinCache);
   }
 
   // load in the GUISettings overrides:
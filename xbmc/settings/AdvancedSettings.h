@@ -21,6 +21,7 @@
  */
 
 #include <vector>
+#include <map>
 #include "utils/StdString.h"
 #include "utils/GlobalsHandling.h"
 
@@ -123,6 +124,8 @@ class CAdvancedSettings
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
     int m_musicResample;
+    CStdString m_musicResampler;
+    int m_musicPrefetchDepth;
     int m_videoBlackBarColour;
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
@@ -139,6 +142,11 @@ class CAdvancedSettings
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
     float m_videoDefaultLatency;
     bool m_videoDisableBackgroundDeinterlace;
+    bool m_videoZeroCopyDemux;
+    bool m_videoFrameThreading;
+    int  m_videoRenderBuffers;
+    bool m_videoDirectRendering;
+    bool m_dvdplayerStreamInfoCache;
     int  m_videoCaptureUseOcclusionQuery;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
@@ -191,6 +199,8 @@ class CAdvancedSettings
     CStdString m_tvshowMultiPartEnumRegExp;
     typedef std::vector< std::pair<CStdString, CStdString> > StringMapping;
     StringMapping m_pathSubstitutions;
+    int m_dirCacheSize; ///< \brief memory budget of the directory cache in KB
+    std::map<CStdString, int> m_dirCacheTTL; ///< \brief seconds a cached listing stays valid, by protocol
     int m_remoteDelay; ///< \brief number of remote messages to ignore before repeating
     float m_controllerDeadzone;
 
@@ -215,8 +225,10 @@ class CAdvancedSettings
 
     bool m_bMusicLibraryHideAllItems;
     int m_iMusicLibraryRecentlyAddedItems;
+    int m_iMusicLibraryLazyLoadItems; ///< songs listings with more rows are made of light items, 0 to disable
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryAlbumsSortByArtistThenYear;
+    bool m_bMusicLibraryScanByMTime;
     CStdString m_strMusicLibraryAlbumFormat;
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
@@ -227,6 +239,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryHideAllItems;
     bool m_bVideoLibraryAllItemsOnBottom;
     int m_iVideoLibraryRecentlyAddedItems;
+    int m_iVideoLibraryLazyLoadItems; ///< episode listings with more rows are made of light items, 0 to disable
     bool m_bVideoLibraryHideRecentlyAddedItems;
     bool m_bVideoLibraryHideEmptySeries;
     bool m_bVideoLibraryCleanOnUpdate;
@@ -234,6 +247,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryImportWatchedState;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerThreads;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
     //TuxBox
@@ -308,8 +322,13 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    int  m_guiTextureCacheSize; ///< \brief KB of unreferenced skin textures kept loaded for reuse
+    bool m_guiSkinCache;        ///< \brief keep include resolved window XML in special://temp/skincache
 
     unsigned int m_cacheMemBufferSize;
+    bool m_cachePersistent;
+    int  m_cachePersistentSize; ///< \brief MB of kept cache files in special://temp, oldest are deleted first
+    bool m_cacheSegmented;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
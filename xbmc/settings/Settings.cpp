@@ -1394,6 +1394,7 @@ void CSettings::LoadSkinSettings(const TiXmlElement* pRootElement)
       }
       pChild = pChild->NextSiblingElement("setting");
     }
+    g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
   }
 }
 
@@ -1437,6 +1438,7 @@ void CSettings::Clear()
   m_mapRssUrls.clear();
   m_skinBools.clear();
   m_skinStrings.clear();
+  g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
 }
 
 int CSettings::TranslateSkinString(const CStdString &setting)
@@ -1472,6 +1474,7 @@ void CSettings::SetSkinString(int setting, const CStdString &label)
   if (it != m_skinStrings.end())
   {
     (*it).second.value = label;
+    g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
     return;
   }
   assert(false);
@@ -1488,6 +1491,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = "";
+      g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
       return;
     }
   }
@@ -1497,6 +1501,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
       return;
     }
   }
@@ -1537,6 +1542,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
     return;
   }
   assert(false);
@@ -1565,6 +1571,7 @@ void CSettings::ResetSkinSettings()
 
     it2++;
   }
+  g_infoManager.Invalidate(INFO_DEPENDS_SKIN);
   g_infoManager.ResetCache();
 }
 
@@ -230,6 +230,24 @@ CCPUInfo::CCPUInfo(void)
           }
         }
       }
+      else if (strncmp(buffer, "Features", 8) == 0)
+      {
+        // arm lists its extensions here
+        char* needle = strchr(buffer, ':');
+        if (needle)
+        {
+          char* tok = NULL,
+              * save;
+          needle++;
+          tok = strtok_r(needle, " \t\n", &save);
+          while (tok)
+          {
+            if (0 == strcmp(tok, "neon"))
+              m_cpuFeatures |= CPU_FEATURE_NEON;
+            tok = strtok_r(NULL, " \t\n", &save);
+          }
+        }
+      }
     }
   }
   else
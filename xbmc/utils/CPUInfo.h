@@ -40,6 +40,7 @@
 #define CPU_FEATURE_3DNOW    1 << 8
 #define CPU_FEATURE_3DNOWEXT 1 << 9
 #define CPU_FEATURE_ALTIVEC  1 << 10
+#define CPU_FEATURE_NEON     1 << 11
 
 struct CoreInfo
 {
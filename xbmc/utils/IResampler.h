@@ -0,0 +1,71 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*!
+ \brief Interface of the sample rate converters used by PAPlayer.
+
+ Interleaved float data is pushed in with PutFloatData(), and converted data
+ comes out in blocks of OutputBufferSize bytes through GetData().
+ */
+class IResampler
+{
+public:
+  virtual ~IResampler() {}
+
+  /*!
+   \brief Initialize the converter
+   \param OldFreq input sample rate
+   \param OldBPS input bits per sample
+   \param Channels number of interleaved channels
+   \param NewFreq output sample rate
+   \param NewBPS output bits per sample
+   \param OutputBufferSize size in bytes of the blocks returned by GetData()
+   \return false if the conversion is not supported
+   */
+  virtual bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize) = 0;
+
+  /*!
+   \brief Free any buffers allocated by InitConverter()
+   */
+  virtual void DeInitialize() = 0;
+
+  /*!
+   \brief Get a block of converted data
+   \param pOutData buffer of at least OutputBufferSize bytes
+   \return true if a block was returned, false if not enough data is ready
+   */
+  virtual bool GetData(unsigned char *pOutData) = 0;
+
+  /*!
+   \brief Put interleaved float samples into the converter
+   \param pInData the samples
+   \param numSamples number of samples (frames * channels) available in pInData
+   \return the number of samples consumed, 0 if GetData() should be called first, -1 if not enough data was given
+   */
+  virtual int PutFloatData(float *pInData, int numSamples) = 0;
+
+  /*!
+   \brief The number of samples the next PutFloatData() call will consume
+   \return number of samples, 0 if GetData() should be called first
+   */
+  virtual int GetInputSamples() = 0;
+};
@@ -22,10 +22,17 @@
 #include "JobManager.h"
 #include <algorithm>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/ThreadLocal.h"
+#include "threads/Atomics.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 
 using namespace std;
 
+// the worker running on the current thread, if any
+static XbmcThreads::ThreadLocal<CJobWorker> currentWorker;
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -33,9 +40,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("Jobworker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int slot) : CThread("Jobworker")
 {
   m_jobManager = manager;
+  m_slot = slot;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -52,6 +60,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  currentWorker.set(this);
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -70,6 +79,7 @@ void CJobWorker::Process()
     }
     m_jobManager->OnJobComplete(success, job);
   }
+  currentWorker.set(NULL);
 }
 
 void CJobQueue::CJobPointer::CancelJob()
@@ -120,13 +130,23 @@ void CJobQueue::AddJob(CJob *job)
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
-  if (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
+  vector<CJob*> jobs;
+  while (m_jobQueue.size() && m_processing.size() + jobs.size() < m_jobsAtOnce)
   {
-    CJobPointer &job = m_jobQueue.back();
-    job.m_id = CJobManager::GetInstance().AddJob(job.m_job, this, m_priority);
-    m_processing.push_back(job);
+    jobs.push_back(m_jobQueue.back().m_job);
     m_jobQueue.pop_back();
   }
+  if (jobs.empty())
+    return;
+
+  vector<unsigned int> ids;
+  CJobManager::GetInstance().AddJobs(jobs, this, m_priority, ids);
+  for (unsigned int i = 0; i < jobs.size(); i++)
+  {
+    CJobPointer job(jobs[i]);
+    job.m_id = ids[i];
+    m_processing.push_back(job);
+  }
 }
 
 void CJobQueue::CancelJobs()
@@ -147,7 +167,21 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_queued = 0;
+  m_processing = 0;
+  m_nextQueue = 0;
+  m_numPaused = 0;
+  m_jobsCompleted = 0;
+  m_jobsStolen = 0;
+  m_queueWait = 0;
+  m_numWorkers = 0;
   m_running = true;
+
+  // jobs are often bound by I/O (thumb extraction, texture caching, network access)
+  // so allow one more worker than we have cores, but never fewer than 5.
+  m_maxWorkers = max(5, g_cpuInfo.getCPUCount() + 1);
+  for (unsigned int i = 0; i < m_maxWorkers; i++)
+    m_queues.push_back(new CWorkQueue);
 }
 
 void CJobManager::CancelJobs()
@@ -155,140 +189,264 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  for (WorkQueues::iterator it = m_queues.begin(); it != m_queues.end(); ++it)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
-  }
+    CWorkQueue &queue = **it;
+    CSingleLock queueLock(queue.m_section);
+
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      for_each(queue.m_jobs[priority].begin(), queue.m_jobs[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
+      AtomicSubtract(&m_queued, queue.m_jobs[priority].size());
+      queue.m_jobs[priority].clear();
+    }
+    queue.m_count = 0;
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+    // cancel any callbacks on jobs still processing
+    queue.m_current.Cancel();
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  while (m_numWorkers)
   {
     lock.Leave();
     m_jobEvent.Set();
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
+
+  CLog::Log(LOGDEBUG, "%s - %ld jobs completed (%ld stolen) on %u workers, average queue wait %ld ms", __FUNCTION__,
+            m_jobsCompleted, m_jobsStolen, m_maxWorkers, m_jobsCompleted ? m_queueWait / m_jobsCompleted : 0);
 }
 
 CJobManager::~CJobManager()
 {
+  for (WorkQueues::iterator it = m_queues.begin(); it != m_queues.end(); ++it)
+    delete *it;
 }
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter++, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, (unsigned int)AtomicIncrement(&m_jobCounter), callback);
+  work.m_queued = XbmcThreads::SystemClockMillis();
+
+  CWorkQueue &queue = GetQueueForAdd();
+  {
+    CSingleLock lock(queue.m_section);
+    queue.m_jobs[priority].push_back(work);
+    queue.m_count++;
+    AtomicIncrement(&m_queued);
+  }
 
   StartWorkers(priority);
   return work.m_id;
 }
 
-void CJobManager::CancelJob(unsigned int jobID)
+void CJobManager::AddJobs(const vector<CJob*> &jobs, IJobCallback *callback, CJob::PRIORITY priority, vector<unsigned int> &ids)
 {
-  CSingleLock lock(m_section);
+  ids.clear();
+  if (jobs.empty())
+    return;
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  CWorkQueue &queue = GetQueueForAdd();
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CSingleLock lock(queue.m_section);
+    for (vector<CJob*>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      CWorkItem work(*it, (unsigned int)AtomicIncrement(&m_jobCounter), callback);
+      work.m_queued = now;
+      queue.m_jobs[priority].push_back(work);
+      ids.push_back(work.m_id);
+    }
+    queue.m_count += jobs.size();
+    AtomicAdd(&m_queued, jobs.size());
+  }
+
+  StartWorkers(priority);
+}
+
+CJobManager::CWorkQueue &CJobManager::GetQueueForAdd()
+{
+  // jobs queued from within a job stay with the worker that queued them
+  CJobWorker *worker = currentWorker.get();
+  if (worker && worker->GetSlot() < m_queues.size())
+    return *m_queues[worker->GetSlot()];
+
+  unsigned long next = (unsigned long)AtomicIncrement(&m_nextQueue);
+  return *m_queues[next % m_queues.size()];
+}
+
+void CJobManager::CancelJob(unsigned int jobID)
+{
+  for (WorkQueues::iterator it = m_queues.begin(); it != m_queues.end(); ++it)
+  {
+    CWorkQueue &queue = **it;
+    CSingleLock lock(queue.m_section);
+
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue::iterator i = find(queue.m_jobs[priority].begin(), queue.m_jobs[priority].end(), jobID);
+      if (i != queue.m_jobs[priority].end())
+      {
+        delete i->m_job;
+        queue.m_jobs[priority].erase(i);
+        queue.m_count--;
+        AtomicDecrement(&m_queued);
+        return;
+      }
+    }
+    // or if we're processing it
+    if (queue.m_current.m_job && queue.m_current == jobID)
+    {
+      queue.m_current.Cancel(); // job is in progress, so only thing to do is to remove callback
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  // wake any sleeping workers. The event stays signalled if nobody is waiting, so
+  // a worker that is just about to go to sleep will pick the new jobs up as well.
+  m_jobEvent.Set();
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
-    return;
+  CSingleLock lock(m_section);
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  // start enough workers to process the queued jobs, within the limit for this priority
+  long pending = m_processing + m_queued;
+  unsigned int wanted = min(GetMaxWorkers(priority), (unsigned int)max(pending, 0L));
+  for (unsigned int i = 0; i < m_queues.size() && m_numWorkers < wanted; i++)
   {
-    m_jobEvent.Set();
-    return;
+    if (!m_queues[i]->m_worker)
+    {
+      m_queues[i]->m_worker = new CJobWorker(this, i);
+      m_numWorkers++;
+    }
   }
+}
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
+{
+  long maxWorkers = GetMaxWorkers(priority);
+  while (true)
+  {
+    long processing = m_processing;
+    if (processing >= maxWorkers)
+      return false;
+    if (cas(&m_processing, processing, processing + 1) == processing)
+      return true;
+  }
 }
 
-CJob *CJobManager::PopJob()
+CJob *CJobManager::PopJob(unsigned int slot)
 {
-  CSingleLock lock(m_section);
+  if (m_queued <= 0)
+    return NULL;
+
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
   {
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (!ReserveWorker(CJob::PRIORITY(priority)))
+      continue;
+
+    // try our own queue first, then steal from the other workers
+    for (unsigned int i = 0; i < m_queues.size(); i++)
     {
-      CWorkItem job = m_jobQueue[priority].front();
+      unsigned int from = (slot + i) % m_queues.size();
+      if (m_queues[from]->m_count <= 0)
+        continue;
 
-      // skip adding any paused types
-      if (priority <= CJob::PRIORITY_LOW)
+      CJob *job = TakeJob(from, slot, CJob::PRIORITY(priority));
+      if (job)
       {
-        std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), job.m_job->GetType());
-        if (i != m_pausedTypes.end())
-          return NULL;
+        if (from != slot)
+          AtomicIncrement(&m_jobsStolen);
+        return job;
       }
-
-      m_jobQueue[priority].pop_front();
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
     }
+    AtomicDecrement(&m_processing);
+  }
+  return NULL;
+}
+
+CJob *CJobManager::TakeJob(unsigned int from, unsigned int slot, CJob::PRIORITY priority)
+{
+  CWorkQueue &source = *m_queues[from];
+  CWorkQueue &target = *m_queues[slot];
+
+  // always lock the work queues in slot order, so two workers stealing from each other can't deadlock
+  CSingleLock lock1(m_queues[min(from, slot)]->m_section);
+  CSingleLock lock2(m_queues[max(from, slot)]->m_section);
+
+  JobQueue &jobs = source.m_jobs[priority];
+  for (JobQueue::iterator i = jobs.begin(); i != jobs.end(); ++i)
+  {
+    // skip any paused types
+    if (priority <= CJob::PRIORITY_LOW && IsPausedType(i->m_job->GetType()))
+      continue;
+
+    CWorkItem job = *i;
+    jobs.erase(i);
+    source.m_count--;
+    AtomicDecrement(&m_queued);
+    AtomicAdd(&m_queueWait, XbmcThreads::SystemClockMillis() - job.m_queued);
+
+    // move to the processing slot of the worker
+    job.m_job->m_callback = this;
+    target.m_current = job;
+    return job.m_job;
   }
   return NULL;
 }
 
 void CJobManager::Pause(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   // just push it in so we get ref counting,
   // the queue will resume when all Pause requests
   // for a given type have been UnPaused.
   m_pausedTypes.push_back(pausedType);
+  m_numPaused = m_pausedTypes.size();
 }
 
 void CJobManager::UnPause(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), pausedType);
   if (i != m_pausedTypes.end())
     m_pausedTypes.erase(i);
+  m_numPaused = m_pausedTypes.size();
+  lock.Leave();
+
+  // wake the workers so they pick up any jobs that are no longer paused
+  m_jobEvent.Set();
 }
 
 bool CJobManager::IsPaused(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), pausedType);
   return (i != m_pausedTypes.end());
 }
 
+bool CJobManager::IsPausedType(const char *type)
+{
+  if (m_numPaused <= 0)
+    return false;
+  return IsPaused(type);
+}
+
 int CJobManager::IsProcessing(const std::string &pausedType)
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
-  for(Processing::iterator it = m_processing.begin(); it < m_processing.end(); it++)
+  for (WorkQueues::iterator it = m_queues.begin(); it != m_queues.end(); ++it)
   {
-    if (pausedType == std::string(it->m_job->GetType()))
+    CSingleLock lock((*it)->m_section);
+    CJob *job = (*it)->m_current.m_job;
+    if (job && pausedType == std::string(job->GetType()))
       jobsMatched++;
   }
   return jobsMatched;
@@ -296,23 +454,20 @@ int CJobManager::IsProcessing(const std::string &pausedType)
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker->GetSlot());
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CSingleLock lock(m_section);
+  CJob *job = PopJob(worker->GetSlot());
   if (job)
     return job;
   // have no jobs
@@ -320,16 +475,36 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   return NULL;
 }
 
+unsigned int CJobManager::FindProcessing(const CJob *job) const
+{
+  // jobs normally report back from the worker processing them
+  CJobWorker *worker = currentWorker.get();
+  if (worker && worker->GetSlot() < m_queues.size())
+  {
+    CSingleLock lock(m_queues[worker->GetSlot()]->m_section);
+    if (m_queues[worker->GetSlot()]->m_current == job)
+      return worker->GetSlot();
+  }
+
+  for (unsigned int i = 0; i < m_queues.size(); i++)
+  {
+    CSingleLock lock(m_queues[i]->m_section);
+    if (m_queues[i]->m_current == job)
+      return i;
+  }
+  return m_queues.size();
+}
+
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // find the job in the processing slots, and check whether it's cancelled (no callback)
+  unsigned int slot = FindProcessing(job);
+  if (slot < m_queues.size())
   {
-    CWorkItem item(*i);
+    CSingleLock lock(m_queues[slot]->m_section);
+    CWorkItem item(m_queues[slot]->m_current);
     lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    if (item.m_job == job && item.m_callback)
     {
       item.m_callback->OnJobProgress(item.m_id, progress, total, job);
       return false;
@@ -340,13 +515,14 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // remove the job from the processing slot
+  unsigned int slot = FindProcessing(job);
+  if (slot < m_queues.size())
   {
+    CWorkQueue &queue = *m_queues[slot];
+    CSingleLock lock(queue.m_section);
     // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
+    CWorkItem item(queue.m_current);
     lock.Leave();
     try
     {
@@ -358,10 +534,10 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    queue.m_current = CWorkItem(NULL, 0, NULL);
     lock.Leave();
+    AtomicDecrement(&m_processing);
+    AtomicIncrement(&m_jobsCompleted);
     item.FreeJob();
   }
 }
@@ -369,14 +545,16 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
   CSingleLock lock(m_section);
-  // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  // remove our worker, unless its slot has already been handed to a new worker
+  unsigned int slot = worker->GetSlot();
+  if (slot < m_queues.size() && m_queues[slot]->m_worker == worker)
+  {
+    m_queues[slot]->m_worker = NULL; // workers auto-delete
+    m_numWorkers--;
+  }
 }
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return m_maxWorkers - (CJob::PRIORITY_HIGH - priority);
 }
@@ -32,12 +32,19 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int slot);
   virtual ~CJobWorker();
 
   void Process();
+
+  /*!
+   \brief Retrieve the index of the work queue owned by this worker.
+   \return the index of the work queue in the job manager.
+   */
+  unsigned int GetSlot() const { return m_slot; };
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_slot;
 };
 
 /*!
@@ -127,6 +134,9 @@ public:
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
 private:
+  /*! \brief Queue as many jobs as we are allowed to process at once.
+   Jobs are handed to the CJobManager in a single batch.
+   */
   void QueueNextJob();
 
   typedef std::deque<CJobPointer> Queue;
@@ -149,6 +159,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker owns a work queue (one deque per priority) guarded by its own lock.
+ Jobs added from outside the pool are spread over the work queues, jobs added from
+ within a job go to the queue of the worker running it.  Idle workers steal from
+ the queues of other workers, so the workers never contend on a single lock.
+ The size of the pool is based on the number of CPU cores.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -161,6 +177,7 @@ class CJobManager
       m_job = job;
       m_id = id;
       m_callback = callback;
+      m_queued = 0;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -182,6 +199,28 @@ class CJobManager
     CJob         *m_job;
     unsigned int  m_id;
     IJobCallback *m_callback;
+    unsigned int  m_queued;   ///< time (in ms) at which the job was queued
+  };
+
+  typedef std::deque<CWorkItem>    JobQueue;
+
+  /*!
+   \brief Work queue owned by a single worker slot.
+   The owning worker takes jobs from it, other workers may steal from it when they run dry.
+   */
+  class CWorkQueue
+  {
+  public:
+    CWorkQueue() : m_current(NULL, 0, NULL)
+    {
+      m_worker = NULL;
+      m_count = 0;
+    };
+    JobQueue         m_jobs[CJob::PRIORITY_HIGH+1];
+    long             m_count;   ///< number of jobs in m_jobs, may be read without the lock as a hint
+    CWorkItem        m_current; ///< job currently processed by the worker in this slot (m_job is NULL if idle)
+    CJobWorker      *m_worker;  ///< worker bound to this slot, protected by CJobManager::m_section
+    CCriticalSection m_section;
   };
 
 public:
@@ -201,6 +240,18 @@ public:
    */
   unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
 
+  /*!
+   \brief Add a batch of jobs to the threaded job manager.
+   All jobs are queued on the same work queue under a single lock, and idle workers are
+   woken once for the whole batch.
+   \param jobs the jobs to add. The jobs should be subclassed from CJob
+   \param callback a pointer to an IJobCallback instance to receive job progress and completion notices.
+   \param priority the priority that these jobs should run at.
+   \param ids [out] the unique identifiers of the jobs, in the same order as jobs.
+   \sa AddJob()
+   */
+  void AddJobs(const std::vector<CJob*> &jobs, IJobCallback *callback, CJob::PRIORITY priority, std::vector<unsigned int> &ids);
+
   /*!
    \brief Cancel a job with the given id.
    \param jobID the id of the job to cancel, retrieved previously from AddJob()
@@ -286,27 +337,57 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the work queue of the given slot, stealing from other slots if it is empty,
+   and mark it as processing in that slot.
+   \param slot the work queue owned by the calling worker
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(unsigned int slot);
+
+  /*! \brief Move the first runnable job of the given priority from a work queue to the processing slot of a worker
+   \param from the slot of the work queue to take the job from
+   \param slot the slot of the worker that will process the job
+   \param priority the priority of the job to take
+   \return the job to process, NULL if no runnable job was found
+   */
+  CJob *TakeJob(unsigned int from, unsigned int slot, CJob::PRIORITY priority);
 
+  /*! \brief Find the work queue to add new jobs to.
+   Jobs added from a worker thread stay on that worker's queue, other jobs are spread round robin.
+   */
+  CWorkQueue &GetQueueForAdd();
+
+  /*! \brief Find the slot processing the given job
+   \return the index of the slot, or m_queues.size() if the job isn't processing
+   */
+  unsigned int FindProcessing(const CJob *job) const;
+
+  bool ReserveWorker(CJob::PRIORITY priority);
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
+  bool IsPausedType(const char *type);
   unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
-  unsigned int m_jobCounter;
+  long m_jobCounter;
+  long m_queued;      ///< number of jobs waiting in the work queues
+  long m_processing;  ///< number of jobs being processed
+  long m_nextQueue;   ///< round robin index of the next work queue for jobs added from outside the pool
+  long m_numPaused;   ///< number of entries in m_pausedTypes
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  // statistics
+  long m_jobsCompleted;
+  long m_jobsStolen;
+  long m_queueWait;   ///< total time (in ms) completed jobs spent waiting in the queues
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  Processing m_processing;
-  Workers    m_workers;
+  typedef std::vector<CWorkQueue*> WorkQueues;
 
-  CCriticalSection m_section;
+  WorkQueues       m_queues;
+  unsigned int     m_maxWorkers;
+  unsigned int     m_numWorkers;
+
+  CCriticalSection m_section;  ///< protects worker creation and removal
   CEvent           m_jobEvent;
-  bool             m_running;
+  volatile bool    m_running;
+  CCriticalSection m_pausedSection;
   std::vector<std::string>  m_pausedTypes;
 };
@@ -0,0 +1,355 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "system.h"
+#include "PolyphaseResampler.h"
+#include "utils/CPUInfo.h"
+#include "utils/MathUtils.h"
+#include "utils/log.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define RESAMPLER_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// coefficients per phase, must be a multiple of 8 for the simd kernels
+#define RESAMPLER_TAPS       64
+// input frames consumed by each PutFloatData()
+#define RESAMPLER_CHUNK      512
+// largest number of phases we accept, limits the coefficient table to 2MB
+#define RESAMPLER_MAX_PHASES 8192
+// kaiser window shape, ~80dB stopband attenuation
+#define RESAMPLER_BETA       8.0
+// half the width of the transition band of RESAMPLER_TAPS taps with RESAMPLER_BETA,
+// relative to the input nyquist frequency. the cutoff is placed this far below the
+// lower of the two nyquist frequencies, so nothing above it aliases back in
+#define RESAMPLER_TRANSITION 0.08
+
+static float DotProductC(const float *coeff, const float *data, unsigned int count)
+{
+  float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+  for (unsigned int i = 0; i < count; i += 4)
+  {
+    sum0 += coeff[i + 0] * data[i + 0];
+    sum1 += coeff[i + 1] * data[i + 1];
+    sum2 += coeff[i + 2] * data[i + 2];
+    sum3 += coeff[i + 3] * data[i + 3];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+#ifdef RESAMPLER_SSE
+static float DotProductSSE(const float *coeff, const float *data, unsigned int count)
+{
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < count; i += 8)
+  {
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_load_ps(coeff + i    ), _mm_loadu_ps(data + i    )));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_load_ps(coeff + i + 4), _mm_loadu_ps(data + i + 4)));
+  }
+  sum0 = _mm_add_ps(sum0, sum1);
+  sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+  sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+
+  float result;
+  _mm_store_ss(&result, sum0);
+  return result;
+}
+#endif
+
+#if defined(__ARM_NEON__)
+static float DotProductNEON(const float *coeff, const float *data, unsigned int count)
+{
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < count; i += 8)
+  {
+    sum0 = vmlaq_f32(sum0, vld1q_f32(coeff + i    ), vld1q_f32(data + i    ));
+    sum1 = vmlaq_f32(sum1, vld1q_f32(coeff + i + 4), vld1q_f32(data + i + 4));
+  }
+  sum0 = vaddq_f32(sum0, sum1);
+  float32x2_t sum = vadd_f32(vget_low_f32(sum0), vget_high_f32(sum0));
+  sum = vpadd_f32(sum, sum);
+  return vget_lane_f32(sum, 0);
+}
+#endif
+
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+  while (b)
+  {
+    unsigned int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// zeroth order modified bessel function of the first kind
+static double besselI0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+CPolyphaseResampler::DotProduct CPolyphaseResampler::GetDotProduct(unsigned int cpuFeatures)
+{
+#ifdef RESAMPLER_SSE
+  if (cpuFeatures & CPU_FEATURE_SSE)
+    return DotProductSSE;
+#endif
+#if defined(__ARM_NEON__)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+    return DotProductNEON;
+#endif
+  return DotProductC;
+}
+
+CPolyphaseResampler::CPolyphaseResampler()
+{
+  m_dot         = DotProductC;
+  m_channels    = 0;
+  m_outputSize  = 0;
+  m_L           = 1;
+  m_M           = 1;
+  m_phase       = 0;
+  m_index       = 0;
+  m_fill        = 0;
+  m_coeff       = NULL;
+  m_coeffBuffer = NULL;
+  m_history     = NULL;
+  m_output      = NULL;
+  m_outputPos   = 0;
+  m_outputMax   = 0;
+}
+
+CPolyphaseResampler::~CPolyphaseResampler()
+{
+  DeInitialize();
+}
+
+void CPolyphaseResampler::DeInitialize()
+{
+  if (m_history)
+  {
+    for (int i = 0; i < m_channels; i++)
+      delete[] m_history[i];
+    delete[] m_history;
+    m_history = NULL;
+  }
+  delete[] m_coeffBuffer;
+  m_coeffBuffer = NULL;
+  m_coeff       = NULL;
+  delete[] m_output;
+  m_output      = NULL;
+  m_outputPos   = 0;
+  m_outputMax   = 0;
+  m_channels    = 0;
+}
+
+bool CPolyphaseResampler::InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize)
+{
+  DeInitialize();
+
+  // input always arrives as float, we only produce 16 bit
+  if (OldFreq <= 0 || NewFreq <= 0 || Channels <= 0 || NewBPS != 16 || OutputBufferSize <= 0)
+    return false;
+
+  unsigned int div = gcd(NewFreq, OldFreq);
+  m_L = NewFreq / div;
+  m_M = OldFreq / div;
+  if (m_L > RESAMPLER_MAX_PHASES)
+  {
+    CLog::Log(LOGERROR, "CPolyphaseResampler::InitConverter - unsupported conversion %i -> %i", OldFreq, NewFreq);
+    return false;
+  }
+
+  m_channels   = Channels;
+  m_outputSize = OutputBufferSize;
+  m_phase      = 0;
+
+  if (m_L != 1 || m_M != 1)
+  {
+    if (!InitFilter())
+      return false;
+
+    // start with silence in the history so the first output frame has something to work on
+    m_history = new float*[m_channels];
+    for (int i = 0; i < m_channels; i++)
+    {
+      m_history[i] = new float[RESAMPLER_TAPS - 1 + RESAMPLER_CHUNK];
+      memset(m_history[i], 0, (RESAMPLER_TAPS - 1) * sizeof(float));
+    }
+  }
+  m_fill  = RESAMPLER_TAPS - 1;
+  m_index = RESAMPLER_TAPS - 1;
+
+  // room for a full block, plus what a single chunk can produce
+  int frames  = (int)(((int64_t)RESAMPLER_CHUNK * m_L + m_M - 1) / m_M) + 1;
+  m_outputMax = m_outputSize + frames * m_channels * sizeof(short);
+  m_output    = new short[m_outputMax / sizeof(short) + 1];
+  m_outputPos = 0;
+
+  m_dot = GetDotProduct(g_cpuInfo.GetCPUFeatures());
+
+  CLog::Log(LOGDEBUG, "CPolyphaseResampler::InitConverter - %i -> %i Hz, %u/%u, %i channels, %s kernel", OldFreq, NewFreq, m_L, m_M, m_channels,
+            m_dot == DotProductC ? "c" : "simd");
+  return true;
+}
+
+bool CPolyphaseResampler::InitFilter()
+{
+  unsigned int length = m_L * RESAMPLER_TAPS;
+
+  m_coeffBuffer = new float[length + 4];
+  m_coeff       = (float*)(((uintptr_t)m_coeffBuffer + 15) & ~(uintptr_t)15);
+
+  // cutoff relative to the input nyquist, lowered when decimating
+  double cutoff = std::min(1.0, (double)m_L / m_M) - RESAMPLER_TRANSITION;
+  double center = (length - 1) * 0.5;
+  double norm   = besselI0(RESAMPLER_BETA);
+  double total  = 0.0;
+
+  std::vector<double> proto(length);
+  for (unsigned int n = 0; n < length; n++)
+  {
+    double x = (n - center) / m_L;
+    double s = x == 0.0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+    double r = (n - center) / (center + 0.5);
+    double w = besselI0(RESAMPLER_BETA * sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+    proto[n] = cutoff * s * w;
+    total   += proto[n];
+  }
+
+  // unity gain through each phase on average, and store each phase
+  // reversed so it lines up with the input history in time order
+  double gain = m_L / total;
+  for (unsigned int p = 0; p < m_L; p++)
+  {
+    for (unsigned int t = 0; t < RESAMPLER_TAPS; t++)
+      m_coeff[p * RESAMPLER_TAPS + t] = (float)(proto[(RESAMPLER_TAPS - 1 - t) * m_L + p] * gain);
+  }
+  return true;
+}
+
+int CPolyphaseResampler::GetInputSamples()
+{
+  if (!m_output || m_outputPos >= m_outputSize)
+    return 0;  // need to take data out first!
+
+  return RESAMPLER_CHUNK * m_channels;
+}
+
+int CPolyphaseResampler::PutFloatData(float *pInData, int numSamples)
+{
+  if (!m_output || m_outputPos >= m_outputSize)
+    return 0;  // need to take data out first!
+
+  int amount = RESAMPLER_CHUNK * m_channels;
+  if (numSamples < amount)
+    return -1;
+
+  if (!m_history)
+  { // same rate, just convert to 16 bit
+    short *out = m_output + m_outputPos / sizeof(short);
+    for (int i = 0; i < amount; i++)
+      out[i] = MathUtils::round_int(std::max(std::min(32767.0f * pInData[i], 32767.0f), -32768.0f));
+    m_outputPos += amount * sizeof(short);
+    return amount;
+  }
+
+  // deinterleave into the history so the kernels run on contiguous data
+  for (int c = 0; c < m_channels; c++)
+  {
+    float *dst = m_history[c] + m_fill;
+    const float *src = pInData + c;
+    for (int i = 0; i < RESAMPLER_CHUNK; i++, src += m_channels)
+      dst[i] = *src;
+  }
+  m_fill += RESAMPLER_CHUNK;
+
+  Convert();
+  return amount;
+}
+
+void CPolyphaseResampler::Convert()
+{
+  short *out = m_output + m_outputPos / sizeof(short);
+  int produced = 0;
+
+  while (m_index < m_fill)
+  {
+    const float *coeff = m_coeff + m_phase * RESAMPLER_TAPS;
+    unsigned int start = m_index - (RESAMPLER_TAPS - 1);
+    for (int c = 0; c < m_channels; c++)
+    {
+      float value = m_dot(coeff, m_history[c] + start, RESAMPLER_TAPS);
+      *out++ = MathUtils::round_int(std::max(std::min(32767.0f * value, 32767.0f), -32768.0f));
+    }
+    produced++;
+
+    m_phase += m_M;
+    m_index += m_phase / m_L;
+    m_phase %= m_L;
+  }
+  m_outputPos += produced * m_channels * sizeof(short);
+
+  // keep the last taps - 1 frames as history for the next chunk
+  unsigned int drop = m_fill - (RESAMPLER_TAPS - 1);
+  for (int c = 0; c < m_channels; c++)
+    memmove(m_history[c], m_history[c] + drop, (RESAMPLER_TAPS - 1) * sizeof(float));
+  m_fill  -= drop;
+  m_index -= drop;
+}
+
+bool CPolyphaseResampler::GetData(unsigned char *pOutData)
+{
+  if (!m_output || m_outputPos < m_outputSize)
+    return false;
+
+  memcpy(pOutData, m_output, m_outputSize);
+  m_outputPos -= m_outputSize;
+  if (m_outputPos)
+    memmove(m_output, (unsigned char *)m_output + m_outputSize, m_outputPos);
+  return true;
+}
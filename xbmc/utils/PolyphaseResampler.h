@@ -0,0 +1,72 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "IResampler.h"
+
+/*!
+ \brief Rational polyphase FIR sample rate converter.
+
+ Converts by L/M (output/input rate reduced by their gcd) using a Kaiser
+ windowed sinc split in L phases of RESAMPLER_TAPS coefficients each. Works on
+ interleaved float data and outputs 16 bit samples. The inner dot product has
+ SSE and NEON versions which are picked at runtime from g_cpuInfo.
+ */
+class CPolyphaseResampler : public IResampler
+{
+public:
+  CPolyphaseResampler();
+  virtual ~CPolyphaseResampler();
+
+  virtual bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize);
+  virtual void DeInitialize();
+  virtual bool GetData(unsigned char *pOutData);
+  virtual int  PutFloatData(float *pInData, int numSamples);
+  virtual int  GetInputSamples();
+
+  typedef float (*DotProduct)(const float *coeff, const float *data, unsigned int count);
+
+  /*!
+   \brief Get the dot product kernel for a set of cpu features.
+   \param cpuFeatures CPU_FEATURE_* flags, as returned by CCPUInfo::GetCPUFeatures()
+   \return the simd kernel the features allow, or the plain C one.
+   */
+  static DotProduct GetDotProduct(unsigned int cpuFeatures);
+
+private:
+  bool InitFilter();
+  void Convert();
+
+  DotProduct     m_dot;
+  int            m_channels;
+  int            m_outputSize;  ///< bytes returned by each GetData()
+  unsigned int   m_L;           ///< interpolation factor, number of phases
+  unsigned int   m_M;           ///< decimation factor
+  unsigned int   m_phase;       ///< current phase, 0 .. m_L - 1
+  unsigned int   m_index;       ///< input frame the next output ends at
+  unsigned int   m_fill;        ///< frames in the history buffers
+  float         *m_coeff;       ///< m_L phases of RESAMPLER_TAPS coefficients, 16 byte aligned
+  float         *m_coeffBuffer; ///< allocation holding m_coeff
+  float        **m_history;     ///< per channel input history
+  short         *m_output;      ///< converted output waiting for GetData()
+  int            m_outputPos;   ///< bytes in m_output
+  int            m_outputMax;   ///< capacity of m_output in bytes
+};
@@ -235,6 +235,72 @@ int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *rig
   return 0; // files are the same
 }
 
+static void AppendSortUnit(std::string &key, uint32_t unit)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+    key += (char)((unit >> shift) & 0xff);
+}
+
+// A character's units are those of its collation transform, each one up by one and followed by
+// a zero unit, so a character sorting before another never runs on into the next character.
+// The classic locale collates on the character values, so there the value is the only unit.
+static void AppendCollationUnits(std::string &key, const collate<wchar_t> &coll, bool classic, wchar_t c)
+{
+  if (classic)
+  {
+    AppendSortUnit(key, (uint32_t)c);
+    return;
+  }
+  wstring transformed = coll.transform(&c, &c + 1);
+  for (unsigned int i = 0; i < transformed.size(); i++)
+  {
+    uint32_t unit = (uint32_t)transformed[i];
+    AppendSortUnit(key, unit < 0xffffffff ? unit + 1 : unit);
+  }
+  AppendSortUnit(key, 0);
+}
+
+// Characters are added as the units of the current locale's collation, with upper case ascii
+// folded as in AlphaNumericCompare(). A run of up to 15 digits becomes the units of '0', a unit
+// of the number of significant digits and a unit per significant digit, so runs sort against
+// each other by value, and against other characters as their digits do. That matches
+// AlphaNumericCompare() as long as the locale collates no other character between the digits.
+// Where one does, the comparison itself isn't a consistent order to match.
+void StringUtils::AlphaNumericSortKey(const wchar_t *label, std::string &key)
+{
+  key.clear();
+  key.reserve(wcslen(label) * 4);
+
+  const locale loc;
+  const collate<wchar_t>& coll = use_facet< collate<wchar_t> >(loc);
+  const bool classic = (loc == locale::classic());
+
+  const wchar_t *l = label;
+  while (*l != 0)
+  {
+    if (*l >= L'0' && *l <= L'9')
+    {
+      const wchar_t *start = l;
+      while (*l >= L'0' && *l <= L'9' && l < start + 15)
+        l++;
+      // leading zeros don't change the value
+      const wchar_t *digits = start;
+      while (digits < l && *digits == L'0')
+        digits++;
+      AppendCollationUnits(key, coll, classic, L'0');
+      AppendSortUnit(key, (uint32_t)(l - digits));
+      for (; digits < l; digits++)
+        AppendSortUnit(key, (uint32_t)(*digits - L'0'));
+      continue;
+    }
+
+    wchar_t c = *l++;
+    if (c >= L'A' && c <= L'Z')
+      c += L'a' - L'A';
+    AppendCollationUnits(key, coll, classic, c);
+  }
+}
+
 int StringUtils::DateStringToYYYYMMDD(const CStdString &dateString)
 {
   CStdStringArray days;
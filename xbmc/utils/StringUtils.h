@@ -48,6 +48,13 @@ public:
   static std::vector<std::string> Split(const CStdString& input, const CStdString& delimiter, unsigned int iMaxStrings = 0);
   static int FindNumber(const CStdString& strInput, const CStdString &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  /*! \brief Build a binary key for a label that compares like AlphaNumericCompare()
+   Keys of two labels built under the same locale compare with std::string::compare() as
+   AlphaNumericCompare() compares the labels, so a list can be sorted on plain byte comparisons.
+   \param label the label to build the key for
+   \param key [out] the key
+   */
+  static void AlphaNumericSortKey(const wchar_t *label, std::string &key);
   static long TimeStringToSeconds(const CStdString &timeString);
   static void RemoveCRLF(CStdString& strLine);
 
@@ -29,6 +29,8 @@
 
 //#include "clsDataStream.h"
 
+#include "IResampler.h"
+
 #ifndef HIGH_PREC
 typedef float REAL;
 #define AA 96
@@ -104,16 +106,16 @@ const double shapercoefs[8][21] =
     },  /* 44.1k, N=15, amp=9 */
   };
 
-class Cssrc
+class Cssrc : public IResampler
 {
 public:
   Cssrc(void);
-  ~Cssrc();
+  virtual ~Cssrc();
 
   //---------------------------------------------------------------------------
   // Inits Freq Converter, returns false if cannot do
   //---------------------------------------------------------------------------
-  bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize);
+  virtual bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize);
 
   //---------------------------------------------------------------------------
   // returns the input bitrate that we are using (in bits per second)
@@ -123,13 +125,13 @@ public:
   //---------------------------------------------------------------------------
   // Deinitializes everything, cleaning up any buffers that exist
   //---------------------------------------------------------------------------
-  void DeInitialize();
+  virtual void DeInitialize();
 
   //---------------------------------------------------------------------------
   // Get Resampled data out of the buffers
   // returns true if data was got, returns false if there is no data ready
   //---------------------------------------------------------------------------
-  bool GetData(unsigned char *pOutData);
+  virtual bool GetData(unsigned char *pOutData);
 
   //---------------------------------------------------------------------------
   // Put up to iSize bytes of data into our resampler
@@ -145,7 +147,7 @@ public:
   // if there is not enough data, it returns -1
   // if we first need to do a GetData() it returns 0
   //---------------------------------------------------------------------------
-  int PutFloatData(float *pInData, int numSamples);
+  virtual int PutFloatData(float *pInData, int numSamples);
 
   //---------------------------------------------------------------------------
   // returns the amount of data (or samples) that the resampler will take in
@@ -155,7 +157,7 @@ public:
   // returns -1
   //---------------------------------------------------------------------------
   int GetInputSize();
-  int GetInputSamples();
+  virtual int GetInputSamples();
 
   int GetMaxInputSize() { return m_iMaxInputSize;};
   //---------------------------------------------------------------------------
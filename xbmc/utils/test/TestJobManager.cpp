@@ -0,0 +1,189 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/JobManager.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+
+#include <boost/test/unit_test.hpp>
+
+//=============================================================================
+// Helper classes
+//=============================================================================
+
+#define NUM_JOBS      20000
+#define WAIT_TIMEOUT  30000
+
+// the completion count is the last thing touched by the worker, so the callback
+// may go out of scope as soon as waitForCount() returns
+class CountingCallback : public IJobCallback
+{
+public:
+  volatile long completed;
+  volatile long succeeded;
+
+  CountingCallback() : completed(0), succeeded(0) {}
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    if (success)
+      AtomicIncrement(&succeeded);
+    AtomicIncrement(&completed);
+  }
+};
+
+static bool waitForCount(volatile long& count, long expected, unsigned int milliseconds)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  while (count < expected)
+  {
+    if (XbmcThreads::SystemClockMillis() - start > milliseconds)
+      return false;
+    Sleep(1);
+  }
+  return count == expected;
+}
+
+class CountingJob : public CJob
+{
+public:
+  volatile long* counter;
+
+  CountingJob(volatile long* c) : counter(c) {}
+  virtual bool DoWork() { AtomicIncrement(counter); return true; }
+  virtual bool operator==(const CJob* job) const { return this == job; }
+};
+
+// queues a number of children from within the worker, which stay on the worker's own queue
+class SpawningJob : public CJob
+{
+public:
+  volatile long* counter;
+  IJobCallback* callback;
+  int children;
+
+  SpawningJob(volatile long* c, IJobCallback* cb, int n) : counter(c), callback(cb), children(n) {}
+  virtual bool DoWork()
+  {
+    for (int i = 0; i < children; i++)
+      CJobManager::GetInstance().AddJob(new CountingJob(counter), callback, CJob::PRIORITY_NORMAL);
+    return true;
+  }
+};
+
+class BlockingJob : public CJob
+{
+public:
+  CEvent& started;
+  CEvent& release;
+
+  BlockingJob(CEvent& s, CEvent& r) : started(s), release(r) {}
+  virtual bool DoWork() { started.Set(); release.Wait(); return true; }
+};
+
+class QueueCallback : public CJobQueue
+{
+public:
+  CountingCallback& counter;
+
+  QueueCallback(CountingCallback& c) : CJobQueue(false, 4, CJob::PRIORITY_NORMAL), counter(c) {}
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    // count last, the queue may be destroyed as soon as the final job is counted
+    CJobQueue::OnJobComplete(jobID, success, job);
+    counter.OnJobComplete(jobID, success, job);
+  }
+};
+
+// stop the workers before the job manager is destroyed at exit, as the application does
+struct JobManagerFixture
+{
+  ~JobManagerFixture() { CJobManager::GetInstance().CancelJobs(); }
+};
+
+//=============================================================================
+
+BOOST_GLOBAL_FIXTURE(JobManagerFixture);
+
+BOOST_AUTO_TEST_CASE(TestJobThroughput)
+{
+  volatile long ran = 0;
+  CountingCallback callback;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (int i = 0; i < NUM_JOBS; i++)
+    CJobManager::GetInstance().AddJob(new CountingJob(&ran), &callback, CJob::PRIORITY_NORMAL);
+
+  BOOST_REQUIRE(waitForCount(callback.completed, NUM_JOBS, WAIT_TIMEOUT));
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  BOOST_CHECK_EQUAL(ran, NUM_JOBS);
+  BOOST_CHECK_EQUAL(callback.succeeded, NUM_JOBS);
+  BOOST_TEST_MESSAGE("CJobManager: " << NUM_JOBS << " jobs in " << elapsed << " ms ("
+                     << (elapsed ? NUM_JOBS * 1000 / elapsed : NUM_JOBS) << " jobs/s)");
+}
+
+BOOST_AUTO_TEST_CASE(TestJobsAddedFromWorkers)
+{
+  const int parents = 100, children = 100;
+  volatile long ran = 0;
+  CountingCallback parentCallback;
+  CountingCallback childCallback;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (int i = 0; i < parents; i++)
+    CJobManager::GetInstance().AddJob(new SpawningJob(&ran, &childCallback, children), &parentCallback, CJob::PRIORITY_NORMAL);
+
+  BOOST_REQUIRE(waitForCount(parentCallback.completed, parents, WAIT_TIMEOUT));
+  BOOST_REQUIRE(waitForCount(childCallback.completed, parents * children, WAIT_TIMEOUT));
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  BOOST_CHECK_EQUAL(ran, parents * children);
+  BOOST_TEST_MESSAGE("CJobManager: " << parents * children << " nested jobs in " << elapsed << " ms");
+}
+
+BOOST_AUTO_TEST_CASE(TestJobQueueBatches)
+{
+  CountingCallback callback;
+  volatile long ran = 0;
+  {
+    QueueCallback queue(callback);
+    for (int i = 0; i < 1000; i++)
+      queue.AddJob(new CountingJob(&ran));
+    BOOST_REQUIRE(waitForCount(callback.completed, 1000, WAIT_TIMEOUT));
+  }
+  BOOST_CHECK_EQUAL(ran, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(TestCancelledJobHasNoCallback)
+{
+  CEvent started, release;
+  CountingCallback callback;
+
+  unsigned int id = CJobManager::GetInstance().AddJob(new BlockingJob(started, release), &callback, CJob::PRIORITY_NORMAL);
+  BOOST_REQUIRE(started.WaitMSec(WAIT_TIMEOUT));
+  CJobManager::GetInstance().CancelJob(id);
+  release.Set();
+
+  BOOST_CHECK(!waitForCount(callback.completed, 1, 200));
+  BOOST_CHECK_EQUAL(callback.completed, 0);
+}
@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/PolyphaseResampler.h"
+#include "utils/CPUInfo.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+#define TEST_CHANNELS   2
+#define TEST_BLOCK      4096  // bytes returned by each GetData()
+#define TEST_FRAMES     16384 // output frames analysed
+#define TEST_SKIP       1024  // output frames skipped while the filter fills
+
+// resample a sine of the given frequency and amplitude, returning the first channel of the output
+static std::vector<double> Resample(int inRate, int outRate, double freq, double amplitude)
+{
+  std::vector<double> output;
+  CPolyphaseResampler resampler;
+  BOOST_REQUIRE(resampler.InitConverter(inRate, 32, TEST_CHANNELS, outRate, 16, TEST_BLOCK));
+
+  std::vector<float> input;
+  std::vector<short> block(TEST_BLOCK / sizeof(short));
+  long frame = 0;
+  while (output.size() < TEST_SKIP + TEST_FRAMES)
+  {
+    if (resampler.GetData((unsigned char*)&block[0]))
+    {
+      for (unsigned int i = 0; i < block.size(); i += TEST_CHANNELS)
+        output.push_back(block[i] / 32768.0);
+      continue;
+    }
+
+    int samples = resampler.GetInputSamples();
+    BOOST_REQUIRE(samples > 0);
+    input.resize(samples);
+    for (int i = 0; i < samples; i += TEST_CHANNELS, frame++)
+    {
+      float value = (float)(amplitude * sin(2.0 * M_PI * freq * frame / inRate));
+      for (int c = 0; c < TEST_CHANNELS; c++)
+        input[i + c] = value;
+    }
+    BOOST_REQUIRE_EQUAL(resampler.PutFloatData(&input[0], samples), samples);
+  }
+  output.erase(output.begin(), output.begin() + TEST_SKIP);
+  output.resize(TEST_FRAMES);
+  return output;
+}
+
+// amplitude of a frequency in the signal, blackman-harris windowed to keep leakage below the 16 bit floor
+static double Amplitude(const std::vector<double> &signal, int rate, double freq)
+{
+  double re = 0.0, im = 0.0, total = 0.0;
+  unsigned int n = signal.size();
+  for (unsigned int i = 0; i < n; i++)
+  {
+    double x = 2.0 * M_PI * i / (n - 1);
+    double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+    re += signal[i] * w * cos(2.0 * M_PI * freq * i / rate);
+    im -= signal[i] * w * sin(2.0 * M_PI * freq * i / rate);
+    total += w;
+  }
+  return 2.0 * sqrt(re * re + im * im) / total;
+}
+
+static double Decibel(double amplitude)
+{
+  return 20.0 * log10(std::max(amplitude, 1e-10));
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestPassband)
+{
+  // input rate, output rate, highest frequency that must pass
+  const int rates[][3] = { { 44100, 48000, 18000 }, { 48000, 44100, 18000 }, { 22050, 48000, 8000 }, { 96000, 44100, 13000 } };
+  for (unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+  {
+    int in = rates[i][0], out = rates[i][1];
+    double edge = rates[i][2];
+
+    const double freqs[] = { 1000.0, edge };
+    for (unsigned int f = 0; f < 2; f++)
+    {
+      double gain = Decibel(Amplitude(Resample(in, out, freqs[f], 0.5), out, freqs[f]) / 0.5);
+      BOOST_TEST_MESSAGE(in << " -> " << out << " Hz: " << freqs[f] << " Hz at " << gain << " dB");
+      BOOST_CHECK_SMALL(gain, 0.2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestNoAliasing)
+{
+  // a tone above the output nyquist frequency must not fold back into the output
+  std::vector<double> down = Resample(48000, 44100, 23000.0, 0.5);
+  double alias = Decibel(Amplitude(down, 44100, 44100 - 23000.0));
+  BOOST_TEST_MESSAGE("48000 -> 44100 Hz: alias of 23000 Hz at " << alias << " dB");
+  BOOST_CHECK(alias < -70.0);
+
+  // with a larger decimation factor the transition band is wider, so tones just above nyquist matter
+  std::vector<double> decimate = Resample(96000, 44100, 22500.0, 0.5);
+  alias = Decibel(Amplitude(decimate, 44100, 44100 - 22500.0));
+  BOOST_TEST_MESSAGE("96000 -> 44100 Hz: alias of 22500 Hz at " << alias << " dB");
+  BOOST_CHECK(alias < -70.0);
+
+  // the image of a tone near the input nyquist frequency must not show up in the output
+  std::vector<double> up = Resample(44100, 48000, 21500.0, 0.5);
+  double image = Decibel(Amplitude(up, 48000, 44100 - 21500.0));
+  BOOST_TEST_MESSAGE("44100 -> 48000 Hz: image of 21500 Hz at " << image << " dB");
+  BOOST_CHECK(image < -70.0);
+}
+
+BOOST_AUTO_TEST_CASE(TestKernelsMatch)
+{
+  CPolyphaseResampler::DotProduct c = CPolyphaseResampler::GetDotProduct(0);
+  CPolyphaseResampler::DotProduct simd = CPolyphaseResampler::GetDotProduct(g_cpuInfo.GetCPUFeatures());
+  if (simd == c)
+    BOOST_TEST_MESSAGE("no simd kernel for this cpu, comparing the C kernel with itself");
+
+  // the simd kernels expect 16 byte aligned coefficients
+  std::vector<float> buffer(256 + 4), data(256 + 1);
+  float *coeff = (float*)(((uintptr_t)&buffer[0] + 15) & ~(uintptr_t)15);
+  srand(1);
+  for (unsigned int i = 0; i < 256; i++)
+    coeff[i] = (float)rand() / RAND_MAX - 0.5f;
+  for (unsigned int i = 0; i < data.size(); i++)
+    data[i] = (float)rand() / RAND_MAX - 0.5f;
+
+  for (unsigned int count = 8; count <= 256; count += 8)
+  {
+    // the history isn't aligned, test both
+    for (unsigned int offset = 0; offset < 2; offset++)
+    {
+      float expected = c(coeff, &data[offset], count);
+      float result   = simd(coeff, &data[offset], count);
+      BOOST_CHECK_SMALL(result - expected, 1e-4f);
+    }
+  }
+}
@@ -0,0 +1,165 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StringUtils.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <locale>
+#include <stdlib.h>
+#include <boost/test/unit_test.hpp>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+#define SORT_ITEMS 100000
+
+// labels like those in a music or video library: words in mixed case, track and
+// episode numbers with and without leading zeros, punctuation and long digit runs
+static CStdStringW randomLabel()
+{
+  static const wchar_t *words[] = { L"The", L"a", L"Abbey", L"road", L"ABBA", L"Disc", L"disc ",
+                                    L"Episode", L"S01E", L"track", L"-", L"_", L".", L"'", L" ",
+                                    L"(Live)", L"[1080p]", L"Zoo", L"zz" };
+  CStdStringW label;
+  int parts = 1 + rand() % 6;
+  for (int i = 0; i < parts; i++)
+  {
+    switch (rand() % 4)
+    {
+      case 0:
+      {
+        CStdStringW number;
+        number.Format(L"%0*d", rand() % 4, rand() % 1200);
+        label += number;
+        break;
+      }
+      case 1:
+        if (rand() % 8 == 0)
+          label += L"1234567890123456789"; // more digits than are compared
+        else
+          label += (wchar_t)(L'0' + rand() % 10);
+        break;
+      default:
+        label += words[rand() % (sizeof(words) / sizeof(words[0]))];
+        break;
+    }
+  }
+  return label;
+}
+
+static int sign(int64_t value)
+{
+  return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+struct SKeyedLabel
+{
+  CStdStringW label;
+  std::string key;
+};
+
+static bool compareLabels(const SKeyedLabel &left, const SKeyedLabel &right)
+{
+  return StringUtils::AlphaNumericCompare(left.label.c_str(), right.label.c_str()) < 0;
+}
+
+static bool compareKeys(const SKeyedLabel &left, const SKeyedLabel &right)
+{
+  return left.key < right.key;
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestSortKeyOrdersLikeCompare)
+{
+  srand(1);
+  std::vector<SKeyedLabel> labels(2000);
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    labels[i].label = randomLabel();
+    StringUtils::AlphaNumericSortKey(labels[i].label.c_str(), labels[i].key);
+  }
+
+  unsigned int mismatches = 0;
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    for (unsigned int j = 0; j < labels.size(); j += 7)
+    {
+      int compare = sign(StringUtils::AlphaNumericCompare(labels[i].label.c_str(), labels[j].label.c_str()));
+      int keys = sign(labels[i].key.compare(labels[j].key));
+      if (compare != keys && mismatches++ < 10)
+        BOOST_ERROR("keys of \"" << CStdStringA(labels[i].label.c_str()) << "\" and \"" << CStdStringA(labels[j].label.c_str())
+                    << "\" compare " << keys << ", labels compare " << compare);
+    }
+  }
+  BOOST_CHECK_EQUAL(mismatches, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(TestSortKeyEdgeCases)
+{
+  const wchar_t *ordered[] = { L"", L"0", L"00", L"1", L"01", L"2", L"10", L"a", L"A1", L"a2", L"a10",
+                               L"ab", L"AB1", L"b" };
+  const unsigned int count = sizeof(ordered) / sizeof(ordered[0]);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string left;
+    StringUtils::AlphaNumericSortKey(ordered[i], left);
+    for (unsigned int j = 0; j < count; j++)
+    {
+      std::string right;
+      StringUtils::AlphaNumericSortKey(ordered[j], right);
+      BOOST_CHECK_EQUAL(sign(left.compare(right)), sign(StringUtils::AlphaNumericCompare(ordered[i], ordered[j])));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestSortKeysSort100k)
+{
+  srand(2);
+  std::vector<SKeyedLabel> byCompare(SORT_ITEMS);
+  for (unsigned int i = 0; i < byCompare.size(); i++)
+    byCompare[i].label = randomLabel();
+  std::vector<SKeyedLabel> byKey(byCompare);
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  std::stable_sort(byCompare.begin(), byCompare.end(), compareLabels);
+  unsigned int compareTime = XbmcThreads::SystemClockMillis() - start;
+
+  // as CFileItemList::SortBySortLabel does it: build the keys once, then sort on them
+  start = XbmcThreads::SystemClockMillis();
+  for (unsigned int i = 0; i < byKey.size(); i++)
+    StringUtils::AlphaNumericSortKey(byKey[i].label.c_str(), byKey[i].key);
+  std::stable_sort(byKey.begin(), byKey.end(), compareKeys);
+  unsigned int keyTime = XbmcThreads::SystemClockMillis() - start;
+
+  // both sorts are stable, so the orders must be identical
+  unsigned int differences = 0;
+  for (unsigned int i = 0; i < byKey.size(); i++)
+  {
+    if (byKey[i].label != byCompare[i].label)
+      differences++;
+  }
+  BOOST_CHECK_EQUAL(differences, 0U);
+  BOOST_TEST_MESSAGE("sorting " << SORT_ITEMS << " labels: " << compareTime << " ms with AlphaNumericCompare, "
+                     << keyTime << " ms with AlphaNumericSortKey");
+}
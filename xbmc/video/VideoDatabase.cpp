@@ -1277,6 +1277,51 @@ void CVideoDatabase::AddLinkToActor(const char *table, int actorID, const char *
   }
 }
 
+void CVideoDatabase::AddCast(const char *table, const char *secondField, int secondID, const std::vector<SActorInfo> &cast)
+{
+  if (cast.empty())
+    return;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return ;
+    if (NULL == m_pDS.get()) return ;
+
+    // existing links are kept, same as AddLinkToActor()
+    set<int> linked;
+    CStdString strSQL=PrepareSQL("select idActor from %s where %s=%i", table, secondField, secondID);
+    m_pDS->query(strSQL.c_str());
+    while (!m_pDS->eof())
+    {
+      linked.insert(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    vector<DatabaseRow> rows;
+    int order = 0;
+    for (CVideoInfoTag::iCast it = cast.begin(); it != cast.end(); ++it, ++order)
+    {
+      int idActor = AddActor(it->strName, it->thumbUrl.m_xml);
+      if (idActor < 0 || !linked.insert(idActor).second)
+        continue;
+
+      DatabaseRow row;
+      row.push_back(idActor);
+      row.push_back(secondID);
+      row.push_back(it->strRole.c_str());
+      row.push_back(order);
+      rows.push_back(row);
+    }
+
+    BulkInsert(PrepareSQL("insert into %s (idActor, %s, strRole, iOrder) values (?,?,?,?)", table, secondField), rows);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+}
+
 void CVideoDatabase::AddToLinkTable(const char *table, const char *firstField, int firstID, const char *secondField, int secondID)
 {
   try
@@ -1801,12 +1846,7 @@ int CVideoDatabase::SetDetailsForMovie(const CStdString& strFilenameAndPath, con
       AddWriterToMovie(idMovie, AddActor(details.m_writingCredits[i],""));
 
     // add cast...
-    int order = 0;
-    for (CVideoInfoTag::iCast it = details.m_cast.begin(); it != details.m_cast.end(); ++it)
-    {
-      int idActor = AddActor(it->strName,it->thumbUrl.m_xml);
-      AddActorToMovie(idMovie, idActor, it->strRole, order++);
-    }
+    AddCast("actorlinkmovie", "idMovie", idMovie, details.m_cast);
 
     // add sets...
     for (unsigned int i = 0; i < details.m_set.size(); i++)
@@ -1857,12 +1897,7 @@ int CVideoDatabase::SetDetailsForTvShow(const CStdString& strPath, const CVideoI
     AddGenreAndDirectorsAndStudios(details,vecDirectors,vecGenres,vecStudios);
 
     // add cast...
-    int order = 0;
-    for (CVideoInfoTag::iCast it = details.m_cast.begin(); it != details.m_cast.end(); ++it)
-    {
-      int idActor = AddActor(it->strName,it->thumbUrl.m_xml);
-      AddActorToTvShow(idTvShow, idActor, it->strRole, order++);
-    }
+    AddCast("actorlinktvshow", "idShow", idTvShow, details.m_cast);
 
     unsigned int i;
     for (i = 0; i < vecGenres.size(); ++i)
@@ -1921,12 +1956,7 @@ int CVideoDatabase::SetDetailsForEpisode(const CStdString& strFilenameAndPath, c
     AddGenreAndDirectorsAndStudios(details,vecDirectors,vecGenres,vecStudios);
 
     // add cast...
-    int order = 0;
-    for (CVideoInfoTag::iCast it = details.m_cast.begin(); it != details.m_cast.end(); ++it)
-    {
-      int idActor = AddActor(it->strName,it->thumbUrl.m_xml);
-      AddActorToEpisode(idEpisode, idActor, it->strRole, order++);
-    }
+    AddCast("actorlinkepisode", "idEpisode", idEpisode, details.m_cast);
 
     // add writers...
     for (unsigned int i = 0; i < details.m_writingCredits.size(); i++)
@@ -2051,31 +2081,53 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
     BeginTransaction();
     m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
 
+    // all stream types share one statement, columns that don't apply are left NULL
+    field_value null;
+    null.set_isNull();
+    vector<DatabaseRow> rows;
+
     for (int i=1; i<=details.GetVideoStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i)",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i)));
+      DatabaseRow row;
+      row.push_back(idFile);
+      row.push_back((int)CStreamDetail::VIDEO);
+      row.push_back(details.GetVideoCodec(i).c_str());
+      row.push_back(details.GetVideoAspect(i));
+      row.push_back(details.GetVideoWidth(i));
+      row.push_back(details.GetVideoHeight(i));
+      row.push_back(details.GetVideoDuration(i));
+      row.insert(row.end(), 4, null);
+      rows.push_back(row);
     }
     for (int i=1; i<=details.GetAudioStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+      DatabaseRow row;
+      row.push_back(idFile);
+      row.push_back((int)CStreamDetail::AUDIO);
+      row.insert(row.end(), 5, null);
+      row.push_back(details.GetAudioCodec(i).c_str());
+      row.push_back(details.GetAudioChannels(i));
+      row.push_back(details.GetAudioLanguage(i).c_str());
+      row.push_back(null);
+      rows.push_back(row);
     }
     for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+      DatabaseRow row;
+      row.push_back(idFile);
+      row.push_back((int)CStreamDetail::SUBTITLE);
+      row.insert(row.end(), 8, null);
+      row.push_back(details.GetSubtitleLanguage(i).c_str());
+      rows.push_back(row);
+    }
+
+    if (!BulkInsert("INSERT INTO streamdetails "
+                    "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, "
+                    "strAudioCodec, iAudioChannels, strAudioLanguage, strSubtitleLanguage) "
+                    "VALUES (?,?,?,?,?,?,?,?,?,?,?)", rows))
+    {
+      RollbackTransaction();
+      return;
     }
 
     CommitTransaction();
@@ -2717,6 +2769,46 @@ CVideoInfoTag CVideoDatabase::GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, i
   return details;
 }
 
+// add the stream of the current streamdetails row to details
+static bool AddStreamDetail(Dataset *pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 {
   if (tag.m_iFileId < 0)
@@ -2732,44 +2824,8 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   details.Reset();
   while (!pDS->eof())
   {
-    CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-    switch (e)
-    {
-    case CStreamDetail::VIDEO:
-      {
-        CStreamDetailVideo *p = new CStreamDetailVideo();
-        p->m_strCodec = pDS->fv(2).get_asString();
-        p->m_fAspect = pDS->fv(3).get_asFloat();
-        p->m_iWidth = pDS->fv(4).get_asInt();
-        p->m_iHeight = pDS->fv(5).get_asInt();
-        p->m_iDuration = pDS->fv(10).get_asInt();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    case CStreamDetail::AUDIO:
-      {
-        CStreamDetailAudio *p = new CStreamDetailAudio();
-        p->m_strCodec = pDS->fv(6).get_asString();
-        if (pDS->fv(7).get_isNull())
-          p->m_iChannels = -1;
-        else
-          p->m_iChannels = pDS->fv(7).get_asInt();
-        p->m_strLanguage = pDS->fv(8).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    case CStreamDetail::SUBTITLE:
-      {
-        CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-        p->m_strLanguage = pDS->fv(9).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    }
-
+    if (AddStreamDetail(pDS.get(), details))
+      retVal = true;
     pDS->next();
   }
 
@@ -2781,6 +2837,42 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 
   return retVal;
 }
+
+#define STREAMDETAILS_BATCH_SIZE 1000 // files per query
+
+void CVideoDatabase::GetStreamDetails(const map<int, CVideoInfoTag*> &tags) const
+{
+  auto_ptr<Dataset> pDS(m_pDB->CreateDataset());
+  map<int, CVideoInfoTag*>::const_iterator batch = tags.begin();
+  while (batch != tags.end())
+  {
+    CStdString ids;
+    map<int, CVideoInfoTag*>::const_iterator it = batch;
+    for (int i = 0; i < STREAMDETAILS_BATCH_SIZE && it != tags.end(); i++, ++it)
+    {
+      it->second->m_streamDetails.Reset();
+      ids.AppendFormat(ids.IsEmpty() ? "%i" : ",%i", it->first);
+    }
+
+    pDS->query("SELECT * FROM streamdetails WHERE idFile IN (" + ids + ")");
+    while (!pDS->eof())
+    {
+      map<int, CVideoInfoTag*>::const_iterator tag = tags.find(pDS->fv(0).get_asInt());
+      if (tag != tags.end())
+        AddStreamDetail(pDS.get(), tag->second->m_streamDetails);
+      pDS->next();
+    }
+    pDS->close();
+
+    for (; batch != it; ++batch)
+    {
+      CStreamDetails &details = batch->second->m_streamDetails;
+      details.DetermineBestStreams();
+      if (details.GetVideoDuration() > 0)
+        batch->second->m_strRuntime.Format("%i", details.GetVideoDuration() / 60 );
+    }
+  }
+}
  
 bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag) const
 {
@@ -2887,7 +2979,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(auto_ptr<Dataset> &pDS, bool n
   return details;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */, bool needsStreamDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2907,7 +2999,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool
   details.m_iIdShow = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt();
   details.m_strShowPath = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_PATH).get_asString();
 
-  GetStreamDetails(details);
+  if (needsStreamDetails)
+    GetStreamDetails(details);
 
   if (needsCast)
   {
@@ -5095,6 +5188,50 @@ bool CVideoDatabase::GetEpisodesNav(const CStdString& strBaseDir, CFileItemList&
   return ret;
 }
 
+// the parts of an episode that aren't needed to label, sort or filter it
+static void FreeEpisodeDetails(CVideoInfoTag &details)
+{
+  details.m_strPlot.clear();
+  details.m_writingCredits.clear();
+  details.m_strPictureURL.Clear();
+  details.m_director.clear();
+  details.m_strOriginalTitle.clear();
+}
+
+static void CopyEpisodeDetails(const CVideoInfoTag &from, CVideoInfoTag &to)
+{
+  to.m_strPlot = from.m_strPlot;
+  to.m_writingCredits = from.m_writingCredits;
+  to.m_strPictureURL = from.m_strPictureURL;
+  to.m_director = from.m_director;
+  to.m_strOriginalTitle = from.m_strOriginalTitle;
+}
+
+// fills in the details of light episode items as they're shown
+class CEpisodeDetailsLoader : public CFileItemDetailsLoader
+{
+protected:
+  virtual void LoadDetails(const vector<CFileItem*> &items)
+  {
+    CVideoDatabase database;
+    if (database.Open())
+    {
+      database.GetEpisodesDetails(items);
+      database.Close();
+    }
+  }
+  virtual void FreeDetails(CFileItem *item)
+  {
+    if (item->HasVideoInfoTag())
+      FreeEpisodeDetails(*item->GetVideoInfoTag());
+  }
+  virtual void ApplyDetails(CFileItem *item, const CFileItem &details)
+  {
+    if (item->HasVideoInfoTag() && details.HasVideoInfoTag())
+      CopyEpisodeDetails(*details.GetVideoInfoTag(), *item->GetVideoInfoTag());
+  }
+};
+
 bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStdString &where, CFileItemList& items, bool appendFullShowPath /* = true */)
 {
   try
@@ -5109,6 +5246,13 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
+    // huge listings only get what's needed to label, sort and filter the episodes here, with
+    // the stream details (for the flags) fetched in batches rather than per episode.
+    // The rest is loaded as they're shown.
+    bool lazy = items.GetLazyDetails() && g_advancedSettings.m_iVideoLibraryLazyLoadItems > 0 &&
+                iRowsFound > g_advancedSettings.m_iVideoLibraryLazyLoadItems;
+    map<int, CVideoInfoTag*> streamDetails;
+
     // get data from returned rows
     items.Reserve(iRowsFound);
     CLabelFormatter formatter("%H. %T", "");
@@ -5117,7 +5261,9 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
       int idEpisode = m_pDS->fv("idEpisode").get_asInt();
       int idShow = m_pDS->fv("idShow").get_asInt();
 
-      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS);
+      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS, false, !lazy);
+      if (lazy)
+        FreeEpisodeDetails(movie);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, g_settings.m_videoSources))
@@ -5133,6 +5279,8 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.m_playCount > 0);
         pItem->m_dateTime = movie.m_firstAired;
         pItem->GetVideoInfoTag()->m_iYear = pItem->m_dateTime.GetYear();
+        if (lazy && movie.m_iFileId >= 0)
+          streamDetails[movie.m_iFileId] = pItem->GetVideoInfoTag();
         items.Add(pItem);
       }
       m_pDS->next();
@@ -5140,6 +5288,12 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
 
     // cleanup
     m_pDS->close();
+
+    if (lazy)
+    {
+      GetStreamDetails(streamDetails);
+      items.SetDetailsLoader(CFileItemDetailsLoaderPtr(new CEpisodeDetailsLoader));
+    }
     return true;
   }
   catch (...)
@@ -5150,6 +5304,49 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
 }
 
 
+bool CVideoDatabase::GetEpisodesDetails(const vector<CFileItem*> &items)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    map<int, CVideoInfoTag*> episodes;
+    CStdString ids;
+    for (vector<CFileItem*>::const_iterator it = items.begin(); it != items.end(); ++it)
+    {
+      if (!(*it)->HasVideoInfoTag())
+        continue;
+      int idEpisode = (*it)->GetVideoInfoTag()->m_iDbId;
+      episodes[idEpisode] = (*it)->GetVideoInfoTag();
+      ids.AppendFormat(ids.IsEmpty() ? "%i" : ",%i", idEpisode);
+    }
+    if (episodes.empty())
+      return true;
+
+    if (!m_pDS->query(("select * from episodeview where idEpisode in (" + ids + ")").c_str()))
+      return false;
+    while (!m_pDS->eof())
+    {
+      map<int, CVideoInfoTag*>::iterator episode = episodes.find(m_pDS->fv(0).get_asInt());
+      if (episode != episodes.end())
+      {
+        CVideoInfoTag details;
+        GetDetailsFromDB(m_pDS, VIDEODB_ID_EPISODE_MIN, VIDEODB_ID_EPISODE_MAX, DbEpisodeOffsets, details);
+        CopyEpisodeDetails(details, *episode->second);
+      }
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetMusicVideosNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idYear, int idArtist, int idDirector, int idStudio, int idAlbum)
 {
   CStdString where;
@@ -26,6 +26,7 @@
 
 #include <memory>
 #include <set>
+#include <map>
 
 class CFileItem;
 class CFileItemList;
@@ -602,6 +603,14 @@ public:
   bool GetMoviesByWhere(const CStdString& strBaseDir, const CStdString &where, const CStdString &order, CFileItemList& items, bool fetchSets = false);
   bool GetTvShowsByWhere(const CStdString& strBaseDir, const CStdString &where, CFileItemList& items);
   bool GetEpisodesByWhere(const CStdString& strBaseDir, const CStdString &where, CFileItemList& items, bool appendFullShowPath = true);
+
+  /*! \brief Load the details of light episode items
+   Fills in what GetEpisodesByWhere leaves out of the items of lazily loaded listings.
+   \param items the episode items to fill in
+   \return true if the query succeeded, false otherwise
+   \sa CFileItemList::SetLazyDetails
+   */
+  bool GetEpisodesDetails(const std::vector<CFileItem*> &items);
   bool GetMusicVideosByWhere(const CStdString &baseDir, const CStdString &whereClause, CFileItemList& items, bool checkLocks = true);
 
   // partymode
@@ -660,6 +669,7 @@ protected:
   // link functions - these two do all the work
   void AddLinkToActor(const char *table, int actorID, const char *secondField, int secondID, const CStdString &role, int order);
   void AddToLinkTable(const char *table, const char *firstField, int firstID, const char *secondField, int secondID);
+  void AddCast(const char *table, const char *secondField, int secondID, const std::vector<SActorInfo> &cast);
 
   void AddSetToMovie(int idMovie, int idSet);
 
@@ -691,7 +701,7 @@ protected:
   CVideoInfoTag GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, int id);
   CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
   CVideoInfoTag GetDetailsForTvShow(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
-  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
+  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false, bool needsStreamDetails = true);
   CVideoInfoTag GetDetailsForMusicVideo(std::auto_ptr<dbiplus::Dataset> &pDS);
   void GetCommonDetails(std::auto_ptr<dbiplus::Dataset> &pDS, CVideoInfoTag &details);
   bool GetPeopleNav(const CStdString& strBaseDir, CFileItemList& items, const CStdString& type, int idContent=-1);
@@ -701,6 +711,7 @@ protected:
   void GetDetailsFromDB(std::auto_ptr<dbiplus::Dataset> &pDS, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
   CStdString GetValueString(const CVideoInfoTag &details, int min, int max, const SDbTableOffsets *offsets) const;
   bool GetStreamDetails(CVideoInfoTag& tag) const;
+  void GetStreamDetails(const std::map<int, CVideoInfoTag*> &tags) const; ///< tags by file id, in batches
 
 private:
   virtual bool CreateTables();
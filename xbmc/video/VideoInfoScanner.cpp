@@ -20,6 +20,9 @@
  */
 
 #include "threads/SystemClock.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "FileItem.h"
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
@@ -46,6 +49,7 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/JobManager.h"
 
 using namespace std;
 using namespace XFILE;
@@ -53,9 +57,87 @@ using namespace ADDON;
 
 namespace VIDEO
 {
+  /*! \brief A movie or music video folder listed on the job queue
+   \sa CVideoInfoScanner::PrefetchFolders
+   */
+  class CScanListing
+  {
+  public:
+    CScanListing(const CStdString &path, const CStdString &dbHash)
+      : m_path(path), m_dbHash(dbHash), m_listed(false), m_complete(false), m_done(true) {}
+
+    CStdString    m_path;
+    CStdString    m_dbHash;   ///< hash of the folder in the database
+    CStdString    m_fastHash;
+    CStdString    m_hash;
+    CFileItemList m_items;
+    bool          m_listed;   ///< false if the folder is unchanged and wasn't listed
+    bool          m_complete; ///< false if the listing was cancelled
+    CEvent        m_done;
+  };
+
+  /*! \brief A movie or music video looked up on the job queue
+   \sa CVideoInfoScanner::LookupVideo, CVideoInfoScanner::FinishLookup
+   */
+  class CScanLookup
+  {
+  public:
+    CScanLookup(const CFileItemPtr &item, const ScraperPtr &scraper, int index, bool dirNames, bool useLocal)
+      : m_item(item), m_scraper(scraper), m_index(index), m_dirNames(dirNames), m_useLocal(useLocal),
+        m_queued(false), m_result(INFO_NOT_NEEDED), m_nfo(CNfoFile::NO_NFO), m_found(1), m_details(false),
+        m_cancelled(true), m_done(true) {}
+
+    CFileItemPtr        m_item;
+    ScraperPtr          m_scraper;
+    int                 m_index;     ///< position of the item in the folder listing
+    bool                m_dirNames;
+    bool                m_useLocal;
+    bool                m_queued;    ///< false if the item didn't need a lookup
+    INFO_RET            m_result;    ///< result for items that weren't queued
+    CNfoFile::NFOResult m_nfo;
+    int                 m_found;     ///< result of the scraper search, < 0 on scraper error
+    bool                m_details;   ///< true if m_item holds the details to add
+    bool                m_cancelled;
+    CEvent              m_done;
+  };
+
+  class CVideoScanJob : public CJob
+  {
+  public:
+    CVideoScanJob(CVideoInfoScanner *scanner, const ScanListingPtr &listing)
+      : m_scanner(scanner), m_listing(listing) {}
+    CVideoScanJob(CVideoInfoScanner *scanner, const ScanLookupPtr &lookup)
+      : m_scanner(scanner), m_lookup(lookup) {}
+
+    virtual ~CVideoScanJob()
+    { // signal on destruction so nobody waits forever on a job the job manager cancelled
+      if (m_listing)
+        m_listing->m_done.Set();
+      if (m_lookup)
+        m_lookup->m_done.Set();
+    }
+
+    virtual const char *GetType() const { return "videoscan"; }
+
+    virtual bool DoWork()
+    {
+      if (m_listing)
+        m_scanner->ListFolder(*m_listing);
+      else
+        m_scanner->LookupVideo(*m_lookup);
+      return true;
+    }
+
+  private:
+    CVideoInfoScanner *m_scanner;
+    ScanListingPtr     m_listing;
+    ScanLookupPtr      m_lookup;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
+    m_jobQueue = NULL;
+    m_scanStart = 0;
     m_bRunning = false;
     m_pObserver = NULL;
     m_bCanInterrupt = false;
@@ -67,6 +149,7 @@ namespace VIDEO
 
   CVideoInfoScanner::~CVideoInfoScanner()
   {
+    delete m_jobQueue;
   }
 
   void CVideoInfoScanner::Process()
@@ -87,6 +170,12 @@ namespace VIDEO
       // Reset progress vars
       m_currentItem = 0;
       m_itemCount = -1;
+      m_stats = SScanStats();
+      m_scanStart = tick;
+      m_actorThumbs.clear();
+
+      if (g_advancedSettings.m_iVideoScannerThreads > 1)
+        m_jobQueue = new CJobQueue(false, g_advancedSettings.m_iVideoScannerThreads, CJob::PRIORITY_NORMAL);
 
       SetPriority(GetMinPriority());
 
@@ -109,6 +198,15 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      if (m_jobQueue)
+      { // wait for folders we prefetched but didn't get to
+        for (map<CStdString, ScanListingPtr>::iterator i = m_listings.begin(); i != m_listings.end(); ++i)
+          i->second->m_done.Wait();
+        m_listings.clear();
+        delete m_jobQueue;
+        m_jobQueue = NULL;
+      }
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -125,6 +223,8 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Listed %ld folders, read %ld nfo files, looked up %ld items and added %ld items",
+                m_stats.foldersListed, m_stats.nfoFiles, m_stats.lookups, m_stats.itemsWritten);
       ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
       
       m_bRunning = false;
@@ -197,6 +297,9 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    // take our listing if it was prefetched, even if we skip the folder
+    ScanListingPtr listing = TakeListing(strDirectory);
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
@@ -223,19 +326,26 @@ namespace VIDEO
       if (m_pObserver)
         m_pObserver->OnStateChanged(content == CONTENT_MOVIES ? FETCHING_MOVIE_INFO : FETCHING_MUSICVIDEO_INFO);
 
-      CStdString fastHash = GetFastHash(strDirectory);
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
+      m_database.GetPathHash(strDirectory, dbHash);
+      if (!listing)
+      { // not prefetched - list the folder ourselves
+        listing.reset(new CScanListing(strDirectory, dbHash));
+        ListFolder(*listing);
+      }
+      if (m_bStop || !listing->m_complete)
+        return false;
+
+      CStdString fastHash = listing->m_fastHash;
+      if (!listing->m_listed)
       { // fast hashes match - no need to process anything
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
         hash = fastHash;
         bSkip = true;
       }
       if (!bSkip)
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
-        items.Stack();
-        // compute hash
-        GetPathHash(items, hash);
+      { // the folder has been fetched and hashed
+        items.Assign(listing->m_items);
+        hash = listing->m_hash;
         if (hash != dbHash && !hash.IsEmpty())
         {
           if (dbHash.IsEmpty())
@@ -315,6 +425,7 @@ namespace VIDEO
     if (m_pObserver)
       m_pObserver->OnDirectoryScanned(strDirectory);
 
+    int prefetched = 0;
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -322,6 +433,10 @@ namespace VIDEO
       if (m_bStop)
         break;
 
+      // list the next folders on the job queue while we scan this one
+      if (m_jobQueue && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+        prefetched = PrefetchFolders(items, std::max(prefetched, i), regexps);
+
       // if we have a directory item (non-playlist) we then recurse into that folder
       // do not recurse for tv shows - we have already looked recursively for episodes
       if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
@@ -337,6 +452,9 @@ namespace VIDEO
 
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
+    if (m_jobQueue && !pDlgProgress && !pURL && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+      return RetrieveVideoInfoQueued(items, bDirNames, content, useLocal);
+
     if (pDlgProgress)
     {
       if (items.Size() > 1 || (items[0]->m_bIsFolder && fetchEpisodes))
@@ -396,6 +514,8 @@ namespace VIDEO
         FoundSomeInfo = false;
         break;
       }
+      UpdateStats();
+
       if (ret == INFO_CANCELLED || ret == INFO_ERROR)
       {
         FoundSomeInfo = false;
@@ -429,6 +549,249 @@ namespace VIDEO
     return FoundSomeInfo;
   }
 
+  bool CVideoInfoScanner::RetrieveVideoInfoQueued(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal)
+  {
+    m_database.Open();
+    m_database.BeginBatch();
+
+    bool FoundSomeInfo = false;
+    deque<ScanLookupPtr> lookups;
+    unsigned int window = 2 * g_advancedSettings.m_iVideoScannerThreads;
+    int next = 0;
+    while (true)
+    {
+      // keep the job queue busy while we wait for the oldest lookup
+      while (!m_bStop && next < items.Size() && lookups.size() < window)
+      {
+        CFileItemPtr pItem = items[next];
+        int index = next++;
+
+        // we do this since we may have a override per dir
+        ScraperPtr info2 = m_database.GetScraperForPath(pItem->m_bIsFolder ? pItem->GetPath() : items.GetPath());
+        if (!info2) // skip
+          continue;
+
+        // Discard all exclude files defined by regExExclude
+        if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), g_advancedSettings.m_moviesExcludeFromScanRegExps))
+          continue;
+
+        ScanLookupPtr lookup(new CScanLookup(pItem, info2, index, bDirNames, useLocal));
+        if (info2->Content() == CONTENT_MOVIES || info2->Content() == CONTENT_MUSICVIDEOS)
+        {
+          if (pItem->m_bIsFolder || !pItem->IsVideo() || pItem->IsNFO() ||
+             (pItem->IsPlayList() && !URIUtils::GetExtension(pItem->GetPath()).Equals(".strm")))
+            lookup->m_result = INFO_NOT_NEEDED;
+          else if (info2->Content() == CONTENT_MOVIES ? m_database.HasMovieInfo(pItem->GetPath())
+                                                      : m_database.HasMusicVideoInfo(pItem->GetPath()))
+            lookup->m_result = INFO_HAVE_ALREADY;
+          else
+          {
+            // clear our scraper cache
+            info2->ClearCache();
+            lookup->m_queued = true;
+            m_jobQueue->AddJob(new CVideoScanJob(this, lookup));
+          }
+        }
+        lookups.push_back(lookup);
+      }
+      if (lookups.empty())
+        break;
+
+      // add the items to the database in listing order
+      ScanLookupPtr lookup = lookups.front();
+      lookups.pop_front();
+      CFileItemPtr pItem = lookup->m_item;
+
+      INFO_RET ret = INFO_CANCELLED;
+      if (lookup->m_scraper->Content() == CONTENT_MOVIES || lookup->m_scraper->Content() == CONTENT_MUSICVIDEOS)
+      {
+        if (m_pObserver)
+        {
+          m_pObserver->OnSetCurrentProgress(lookup->m_index, items.Size());
+          if (!pItem->m_bIsFolder && m_itemCount)
+            m_pObserver->OnSetProgress(m_currentItem++, m_itemCount);
+        }
+        if (lookup->m_queued)
+        {
+          lookup->m_done.Wait();
+          ret = FinishLookup(*lookup);
+        }
+        else
+          ret = lookup->m_result;
+      }
+      else if (lookup->m_scraper->Content() == CONTENT_TVSHOWS)
+      {
+        lookup->m_scraper->ClearCache();
+        ret = RetrieveInfoForTvShow(pItem, bDirNames, lookup->m_scraper, useLocal, NULL, true, NULL);
+      }
+      else
+        CLog::Log(LOGERROR, "VideoInfoScanner: Unknown content type %d (%s)", lookup->m_scraper->Content(), pItem->GetPath().c_str());
+
+      UpdateStats();
+
+      if (ret == INFO_CANCELLED || ret == INFO_ERROR)
+      {
+        FoundSomeInfo = false;
+        break;
+      }
+      if (ret == INFO_ADDED || ret == INFO_HAVE_ALREADY)
+        FoundSomeInfo = true;
+    }
+    WaitForJobs(lookups);
+
+    if (!m_database.CommitBatch())
+    { // some of the folder didn't make it into the database, scan it again next time
+      CLog::Log(LOGWARNING, "VideoInfoScanner: Items of %s were rolled back, clearing its hash", items.GetPath().c_str());
+      m_database.SetPathHash(items.GetPath(), "");
+      FoundSomeInfo = false;
+    }
+
+    g_infoManager.ResetLibraryBools();
+    m_database.Close();
+    return FoundSomeInfo;
+  }
+
+  void CVideoInfoScanner::LookupVideo(CScanLookup &lookup)
+  {
+    if (m_bStop)
+      return;
+    lookup.m_cancelled = false;
+
+    // the scraper parser keeps state between calls, so each lookup works on its own copy
+    CFileItem *pItem = lookup.m_item.get();
+    ScraperPtr scraper = boost::dynamic_pointer_cast<CScraper>(lookup.m_scraper->Clone(lookup.m_scraper));
+    CNfoFile nfoReader;
+    CScraperUrl url;
+    if (lookup.m_useLocal)
+    { // url nfo files are tried against the shared fallback scrapers too
+      CSingleLock lock(m_nfoSection);
+      lookup.m_nfo = CheckForNFOFile(pItem, lookup.m_dirNames, scraper, url, nfoReader);
+      if (lookup.m_nfo == CNfoFile::URL_NFO || lookup.m_nfo == CNfoFile::COMBINED_NFO)
+        scraper = boost::dynamic_pointer_cast<CScraper>(scraper->Clone(scraper));
+    }
+    lookup.m_scraper = scraper;
+
+    if (lookup.m_nfo == CNfoFile::FULL_NFO)
+    {
+      pItem->GetVideoInfoTag()->Reset();
+      nfoReader.GetDetails(*pItem->GetVideoInfoTag());
+      lookup.m_details = true;
+    }
+    else
+    {
+      if (lookup.m_nfo != CNfoFile::URL_NFO && lookup.m_nfo != CNfoFile::COMBINED_NFO)
+      {
+        MOVIELIST movielist;
+        CVideoInfoDownloader imdb(scraper);
+        lookup.m_found = imdb.FindMovie(pItem->GetMovieName(lookup.m_dirNames), movielist, NULL);
+        if (lookup.m_found <= 0 || movielist.empty())
+          return;
+        url = movielist[0];
+      }
+      lookup.m_details = GetDetails(pItem, url, scraper, lookup.m_nfo == CNfoFile::COMBINED_NFO ? &nfoReader : NULL);
+    }
+
+    if (lookup.m_details)
+      FetchArtwork(pItem, scraper->Content(), lookup.m_dirNames, lookup.m_useLocal, NULL);
+  }
+
+  INFO_RET CVideoInfoScanner::FinishLookup(CScanLookup &lookup)
+  {
+    if (lookup.m_cancelled)
+      return INFO_CANCELLED;
+
+    if (lookup.m_found < 0 || (lookup.m_found == 0 && !DownloadFailed(NULL)))
+    { // scraper reported an error, or we had an error and user wants to cancel the scan
+      m_bStop = true;
+      return INFO_CANCELLED;
+    }
+    if (!lookup.m_details)
+      return INFO_NOT_FOUND;
+
+    if (AddVideo(lookup.m_item.get(), lookup.m_scraper->Content(), lookup.m_dirNames) < 0)
+      return INFO_ERROR;
+    AnnounceUpdate(*lookup.m_item, lookup.m_scraper->Content());
+    return INFO_ADDED;
+  }
+
+  void CVideoInfoScanner::ListFolder(CScanListing &listing)
+  {
+    if (m_bStop)
+      return;
+
+    listing.m_fastHash = GetFastHash(listing.m_path);
+    if (listing.m_fastHash.IsEmpty() || listing.m_fastHash != listing.m_dbHash)
+    {
+      CDirectory::GetDirectory(listing.m_path, listing.m_items, g_settings.m_videoExtensions);
+      listing.m_items.Stack();
+      // compute hash
+      GetPathHash(listing.m_items, listing.m_hash);
+      listing.m_listed = true;
+      AtomicIncrement(&m_stats.foldersListed);
+    }
+    listing.m_complete = true;
+  }
+
+  int CVideoInfoScanner::PrefetchFolders(const CFileItemList &items, int start, const CStdStringArray &regexps)
+  {
+    unsigned int window = 2 * g_advancedSettings.m_iVideoScannerThreads;
+    int i = start;
+    for (; i < items.Size() && m_listings.size() < window; ++i)
+    {
+      CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList() ||
+          m_listings.find(pItem->GetPath()) != m_listings.end())
+        continue;
+
+      // only list folders that DoScan() will list itself
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(pItem->GetPath(), settings, foundDirectly);
+      if (!info || (info->Content() != CONTENT_MOVIES && info->Content() != CONTENT_MUSICVIDEOS) ||
+          (m_scanAll && settings.noupdate) || CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+        continue;
+
+      CStdString dbHash;
+      m_database.GetPathHash(pItem->GetPath(), dbHash);
+      ScanListingPtr listing(new CScanListing(pItem->GetPath(), dbHash));
+      m_listings.insert(make_pair(pItem->GetPath(), listing));
+      m_jobQueue->AddJob(new CVideoScanJob(this, listing));
+    }
+    return i;
+  }
+
+  ScanListingPtr CVideoInfoScanner::TakeListing(const CStdString &path)
+  {
+    ScanListingPtr listing;
+    map<CStdString, ScanListingPtr>::iterator i = m_listings.find(path);
+    if (i != m_listings.end())
+    {
+      listing = i->second;
+      m_listings.erase(i);
+      listing->m_done.Wait();
+    }
+    return listing;
+  }
+
+  void CVideoInfoScanner::WaitForJobs(deque<ScanLookupPtr> &lookups)
+  {
+    for (deque<ScanLookupPtr>::iterator i = lookups.begin(); i != lookups.end(); ++i)
+    {
+      if ((*i)->m_queued)
+        (*i)->m_done.Wait();
+    }
+    lookups.clear();
+  }
+
+  void CVideoInfoScanner::UpdateStats()
+  {
+    if (m_pObserver)
+    {
+      m_stats.elapsed = XbmcThreads::SystemClockMillis() - m_scanStart;
+      m_pObserver->OnSetStats(m_stats);
+    }
+  }
+
   INFO_RET CVideoInfoScanner::RetrieveInfoForTvShow(CFileItemPtr pItem, bool bDirNames, ScraperPtr &info2, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     long idTvShow = -1;
@@ -1096,11 +1459,20 @@ namespace VIDEO
     if (g_advancedSettings.m_bVideoLibraryImportWatchedState)
       m_database.SetPlayCount(*pItem, movieDetails.m_playCount, movieDetails.m_lastPlayed);
 
+    if (lResult > -1)
+      AtomicIncrement(&m_stats.itemsWritten);
+
     m_database.Close();
     return lResult;
   }
 
   void CVideoInfoScanner::GetArtwork(CFileItem *pItem, const CONTENT_TYPE &content, bool bApplyToDir, bool useLocal, CGUIDialogProgress* pDialog /* == NULL */)
+  {
+    FetchArtwork(pItem, content, bApplyToDir, useLocal, pDialog);
+    AnnounceUpdate(*pItem, content);
+  }
+
+  void CVideoInfoScanner::FetchArtwork(CFileItem *pItem, const CONTENT_TYPE &content, bool bApplyToDir, bool useLocal, CGUIDialogProgress* pDialog)
   {
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
     // get & save fanart image
@@ -1160,11 +1532,14 @@ namespace VIDEO
       FetchActorThumbs(movieDetails.m_cast, parentDir);
     if (bApplyToDir)
       ApplyThumbToFolder(parentDir, cachedThumb);
+  }
 
-    CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
+  void CVideoInfoScanner::AnnounceUpdate(const CFileItem &item, const CONTENT_TYPE &content)
+  {
+    CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(item));
     // Hack to make sure CVideoInfoTag::m_strShowTitle is set for tvshows
     // to make sure CAnnouncementManager provides the correct type for the item
-    if (content == CONTENT_TVSHOWS && !isEpisode && itemCopy->HasVideoInfoTag())
+    if (content == CONTENT_TVSHOWS && item.m_bIsFolder && itemCopy->HasVideoInfoTag())
       itemCopy->GetVideoInfoTag()->m_strShowTitle = itemCopy->GetVideoInfoTag()->m_strTitle;
     ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", itemCopy);
   }
@@ -1495,6 +1870,7 @@ namespace VIDEO
 
     if (ret)
     {
+      AtomicIncrement(&m_stats.lookups);
       if (nfoFile)
         nfoFile->GetDetails(movieDetails,NULL,true);
 
@@ -1636,6 +2012,11 @@ namespace VIDEO
   {
     for (unsigned int i=0;i<actors.size();++i)
     {
+      { // lookups on the job queue share actors, only handle each one once per scan
+        CSingleLock lock(m_actorSection);
+        if (!m_actorThumbs.insert(actors[i].strName).second)
+          continue;
+      }
       CFileItem item;
       item.SetLabel(actors[i].strName);
       CStdString strThumb = item.GetCachedActorThumb();
@@ -1654,6 +2035,11 @@ namespace VIDEO
   }
 
   CNfoFile::NFOResult CVideoInfoScanner::CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ScraperPtr& info, CScraperUrl& scrUrl)
+  {
+    return CheckForNFOFile(pItem, bGrabAny, info, scrUrl, m_nfoReader);
+  }
+
+  CNfoFile::NFOResult CVideoInfoScanner::CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ScraperPtr& info, CScraperUrl& scrUrl, CNfoFile &nfoReader)
   {
     CStdString strNfoFile;
     if (info->Content() == CONTENT_MOVIES || info->Content() == CONTENT_MUSICVIDEOS
@@ -1665,7 +2051,7 @@ namespace VIDEO
     CNfoFile::NFOResult result=CNfoFile::NO_NFO;
     if (!strNfoFile.IsEmpty() && CFile::Exists(strNfoFile))
     {
-      result = m_nfoReader.Create(strNfoFile,info,pItem->GetVideoInfoTag()->m_iEpisode);
+      result = nfoReader.Create(strNfoFile,info,pItem->GetVideoInfoTag()->m_iEpisode);
 
       CStdString type;
       switch(result)
@@ -1689,19 +2075,20 @@ namespace VIDEO
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Found matching %s NFO file: %s", type.c_str(), strNfoFile.c_str());
       if (result == CNfoFile::FULL_NFO)
       {
+        AtomicIncrement(&m_stats.nfoFiles);
         if (info->Content() == CONTENT_TVSHOWS)
-          info = m_nfoReader.GetScraperInfo();
+          info = nfoReader.GetScraperInfo();
       }
       else if (result != CNfoFile::NO_NFO && result != CNfoFile::ERROR_NFO)
       {
-        scrUrl = m_nfoReader.ScraperUrl();
-        info = m_nfoReader.GetScraperInfo();
+        scrUrl = nfoReader.ScraperUrl();
+        info = nfoReader.GetScraperInfo();
 
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Fetching url '%s' using %s scraper (content: '%s')",
           scrUrl.m_url[0].m_url.c_str(), info->Name().c_str(), TranslateContent(info->Content()).c_str());
 
         if (result == CNfoFile::COMBINED_NFO)
-          m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
+          nfoReader.GetDetails(*pItem->GetVideoInfoTag());
       }
     }
     else
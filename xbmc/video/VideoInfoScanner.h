@@ -20,13 +20,18 @@
  *
  */
 #include "threads/Thread.h"
+#include "threads/CriticalSection.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
 #include "VideoInfoDownloader.h"
 #include "XBDateTime.h"
 
+#include <deque>
+#include <map>
+
 class CRegExp;
+class CJobQueue;
 
 namespace VIDEO
 {
@@ -54,6 +59,25 @@ namespace VIDEO
 
   enum SCAN_STATE { PREPARING = 0, REMOVING_OLD, CLEANING_UP_DATABASE, FETCHING_MOVIE_INFO, FETCHING_MUSICVIDEO_INFO, FETCHING_TVSHOW_INFO, COMPRESSING_DATABASE, WRITING_CHANGES };
 
+  /*! \brief Throughput of the scan stages
+   Folders are listed and items looked up on the scanner's job queue, while the scanner
+   thread is the only one writing to the database.
+   */
+  typedef struct SScanStats
+  {
+    SScanStats() { foldersListed = nfoFiles = lookups = itemsWritten = 0; elapsed = 0; }
+    long foldersListed;    /* folders listed and hashed */
+    long nfoFiles;         /* items resolved from a local nfo file */
+    long lookups;          /* items searched and fetched with a scraper */
+    long itemsWritten;     /* items added to the database */
+    unsigned int elapsed;  /* milliseconds since the scan started */
+  } SScanStats;
+
+  class CScanListing;
+  class CScanLookup;
+  typedef boost::shared_ptr<CScanListing> ScanListingPtr;
+  typedef boost::shared_ptr<CScanLookup> ScanLookupPtr;
+
   class IVideoInfoScannerObserver
   {
   public:
@@ -64,6 +88,7 @@ namespace VIDEO
     virtual void OnSetProgress(int currentItem, int itemCount)=0;
     virtual void OnSetCurrentProgress(int currentItem, int itemCount)=0;
     virtual void OnSetTitle(const CStdString& strTitle) = 0;
+    virtual void OnSetStats(const SScanStats& stats) = 0;
     virtual void OnFinished() = 0;
   };
 
@@ -78,6 +103,7 @@ namespace VIDEO
 
   class CVideoInfoScanner : CThread
   {
+    friend class CVideoScanJob;
   public:
     CVideoInfoScanner();
     virtual ~CVideoInfoScanner();
@@ -134,6 +160,54 @@ namespace VIDEO
     INFO_RET RetrieveInfoForMusicVideo(CFileItemPtr pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForEpisodes(CFileItemPtr item, long showID, const ADDON::ScraperPtr &scraper, bool useLocal, CGUIDialogProgress *progress = NULL);
 
+    /*! \brief Retrieve information for a folder of movies or music videos using the job queue.
+     Up to m_iVideoScannerThreads items are looked up at once (nfo file, scraper search and details,
+     artwork) while this thread adds the finished ones to the database in listing order, all within
+     one database batch.
+     \param items list of items to retrieve info for.
+     \param bDirNames whether we should use folder or file names for lookups.
+     \param content type of content to retrieve.
+     \param useLocal should local data (.nfo and art) be used.
+     \return true if we successfully found information for some items, false otherwise
+     \sa RetrieveVideoInfo
+     */
+    bool RetrieveVideoInfoQueued(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal);
+
+    /*! \brief Look up a movie or music video without using the database. Runs on the job queue.
+     \sa FinishLookup
+     */
+    void LookupVideo(CScanLookup &lookup);
+
+    /*! \brief Add a looked up item to the database
+     \return the result of the lookup as RetrieveInfoForMovie() would have returned it
+     \sa LookupVideo
+     */
+    INFO_RET FinishLookup(CScanLookup &lookup);
+
+    /*! \brief List and hash a movie or music video folder. Runs on the job queue.
+     The listing is skipped if the fast hash of the folder matches the one in the database.
+     */
+    void ListFolder(CScanListing &listing);
+
+    /*! \brief Queue listings of the folders DoScan() will recurse into next
+     \param items the folder listing being scanned
+     \param start index of the first item not yet considered for prefetching
+     \param regexps exclude regexps of the current content
+     \return index of the first item not yet considered for prefetching
+     */
+    int PrefetchFolders(const CFileItemList &items, int start, const CStdStringArray &regexps);
+
+    /*! \brief Retrieve a listing queued by PrefetchFolders(), waiting for it if needed
+     \return the listing, or an empty pointer if the folder wasn't queued
+     */
+    ScanListingPtr TakeListing(const CStdString &path);
+
+    /*! \brief Wait for lookups still on the job queue and drop them
+     */
+    void WaitForJobs(std::deque<ScanLookupPtr> &lookups);
+
+    void UpdateStats();
+
     /*! \brief Update the progress bar with the heading and line and check for cancellation
      \param progress CGUIDialogProgress bar
      \param heading string id of heading
@@ -171,6 +245,15 @@ namespace VIDEO
      */
     void GetArtwork(CFileItem *pItem, const CONTENT_TYPE &content, bool bApplyToDir=false, bool useLocal=true, CGUIDialogProgress* pDialog = NULL);
 
+    /*! \brief Retrieve the artwork of an item without announcing the update
+     \sa GetArtwork, AnnounceUpdate
+     */
+    void FetchArtwork(CFileItem *pItem, const CONTENT_TYPE &content, bool bApplyToDir, bool useLocal, CGUIDialogProgress* pDialog);
+
+    /*! \brief Announce that an item has been added or updated in the library
+     */
+    void AnnounceUpdate(const CFileItem &item, const CONTENT_TYPE &content);
+
     /*! \brief Extract episode and season numbers from a processed regexp
      \param reg Regular expression object with at least 2 matches
      \param episodeInfo Episode information to fill in.
@@ -235,6 +318,7 @@ namespace VIDEO
     bool ProcessItemByVideoInfoTag(const CFileItemPtr item, EPISODES &episodeList);
 
     CStdString GetnfoFile(CFileItem *item, bool bGrabAny=false) const;
+    CNfoFile::NFOResult CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ADDON::ScraperPtr& scraper, CScraperUrl& scrUrl, CNfoFile &nfoReader);
 
     /*! \brief Retrieve the parent folder of an item, accounting for stacks and files in rars.
      \param item a media item.
@@ -255,6 +339,14 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+
+    CJobQueue *m_jobQueue;                            ///< listings and lookups, NULL when scanning serially
+    std::map<CStdString, ScanListingPtr> m_listings;  ///< folder listings queued by PrefetchFolders()
+    SScanStats m_stats;
+    unsigned int m_scanStart;
+    CCriticalSection m_nfoSection;
+    CCriticalSection m_actorSection;
+    std::set<CStdString> m_actorThumbs;              ///< actors whose thumbs were handled during this scan
   };
 }
 
@@ -27,6 +27,7 @@
 #include "settings/GUISettings.h"
 #include "Application.h"
 #include "threads/SingleLock.h"
+#include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
 
 #define CONTROL_LABELSTATUS       401
@@ -34,6 +35,7 @@
 #define CONTROL_PROGRESS          403
 #define CONTROL_CURRENT_PROGRESS  404
 #define CONTROL_LABELTITLE        405
+#define CONTROL_LABELSTATS        406
 
 using namespace VIDEO;
 
@@ -57,6 +59,7 @@ bool CGUIDialogVideoScan::OnMessage(CGUIMessage& message)
 
       m_strCurrentDir.Empty();
       m_strTitle.Empty();
+      m_stats = SScanStats();
 
       m_fPercentDone=-1.0f;
       m_fCurrentPercentDone=-1.0f;
@@ -115,6 +118,13 @@ void CGUIDialogVideoScan::OnSetTitle(const CStdString& strTitle)
   m_strTitle = strTitle;
 }
 
+void CGUIDialogVideoScan::OnSetStats(const SScanStats& stats)
+{
+  CSingleLock lock (m_critical);
+
+  m_stats = stats;
+}
+
 void CGUIDialogVideoScan::StartScanning(const CStdString& strDirectory, bool scanAll)
 {
   m_ScanState = PREPARING;
@@ -178,6 +188,12 @@ void CGUIDialogVideoScan::UpdateState()
     SET_CONTROL_LABEL(CONTROL_LABELDIRECTORY, strStrippedPath);
     SET_CONTROL_LABEL(CONTROL_LABELTITLE, m_strTitle);
 
+    CStdString strStats;
+    if (m_stats.elapsed)
+      strStats.Format(g_localizeStrings.Get(20459), m_stats.foldersListed, m_stats.nfoFiles + m_stats.lookups,
+                      m_stats.itemsWritten, m_stats.itemsWritten * 60000.0f / m_stats.elapsed);
+    SET_CONTROL_LABEL(CONTROL_LABELSTATS, strStats);
+
     if (m_fCurrentPercentDone>-1.0f)
     {
       SET_CONTROL_VISIBLE(CONTROL_CURRENT_PROGRESS);
@@ -195,6 +211,7 @@ void CGUIDialogVideoScan::UpdateState()
   {
     SET_CONTROL_LABEL(CONTROL_LABELDIRECTORY, "");
     SET_CONTROL_LABEL(CONTROL_LABELTITLE, "");
+    SET_CONTROL_LABEL(CONTROL_LABELSTATS, "");
     SET_CONTROL_HIDDEN(CONTROL_PROGRESS);
     SET_CONTROL_HIDDEN(CONTROL_CURRENT_PROGRESS);
   }
@@ -47,11 +47,13 @@ protected:
   virtual void OnSetProgress(int currentItem, int itemCount);
   virtual void OnSetCurrentProgress(int currentItem, int itemCount);
   virtual void OnSetTitle(const CStdString& strTitle);
+  virtual void OnSetStats(const VIDEO::SScanStats& stats);
 
   VIDEO::CVideoInfoScanner m_videoInfoScanner;
   VIDEO::SCAN_STATE m_ScanState;
   CStdString m_strCurrentDir;
   CStdString m_strTitle;
+  VIDEO::SScanStats m_stats;
 
   CCriticalSection m_critical;
 
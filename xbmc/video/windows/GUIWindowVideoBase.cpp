@@ -704,6 +704,9 @@ void CGUIWindowVideoBase::OnQueueItem(int iItem)
   if (!item->CanQueue())
     item->SetCanQueue(true);
 
+  if (!item->m_bIsFolder)
+    LoadDetails(vector<CFileItem*>(1, item.get()));
+
   CFileItemList queuedItems;
   AddItemToPlayList(item, queuedItems);
   // if party mode, add items but DONT start playing
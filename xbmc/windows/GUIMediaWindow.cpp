@@ -717,8 +717,13 @@ bool CGUIMediaWindow::Update(const CStdString &strDirectory)
 
   m_history.SetSelectedItem(strSelectedItem, strOldDirectory);
 
+  // huge library nodes shown here are listed with light items, as the view fills in their details.
+  // Listings fetched to queue or play items keep all the details.
   CFileItemList items;
-  if (!GetDirectory(strDirectory, items))
+  m_rootDir.SetFlags(XFILE::DIR_FLAG_ALLOW_PROMPT | XFILE::DIR_FLAG_LAZY_DETAILS);
+  bool result = GetDirectory(strDirectory, items);
+  m_rootDir.SetFlags(XFILE::DIR_FLAG_ALLOW_PROMPT);
+  if (!result)
   {
     CLog::Log(LOGERROR,"CGUIMediaWindow::GetDirectory(%s) failed", strDirectory.c_str());
     // if the directory is the same as the old directory, then we'll return
@@ -1223,6 +1228,7 @@ bool CGUIMediaWindow::OnPlayAndQueueMedia(const CFileItemPtr &item)
     g_playlistPlayer.Reset();
     int mediaToPlay = 0;
     CFileItemList queueItems;
+    vector<CFileItem*> copies;
     for ( int i = 0; i < m_vecItems->Size(); i++ )
     {
       CFileItemPtr nItem = m_vecItems->Get(i);
@@ -1231,13 +1237,23 @@ bool CGUIMediaWindow::OnPlayAndQueueMedia(const CFileItemPtr &item)
         continue;
 
       if (!nItem->IsPlayList() && !nItem->IsZIP() && !nItem->IsRAR())
-        queueItems.Add(nItem);
+      {
+        if (m_vecItems->GetDetailsLoader())
+        {
+          CFileItemPtr copy(new CFileItem(*nItem));
+          copies.push_back(copy.get());
+          queueItems.Add(copy);
+        }
+        else
+          queueItems.Add(nItem);
+      }
 
       if (nItem == item)
       { // item that was clicked
         mediaToPlay = queueItems.Size() - 1;
       }
     }
+    LoadDetails(copies);
     g_playlistPlayer.Add(iPlaylist, queueItems);
 
     // Save current window and directory to know where the selected item was
@@ -1259,6 +1275,15 @@ bool CGUIMediaWindow::OnPlayAndQueueMedia(const CFileItemPtr &item)
   return true;
 }
 
+// Light items of the listing only have the details of what's on screen, so copies of them
+// leaving the view to be queued or played get all of theirs first.
+void CGUIMediaWindow::LoadDetails(const vector<CFileItem*> &copies)
+{
+  CFileItemDetailsLoaderPtr loader = m_vecItems->GetDetailsLoader();
+  if (loader && !copies.empty())
+    loader->LoadNow(copies);
+}
+
 // \brief Synchonize the fileitems with the playlistplayer
 // It recreated the playlist of the playlistplayer based
 // on the fileitems of the window